@@ -0,0 +1,38 @@
+#!/bin/sh
+#
+# Measures the wall clock time of the Sequential, Parallel2 and Parallel4
+# configurations. The processes of the partitions communicate via named pipes
+# in the comm/ directory, so all of them run on this machine.
+#
+# usage: ./benchmark.sh [extra options passed to the simulation, e.g. --sim-time-limit=100s]
+#
+
+RUN=../../../src/run_inet
+
+run_config()
+{
+    config=$1
+    partitions=$2
+    shift 2
+    rm -rf comm
+    mkdir comm
+    start=$(date +%s.%N)
+    if [ $partitions -eq 1 ]; then
+        $RUN -u Cmdenv -c $config "$@" >$config.log 2>&1
+    else
+        procid=1
+        while [ $procid -lt $partitions ]; do
+            $RUN -u Cmdenv -c $config --parsim-procid=$procid "$@" >$config-$procid.log 2>&1 &
+            procid=$((procid+1))
+        done
+        $RUN -u Cmdenv -c $config --parsim-procid=0 "$@" >$config-0.log 2>&1
+        wait
+    fi
+    end=$(date +%s.%N)
+    echo "$config: $(echo "$end - $start" | bc) s"
+}
+
+run_config Sequential 1 "$@"
+run_config Parallel2 2 "$@"
+run_config Parallel4 4 "$@"
+rm -rf comm
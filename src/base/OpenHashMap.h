@@ -0,0 +1,260 @@
+//
+// Copyright (C) 2026 OpenSim Ltd
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program; if not, see <http://www.gnu.org/licenses/>.
+//
+
+#ifndef __INET_OPENHASHMAP_H
+#define __INET_OPENHASHMAP_H
+
+#include <vector>
+
+#include "INETDefs.h"
+
+
+/**
+ * Mixes the bits of a 32-bit value (the 32-bit finalizer of MurmurHash3).
+ * Meant for building the hash functors of OpenHashMap.
+ */
+inline size_t hashUInt32(uint32 h)
+{
+    h ^= h >> 16;
+    h *= 0x85ebca6bU;
+    h ^= h >> 13;
+    h *= 0xc2b2ae35U;
+    h ^= h >> 16;
+    return h;
+}
+
+/**
+ * Mixes the bits of a 64-bit value (the 64-bit finalizer of MurmurHash3).
+ * Meant for building the hash functors of OpenHashMap.
+ */
+inline size_t hashUInt64(uint64 h)
+{
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ULL;
+    h ^= h >> 33;
+    return (size_t)h;
+}
+
+/**
+ * Combines two hash values, e.g. those of the fields of a compound key.
+ */
+inline size_t hashCombine(size_t h1, size_t h2)
+{
+    return h1 ^ (h2 * 31);
+}
+
+/**
+ * Hash table for the large per-node tables of the protocol models (MAC
+ * address tables, routing protocol databases, etc.). It implements the
+ * subset of the std::map<K,T> interface used in INET: find(), operator[],
+ * insert(), erase(), iteration, size().
+ *
+ * Hash is a functor class that computes the hash value of a key, usually
+ * with hashUInt32() or hashUInt64(); K must be default constructible and
+ * comparable with ==.
+ *
+ * Open addressing with linear probing and backward shift deletion is used,
+ * so lookups are O(1) on average, and no memory is allocated per entry and
+ * no tombstones are left behind. Unlike with std::map, iteration order is
+ * unspecified (but deterministic), and insert() and erase() invalidate all
+ * iterators and element pointers, except the iterator returned by them.
+ */
+template<typename K, typename T, typename Hash>
+class OpenHashMap
+{
+  public:
+    typedef K key_type;
+    typedef T mapped_type;
+    typedef std::pair<K, T> value_type;
+
+  protected:
+    struct Slot
+    {
+        bool used;
+        value_type value;
+        Slot() : used(false), value(K(), T()) {}
+    };
+
+    std::vector<Slot> slots;    // size is 0 or a power of 2
+    size_t count;
+    Hash hash;
+
+  public:
+    class const_iterator;
+
+    class iterator
+    {
+        friend class OpenHashMap;
+        friend class const_iterator;
+      protected:
+        OpenHashMap *map;
+        size_t index;
+
+        iterator(OpenHashMap *map, size_t index) : map(map), index(index) { skipUnused(); }
+        void skipUnused() { while (index < map->slots.size() && !map->slots[index].used) index++; }
+
+      public:
+        iterator() : map(NULL), index(0) {}
+        value_type& operator*() const { return map->slots[index].value; }
+        value_type *operator->() const { return &map->slots[index].value; }
+        iterator& operator++() { index++; skipUnused(); return *this; }
+        iterator operator++(int) { iterator tmp = *this; ++(*this); return tmp; }
+        bool operator==(const iterator& other) const { return index == other.index; }
+        bool operator!=(const iterator& other) const { return index != other.index; }
+    };
+
+    class const_iterator
+    {
+        friend class OpenHashMap;
+      protected:
+        const OpenHashMap *map;
+        size_t index;
+
+        const_iterator(const OpenHashMap *map, size_t index) : map(map), index(index) { skipUnused(); }
+        void skipUnused() { while (index < map->slots.size() && !map->slots[index].used) index++; }
+
+      public:
+        const_iterator() : map(NULL), index(0) {}
+        const_iterator(const iterator& it) : map(it.map), index(it.index) {}
+        const value_type& operator*() const { return map->slots[index].value; }
+        const value_type *operator->() const { return &map->slots[index].value; }
+        const_iterator& operator++() { index++; skipUnused(); return *this; }
+        const_iterator operator++(int) { const_iterator tmp = *this; ++(*this); return tmp; }
+        bool operator==(const const_iterator& other) const { return index == other.index; }
+        bool operator!=(const const_iterator& other) const { return index != other.index; }
+    };
+
+  protected:
+    size_t mask() const { return slots.size() - 1; }
+
+    // returns the slot of the key, or the free slot where it would go
+    size_t probe(const K& key) const
+    {
+        size_t i = hash(key) & mask();
+        while (slots[i].used && !(slots[i].value.first == key))
+            i = (i + 1) & mask();
+        return i;
+    }
+
+    void rehash(size_t newSize)
+    {
+        std::vector<Slot> oldSlots(newSize);
+        oldSlots.swap(slots);
+        for (size_t i = 0; i < oldSlots.size(); i++)
+            if (oldSlots[i].used)
+                slots[probe(oldSlots[i].value.first)] = oldSlots[i];
+    }
+
+    // backward shift deletion: moves the following entries of the cluster
+    // into the hole, so that lookups need no tombstones
+    void eraseSlot(size_t hole)
+    {
+        size_t i = hole;
+        while (true)
+        {
+            i = (i + 1) & mask();
+            if (!slots[i].used)
+                break;
+            size_t home = hash(slots[i].value.first) & mask();
+            // move the entry if its home slot is not cyclically in (hole, i]
+            if (((i - home) & mask()) >= ((i - hole) & mask()))
+            {
+                slots[hole] = slots[i];
+                hole = i;
+            }
+        }
+        slots[hole] = Slot();
+        count--;
+    }
+
+  public:
+    OpenHashMap() : count(0) {}
+
+    bool empty() const { return count == 0; }
+    size_t size() const { return count; }
+
+    iterator begin() { return iterator(this, 0); }
+    iterator end() { return iterator(this, slots.size()); }
+    const_iterator begin() const { return const_iterator(this, 0); }
+    const_iterator end() const { return const_iterator(this, slots.size()); }
+
+    iterator find(const K& key)
+    {
+        if (count == 0)
+            return end();
+        size_t i = probe(key);
+        return slots[i].used ? iterator(this, i) : end();
+    }
+
+    const_iterator find(const K& key) const
+    {
+        if (count == 0)
+            return end();
+        size_t i = probe(key);
+        return slots[i].used ? const_iterator(this, i) : end();
+    }
+
+    std::pair<iterator, bool> insert(const value_type& value)
+    {
+        // keep the load factor at most 1/2
+        if (2 * (count + 1) > slots.size())
+            rehash(slots.empty() ? 16 : 2 * slots.size());
+        size_t i = probe(value.first);
+        if (slots[i].used)
+            return std::make_pair(iterator(this, i), false);
+        slots[i].used = true;
+        slots[i].value = value;
+        count++;
+        return std::make_pair(iterator(this, i), true);
+    }
+
+    T& operator[](const K& key)
+    {
+        return insert(value_type(key, T())).first->second;
+    }
+
+    size_t erase(const K& key)
+    {
+        iterator it = find(key);
+        if (it == end())
+            return 0;
+        eraseSlot(it.index);
+        return 1;
+    }
+
+    /**
+     * Erases the element, and returns the iterator to continue the iteration
+     * with. All elements not yet visited will be visited, but when the erase
+     * moves an already visited element, it is visited again; so this is meant
+     * for erasing the elements that satisfy some condition.
+     */
+    iterator erase(iterator it)
+    {
+        eraseSlot(it.index);
+        return iterator(this, it.index);
+    }
+
+    void clear()
+    {
+        slots.clear();
+        count = 0;
+    }
+};
+
+#endif
@@ -0,0 +1,130 @@
+//
+// Copyright (C) 2026 OpenSim Ltd
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program; if not, see <http://www.gnu.org/licenses/>.
+//
+
+#include <algorithm>
+#include <sstream>
+
+#include "PacketRingBuffer.h"
+
+
+PacketRingBuffer::PacketRingBuffer(const char *name, int packetCapacity, int64 byteCapacity) :
+    cOwnedObject(name), head(0), count(0), byteLength(0), packetCapacity(0), byteCapacity(0)
+{
+    setCapacity(packetCapacity, byteCapacity);
+}
+
+PacketRingBuffer::~PacketRingBuffer()
+{
+    clear();
+}
+
+std::string PacketRingBuffer::info() const
+{
+    std::stringstream out;
+    if (count == 0)
+        out << "empty";
+    else
+        out << "len=" << count << ", " << byteLength << " bytes";
+    return out.str();
+}
+
+void PacketRingBuffer::forEachChild(cVisitor *v)
+{
+    for (unsigned int i = 0; i < count; i++)
+        v->visit(slot(i));
+}
+
+void PacketRingBuffer::setCapacity(int packetCapacity, int64 byteCapacity)
+{
+    if (packetCapacity < 0 || byteCapacity < 0)
+        throw cRuntimeError(this, "Negative capacity");
+    this->packetCapacity = packetCapacity;
+    this->byteCapacity = byteCapacity;
+    // allocate up front, but not excessively: huge capacities are usually
+    // just meant as "unlimited"
+    if (packetCapacity > 0)
+        reserve(std::min(packetCapacity, 1024));
+}
+
+void PacketRingBuffer::reserve(unsigned int size)
+{
+    if (size <= slots.size())
+        return;
+    unsigned int newSize = slots.empty() ? 16 : slots.size();
+    while (newSize < size)
+        newSize *= 2;
+
+    std::vector<cPacket *> newSlots(newSize, (cPacket *)NULL);
+    for (unsigned int i = 0; i < count; i++)
+        newSlots[i] = slot(i);
+    slots.swap(newSlots);
+    head = 0;
+}
+
+void PacketRingBuffer::insert(cPacket *packet)
+{
+    if (!packet)
+        throw cRuntimeError(this, "Cannot insert NULL pointer");
+    reserve(count + 1);
+    take(packet);
+    slot(count) = packet;
+    count++;
+    byteLength += packet->getByteLength();
+}
+
+void PacketRingBuffer::insertAt(int i, cPacket *packet)
+{
+    if (i < 0 || i > (int)count)
+        throw cRuntimeError(this, "insertAt(): index %d out of range", i);
+    insert(packet);
+    // rotate the new packet into place
+    for (int j = count - 1; j > i; j--)
+        slot(j) = slot(j - 1);
+    slot(i) = packet;
+}
+
+cPacket *PacketRingBuffer::pop()
+{
+    if (count == 0)
+        return NULL;
+    cPacket *packet = slot(0);
+    slot(0) = NULL;
+    head = (head + 1) & (slots.size() - 1);
+    count--;
+    byteLength -= packet->getByteLength();
+    drop(packet);
+    return packet;
+}
+
+cPacket *PacketRingBuffer::get(int i) const
+{
+    if (i < 0 || i >= (int)count)
+        throw cRuntimeError(this, "get(): index %d out of range", i);
+    return slot(i);
+}
+
+void PacketRingBuffer::clear()
+{
+    for (unsigned int i = 0; i < count; i++)
+    {
+        dropAndDelete(slot(i));
+        slot(i) = NULL;
+    }
+    head = 0;
+    count = 0;
+    byteLength = 0;
+}
@@ -0,0 +1,138 @@
+//
+// Copyright (C) 2026 OpenSim Ltd
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program; if not, see <http://www.gnu.org/licenses/>.
+//
+
+#ifndef __INET_PACKETRINGBUFFER_H
+#define __INET_PACKETRINGBUFFER_H
+
+#include <vector>
+
+#include "INETDefs.h"
+
+
+/**
+ * FIFO container of packets, stored in a ring buffer. An alternative to
+ * cQueue in packet queues (see DropTailRingQueue): cQueue allocates a list
+ * element for every insertion, while this container only allocates when
+ * it grows beyond its largest size so far.
+ * Insertion at the back, removal at the front, and the length and byte
+ * length queries are O(1); inserting elsewhere (insertAt()) is O(n).
+ *
+ * Like cQueue, the container owns the packets it holds: they are taken
+ * on insertion, dropped on removal, and deleted by clear() and by the
+ * destructor. The byte length is maintained from the lengths of the packets
+ * at insertion time, so packets must not be modified while they are queued.
+ *
+ * Optional packet and byte capacities can be set; they are not enforced by
+ * insert(), but callers can check them with isFull() and wouldOverflow().
+ * Note that unlike cQueue, the container is not recognized by the 'q'
+ * display string tag of Tkenv.
+ */
+class INET_API PacketRingBuffer : public cOwnedObject
+{
+  protected:
+    std::vector<cPacket *> slots;   // size is 0 or a power of 2
+    unsigned int head;              // slot index of the first packet
+    unsigned int count;             // number of packets
+    int64 byteLength;               // total length of the packets
+    int packetCapacity;             // 0 means unlimited
+    int64 byteCapacity;             // 0 means unlimited
+
+  protected:
+    cPacket *& slot(int i) { return slots[(head + i) & (slots.size() - 1)]; }
+    cPacket *slot(int i) const { return slots[(head + i) & (slots.size() - 1)]; }
+    void reserve(unsigned int size);
+
+  private:
+    // copying is not supported
+    PacketRingBuffer(const PacketRingBuffer&);
+    PacketRingBuffer& operator=(const PacketRingBuffer&);
+
+  public:
+    /**
+     * Creates an empty buffer. See setCapacity().
+     */
+    explicit PacketRingBuffer(const char *name = NULL, int packetCapacity = 0, int64 byteCapacity = 0);
+    virtual ~PacketRingBuffer();
+
+    /** @name Redefined cObject methods */
+    //@{
+    virtual std::string info() const;
+    virtual void forEachChild(cVisitor *v);
+    //@}
+
+    /**
+     * Sets the capacities (0 means unlimited). Space for packetCapacity
+     * packets (at most 1024) is allocated up front.
+     */
+    void setCapacity(int packetCapacity, int64 byteCapacity);
+    int getPacketCapacity() const { return packetCapacity; }
+    int64 getByteCapacity() const { return byteCapacity; }
+
+    /**
+     * Returns true if the packet count or byte length has reached its capacity.
+     */
+    bool isFull() const {
+        return (packetCapacity != 0 && (int)count >= packetCapacity) || (byteCapacity != 0 && byteLength >= byteCapacity);
+    }
+
+    /**
+     * Returns true if inserting the packet would exceed a capacity.
+     */
+    bool wouldOverflow(const cPacket *packet) const {
+        return (packetCapacity != 0 && (int)count >= packetCapacity) ||
+               (byteCapacity != 0 && byteLength + packet->getByteLength() > byteCapacity);
+    }
+
+    /**
+     * Inserts the packet at the back.
+     */
+    void insert(cPacket *packet);
+
+    /**
+     * Inserts the packet at the given position (0 is the front).
+     */
+    void insertAt(int i, cPacket *packet);
+
+    /**
+     * Removes and returns the packet at the front, or returns NULL if empty.
+     */
+    cPacket *pop();
+
+    /**
+     * Returns the packet at the front without removing it, or NULL if empty.
+     */
+    cPacket *front() const { return count > 0 ? slot(0) : NULL; }
+
+    /**
+     * Returns the i-th packet (0 is the front).
+     */
+    cPacket *get(int i) const;
+
+    /**
+     * Deletes all packets.
+     */
+    void clear();
+
+    int getLength() const { return count; }
+    int length() const { return count; }
+    int64 getByteLength() const { return byteLength; }
+    bool isEmpty() const { return count == 0; }
+    bool empty() const { return count == 0; }
+};
+
+#endif
+
@@ -210,4 +210,14 @@ inline std::ostream& operator<<(std::ostream& os, const MACAddress& mac)
     return os << mac.str();
 }
 
+inline void doPacking(cCommBuffer *buf, const MACAddress& mac)
+{
+    buf->pack(mac.getInt());
+}
+
+inline void doUnpacking(cCommBuffer *buf, MACAddress& mac)
+{
+    uint64 d; buf->unpack(d); mac = MACAddress(d);
+}
+
 #endif
@@ -15,6 +15,8 @@
  * along with this program; if not, see <http://www.gnu.org/licenses/>.
 */
 
+#include <algorithm>
+
 #include "EtherBus.h"
 
 Define_Module(EtherBus);
@@ -106,11 +108,19 @@ void EtherBus::checkConnections(bool errorWhenAsymmetric)
     int numActiveTaps = 0;
 
     double datarate = 0.0;
+    dataratesDiffer = false;
+    firstConnectedTap = numTaps;
+    lastConnectedTap = -1;
 
     for (int i = 0; i < numTaps; i++)
     {
         cGate* igate = gate(inputGateBaseId + i);
         cGate* ogate = gate(outputGateBaseId + i);
+        if (ogate->isConnected())
+        {
+            firstConnectedTap = std::min(firstConnectedTap, i);
+            lastConnectedTap = i;
+        }
         if (!igate->isConnected() && !ogate->isConnected())
             continue;
 
@@ -209,18 +219,22 @@ void EtherBus::handleMessage(cMessage *msg)
         int tapPoint = msg->getArrivalGate()->getIndex();
         EV << "Frame " << msg << " arrived on tap " << tapPoint << endl;
 
-        // create upstream and downstream events
-        if (tapPoint > 0)
+        // create upstream and downstream events, but only towards taps
+        // where the frame can be delivered
+        bool upstream = firstConnectedTap < tapPoint;
+        bool downstream = lastConnectedTap > tapPoint;
+
+        if (upstream)
         {
             // start UPSTREAM travel
             // if goes downstream too, we need to make a copy
-            cMessage *msg2 = (tapPoint < numTaps-1) ? msg->dup() : msg;
+            cMessage *msg2 = downstream ? msg->dup() : msg;
             msg2->setKind(UPSTREAM);
             msg2->setContextPointer(&tap[tapPoint-1]);
             scheduleAt(simTime()+tap[tapPoint].propagationDelay[UPSTREAM], msg2);
         }
 
-        if (tapPoint < numTaps-1)
+        if (downstream)
         {
             // start DOWNSTREAM travel
             msg->setKind(DOWNSTREAM);
@@ -228,9 +242,9 @@ void EtherBus::handleMessage(cMessage *msg)
             scheduleAt(simTime()+tap[tapPoint].propagationDelay[DOWNSTREAM], msg);
         }
 
-        if (numTaps == 1)
+        if (!upstream && !downstream)
         {
-            // if there's only one tap, there's nothing to do
+            // there's no other tap to deliver the frame to
             delete msg;
         }
     }
@@ -243,8 +257,10 @@ void EtherBus::handleMessage(cMessage *msg)
 
         EV << "Event " << msg << " on tap " << tapPoint << ", sending out frame\n";
 
-        // send out on gate
-        bool isLast = (direction == UPSTREAM) ? (tapPoint == 0) : (tapPoint == numTaps-1);
+        // send out on gate; the frame travels no further than the last
+        // connected tap, which gets the original instead of a copy. Copies
+        // share the encapsulated packet, see EtherHub::handleMessage().
+        bool isLast = (direction == UPSTREAM) ? (tapPoint <= firstConnectedTap) : (tapPoint >= lastConnectedTap);
         cGate* ogate = gate(outputGateBaseId + tapPoint);
         if (ogate->isConnected())
         {
@@ -53,6 +53,8 @@ class INET_API EtherBus : public cSimpleModule, cListener
 
     // state
     bool dataratesDiffer;
+    int firstConnectedTap;  // lowest index of a tap with connected output gate, or numTaps
+    int lastConnectedTap;   // highest index of a tap with connected output gate, or -1
 
     // statistics
     long numMessages;  // number of messages handled
@@ -113,6 +113,7 @@ void EtherHub::receiveSignal(cComponent *source, simsignal_t signalID, cObject *
             int newSize = gateSize("ethg");
             for (int i = notif->oldSize; i < newSize; i++)
                 gate(inputGateBaseId + i)->setDeliverOnReceptionStart(true);
+            numPorts = newSize;
         }
         return;
     }
@@ -160,13 +161,24 @@ void EtherHub::handleMessage(cMessage *msg)
     numMessages++;
     emit(pkSignal, msg);
 
-    if (numPorts <= 1)
+    // Every port gets its own copy of the frame, and the original goes to the
+    // last connected port. Copies are cheap: dup() only copies the frame
+    // header fields, while the encapsulated packet is shared among the copies
+    // (cPacket reference counting), and it is only duplicated for a receiver
+    // that decapsulates or otherwise accesses it. Receivers that drop the
+    // frame, e.g. because it is not addressed to them, never copy the payload.
+    int lastPort = -1;
+    for (int i = numPorts - 1; i >= 0 && lastPort == -1; i--)
+        if (i != arrivalPort && gate(outputGateBaseId + i)->isConnected())
+            lastPort = i;
+
+    if (lastPort == -1)
     {
         delete msg;
         return;
     }
 
-    for (int i = 0; i < numPorts; i++)
+    for (int i = 0; i <= lastPort; i++)
     {
         if (i != arrivalPort)
         {
@@ -174,20 +186,15 @@ void EtherHub::handleMessage(cMessage *msg)
             if (!ogate->isConnected())
                 continue;
 
-            bool isLast = (arrivalPort == numPorts-1) ? (i == numPorts-2) : (i == numPorts-1);
-            cMessage *msg2 = isLast ? msg : msg->dup();
+            cMessage *msg2 = (i == lastPort) ? msg : msg->dup();
 
             // stop current transmission
             ogate->getTransmissionChannel()->forceTransmissionFinishTime(SIMTIME_ZERO);
 
             // send
             send(msg2, ogate);
-
-            if (isLast)
-                msg = NULL;  // msg sent, do not delete it.
         }
     }
-    delete msg;
 }
 
 void EtherHub::finish()
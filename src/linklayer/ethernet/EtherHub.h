@@ -22,7 +22,8 @@
 
 /**
  * Models a wiring hub. It simply broadcasts the received message
- * on all other ports.
+ * on all other ports. The copies share the encapsulated packet,
+ * see the NED documentation.
  */
 class INET_API EtherHub : public cSimpleModule, protected cListener
 {
@@ -504,6 +504,18 @@ void EtherMACBase::readChannelParameters(bool errorWhenAsymmetric)
 
     connected = physOutGate->getPathEndGate()->isConnected() && physInGate->getPathStartGate()->isConnected();
 
+    // In a parallel simulation, the channel of a link between two partitions
+    // exists only in the partition of the sender, so the incoming channel of
+    // a link to a remote peer is not available; the link is assumed to be
+    // symmetric. The delay of the link provides the lookahead.
+    if (connected && physInGate->getPathStartGate()->getOwnerModule()->isPlaceholder())
+    {
+        if (outTrChannel && outTrChannel->getDelay() == 0)
+            throw cRuntimeError("The channel %s connects to an other partition, it must have nonzero delay",
+                    outTrChannel->getFullPath().c_str());
+        inTrChannel = outTrChannel;
+    }
+
     if (connected && ((!outTrChannel) || (!inTrChannel)))
         throw cRuntimeError("Ethernet phys gate must be connected using a transmission channel");
 
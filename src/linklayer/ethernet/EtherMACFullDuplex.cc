@@ -31,6 +31,8 @@ Define_Module(EtherMACFullDuplex);
 
 EtherMACFullDuplex::EtherMACFullDuplex()
 {
+    txBatchSize = 1;
+    numBatchFrames = 0;
 }
 
 void EtherMACFullDuplex::initialize(int stage)
@@ -42,6 +44,10 @@ void EtherMACFullDuplex::initialize(int stage)
         if (!par("duplexMode").boolValue())
             throw cRuntimeError("Half duplex operation is not supported by EtherMACFullDuplex, use the EtherMAC module for that! (Please enable csmacdSupport on EthernetInterface)");
 
+        txBatchSize = par("txBatchSize");
+        if (txBatchSize < 1)
+            throw cRuntimeError("Invalid txBatchSize %d, must be at least 1", txBatchSize);
+
         beginSendFrames();
     }
 }
@@ -116,11 +122,23 @@ void EtherMACFullDuplex::startFrameTransmission()
     // add preamble and SFD (Starting Frame Delimiter), then send out
     frame->addByteLength(PREAMBLE_BYTES+SFD_BYTES);
 
+    // a new batch starts unless we are continuing one from handleEndIFGPeriod()
+    if (transmitState != TRANSMITTING_STATE)
+        numBatchFrames = 0;
+
     // send
     EV << "Starting transmission of " << frame << endl;
     send(frame, physOutGate);
 
-    scheduleAt(transmissionChannel->getTransmissionFinishTime(), endTxMsg);
+    simtime_t finishTime = transmissionChannel->getTransmissionFinishTime();
+    if (txBatchSize > 1 && !txQueue.extQueue && !txQueue.innerQueue->empty() && ++numBatchFrames < txBatchSize)
+    {
+        // the next frame is already waiting: the end of this frame and the
+        // IFG after it are handled in a single event
+        scheduleAt(finishTime + INTERFRAME_GAP_BITS / curEtherDescr->txrate, endIFGMsg);
+    }
+    else
+        scheduleAt(finishTime, endTxMsg);
     transmitState = TRANSMITTING_STATE;
 }
 
@@ -249,7 +267,23 @@ void EtherMACFullDuplex::processMsgFromNetwork(EtherTraffic *msg)
 
 void EtherMACFullDuplex::handleEndIFGPeriod()
 {
-    if (transmitState != WAIT_IFG_STATE)
+    if (transmitState == TRANSMITTING_STATE)
+    {
+        // end of a frame in a batch, and of the IFG after it (see startFrameTransmission())
+        finishFrameTransmission();
+        lastTxFinishTime = simTime() - INTERFRAME_GAP_BITS / curEtherDescr->txrate;
+        getNextFrameFromQueue();
+
+        if (pauseUnitsRequested > 0)
+        {
+            EV << "Going to PAUSE mode for " << pauseUnitsRequested << " time units\n";
+
+            scheduleEndPausePeriod(pauseUnitsRequested);
+            pauseUnitsRequested = 0;
+            return;
+        }
+    }
+    else if (transmitState != WAIT_IFG_STATE)
         error("Not in WAIT_IFG_STATE at the end of IFG period");
 
     // End of IFG period, okay to transmit
@@ -267,6 +301,27 @@ void EtherMACFullDuplex::handleEndTxPeriod()
     if (NULL == curTxFrame)
         error("Frame under transmission cannot be found");
 
+    finishFrameTransmission();
+    lastTxFinishTime = simTime();
+    getNextFrameFromQueue();
+
+    if (pauseUnitsRequested > 0)
+    {
+        // if we received a PAUSE frame recently, go into PAUSE state
+        EV << "Going to PAUSE mode for " << pauseUnitsRequested << " time units\n";
+
+        scheduleEndPausePeriod(pauseUnitsRequested);
+        pauseUnitsRequested = 0;
+    }
+    else
+    {
+        EV << "Start IFG period\n";
+        scheduleEndIFGPeriod();
+    }
+}
+
+void EtherMACFullDuplex::finishFrameTransmission()
+{
     emit(packetSentToLowerSignal, curTxFrame);  //consider: emit with start time of frame
 
     if (dynamic_cast<EtherPauseFrame*>(curTxFrame) != NULL)
@@ -285,22 +340,6 @@ void EtherMACFullDuplex::handleEndTxPeriod()
     EV << "Transmission of " << curTxFrame << " successfully completed\n";
     delete curTxFrame;
     curTxFrame = NULL;
-    lastTxFinishTime = simTime();
-    getNextFrameFromQueue();
-
-    if (pauseUnitsRequested > 0)
-    {
-        // if we received a PAUSE frame recently, go into PAUSE state
-        EV << "Going to PAUSE mode for " << pauseUnitsRequested << " time units\n";
-
-        scheduleEndPausePeriod(pauseUnitsRequested);
-        pauseUnitsRequested = 0;
-    }
-    else
-    {
-        EV << "Start IFG period\n";
-        scheduleEndIFGPeriod();
-    }
 }
 
 void EtherMACFullDuplex::finish()
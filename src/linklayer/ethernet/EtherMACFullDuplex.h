@@ -50,6 +50,7 @@ class INET_API EtherMACFullDuplex : public EtherMACBase
 
     // helpers
     virtual void startFrameTransmission();
+    virtual void finishFrameTransmission();
     virtual void processFrameFromUpperLayer(EtherFrame *frame);
     virtual void processMsgFromNetwork(EtherTraffic *msg);
     virtual void processReceivedDataFrame(EtherFrame *frame);
@@ -59,6 +60,12 @@ class INET_API EtherMACFullDuplex : public EtherMACBase
     virtual void beginSendFrames();
 
 
+    // configuration
+    int txBatchSize;    // max number of back-to-back frames with one event per frame, see NED
+
+    // state
+    int numBatchFrames; // number of frames sent so far in the current batch
+
     // statistics
     simtime_t totalSuccessfulRxTime; // total duration of successful transmissions on channel
 };
@@ -66,8 +66,8 @@ class INET_API IMACAddressTable
     virtual void removeAgedEntriesFromAllVlans() = 0;
 
     /*
-     * It calls removeAgedEntriesFromAllVlans() if and only if at least
-     * 1 second has passed since the method was last called.
+     * Removes the entries that have aged since the last call. It is called
+     * while relaying frames, so it should be cheap when nothing is due.
      */
     virtual void removeAgedEntriesIfNeeded() = 0;
 
@@ -14,11 +14,14 @@
 // along with this program.  If not, see http://www.gnu.org/licenses/.
 // 
 
-#include <map>
+#include <math.h>
+
 #include "MACAddressTable.h"
 
 #define MAX_LINE 100
 
+#define AGING_WHEEL_SIZE    256     // number of aging wheel buckets, one per second
+
 Define_Module(MACAddressTable);
 
 std::ostream& operator<<(std::ostream& os, const MACAddressTable::AddressEntry& entry)
@@ -27,25 +30,37 @@ std::ostream& operator<<(std::ostream& os, const MACAddressTable::AddressEntry&
     return os;
 }
 
+std::ostream& operator<<(std::ostream& os, const MACAddressTable::AddressTable& table)
+{
+    os << table.size() << " entries:";
+    for (MACAddressTable::AddressTable::const_iterator it = table.begin(); it != table.end(); ++it)
+        os << " " << it->first.address << "=" << it->second.entry;
+    return os;
+}
+
 MACAddressTable::MACAddressTable()
 {
-    addressTable = new AddressTable();
-    // Set addressTable for VLAN ID 0
-    vlanAddressTable[0] = addressTable;
+    maxEntries = 0;
+    lastGeneration = 0;
+    agingWheel.resize(AGING_WHEEL_SIZE);
+    lastAgedTick = -1;
+    numEvictions = 0;
 }
 
 void MACAddressTable::initialize()
 {
     agingTime = par("agingTime");
-    lastPurge = SIMTIME_ZERO;
+    maxEntries = par("addressTableSize");
+    if (maxEntries < 0)
+        error("addressTableSize must not be negative");
 
     // Option to pre-read in Address Table. To turn it off, set addressTableFile to empty string
     const char * addressTableFile = par("addressTableFile");
     if (addressTableFile && *addressTableFile)
         readAddressTable(addressTableFile);
 
-    AddressTable& addressTable = *this->addressTable; // magic to hide the '*' from the name of the watch below
-    WATCH_MAP(addressTable);
+    WATCH(addressTable);
+    WATCH(numEvictions);
 }
 
 /**
@@ -79,22 +94,121 @@ void MACAddressTable::handleMessage(cMessage *)
     throw cRuntimeError("This module doesn't process messages");
 }
 
+void MACAddressTable::finish()
+{
+    recordScalar("evicted entries", numEvictions);
+}
+
+void MACAddressTable::insertEntry(const MACAddress& address, const AddressEntry& entry)
+{
+    AddressKey key(entry.vid, address);
+    AddressRecord& record = addressTable.insert(std::make_pair(key, AddressRecord())).first->second;
+    record.entry = entry;
+    if (++lastGeneration == 0)
+        ++lastGeneration;
+    record.generation = lastGeneration;
+    addToAgingWheel(key, record);
+}
+
+int64 MACAddressTable::getAgingTick(simtime_t t)
+{
+    return (int64)floor(t.dbl());
+}
+
+void MACAddressTable::addToAgingWheel(const AddressKey& key, const AddressRecord& record)
+{
+    // entries that have already aged go to the next bucket to be processed
+    int64 tick = std::max(getAgingTick(record.entry.insertionTime + agingTime), lastAgedTick + 1);
+    agingWheel[tick % AGING_WHEEL_SIZE].push_back(AgingRef(key, record.generation));
+}
+
+void MACAddressTable::rebuildAgingWheel()
+{
+    for (std::vector<AgingBucket>::iterator it = agingWheel.begin(); it != agingWheel.end(); ++it)
+        it->clear();
+    for (AddressTable::iterator it = addressTable.begin(); it != addressTable.end(); ++it)
+        addToAgingWheel(it->first, it->second);
+}
+
 /*
- * getTableForVid
- * Returns a MAC Address Table for a specified VLAN ID
- * or NULL pointer if it is not found
+ * Processes the buckets of the seconds elapsed since the last call. A second is
+ * only processed once it is over, so every entry still expiring in it has aged.
  */
+void MACAddressTable::advanceAgingWheel()
+{
+    int64 lastTick = getAgingTick(simTime()) - 1;
+    if (lastTick <= lastAgedTick)
+        return;
 
-MACAddressTable::AddressTable * MACAddressTable::getTableForVid(unsigned int vid)
+    int64 firstTick = std::max(lastAgedTick + 1, lastTick - AGING_WHEEL_SIZE + 1);
+    lastAgedTick = lastTick;
+    for (int64 tick = firstTick; tick <= lastTick; tick++)
+    {
+        AgingBucket bucket;
+        bucket.swap(agingWheel[tick % AGING_WHEEL_SIZE]);
+        for (AgingBucket::iterator it = bucket.begin(); it != bucket.end(); ++it)
+        {
+            AddressTable::iterator entryIt = addressTable.find(it->key);
+            if (entryIt == addressTable.end() || entryIt->second.generation != it->generation)
+                continue;   // stale reference
+            const AddressEntry& entry = entryIt->second.entry;
+            if (entry.insertionTime + agingTime <= simTime())
+            {
+                EV<< "Removing aged entry from Address Table: " <<
+                it->key.address << " --> port" << entry.portno << "\n";
+                addressTable.erase(entryIt);
+            }
+            else
+                addToAgingWheel(entryIt->first, entryIt->second);  // refreshed since
+        }
+    }
+}
+
+void MACAddressTable::evictOldestEntry()
 {
-    if (vid == 0)
-        return addressTable;
-
-    MACAddressTable::VlanAddressTable::iterator iter;
-    iter = vlanAddressTable.find(vid);
-    if (iter != vlanAddressTable.end())
-        return iter->second;
-    return NULL;
+    // the wheel is ordered by expiry time; skip the entries refreshed since they were bucketed
+    int64 fallbackTick = -1;
+    for (int64 tick = lastAgedTick + 1; tick <= lastAgedTick + AGING_WHEEL_SIZE; tick++)
+    {
+        AgingBucket& bucket = agingWheel[tick % AGING_WHEEL_SIZE];
+        for (unsigned int i = 0; i < bucket.size(); )
+        {
+            AddressTable::iterator it = addressTable.find(bucket[i].key);
+            if (it == addressTable.end() || it->second.generation != bucket[i].generation)
+            {
+                // drop stale reference
+                bucket[i] = bucket.back();
+                bucket.pop_back();
+                continue;
+            }
+            if (getAgingTick(it->second.entry.insertionTime + agingTime) <= tick)
+            {
+                EV << "Address Table full, evicting entry: " << it->first.address << " --> port" << it->second.entry.portno << "\n";
+                bucket[i] = bucket.back();
+                bucket.pop_back();
+                addressTable.erase(it);
+                numEvictions++;
+                return;
+            }
+            if (fallbackTick < 0)
+                fallbackTick = tick;
+            i++;
+        }
+    }
+
+    // all entries expire beyond the range of the wheel: evict one of the earliest bucketed ones
+    if (fallbackTick >= 0)
+    {
+        AgingBucket& bucket = agingWheel[fallbackTick % AGING_WHEEL_SIZE];
+        AddressTable::iterator it = addressTable.find(bucket.back().key);
+        if (it != addressTable.end() && it->second.generation == bucket.back().generation)
+        {
+            EV << "Address Table full, evicting entry: " << it->first.address << " --> port" << it->second.entry.portno << "\n";
+            addressTable.erase(it);
+            numEvictions++;
+        }
+        bucket.pop_back();
+    }
 }
 
 /*
@@ -107,26 +221,21 @@ int MACAddressTable::getPortForAddress(MACAddress& address, unsigned int vid)
 {
     Enter_Method("MACAddressTable::getPortForAddress()");
 
-    AddressTable * table = getTableForVid(vid);
-    // VLAN ID vid does not exist
-    if (table == NULL)
-        return -1;
-
-    AddressTable::iterator iter = table->find(address);
-
-    if (iter == table->end())
+    AddressTable::iterator it = addressTable.find(AddressKey(vid, address));
+    if (it == addressTable.end())
     {
         // not found
         return -1;
     }
-    if (iter->second.insertionTime + agingTime <= simTime())
+    const AddressEntry& entry = it->second.entry;
+    if (entry.insertionTime + agingTime <= simTime())
     {
         // don't use (and throw out) aged entries
-        EV<< "Ignoring and deleting aged entry: "<< iter->first << " --> port" << iter->second.portno << "\n";
-        table->erase(iter);
+        EV<< "Ignoring and deleting aged entry: "<< address << " --> port" << entry.portno << "\n";
+        addressTable.erase(it);
         return -1;
     }
-    return iter->second.portno;
+    return entry.portno;
 }
 
 /*
@@ -140,38 +249,24 @@ bool MACAddressTable::updateTableWithAddress(int portno, MACAddress& address, un
     if (address.isBroadcast())
         return false;
 
-    AddressTable::iterator iter;
-    AddressTable * table = getTableForVid(vid);
+    removeAgedEntriesIfNeeded();
 
-    if (table == NULL)
+    AddressTable::iterator it = addressTable.find(AddressKey(vid, address));
+    if (it == addressTable.end())
     {
-        // MAC Address Table does not exist for VLAN ID vid, so we create it
-        table = new AddressTable();
-
-        // set 'the addressTable' to VLAN ID 0
-        if (vid == 0)
-            addressTable = table;
-
-        vlanAddressTable[vid] = table;
-        iter = table->end();
-    }
-    else
-        iter = table->find(address);
-
-    if (iter == table->end())
-    {
-        removeAgedEntriesIfNeeded();
+        if (maxEntries > 0 && (int)addressTable.size() >= maxEntries)
+            evictOldestEntry();
 
         // Add entry to table
         EV<< "Adding entry to Address Table: "<< address << " --> port" << portno << "\n";
-        (*table)[address] = AddressEntry(vid,portno,simTime());
+        insertEntry(address, AddressEntry(vid, portno, simTime()));
         return false;
     }
     else
     {
-        // Update existing entry
+        // Update existing entry; its aging wheel reference is moved lazily
         EV << "Updating entry in Address Table: "<< address << " --> port" << portno << "\n";
-        AddressEntry& entry = iter->second;
+        AddressEntry& entry = it->second.entry;
         entry.insertionTime = simTime();
         entry.portno = portno;
     }
@@ -185,16 +280,12 @@ bool MACAddressTable::updateTableWithAddress(int portno, MACAddress& address, un
 void MACAddressTable::flush(int portno)
 {
     Enter_Method("MACAddressTable::flush():  Clearing gate %d cache", portno);
-    for (VlanAddressTable::iterator i = vlanAddressTable.begin(); i != vlanAddressTable.end(); i++)
+    for (AddressTable::iterator it = addressTable.begin(); it != addressTable.end(); )
     {
-        AddressTable * table = i->second;
-        for (AddressTable::iterator j = table->begin(); j != table->end();)
-        {
-            AddressTable::iterator cur = j++;
-            if (cur->second.portno == portno)
-                table->erase(cur);
-        }
-
+        if (it->second.entry.portno == portno)
+            it = addressTable.erase(it);
+        else
+            ++it;
     }
 }
 /*
@@ -205,73 +296,50 @@ void MACAddressTable::printState()
 {
     EV<< endl << "MAC Address Table" << endl;
     EV << "VLAN ID    MAC    Port    Inserted" << endl;
-    for (VlanAddressTable::iterator i = vlanAddressTable.begin(); i != vlanAddressTable.end(); i++)
-    {
-        AddressTable * table = i->second;
-        for (AddressTable::iterator j = table->begin(); j != table->end(); j++)
-        EV << j->second.vid << "   " << j->first << "   " << j->second.portno << "   " << j->second.insertionTime << endl;
-    }
-
+    for (AddressTable::iterator j = addressTable.begin(); j != addressTable.end(); j++)
+        EV << j->second.entry.vid << "   " << j->first.address << "   " << j->second.entry.portno << "   " << j->second.entry.insertionTime << endl;
 }
 
 void MACAddressTable::copyTable(int portA, int portB)
 {
-    for (VlanAddressTable::iterator i = vlanAddressTable.begin(); i != vlanAddressTable.end(); i++)
-    {
-        AddressTable * table = i->second;
-        for (AddressTable::iterator j = table->begin(); j != table->end(); j++)
-            if (j->second.portno == portA)
-                j->second.portno = portB;
-    }
+    for (AddressTable::iterator j = addressTable.begin(); j != addressTable.end(); j++)
+        if (j->second.entry.portno == portA)
+            j->second.entry.portno = portB;
 }
 
 void MACAddressTable::removeAgedEntriesFromVlan(unsigned int vid)
 {
-    AddressTable * table = getTableForVid(vid);
-    if (table == NULL)
-        return;
-    // TODO: this part could be factored out
-    for (AddressTable::iterator iter = table->begin(); iter != table->end();)
+    for (AddressTable::iterator it = addressTable.begin(); it != addressTable.end(); )
     {
-        AddressTable::iterator cur = iter++; // iter will get invalidated after erase()
-        AddressEntry& entry = cur->second;
-        if (entry.insertionTime + agingTime <= simTime())
+        if (it->second.entry.vid == vid && it->second.entry.insertionTime + agingTime <= simTime())
         {
             EV<< "Removing aged entry from Address Table: " <<
-            cur->first << " --> port" << cur->second.portno << "\n";
-            table->erase(cur);
+            it->first.address << " --> port" << it->second.entry.portno << "\n";
+            it = addressTable.erase(it);
         }
+        else
+            ++it;
     }
 }
 
 void MACAddressTable::removeAgedEntriesFromAllVlans()
 {
-    for (VlanAddressTable::iterator i = vlanAddressTable.begin(); i != vlanAddressTable.end(); i++)
+    for (AddressTable::iterator it = addressTable.begin(); it != addressTable.end(); )
     {
-        AddressTable * table = i->second;
-        // TODO: this part could be factored out
-        for (AddressTable::iterator j = table->begin(); j != table->end();)
+        if (it->second.entry.insertionTime + agingTime <= simTime())
         {
-            AddressTable::iterator cur = j++; // iter will get invalidated after erase()
-            AddressEntry& entry = cur->second;
-            if (entry.insertionTime + agingTime <= simTime())
-            {
-                EV<< "Removing aged entry from Address Table: " <<
-                cur->first << " --> port" << cur->second.portno << "\n";
-                table->erase(cur);
-            }
+            EV<< "Removing aged entry from Address Table: " <<
+            it->first.address << " --> port" << it->second.entry.portno << "\n";
+            it = addressTable.erase(it);
         }
+        else
+            ++it;
     }
 }
 
 void MACAddressTable::removeAgedEntriesIfNeeded()
 {
-    simtime_t now = simTime();
-
-    if(now >= lastPurge + 1)
-        removeAgedEntriesFromAllVlans();
-
-    lastPurge = simTime();
+    advanceAgingWheel();
 }
 
 void MACAddressTable::readAddressTable(const char* fileName)
@@ -317,15 +385,13 @@ void MACAddressTable::readAddressTable(const char* fileName)
 
         // Create an entry with address and portno and insert into table
         AddressEntry entry(atoi(vlanID), atoi(portno), 0);
-        AddressTable * table = getTableForVid(entry.vid);
-
-        if(table == NULL)
-        {
-            table = new AddressTable();
-            vlanAddressTable[entry.vid] = table;
-        }
-
-        (*table)[MACAddress(hexaddress)] = entry;
+        MACAddress address(hexaddress);
+        AddressTable::iterator it = addressTable.find(AddressKey(entry.vid, address));
+        if (it != addressTable.end())
+            addressTable.erase(it);
+        else if (maxEntries > 0 && (int)addressTable.size() >= maxEntries)
+            evictOldestEntry();
+        insertEntry(address, entry);
 
         // Garbage collection before next iteration
         delete [] line;
@@ -335,24 +401,23 @@ void MACAddressTable::readAddressTable(const char* fileName)
 
 void MACAddressTable::clearTable()
 {
-    for (VlanAddressTable::iterator iter = vlanAddressTable.begin(); iter != vlanAddressTable.end(); iter++)
-        delete iter->second;
-
-    vlanAddressTable.clear();
-    addressTable = NULL;
+    addressTable.clear();
+    for (std::vector<AgingBucket>::iterator it = agingWheel.begin(); it != agingWheel.end(); ++it)
+        it->clear();
 }
 
 MACAddressTable::~MACAddressTable()
 {
-    for (VlanAddressTable::iterator iter = vlanAddressTable.begin(); iter != vlanAddressTable.end(); iter++)
-        delete iter->second;
 }
+
 void MACAddressTable::setAgingTime(simtime_t agingTime)
 {
     this->agingTime = agingTime;
+    rebuildAgingWheel();
 }
 
 void MACAddressTable::resetDefaultAging()
 {
     agingTime = par("agingTime");
+    rebuildAgingWheel();
 }
@@ -17,11 +17,21 @@
 #ifndef __INET_MACADDRESSTABLE_H_
 #define __INET_MACADDRESSTABLE_H_
 
+#include <vector>
+
 #include "MACAddress.h"
+#include "OpenHashMap.h"
 #include "IMACAddressTable.h"
 
 /**
  * This module handles the mapping between ports and MAC addresses. See the NED definition for details.
+ *
+ * Entries of all VLANs are stored in a single hash table keyed on
+ * (VLAN ID, MAC address). Aging is driven by a timer wheel
+ * with one bucket per second: an entry is referenced from the bucket of the
+ * second in which it expires, so purging only visits the entries that are due.
+ * Refreshing an entry does not touch the wheel; the stale reference is moved
+ * forward when its bucket is processed.
  */
 class MACAddressTable : public cSimpleModule, public IMACAddressTable
 {
@@ -37,29 +47,71 @@ class MACAddressTable : public cSimpleModule, public IMACAddressTable
         };
         friend std::ostream& operator<<(std::ostream& os, const AddressEntry& entry);
 
-        struct MAC_compare
+        struct AddressKey
         {
-            bool operator()(const MACAddress& u1, const MACAddress& u2) const {return u1.compareTo(u2) < 0;}
+                unsigned int vid;
+                MACAddress address;
+                AddressKey() : vid(0) { }
+                AddressKey(unsigned int vid, const MACAddress& address) : vid(vid), address(address) { }
+                bool operator==(const AddressKey& other) const { return vid == other.vid && address == other.address; }
         };
 
+        struct AddressKeyHash
+        {
+                size_t operator()(const AddressKey& key) const { return hashCombine(hashUInt64(key.address.getInt()), key.vid); }
+        };
 
-        typedef std::map<MACAddress, AddressEntry, MAC_compare> AddressTable;
-        typedef std::map<unsigned int, AddressTable*> VlanAddressTable;
+        struct AddressRecord
+        {
+                AddressEntry entry;
+                unsigned int generation;    // identifies the entry in the aging wheel
+                AddressRecord() : generation(0) { }
+        };
+
+        typedef OpenHashMap<AddressKey, AddressRecord, AddressKeyHash> AddressTable;
+        friend std::ostream& operator<<(std::ostream& os, const AddressTable& table);
+
+        // Reference from an aging wheel bucket to an entry; it is stale if the
+        // entry has been removed (or removed and added again) since
+        struct AgingRef
+        {
+                AddressKey key;
+                unsigned int generation;
+                AgingRef(const AddressKey& key, unsigned int generation) : key(key), generation(generation) { }
+        };
+        typedef std::vector<AgingRef> AgingBucket;
 
         simtime_t agingTime;                // Max idle time for address table entries
-        simtime_t lastPurge;                // Time of the last call of removeAgedEntriesFromAllVlans()
-        AddressTable * addressTable;        // VLAN-unaware address lookup (vid = 0)
-        VlanAddressTable vlanAddressTable;  // VLAN-aware address lookup
+        int maxEntries;                     // Capacity of the table, 0 for unlimited
+        AddressTable addressTable;          // Entries of all VLANs
+        unsigned int lastGeneration;        // Generation of the most recently added entry
+        std::vector<AgingBucket> agingWheel; // Bucket (t mod size) refers to the entries expiring in second t
+        int64 lastAgedTick;                 // Last second whose bucket has been processed
+        long numEvictions;                  // Entries removed because the table was full
 
     protected:
 
         virtual void initialize();
         virtual void handleMessage(cMessage *msg);
+        virtual void finish();
+
+        /**
+         * Adds a new entry; the table must not contain (entry.vid, address) yet.
+         */
+        void insertEntry(const MACAddress& address, const AddressEntry& entry);
+
+        /** @name Aging wheel */
+        //@{
+        static int64 getAgingTick(simtime_t t);
+        void addToAgingWheel(const AddressKey& key, const AddressRecord& record);
+        void rebuildAgingWheel();
+        void advanceAgingWheel();
+        //@}
 
         /**
-         * @brief Returns a MAC Address Table for a specified VLAN ID
+         * @brief Removes the entry expiring first (up to the wheel resolution) to make room for a new one
          */
-        AddressTable * getTableForVid(unsigned int vid);
+        void evictOldestEntry();
 
     public:
 
@@ -109,8 +161,8 @@ class MACAddressTable : public cSimpleModule, public IMACAddressTable
         virtual void removeAgedEntriesFromAllVlans();
 
         /*
-         * It calls removeAgedEntriesFromAllVlans() if and only if at least
-         * 1 second has passed since the method was last called.
+         * Removes the entries whose aging second has elapsed since the last
+         * call; the cost is proportional to the number of entries due.
          */
         virtual void removeAgedEntriesIfNeeded();
 
@@ -120,7 +172,7 @@ class MACAddressTable : public cSimpleModule, public IMACAddressTable
         virtual void readAddressTable(const char * fileName);
 
         /**
-         * For lifecycle: clears all entries from the vlanAddressTable.
+         * For lifecycle: clears all entries from the address table.
          */
         virtual void clearTable();
 
@@ -0,0 +1,91 @@
+//
+// Copyright (C) 2026 OpenSim Ltd
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program; if not, see <http://www.gnu.org/licenses/>.
+//
+
+#include "Ieee80211AggregateFrame.h"
+
+
+Register_Class(Ieee80211AggregateFrame);
+
+Ieee80211AggregateFrame::~Ieee80211AggregateFrame()
+{
+    clean();
+}
+
+Ieee80211AggregateFrame& Ieee80211AggregateFrame::operator=(const Ieee80211AggregateFrame& other)
+{
+    if (this == &other)
+        return *this;
+    clean();
+    Ieee80211AggregateFrame_Base::operator=(other);
+    copy(other);
+    return *this;
+}
+
+void Ieee80211AggregateFrame::copy(const Ieee80211AggregateFrame& other)
+{
+    // the length and the bitmap have been copied by the base class
+    for (std::vector<Ieee80211DataFrame *>::const_iterator it = other.subframes.begin(); it != other.subframes.end(); ++it)
+    {
+        Ieee80211DataFrame *frame = (*it)->dup();
+        take(frame);
+        subframes.push_back(frame);
+    }
+}
+
+void Ieee80211AggregateFrame::clean()
+{
+    for (std::vector<Ieee80211DataFrame *>::iterator it = subframes.begin(); it != subframes.end(); ++it)
+        dropAndDelete(*it);
+    subframes.clear();
+}
+
+int64 Ieee80211AggregateFrame::getSubframeLength(const Ieee80211DataFrame *frame) const
+{
+    int64 length;
+    if (getAmpdu())
+        length = AMPDU_DELIMITER_BYTES + frame->getByteLength();
+    else
+        length = AMSDU_SUBFRAME_HEADER_BYTES + frame->getByteLength() - LENGTH_DATAHDR / 8;
+    return (length + 3) & ~(int64)3;
+}
+
+void Ieee80211AggregateFrame::addSubframe(Ieee80211DataFrame *frame)
+{
+    if (getAmpdu())
+    {
+        unsigned int offset = (frame->getSequenceNumber() - getSequenceNumber()) & 0xfff;
+        if (offset >= BLOCKACK_WINDOW_SIZE)
+            throw cRuntimeError(this, "addSubframe(): sequence number %d is outside the block ack window starting at %d",
+                    frame->getSequenceNumber(), getSequenceNumber());
+        setSubframeBitmap(getSubframeBitmap() | ((uint64)1 << offset));
+    }
+    addByteLength(getSubframeLength(frame));
+    take(frame);
+    subframes.push_back(frame);
+}
+
+Ieee80211DataFrame *Ieee80211AggregateFrame::removeSubframe()
+{
+    if (subframes.empty())
+        return NULL;
+
+    Ieee80211DataFrame *frame = subframes.front();
+    subframes.erase(subframes.begin());
+    drop(frame);
+    return frame;
+}
+
@@ -0,0 +1,77 @@
+//
+// Copyright (C) 2026 OpenSim Ltd
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program; if not, see <http://www.gnu.org/licenses/>.
+//
+
+#ifndef __IEEE80211AGGREGATEFRAME_H
+#define __IEEE80211AGGREGATEFRAME_H
+
+#include <vector>
+
+#include "INETDefs.h"
+
+#include "Ieee80211Frame_m.h"
+
+
+/**
+ * Represents an A-MSDU or A-MPDU. More info in the Ieee80211Frame.msg file
+ * (and the documentation generated from it).
+ *
+ * The aggregate owns its subframes. The sender sets the header fields
+ * (in particular the sequence number), then adds the subframes with
+ * addSubframe(), which updates the frame length and, for an A-MPDU,
+ * the subframe bitmap. The receiver takes them out with removeSubframe();
+ * that leaves the length and the bitmap unchanged, so the emptied aggregate
+ * can still be answered with a block ack.
+ */
+class INET_API Ieee80211AggregateFrame : public Ieee80211AggregateFrame_Base
+{
+  protected:
+    std::vector<Ieee80211DataFrame *> subframes;
+
+  private:
+    void copy(const Ieee80211AggregateFrame& other);
+    void clean();
+
+  public:
+    Ieee80211AggregateFrame(const char *name = NULL, int kind = 0) : Ieee80211AggregateFrame_Base(name, kind) {}
+    Ieee80211AggregateFrame(const Ieee80211AggregateFrame& other) : Ieee80211AggregateFrame_Base(other) { copy(other); }
+    virtual ~Ieee80211AggregateFrame();
+    Ieee80211AggregateFrame& operator=(const Ieee80211AggregateFrame& other);
+    virtual Ieee80211AggregateFrame *dup() const { return new Ieee80211AggregateFrame(*this); }
+
+    /**
+     * Returns the number of bytes the given frame would add to the
+     * aggregate: subframe header or delimiter, frame body and padding.
+     */
+    virtual int64 getSubframeLength(const Ieee80211DataFrame *frame) const;
+
+    /**
+     * Appends the frame to the aggregate, taking its ownership.
+     */
+    virtual void addSubframe(Ieee80211DataFrame *frame);
+
+    virtual unsigned int getNumSubframes() const { return subframes.size(); }
+    virtual Ieee80211DataFrame *getSubframe(unsigned int k) const { return subframes.at(k); }
+
+    /**
+     * Removes and returns the first subframe, or returns NULL if the
+     * aggregate is empty.
+     */
+    virtual Ieee80211DataFrame *removeSubframe();
+};
+
+#endif
+
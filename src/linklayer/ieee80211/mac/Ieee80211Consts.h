@@ -24,9 +24,15 @@ const unsigned int LENGTH_CTS = 112; //bits
 const unsigned int LENGTH_ACK = 112; //bits
 const unsigned int LENGTH_MGMT = 28 * 8; //bits
 const unsigned int LENGTH_DATAHDR = 34 * 8; //bits
+const unsigned int LENGTH_BLOCKACK = 32 * 8; //bits (compressed bitmap)
 
 const unsigned int SNAP_HEADER_BYTES = 8;
 
+// frame aggregation (802.11n)
+const unsigned int AMSDU_SUBFRAME_HEADER_BYTES = 14; // DA, SA, length
+const unsigned int AMPDU_DELIMITER_BYTES = 4;
+const unsigned int BLOCKACK_WINDOW_SIZE = 64; // bits in the compressed bitmap
+
 // time slot ST, short interframe space SIFS, distributed interframe
 // space DIFS, and extended interframe space EIFS
 
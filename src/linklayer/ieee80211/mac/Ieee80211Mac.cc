@@ -17,6 +17,8 @@
 // along with this program; if not, see <http://www.gnu.org/licenses/>.
 //
 
+#include <algorithm>
+
 #include "Ieee80211Mac.h"
 #include "RadioState.h"
 #include "IInterfaceTable.h"
@@ -66,6 +68,7 @@ Ieee80211Mac::Ieee80211Mac()
     mediumStateChange = NULL;
     pendingRadioConfigMsg = NULL;
     classifier = NULL;
+    minstrel = NULL;
 }
 
 Ieee80211Mac::~Ieee80211Mac()
@@ -97,6 +100,7 @@ Ieee80211Mac::~Ieee80211Mac()
     edcCAFOutVector.clear();
     if (pendingRadioConfigMsg)
         delete pendingRadioConfigMsg;
+    delete minstrel;
 }
 
 /****************************************************************
@@ -155,6 +159,21 @@ void Ieee80211Mac::initialize(int stage)
         maxQueueSize = par("maxQueueSize");
         rtsThreshold = par("rtsThresholdBytes");
 
+        const char *aggregationStr = par("aggregation").stringValue();
+        if (strcmp("none", aggregationStr)==0)
+            aggregation = AGGREGATION_NONE;
+        else if (strcmp("amsdu", aggregationStr)==0)
+            aggregation = AGGREGATION_AMSDU;
+        else if (strcmp("ampdu", aggregationStr)==0)
+            aggregation = AGGREGATION_AMPDU;
+        else
+            throw cRuntimeError("Invalid aggregation='%s'", aggregationStr);
+        maxAggregatedFrames = par("maxAggregatedFrames");
+        maxAggregateSize = par("maxAggregateSize");
+        if (aggregation == AGGREGATION_AMPDU && maxAggregatedFrames > (int)BLOCKACK_WINDOW_SIZE)
+            throw cRuntimeError("Invalid maxAggregatedFrames=%d, an A-MPDU can carry at most %d frames", maxAggregatedFrames, BLOCKACK_WINDOW_SIZE);
+        aggregateDuration = 0;
+
         // the variable is renamed due to a confusion in the standard
         // the name retry limit would be misleading, see the header file comment
         transmissionLimit = par("retryLimit");
@@ -226,7 +245,6 @@ void Ieee80211Mac::initialize(int stage)
         duplicateDetect = par("duplicateDetectionFilter");
         purgeOldTuples = par("purgeOldTuples");
         duplicateTimeOut = par("duplicateTimeOut");
-        lastTimeDelete = 0;
 
         if (bitrate == -1)
         {
@@ -348,6 +366,10 @@ void Ieee80211Mac::initialize(int stage)
         numSentTXOP = 0;
         numReceivedOther = 0;
         numAckSend = 0;
+        numSentAggregates = 0;
+        numSentInAggregates = 0;
+        numReceivedAggregates = 0;
+        numBlockAckSend = 0;
         successCounter = 0;
         failedCounter = 0;
         recovery = 0;
@@ -424,6 +446,8 @@ void Ieee80211Mac::initWatches()
          WATCH(edcCAF[i].numDropped);
      if (throughputTimer)
          WATCH(throughputLastPeriod);
+     WATCH(numSentAggregates);
+     WATCH(numReceivedAggregates);
 }
 
 void Ieee80211Mac::configureAutoBitRate()
@@ -451,6 +475,16 @@ void Ieee80211Mac::configureAutoBitRate()
         maxSuccessThreshold = par("maxSuccessThreshold");
         EV<<"MAC Transmission algorithm : AARF Rate"  <<endl;
         break;
+    case 3:
+    {
+        rateControlMode = RATE_MINSTREL;
+        // interframe spaces, average backoff and ACK of one attempt
+        simtime_t attemptOverhead = getDIFS() + getSlotTime() * cwMinData / 2 + getSIFS() + controlFrameTxTime(LENGTH_ACK);
+        minstrel = new Ieee80211MinstrelRateControl(opMode, wifiPreambleType, par("minstrelFrameLength"), attemptOverhead,
+                par("minstrelUpdateInterval").doubleValue(), par("minstrelEwmaLevel"), par("minstrelLookaroundRatio"));
+        EV<<"MAC Transmission algorithm : Minstrel"  <<endl;
+        break;
+    }
     default:
         throw cRuntimeError("Invalid autoBitrate parameter: '%d'", autoBitrate);
         break;
@@ -499,6 +533,15 @@ void Ieee80211Mac::finish()
         std::string th = "numDropped AC "+os.str();
         recordScalar(th.c_str(), numDropped(i));
     }
+    if (aggregation != AGGREGATION_NONE || numReceivedAggregates > 0)
+    {
+        recordScalar("sent aggregates", numSentAggregates);
+        recordScalar("frames sent in aggregates", numSentInAggregates);
+        recordScalar("received aggregates", numReceivedAggregates);
+        recordScalar("sent block acks", numBlockAckSend);
+    }
+    if (minstrel)
+        minstrel->recordScalars(this);
 }
 
 InterfaceEntry *Ieee80211Mac::createInterfaceEntry()
@@ -535,6 +578,12 @@ void Ieee80211Mac::initializeQueueModule()
         queueModule->requestPacket();
         // needed for backoff: mandatory if next message is already present
         queueModule->requestPacket();
+
+        // with a single queue, the MAC asks for one frame per frame sent,
+        // so keep enough frames here to fill an aggregate
+        if (aggregation != AGGREGATION_NONE && numCategories() == 1)
+            for (int i = 2; i < maxAggregatedFrames; i++)
+                queueModule->requestPacket();
     }
 }
 
@@ -1172,6 +1221,14 @@ void Ieee80211Mac::handleWithFSM(cMessage *msg)
                                   if (endTXOP->isScheduled()) cancelEvent(endTXOP);
                                  );
 #endif
+            // aggregates are not sent within a TXOP burst, see sendDataFrame()
+            FSMA_Event_Transition(Receive-ACK-Aggregate,
+                                  isLowerMsg(msg) && isForUs(frame) && (frameType == ST_ACK || frameType == ST_BLOCKACK) && !aggregatedFrames.empty(),
+                                  DEFER,
+                                  currentAC = oldcurrentAC;
+                                  cancelTimeoutPeriod();
+                                  finishAggregateTransmission(dynamic_cast<Ieee80211BlockAckFrame *>(frame));
+                                  );
             FSMA_Event_Transition(Receive-ACK-TXOP-Empty,
                                   isLowerMsg(msg) && isForUs(frame) && frameType == ST_ACK && txop && transmissionQueue(oldcurrentAC)->size() == 1,
                                   DEFER,
@@ -1652,18 +1709,20 @@ void Ieee80211Mac::scheduleDataTimeoutPeriod(Ieee80211DataOrMgmtFrame *frameToSe
     if (!endTimeout->isScheduled())
     {
         EV << "scheduling data timeout period\n";
+        // an aggregate carries more than frameToSend, and an A-MPDU is answered with a block ack
+        double duration = aggregatedFrames.empty() ? computeFrameDuration(frameToSend) : aggregateDuration;
+        int responseBits = (!aggregatedFrames.empty() && aggregation == AGGREGATION_AMPDU) ? LENGTH_BLOCKACK : LENGTH_ACK;
         if (useModulationParameters)
         {
             ModulationType modType;
             modType = WifiModulationType::getModulationType(opMode, bitRate);
-            double duration = computeFrameDuration(frameToSend);
             double slot = SIMTIME_DBL(WifiModulationType::getSlotDuration(modType,wifiPreambleType));
             double sifs =  SIMTIME_DBL(WifiModulationType::getSifsTime(modType,wifiPreambleType));
             double PHY_RX_START = SIMTIME_DBL(WifiModulationType::get_aPHY_RX_START_Delay (modType,wifiPreambleType));
             tim = duration + slot + sifs + PHY_RX_START;
         }
         else
-            tim = computeFrameDuration(frameToSend) + SIMTIME_DBL( getSlotTime()) +SIMTIME_DBL( getSIFS()) + controlFrameTxTime(LENGTH_ACK) + MAX_PROPAGATION_DELAY * 2;
+            tim = duration + SIMTIME_DBL( getSlotTime()) +SIMTIME_DBL( getSIFS()) + controlFrameTxTime(responseBits) + MAX_PROPAGATION_DELAY * 2;
         EV<<" time out="<<tim*1e6<<"us"<<endl;
         scheduleAt(simTime() + tim, endTimeout);
     }
@@ -1783,7 +1842,11 @@ void Ieee80211Mac::sendACKFrameOnEndSIFS()
 {
     Ieee80211Frame *frameToACK = (Ieee80211Frame *)endSIFS->getContextPointer();
     endSIFS->setContextPointer(NULL);
-    sendACKFrame(check_and_cast<Ieee80211DataOrMgmtFrame*>(frameToACK));
+    Ieee80211AggregateFrame *aggregate = dynamic_cast<Ieee80211AggregateFrame *>(frameToACK);
+    if (aggregate && aggregate->getAmpdu())
+        sendBlockAckFrame(aggregate);
+    else
+        sendACKFrame(check_and_cast<Ieee80211DataOrMgmtFrame*>(frameToACK));
     delete frameToACK;
 }
 
@@ -1794,6 +1857,13 @@ void Ieee80211Mac::sendACKFrame(Ieee80211DataOrMgmtFrame *frameToACK)
     sendDown(setControlBitrate(buildACKFrame(frameToACK)));
 }
 
+void Ieee80211Mac::sendBlockAckFrame(Ieee80211AggregateFrame *aggregate)
+{
+    EV << "sending BlockAck frame\n";
+    numBlockAckSend++;
+    sendDown(setControlBitrate(buildBlockAckFrame(aggregate)));
+}
+
 void Ieee80211Mac::sendDataFrameOnEndSIFS(Ieee80211DataOrMgmtFrame *frameToSend)
 {
     Ieee80211Frame *ctsFrame = (Ieee80211Frame *)endSIFS->getContextPointer();
@@ -1810,6 +1880,25 @@ void Ieee80211Mac::sendDataFrame(Ieee80211DataOrMgmtFrame *frameToSend)
 
     frame = transmissionQueue()->begin();
     ASSERT(*frame==frameToSend);
+
+    if (rateControlMode == RATE_MINSTREL)
+        setBitrate(minstrel->getTransmissionBitrate(frameToSend->getReceiverAddress(), retryCounter()));
+
+    // an aggregate is sent instead of a TXOP burst, so it is only built outside of bursts
+    aggregatedFrames.clear();
+    if (aggregation != AGGREGATION_NONE && !txop)
+    {
+        Ieee80211AggregateFrame *aggregate = buildAggregateFrame(frameToSend);
+        if (aggregate)
+        {
+            aggregateDuration = computeFrameDuration(aggregate->getBitLength(), getBitrate());
+            numSentAggregates++;
+            EV << "sending aggregate of " << aggregatedFrames.size() << " frames\n";
+            sendDown(setBitrateFrame(aggregate));
+            return;
+        }
+    }
+
     if (!txop && TXOP() > 0 && transmissionQueue()->size() >= 2 )
     {
         //we start packet burst within TXOP time period
@@ -1928,6 +2017,74 @@ Ieee80211ACKFrame *Ieee80211Mac::buildACKFrame(Ieee80211DataOrMgmtFrame *frameTo
     return frame;
 }
 
+Ieee80211BlockAckFrame *Ieee80211Mac::buildBlockAckFrame(Ieee80211AggregateFrame *aggregate)
+{
+    // the whole A-MPDU has been received, so every MPDU in it is acknowledged
+    Ieee80211BlockAckFrame *frame = new Ieee80211BlockAckFrame("wlan-blockack");
+    frame->setReceiverAddress(aggregate->getTransmitterAddress());
+    frame->setTransmitterAddress(address);
+    frame->setStartingSequenceNumber(aggregate->getSequenceNumber());
+    frame->setBitmap(aggregate->getSubframeBitmap());
+    frame->setDuration(0);
+
+    return frame;
+}
+
+Ieee80211AggregateFrame *Ieee80211Mac::buildAggregateFrame(Ieee80211DataOrMgmtFrame *frameToSend)
+{
+    Ieee80211DataFrame *head = dynamic_cast<Ieee80211DataFrame *>(frameToSend);
+    if (!head || isMulticast(head) || head->getMoreFragments())
+        return NULL;
+
+    bool ampdu = (aggregation == AGGREGATION_AMPDU);
+    Ieee80211AggregateFrame *aggregate = new Ieee80211AggregateFrame(ampdu ? "wlan-ampdu" : "wlan-amsdu");
+    aggregate->setAmpdu(ampdu);
+    aggregate->setByteLength(ampdu ? 0 : LENGTH_DATAHDR / 8);
+    aggregate->setToDS(head->getToDS());
+    aggregate->setFromDS(head->getFromDS());
+    aggregate->setRetry(head->getRetry());
+    aggregate->setReceiverAddress(head->getReceiverAddress());
+    aggregate->setTransmitterAddress(head->getTransmitterAddress());
+    aggregate->setAddress3(head->getAddress3());
+    aggregate->setSequenceNumber(head->getSequenceNumber());
+    aggregate->setMACArrive(head->getMACArrive());
+
+    // take the data frames to the same receiver in queue order, starting with
+    // the head of the queue, within the size, block ack window and TXOP limits
+    simtime_t responseTime = getSIFS() + controlFrameTxTime(ampdu ? LENGTH_BLOCKACK : LENGTH_ACK);
+    for (Ieee80211DataOrMgmtFrameList::iterator it = transmissionQueue()->begin();
+         it != transmissionQueue()->end() && (int)aggregatedFrames.size() < maxAggregatedFrames; ++it)
+    {
+        Ieee80211DataFrame *frame = dynamic_cast<Ieee80211DataFrame *>(*it);
+        if (!frame || frame->getReceiverAddress() != head->getReceiverAddress())
+            continue;
+        // keep the order of the frames to the receiver; a retried aggregate
+        // carries only the frames of the failed one (they are at the head of
+        // the queue, see finishAggregateTransmission()), so that they can share
+        // its retry counter
+        if (frame->getMoreFragments() || frame->getRetry() != head->getRetry())
+            break;
+        if (ampdu && ((frame->getSequenceNumber() - head->getSequenceNumber()) & 0xfff) >= BLOCKACK_WINDOW_SIZE)
+            break;
+        int64 length = aggregate->getByteLength() + aggregate->getSubframeLength(frame);
+        if (length > maxAggregateSize)
+            break;
+        if (TXOP() > 0 && computeFrameDuration(length * 8, getBitrate()) + responseTime > TXOP())
+            break;
+        aggregate->addSubframe(frame->dup());
+        aggregatedFrames.push_back(frame);
+    }
+
+    if (aggregatedFrames.size() < 2)
+    {
+        aggregatedFrames.clear();
+        delete aggregate;
+        return NULL;
+    }
+    aggregate->setDuration(responseTime);
+    return aggregate;
+}
+
 Ieee80211RTSFrame *Ieee80211Mac::buildRTSFrame(Ieee80211DataOrMgmtFrame *frameToSend)
 {
     Ieee80211RTSFrame *frame = new Ieee80211RTSFrame("wlan-rts");
@@ -2012,6 +2169,8 @@ Ieee80211Frame *Ieee80211Mac::setBitrateFrame(Ieee80211Frame *frame)
  */
 void Ieee80211Mac::finishCurrentTransmission()
 {
+    if (rateControlMode == RATE_MINSTREL)
+        minstrel->reportTransmissionResult(1, 1);
     popTransmissionQueue();
     resetStateVariables();
 }
@@ -2019,6 +2178,22 @@ void Ieee80211Mac::finishCurrentTransmission()
 void Ieee80211Mac::giveUpCurrentTransmission()
 {
     Ieee80211DataOrMgmtFrame *temp = (Ieee80211DataOrMgmtFrame*) transmissionQueue()->front();
+    if (rateControlMode == RATE_MINSTREL)
+        minstrel->reportTransmissionResult(aggregatedFrames.empty() ? 1 : aggregatedFrames.size(), 0);
+    if (isAggregateInFlight())
+    {
+        // the frames of the aggregate have been sent the same number of times
+        std::vector<Ieee80211DataOrMgmtFrame *> frames;
+        frames.swap(aggregatedFrames);
+        for (unsigned int i = 0; i < frames.size(); i++)
+        {
+            nb->fireChangeNotification(NF_LINK_BREAK, frames[i]);
+            removeFromTransmissionQueue(frames[i]);
+            numGivenUp()++;
+        }
+        resetStateVariables();
+        return;
+    }
     nb->fireChangeNotification(NF_LINK_BREAK, temp);
     popTransmissionQueue();
     resetStateVariables();
@@ -2029,6 +2204,11 @@ void Ieee80211Mac::retryCurrentTransmission()
 {
     ASSERT(retryCounter() < transmissionLimit - 1);
     getCurrentTransmission()->setRetry(true);
+    if (isAggregateInFlight())
+        for (unsigned int i = 0; i < aggregatedFrames.size(); i++)
+            aggregatedFrames[i]->setRetry(true);
+    if (rateControlMode == RATE_MINSTREL)
+        minstrel->reportTransmissionResult(aggregatedFrames.empty() ? 1 : aggregatedFrames.size(), 0);
     if (rateControlMode == RATE_AARF || rateControlMode == RATE_ARF)
         reportDataFailed();
     else
@@ -2038,6 +2218,76 @@ void Ieee80211Mac::retryCurrentTransmission()
     generateBackoffPeriod();
 }
 
+void Ieee80211Mac::finishAggregateTransmission(Ieee80211BlockAckFrame *blockAck)
+{
+    std::vector<Ieee80211DataOrMgmtFrame *> frames;
+    frames.swap(aggregatedFrames);
+
+    std::vector<Ieee80211DataOrMgmtFrame *> unacknowledgedFrames;
+    for (unsigned int i = 0; i < frames.size(); i++)
+    {
+        fr = frames[i];
+        if (blockAck)
+        {
+            unsigned int offset = (fr->getSequenceNumber() - blockAck->getStartingSequenceNumber()) & 0xfff;
+            if (offset >= BLOCKACK_WINDOW_SIZE || !(blockAck->getBitmap() & ((uint64)1 << offset)))
+            {
+                unacknowledgedFrames.push_back(fr);
+                continue;
+            }
+        }
+        if (retryCounter() == 0)
+            numSentWithoutRetry()++;
+        numSent()++;
+        numSentInAggregates++;
+        numBits += fr->getBitLength();
+        bits() += fr->getBitLength();
+        macDelay()->record(simTime() - fr->getMACArrive());
+        if (maxJitter() == SIMTIME_ZERO || maxJitter() < (simTime() - fr->getMACArrive()))
+            maxJitter() = simTime() - fr->getMACArrive();
+        if (minJitter() == SIMTIME_ZERO || minJitter() > (simTime() - fr->getMACArrive()))
+            minJitter() = simTime() - fr->getMACArrive();
+        removeFromTransmissionQueue(fr);
+    }
+    EV << "aggregate: " << frames.size() - unacknowledgedFrames.size() << " of " << frames.size() << " frames acknowledged\n";
+    if (rateControlMode == RATE_MINSTREL)
+        minstrel->reportTransmissionResult(frames.size(), frames.size() - unacknowledgedFrames.size());
+
+    if (unacknowledgedFrames.empty())
+    {
+        resetStateVariables();
+        resetCurrentBackOff();
+    }
+    else if (retryCounter() == transmissionLimit - 1)
+    {
+        // the unacknowledged frames have been in every attempt of the aggregate
+        for (unsigned int i = 0; i < unacknowledgedFrames.size(); i++)
+        {
+            nb->fireChangeNotification(NF_LINK_BREAK, unacknowledgedFrames[i]);
+            removeFromTransmissionQueue(unacknowledgedFrames[i]);
+            numGivenUp()++;
+        }
+        resetStateVariables();
+    }
+    else
+    {
+        // move them to the head of the queue in their order, so that they
+        // are retried together (see buildAggregateFrame())
+        for (int i = unacknowledgedFrames.size() - 1; i >= 0; i--)
+        {
+            transmissionQueue()->remove(unacknowledgedFrames[i]);
+            transmissionQueue()->push_front(unacknowledgedFrames[i]);
+            unacknowledgedFrames[i]->setRetry(true);
+        }
+        retryCurrentTransmission();
+    }
+}
+
+bool Ieee80211Mac::isAggregateInFlight()
+{
+    return !aggregatedFrames.empty() && aggregatedFrames.front() == getCurrentTransmission();
+}
+
 Ieee80211DataOrMgmtFrame *Ieee80211Mac::getCurrentTransmission()
 {
     return transmissionQueue()->empty() ? NULL : (Ieee80211DataOrMgmtFrame *)transmissionQueue()->front();
@@ -2140,6 +2390,26 @@ void Ieee80211Mac::popTransmissionQueue()
     Ieee80211Frame *temp = dynamic_cast<Ieee80211Frame *>(transmissionQueue()->front());
     ASSERT(!transmissionQueue()->empty());
     transmissionQueue()->pop_front();
+    if (!aggregatedFrames.empty())
+        aggregatedFrames.erase(std::remove(aggregatedFrames.begin(), aggregatedFrames.end(), temp), aggregatedFrames.end());
+    requestFrameFromQueueModule();
+    delete temp;
+}
+
+void Ieee80211Mac::removeFromTransmissionQueue(Ieee80211DataOrMgmtFrame *frame)
+{
+    EV << "dropping frame " << frame << " from transmission queue\n";
+    Ieee80211DataOrMgmtFrameList::iterator it = std::find(transmissionQueue()->begin(), transmissionQueue()->end(), frame);
+    ASSERT(it != transmissionQueue()->end());
+    transmissionQueue()->erase(it);
+    if (!aggregatedFrames.empty())
+        aggregatedFrames.erase(std::remove(aggregatedFrames.begin(), aggregatedFrames.end(), frame), aggregatedFrames.end());
+    requestFrameFromQueueModule();
+    delete frame;
+}
+
+void Ieee80211Mac::requestFrameFromQueueModule()
+{
     if (queueModule)
     {
         if (numCategories()==1)
@@ -2156,7 +2426,6 @@ void Ieee80211Mac::popTransmissionQueue()
             queueModule->requestPacket();
          }
     }
-    delete temp;
 }
 
 double Ieee80211Mac::computeFrameDuration(Ieee80211Frame *msg)
@@ -2273,6 +2542,7 @@ void Ieee80211Mac::flushQueue()
             delete msg;
         }
     }
+    aggregatedFrames.clear();
 }
 
 void Ieee80211Mac::clearQueue()
@@ -2290,6 +2560,7 @@ void Ieee80211Mac::clearQueue()
             delete msg;
         }
     }
+    aggregatedFrames.clear();
 }
 
 void Ieee80211Mac::reportDataOk()
@@ -2730,8 +3001,31 @@ void Ieee80211Mac::sendUp(cMessage *msg)
 {
     EV << "sending up " << msg << "\n";
 
+    Ieee80211AggregateFrame *aggregate = dynamic_cast<Ieee80211AggregateFrame *>(msg);
+    if (aggregate)
+    {
+        // the emptied aggregate is kept for the (block) ack and deleted by handleLowerMsg()
+        numReceivedAggregates++;
+        while (Ieee80211DataFrame *frame = aggregate->removeSubframe())
+        {
+            if (duplicateDetect && updateBlockAckRecord(frame))
+                delete frame;
+            else
+            {
+                emit(packetSentToUpperSignal, frame);
+                send(frame, upperLayerOut);
+            }
+        }
+        return;
+    }
+
     if (!isDuplicated(msg)) // duplicate detection filter
     {
+        // keep the window of a transmitter that sends aggregates up to date
+        Ieee80211DataOrMgmtFrame *frame = dynamic_cast<Ieee80211DataOrMgmtFrame *>(msg);
+        if (duplicateDetect && frame && blockAckRecords.find(frame->getTransmitterAddress()) != blockAckRecords.end())
+            updateBlockAckRecord(frame);
+
         if (msg->isPacket())
             emit(packetSentToUpperSignal, msg);
 
@@ -2741,20 +3035,38 @@ void Ieee80211Mac::sendUp(cMessage *msg)
 
 void Ieee80211Mac::removeOldTuplesFromDuplicateMap()
 {
-    if (duplicateDetect && lastTimeDelete+duplicateTimeOut>=simTime())
+    if (!duplicateDetect || !purgeOldTuples)
+        return;
+
+    // only the expired records are visited, so the cost does not depend on
+    // the number of transmitters
+    simtime_t now = simTime();
+    while (!asfExpiryQueue.empty() && asfExpiryQueue.front().first + duplicateTimeOut < now)
+    {
+        MACAddress address = asfExpiryQueue.front().second;
+        asfExpiryQueue.pop_front();
+        Ieee80211ASFTupleList::iterator it = asfTuplesList.find(address);
+        if (it == asfTuplesList.end())
+            continue;
+        if (it->second.receivedTime + duplicateTimeOut < now)
+            asfTuplesList.erase(address);
+        else
+            asfExpiryQueue.push_back(std::make_pair(it->second.receivedTime, address));  // refreshed since
+    }
+
+    // the block ack agreement with a transmitter ends when nothing has been
+    // received from it for duplicateTimeOut
+    while (!blockAckExpiryQueue.empty() && blockAckExpiryQueue.front().first + duplicateTimeOut < now)
     {
-        lastTimeDelete=simTime();
-        for (Ieee80211ASFTupleList::iterator it = asfTuplesList.begin(); it!=asfTuplesList.end(); )
-        {
-            if (it->second.receivedTime+duplicateTimeOut<simTime())
-            {
-                Ieee80211ASFTupleList::iterator itAux=it;
-                it++;
-                asfTuplesList.erase(itAux);
-            }
-            else
-                it++;
-        }
+        MACAddress address = blockAckExpiryQueue.front().second;
+        blockAckExpiryQueue.pop_front();
+        Ieee80211BlockAckRecordList::iterator it = blockAckRecords.find(address);
+        if (it == blockAckRecords.end())
+            continue;
+        if (it->second.receivedTime + duplicateTimeOut < now)
+            blockAckRecords.erase(it);
+        else
+            blockAckExpiryQueue.push_back(std::make_pair(it->second.receivedTime, address));  // refreshed since
     }
 }
 
@@ -2788,11 +3100,15 @@ bool Ieee80211Mac::isDuplicated(cMessage *msg)
                 tuple.sequenceNumber = frame->getSequenceNumber();
                 tuple.fragmentNumber = frame->getFragmentNumber();
                 asfTuplesList.insert(std::pair<MACAddress, Ieee80211ASFTuple>(frame->getTransmitterAddress(), tuple));
+                if (purgeOldTuples)
+                    asfExpiryQueue.push_back(std::make_pair(tuple.receivedTime, frame->getTransmitterAddress()));
             }
             else
             {
-                // check if duplicate
-                if (it->second.sequenceNumber == frame->getSequenceNumber()
+                // check if duplicate; a tuple not purged yet but older than
+                // duplicateTimeOut is ignored
+                bool expired = purgeOldTuples && it->second.receivedTime + duplicateTimeOut < simTime();
+                if (!expired && it->second.sequenceNumber == frame->getSequenceNumber()
                         && it->second.fragmentNumber == frame->getFragmentNumber())
                 {
                     return true;
@@ -2810,8 +3126,65 @@ bool Ieee80211Mac::isDuplicated(cMessage *msg)
     return false;
 }
 
+bool Ieee80211Mac::updateBlockAckRecord(Ieee80211DataOrMgmtFrame *frame)
+{
+    unsigned int sequenceNumber = frame->getSequenceNumber();
+    Ieee80211BlockAckRecordList::iterator it = blockAckRecords.find(frame->getTransmitterAddress());
+    if (it == blockAckRecords.end())
+    {
+        Ieee80211BlockAckRecord record;
+        record.windowStart = sequenceNumber;
+        record.bitmap = 1;
+        record.receivedTime = simTime();
+        blockAckRecords.insert(std::pair<MACAddress, Ieee80211BlockAckRecord>(frame->getTransmitterAddress(), record));
+        if (purgeOldTuples)
+            blockAckExpiryQueue.push_back(std::make_pair(record.receivedTime, frame->getTransmitterAddress()));
+        return false;
+    }
+
+    Ieee80211BlockAckRecord& record = it->second;
+    // a record not purged yet but older than duplicateTimeOut belongs to an ended agreement
+    bool expired = purgeOldTuples && record.receivedTime + duplicateTimeOut < simTime();
+    record.receivedTime = simTime();
+    unsigned int offset = (sequenceNumber - record.windowStart) & 0xfff;
+    if (expired)
+    {
+        record.windowStart = sequenceNumber;
+        record.bitmap = 1;
+    }
+    else if (offset < BLOCKACK_WINDOW_SIZE)
+    {
+        if (record.bitmap & ((uint64)1 << offset))
+            return true;
+        record.bitmap |= (uint64)1 << offset;
+    }
+    else if (offset < 2048)
+    {
+        // ahead of the window: slide it so that it ends with this frame
+        unsigned int shift = offset - (BLOCKACK_WINDOW_SIZE - 1);
+        record.bitmap = (shift < BLOCKACK_WINDOW_SIZE) ? (record.bitmap >> shift) : 0;
+        record.bitmap |= (uint64)1 << (BLOCKACK_WINDOW_SIZE - 1);
+        record.windowStart = (record.windowStart + shift) & 0xfff;
+    }
+    else
+    {
+        // behind the window: too old to tell (e.g. after a sequence number wrap-around), restart from here
+        record.windowStart = sequenceNumber;
+        record.bitmap = 1;
+    }
+    return false;
+}
+
 void Ieee80211Mac::promiscousFrame(cMessage *msg)
 {
+    Ieee80211AggregateFrame *aggregate = dynamic_cast<Ieee80211AggregateFrame *>(msg);
+    if (aggregate)
+    {
+        for (unsigned int i = 0; i < aggregate->getNumSubframes(); i++)
+            promiscousFrame(aggregate->getSubframe(i));
+        return;
+    }
+
     if (!isDuplicated(msg)) // duplicate detection filter
         nb->fireChangeNotification(NF_LINK_PROMISCUOUS, msg);
 }
@@ -25,14 +25,19 @@
 // un-comment this if you do not want to log state machine transitions
 //#define FSM_DEBUG
 
+#include <deque>
+
 #include "WifiMode.h"
 #include "WirelessMacBase.h"
 #include "IPassiveQueue.h"
 #include "Ieee80211Frame_m.h"
+#include "Ieee80211AggregateFrame.h"
+#include "Ieee80211MinstrelRateControl.h"
 #include "Ieee80211Consts.h"
 #include "NotificationBoard.h"
 #include "RadioState.h"
 #include "FSMA.h"
+#include "OpenHashMap.h"
 #include "IQoSClassifier.h"
 
 /**
@@ -78,13 +83,34 @@ class INET_API Ieee80211Mac : public WirelessMacBase
         }
     };
 
-    typedef std::map<MACAddress, Ieee80211ASFTuple> Ieee80211ASFTupleList;
+    struct MACAddressHash
+    {
+        size_t operator()(const MACAddress& address) const { return hashUInt64(address.getInt()); }
+    };
+
+    typedef OpenHashMap<MACAddress, Ieee80211ASFTuple, MACAddressHash> Ieee80211ASFTupleList;
+    typedef std::deque<std::pair<simtime_t, MACAddress> > Ieee80211ASFExpiryQueue;
+
+    /**
+     * Sequence numbers recently received from a transmitter that sends
+     * aggregates (block ack scoreboard). Bit i of the bitmap
+     * is set if the frame with sequence number windowStart+i has been received.
+     */
+    struct Ieee80211BlockAckRecord
+    {
+        unsigned int windowStart;
+        uint64 bitmap;
+        simtime_t receivedTime;
+    };
+
+    typedef std::map<MACAddress, Ieee80211BlockAckRecord> Ieee80211BlockAckRecordList;
 
     enum
     {
         RATE_ARF,   // Auto Rate Fallback
         RATE_AARF,  // Adaptatice ARF
         RATE_CR,    // Constant Rate
+        RATE_MINSTREL,  // Minstrel, see Ieee80211MinstrelRateControl
     } rateControlMode;
 
     WifiPreamble wifiPreambleType;
@@ -129,6 +155,7 @@ class INET_API Ieee80211Mac : public WirelessMacBase
     int minTimerTimeout;
     double successCoeff;
     double timerCoeff;
+    Ieee80211MinstrelRateControl *minstrel;
     double _snr;
     double snr;
     double lossRate;
@@ -183,6 +210,20 @@ class INET_API Ieee80211Mac : public WirelessMacBase
 
     /** Messages longer than this threshold will be sent in multiple fragments. see spec 361 */
     static const int fragmentationThreshold = 2346;
+
+    /** Frame aggregation used by the sender; received aggregates are always accepted */
+    enum AggregationMode
+    {
+        AGGREGATION_NONE,
+        AGGREGATION_AMSDU,
+        AGGREGATION_AMPDU,
+    } aggregation;
+
+    /** Maximum number of frames in an aggregate */
+    int maxAggregatedFrames;
+
+    /** Maximum length of an aggregate in bytes */
+    int maxAggregateSize;
     //@}
 
   public:
@@ -346,15 +387,41 @@ class INET_API Ieee80211Mac : public WirelessMacBase
 
     Ieee80211DataOrMgmtFrame *fr;
 
+    /**
+     * The frames of the transmission queue carried by the aggregate waiting
+     * for the ACK or block ack, in transmission order; empty if the last
+     * data frame sent was not an aggregate. They stay in the queue until
+     * they are acknowledged. The first one is the head of the queue, and
+     * the frames of a failed aggregate share its retry counter: they are
+     * retried together, and no new frame joins them.
+     */
+    std::vector<Ieee80211DataOrMgmtFrame *> aggregatedFrames;
+
+    /** Duration of the last aggregate sent */
+    double aggregateDuration;
+
     /**
     * A list of last sender, sequence and fragment number tuples to identify
-    * duplicates, see spec 9.2.9.
+    * duplicates, see spec 9.2.9. Tuples older than duplicateTimeOut are
+    * ignored, and purged using asfExpiryQueue, which holds one
+    * (receivedTime, transmitter) record per tuple, in roughly increasing
+    * order of time; refreshed tuples are requeued when their record expires.
     */
     bool duplicateDetect;
     bool purgeOldTuples;
     simtime_t duplicateTimeOut;
-    simtime_t lastTimeDelete;
     Ieee80211ASFTupleList asfTuplesList;
+    Ieee80211ASFExpiryQueue asfExpiryQueue;
+
+    /**
+     * The duplicate filter for aggregates: a retransmitted aggregate may
+     * carry several frames that have already been received. The block ack
+     * agreement with a transmitter is implicit, it ends when nothing has been
+     * received from it for duplicateTimeOut; the expiry queue works like that
+     * of the tuples.
+     */
+    Ieee80211BlockAckRecordList blockAckRecords;
+    Ieee80211ASFExpiryQueue blockAckExpiryQueue;
 
     /** Passive queue module to request messages from */
     IPassiveQueue *queueModule;
@@ -411,6 +478,10 @@ class INET_API Ieee80211Mac : public WirelessMacBase
     // long numDropped[4];
     long numReceivedOther;
     long numAckSend;
+    long numSentAggregates;
+    long numSentInAggregates;
+    long numReceivedAggregates;
+    long numBlockAckSend;
     cOutVector stateVector;
     simtime_t  last;
     // long bits[4];
@@ -531,6 +602,7 @@ class INET_API Ieee80211Mac : public WirelessMacBase
     //@{
     virtual void sendACKFrameOnEndSIFS();
     virtual void sendACKFrame(Ieee80211DataOrMgmtFrame *frame);
+    virtual void sendBlockAckFrame(Ieee80211AggregateFrame *aggregate);
     virtual void sendRTSFrame(Ieee80211DataOrMgmtFrame *frameToSend);
     virtual void sendCTSFrameOnEndSIFS();
     virtual void sendCTSFrame(Ieee80211RTSFrame *rtsFrame);
@@ -546,6 +618,14 @@ class INET_API Ieee80211Mac : public WirelessMacBase
     //@{
     virtual Ieee80211DataOrMgmtFrame *buildDataFrame(Ieee80211DataOrMgmtFrame *frameToSend);
     virtual Ieee80211ACKFrame *buildACKFrame(Ieee80211DataOrMgmtFrame *frameToACK);
+    virtual Ieee80211BlockAckFrame *buildBlockAckFrame(Ieee80211AggregateFrame *aggregate);
+
+    /**
+     * Builds an aggregate from frameToSend (the head of the current queue) and
+     * the following data frames of the queue to the same receiver, and fills
+     * in aggregatedFrames. Returns NULL if there is nothing to aggregate.
+     */
+    virtual Ieee80211AggregateFrame *buildAggregateFrame(Ieee80211DataOrMgmtFrame *frameToSend);
     virtual Ieee80211RTSFrame *buildRTSFrame(Ieee80211DataOrMgmtFrame *frameToSend);
     virtual Ieee80211CTSFrame *buildCTSFrame(Ieee80211RTSFrame *rtsFrame);
     virtual Ieee80211DataOrMgmtFrame *buildMulticastFrame(Ieee80211DataOrMgmtFrame *frameToSend);
@@ -566,6 +646,17 @@ class INET_API Ieee80211Mac : public WirelessMacBase
     virtual void finishCurrentTransmission();
     virtual void giveUpCurrentTransmission();
     virtual void retryCurrentTransmission();
+
+    /** Returns true if aggregatedFrames is the aggregate of the current transmission */
+    virtual bool isAggregateInFlight();
+
+    /**
+     * Handles the ACK (blockAck == NULL) or block ack received for the aggregate
+     * in flight: removes the acknowledged frames from the queue and retries or
+     * gives up the others. The frames to retry are moved to the head of the
+     * queue, so that they are sent in the next aggregate.
+     */
+    virtual void finishAggregateTransmission(Ieee80211BlockAckFrame *blockAck);
     virtual bool transmissionQueueEmpty();
     virtual unsigned int transmissionQueueSize();
     virtual void flushQueue();
@@ -614,6 +705,12 @@ class INET_API Ieee80211Mac : public WirelessMacBase
     /** @brief Deletes frame at the front of queue. */
     virtual void popTransmissionQueue();
 
+    /** @brief Deletes the given frame from the current queue. */
+    virtual void removeFromTransmissionQueue(Ieee80211DataOrMgmtFrame *frame);
+
+    /** @brief Asks the queue module for a new frame when there is room for it. */
+    virtual void requestFrameFromQueueModule();
+
     /**
      * @brief Computes the duration (in seconds) of the transmission of a frame
      * over the physical channel. 'bits' should be the total length of the MAC frame
@@ -669,6 +766,12 @@ class INET_API Ieee80211Mac : public WirelessMacBase
 
     virtual bool isDuplicated(cMessage *msg);
 
+    /**
+     * Records the sequence number of a frame received from a transmitter that
+     * sends aggregates. Returns true if the frame has already been received.
+     */
+    virtual bool updateBlockAckRecord(Ieee80211DataOrMgmtFrame *frame);
+
     virtual void sendNotification(int category, cMessage *pkt)
     {
         if (!nb)
@@ -0,0 +1,229 @@
+//
+// Copyright (C) 2026 OpenSim Ltd
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program; if not, see <http://www.gnu.org/licenses/>.
+//
+
+#include <algorithm>
+
+#include "Ieee80211MinstrelRateControl.h"
+
+#include "Ieee80211DataRate.h"
+
+// rates below this success probability are not worth using
+#define MINSTREL_MIN_PROBABILITY    0.1
+// above this probability the more reliable rate is chosen by throughput
+#define MINSTREL_HIGH_PROBABILITY   0.95
+
+
+Ieee80211MinstrelRateControl::Ieee80211MinstrelRateControl(char opMode, WifiPreamble preamble, int frameLength,
+        simtime_t attemptOverhead, simtime_t updateInterval, double ewmaLevel, double lookaroundRatio) :
+    updateInterval(updateInterval), ewmaLevel(ewmaLevel), lookaroundRatio(lookaroundRatio),
+    pending(false), pendingRate(-1), selectedBitrateVector("minstrel selected bitrate")
+{
+    if (ewmaLevel < 0 || ewmaLevel >= 1)
+        throw cRuntimeError("Invalid Minstrel EWMA level %g, must be in [0,1)", ewmaLevel);
+    if (lookaroundRatio < 0 || lookaroundRatio > 1)
+        throw cRuntimeError("Invalid Minstrel lookaround ratio %g, must be in [0,1]", lookaroundRatio);
+
+    referenceBits = frameLength * 8;
+    int maxIdx = Ieee80211Descriptor::getMaxIdx(opMode);
+    for (int idx = Ieee80211Descriptor::getMinIdx(opMode); idx <= maxIdx; idx++)
+    {
+        const Ieee80211DescriptorData& descriptor = Ieee80211Descriptor::getDescriptor(idx);
+        bitrates.push_back(descriptor.bitrate);
+        attemptTimes.push_back(WifiModulationType::calculateTxDuration(referenceBits, descriptor.modulationType, preamble) + attemptOverhead);
+
+        char name[64];
+        sprintf(name, "minstrel success probability %gMbps", descriptor.bitrate / 1e6);
+        probabilityVectors.push_back(new cOutVector(name));
+    }
+}
+
+Ieee80211MinstrelRateControl::~Ieee80211MinstrelRateControl()
+{
+    for (unsigned int i = 0; i < probabilityVectors.size(); i++)
+        delete probabilityVectors[i];
+}
+
+Ieee80211MinstrelRateControl::DestinationStats& Ieee80211MinstrelRateControl::getDestinationStats(const MACAddress& destination)
+{
+    DestinationStatsMap::iterator it = destinations.find(destination);
+    if (it != destinations.end())
+        return it->second;
+
+    // start optimistically at the highest rate, and let sampling and the
+    // first update find the right one
+    DestinationStats& stats = destinations[destination];
+    RateStats rateStats;
+    rateStats.attempts = rateStats.successes = 0;
+    rateStats.totalAttempts = rateStats.totalSuccesses = 0;
+    rateStats.probability = rateStats.throughput = 0;
+    rateStats.sampled = false;
+    stats.rates.assign(bitrates.size(), rateStats);
+    int numRates = bitrates.size();
+    stats.maxThroughputRate = numRates - 1;
+    stats.secondThroughputRate = std::max(numRates - 2, 0);
+    stats.maxProbabilityRate = 0;
+    stats.nextUpdate = simTime() + updateInterval;
+    stats.sampling = false;
+    stats.sampleRate = -1;
+    return stats;
+}
+
+void Ieee80211MinstrelRateControl::updateStats(DestinationStats& stats)
+{
+    bool anySampled = false;
+    for (unsigned int i = 0; i < stats.rates.size(); i++)
+    {
+        RateStats& r = stats.rates[i];
+        if (r.attempts > 0)
+        {
+            double ratio = (double)r.successes / r.attempts;
+            r.probability = r.sampled ? ewmaLevel * r.probability + (1 - ewmaLevel) * ratio : ratio;
+            r.sampled = true;
+            r.attempts = r.successes = 0;
+            r.throughput = r.probability < MINSTREL_MIN_PROBABILITY ? 0 : r.probability * referenceBits / SIMTIME_DBL(attemptTimes[i]);
+            probabilityVectors[i]->record(r.probability);
+        }
+        anySampled = anySampled || r.sampled;
+    }
+    if (!anySampled)
+        return;
+
+    int best = -1, second = -1, mostReliable = -1;
+    for (int i = 0; i < (int)stats.rates.size(); i++)
+    {
+        const RateStats& r = stats.rates[i];
+        if (!r.sampled)
+            continue;
+        if (best == -1 || r.throughput > stats.rates[best].throughput)
+        {
+            second = best;
+            best = i;
+        }
+        else if (second == -1 || r.throughput > stats.rates[second].throughput)
+            second = i;
+
+        if (mostReliable == -1)
+            mostReliable = i;
+        else
+        {
+            const RateStats& m = stats.rates[mostReliable];
+            if (r.probability >= MINSTREL_HIGH_PROBABILITY && m.probability >= MINSTREL_HIGH_PROBABILITY
+                    ? r.throughput > m.throughput : r.probability > m.probability)
+                mostReliable = i;
+        }
+    }
+
+    if (stats.rates[best].throughput == 0)
+    {
+        // nothing gets through: fall back to the lowest rate
+        stats.maxThroughputRate = stats.secondThroughputRate = stats.maxProbabilityRate = 0;
+        return;
+    }
+    stats.maxThroughputRate = best;
+    stats.secondThroughputRate = second != -1 && stats.rates[second].throughput > 0 ? second : mostReliable;
+    stats.maxProbabilityRate = mostReliable;
+}
+
+int Ieee80211MinstrelRateControl::chooseSampleRate(const DestinationStats& stats)
+{
+    int numRates = bitrates.size();
+    if (numRates < 2)
+        return -1;
+    int rate = intuniform(0, numRates - 2);
+    if (rate >= stats.maxThroughputRate)
+        rate++;
+    // a rate that is slower than the current best one even without losses is not worth a sample
+    double idealThroughput = referenceBits / SIMTIME_DBL(attemptTimes[rate]);
+    if (idealThroughput <= stats.rates[stats.maxThroughputRate].throughput)
+        return -1;
+    return rate;
+}
+
+int Ieee80211MinstrelRateControl::getRetryChainRate(const DestinationStats& stats, int retryCount)
+{
+    if (stats.sampling)
+    {
+        // sample once, then continue with the normal chain
+        if (retryCount == 0)
+            return stats.sampleRate;
+        retryCount--;
+    }
+    if (retryCount < 2)
+        return stats.maxThroughputRate;
+    else if (retryCount < 4)
+        return stats.secondThroughputRate;
+    else if (retryCount < 6)
+        return stats.maxProbabilityRate;
+    else
+        return 0;
+}
+
+double Ieee80211MinstrelRateControl::getTransmissionBitrate(const MACAddress& destination, int retryCount)
+{
+    DestinationStats& stats = getDestinationStats(destination);
+    if (simTime() >= stats.nextUpdate)
+    {
+        updateStats(stats);
+        stats.nextUpdate = simTime() + updateInterval;
+    }
+    if (retryCount == 0)
+    {
+        stats.sampleRate = uniform(0, 1) < lookaroundRatio ? chooseSampleRate(stats) : -1;
+        stats.sampling = stats.sampleRate != -1;
+    }
+
+    pending = true;
+    pendingDestination = destination;
+    pendingRate = getRetryChainRate(stats, retryCount);
+    selectedBitrateVector.record(bitrates[pendingRate]);
+    return bitrates[pendingRate];
+}
+
+void Ieee80211MinstrelRateControl::reportTransmissionResult(int numFrames, int numAcked)
+{
+    if (!pending)
+        return;
+    pending = false;
+
+    RateStats& r = getDestinationStats(pendingDestination).rates[pendingRate];
+    r.attempts += numFrames;
+    r.successes += numAcked;
+    r.totalAttempts += numFrames;
+    r.totalSuccesses += numAcked;
+}
+
+void Ieee80211MinstrelRateControl::recordScalars(cComponent *component)
+{
+    for (unsigned int i = 0; i < bitrates.size(); i++)
+    {
+        unsigned long attempts = 0, successes = 0;
+        for (DestinationStatsMap::const_iterator it = destinations.begin(); it != destinations.end(); ++it)
+        {
+            attempts += it->second.rates[i].totalAttempts;
+            successes += it->second.rates[i].totalSuccesses;
+        }
+        char name[64];
+        sprintf(name, "minstrel attempts %gMbps", bitrates[i] / 1e6);
+        component->recordScalar(name, attempts);
+        if (attempts > 0)
+        {
+            sprintf(name, "minstrel success ratio %gMbps", bitrates[i] / 1e6);
+            component->recordScalar(name, (double)successes / attempts);
+        }
+    }
+}
+
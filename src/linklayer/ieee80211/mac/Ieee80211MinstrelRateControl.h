@@ -0,0 +1,132 @@
+//
+// Copyright (C) 2026 OpenSim Ltd
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program; if not, see <http://www.gnu.org/licenses/>.
+//
+
+#ifndef __IEEE80211MINSTRELRATECONTROL_H
+#define __IEEE80211MINSTRELRATECONTROL_H
+
+#include <map>
+#include <vector>
+
+#include "INETDefs.h"
+
+#include "MACAddress.h"
+#include "WifiMode.h"
+
+
+/**
+ * Sampling-based rate control in the style of the Linux Minstrel algorithm,
+ * used by Ieee80211Mac when autoBitrate = 3.
+ *
+ * A statistics table is kept for each destination. Every updateInterval the
+ * success ratio of each rate in the last interval is folded into an EWMA of
+ * its success probability, and the expected throughput of each rate is
+ * computed from that probability and the time one attempt takes. The rates
+ * with the best and second best throughput and the one with the highest
+ * probability form the retry chain of normal frames. A lookaroundRatio
+ * fraction of the frames is sent at a randomly chosen rate instead, so that
+ * the statistics of the other rates stay up to date; rates that could not
+ * beat the current best one even without losses are not sampled.
+ *
+ * The MAC asks for the bitrate of every transmission attempt of a unicast
+ * frame with getTransmissionBitrate(), and reports its outcome with
+ * reportTransmissionResult(). Results that do not belong to an attempt
+ * (e.g. a CTS timeout) are ignored.
+ */
+class INET_API Ieee80211MinstrelRateControl
+{
+  public:
+    struct RateStats
+    {
+        unsigned int attempts;      // in the current interval
+        unsigned int successes;     // in the current interval
+        unsigned long totalAttempts;
+        unsigned long totalSuccesses;
+        double probability;         // EWMA of the success ratio
+        double throughput;          // expected throughput in bps
+        bool sampled;               // probability is valid
+    };
+
+    struct DestinationStats
+    {
+        std::vector<RateStats> rates;
+        int maxThroughputRate;
+        int secondThroughputRate;
+        int maxProbabilityRate;
+        simtime_t nextUpdate;
+        bool sampling;              // the current frame is a sampling frame
+        int sampleRate;
+    };
+
+    typedef std::map<MACAddress, DestinationStats> DestinationStatsMap;
+
+  protected:
+    simtime_t updateInterval;
+    double ewmaLevel;
+    double lookaroundRatio;
+    int referenceBits;
+
+    std::vector<double> bitrates;           // supported rates, ascending
+    std::vector<simtime_t> attemptTimes;    // time of one attempt of a reference frame at each rate
+    DestinationStatsMap destinations;
+
+    // the attempt whose result has not been reported yet
+    bool pending;
+    MACAddress pendingDestination;
+    int pendingRate;
+
+    cOutVector selectedBitrateVector;
+    std::vector<cOutVector *> probabilityVectors;
+
+  protected:
+    DestinationStats& getDestinationStats(const MACAddress& destination);
+    void updateStats(DestinationStats& stats);
+    int chooseSampleRate(const DestinationStats& stats);
+    int getRetryChainRate(const DestinationStats& stats, int retryCount);
+
+  public:
+    /**
+     * The attempt time of a rate is the duration of a frameLength bytes long
+     * frame at that rate, plus the given per-attempt overhead (interframe
+     * spaces, average backoff and the ACK).
+     */
+    Ieee80211MinstrelRateControl(char opMode, WifiPreamble preamble, int frameLength, simtime_t attemptOverhead,
+            simtime_t updateInterval, double ewmaLevel, double lookaroundRatio);
+    virtual ~Ieee80211MinstrelRateControl();
+
+    /**
+     * Returns the bitrate to use for the next transmission attempt of a frame
+     * to the given destination; retryCount is the number of previous attempts.
+     */
+    virtual double getTransmissionBitrate(const MACAddress& destination, int retryCount);
+
+    /**
+     * Reports the result of the last attempt: numFrames frames were sent
+     * (more than one for an aggregate), numAcked of them were acknowledged.
+     */
+    virtual void reportTransmissionResult(int numFrames, int numAcked);
+
+    /**
+     * Records the number of attempts and the success probability of each
+     * rate, summed over all destinations, as scalars of the given module.
+     */
+    virtual void recordScalars(cComponent *component);
+
+    const DestinationStatsMap& getDestinations() const { return destinations; }
+};
+
+#endif
+
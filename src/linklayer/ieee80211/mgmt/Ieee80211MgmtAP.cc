@@ -38,6 +38,14 @@ static std::ostream& operator<<(std::ostream& os, const Ieee80211MgmtAP::STAInfo
     return os;
 }
 
+static std::ostream& operator<<(std::ostream& os, const Ieee80211MgmtAP::STAList& staList)
+{
+    os << staList.size() << " STAs:";
+    for (Ieee80211MgmtAP::STAList::const_iterator it = staList.begin(); it != staList.end(); ++it)
+        os << " " << it->first << " (" << it->second << ")";
+    return os;
+}
+
 Ieee80211MgmtAP::~Ieee80211MgmtAP()
 {
     cancelAndDelete(beaconTimer);
@@ -60,7 +68,7 @@ void Ieee80211MgmtAP::initialize(int stage)
         WATCH(channelNumber);
         WATCH(beaconInterval);
         WATCH(numAuthSteps);
-        WATCH_MAP(staList);
+        WATCH(staList);
 
         //TBD fill in supportedRates
 
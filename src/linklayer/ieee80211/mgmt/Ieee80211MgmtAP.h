@@ -18,12 +18,11 @@
 #ifndef IEEE80211_MGMT_AP_H
 #define IEEE80211_MGMT_AP_H
 
-#include <map>
-
 #include "INETDefs.h"
 
 #include "Ieee80211MgmtAPBase.h"
 #include "NotificationBoard.h"
+#include "OpenHashMap.h"
 
 
 /**
@@ -59,10 +58,13 @@ class INET_API Ieee80211MgmtAP : public Ieee80211MgmtAPBase
     };
 
 
-    struct MAC_compare {
-        bool operator()(const MACAddress& u1, const MACAddress& u2) const {return u1.compareTo(u2) < 0;}
+    struct MACAddressHash
+    {
+        size_t operator()(const MACAddress& address) const { return hashUInt64(address.getInt()); }
     };
-    typedef std::map<MACAddress,STAInfo, MAC_compare> STAList;
+
+    /** STAs by address; hashed, so that lookups stay cheap with many STAs */
+    typedef OpenHashMap<MACAddress, STAInfo, MACAddressHash> STAList;
 
   protected:
     NotificationBoard *nb;
@@ -57,7 +57,10 @@ void STPBase::initialize(int stage)
     if (stage == 1) // "auto" MAC addresses assignment takes place in stage 0
     {
         if (nb)
+        {
             nb->subscribe(this, NF_INTERFACE_STATE_CHANGED);
+            nb->subscribe(this, NF_INTERFACE_DELETED);
+        }
 
         NodeStatus *nodeStatus = dynamic_cast<NodeStatus *>(switchModule->getSubmodule("status"));
         isOperational = (!nodeStatus) || nodeStatus->getState() == NodeStatus::UP;
@@ -173,6 +176,9 @@ Ieee8021dInterfaceData * STPBase::getPortInterfaceData(unsigned int portNum)
 
 InterfaceEntry * STPBase::getPortInterfaceEntry(unsigned int portNum)
 {
+    if (portNum < portInterfaces.size() && portInterfaces[portNum])
+        return portInterfaces[portNum];
+
     cGate *gate = switchModule->gate("ethg$o", portNum);
     if (!gate)
         error("gate is NULL");
@@ -180,9 +186,18 @@ InterfaceEntry * STPBase::getPortInterfaceEntry(unsigned int portNum)
     if (!gateIfEntry)
         error("gate's Interface is NULL");
 
+    if (portNum >= portInterfaces.size())
+        portInterfaces.resize(numPorts > portNum ? numPorts : portNum + 1, NULL);
+    portInterfaces[portNum] = gateIfEntry;
     return gateIfEntry;
 }
 
+void STPBase::receiveChangeNotification(int category, const cObject *details)
+{
+    if (category == NF_INTERFACE_DELETED)
+        portInterfaces.clear();
+}
+
 int STPBase::getRootIndex()
 {
     for (unsigned int i = 0; i < numPorts; i++)
@@ -47,11 +47,12 @@ protected:
     IMACAddressTable * macTable;
     IInterfaceTable * ifTable;
     InterfaceEntry * ie;
+    std::vector<InterfaceEntry *> portInterfaces;  // cache for getPortInterfaceEntry(), indexed by port number
 
 public:
     STPBase();
     virtual bool handleOperationStage(LifecycleOperation *operation, int stage, IDoneCallback *doneCallback);
-    virtual void receiveChangeNotification(int category, const cObject *details) {}
+    virtual void receiveChangeNotification(int category, const cObject *details);
 protected:
     virtual int numInitStages() const { return 2; }
     virtual void initialize(int stage);
@@ -84,7 +85,9 @@ protected:
     Ieee8021dInterfaceData *getPortInterfaceData(unsigned int portNum);
 
     /**
-     * @brief Gets InterfaceEntry for port number.
+     * @brief Gets InterfaceEntry for port number. The result is cached, because
+     * this is called for every port while processing a BPDU, and the interface
+     * table lookup by gate is a linear search.
      * @return The port's InterfaceEntry, or NULL if it doesn't exist.
      */
     InterfaceEntry *getPortInterfaceEntry(unsigned int portNum);
@@ -372,6 +372,7 @@ bool RSTP::processBetterSource(BPDU *frame, unsigned int arrivalPortNum)
         // there was a Root -> challenge 2 (compare with the root)
         int case2 = compareInterfacedata(r, frame, arrivalPort->getLinkCost()); // comparing with root port's BPDU
         int case3 = 0;
+        bool isAnyPortReset = false;
 
         switch (case2)
         {
@@ -419,11 +420,15 @@ bool RSTP::processBetterSource(BPDU *frame, unsigned int arrivalPortNum)
                         iPort->setRole(Ieee8021dInterfaceData::NOTASSIGNED);
                         iPort->setState(Ieee8021dInterfaceData::DISCARDING);
                         iPort->setNextUpgrade(simTime() + migrateTime);
-                        scheduleNextUpgrde();
                         initInterfacedata(i);
+                        isAnyPortReset = true;
                     }
                 }
             }
+            // once for all reset ports instead of once per port, it is a linear search;
+            // the arrival port is not a root port yet, as it was not for the last per-port call
+            if (isAnyPortReset)
+                scheduleNextUpgrde();
             arrivalPort->setRole(Ieee8021dInterfaceData::ROOT);
             arrivalPort->setState(Ieee8021dInterfaceData::FORWARDING);
             arrivalPort->setLostBPDU(0);
@@ -673,6 +678,7 @@ void RSTP::sendTCNtoRoot()
 void RSTP::sendBPDUs()
 {
     // send BPDUs through all ports, if they are required
+    int r = getRootIndex();
     for (unsigned int i = 0; i < numPorts; i++)
     {
         Ieee8021dInterfaceData * iPort = getPortInterfaceData(i);
@@ -680,16 +686,20 @@ void RSTP::sendBPDUs()
                 && (iPort->getRole() != Ieee8021dInterfaceData::ALTERNATE)
                 && (iPort->getRole() != Ieee8021dInterfaceData::DISABLED) && (!iPort->isEdge()))
         {
-            sendBPDU(i);
+            sendBPDU(i, r);
         }
     }
 }
 
 void RSTP::sendBPDU(int port)
+{
+    sendBPDU(port, getRootIndex());
+}
+
+void RSTP::sendBPDU(int port, int r)
 {
     // send a BPDU throuth port
     Ieee8021dInterfaceData * iport = getPortInterfaceData(port);
-    int r = getRootIndex();
     Ieee8021dInterfaceData * rootPort;
     if (r != -1)
         rootPort = getPortInterfaceData(r);
@@ -937,6 +947,8 @@ void RSTP::flushOtherPorts(unsigned int portNum)
 
 void RSTP::receiveChangeNotification(int category, const cObject *details)
 {
+    STPBase::receiveChangeNotification(category, details);
+
     if (category == NF_INTERFACE_STATE_CHANGED)
     {
         for (unsigned int i = 0; i < numPorts; i++)
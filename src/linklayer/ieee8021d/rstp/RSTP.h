@@ -85,6 +85,11 @@ protected:
      */
     virtual void sendBPDU(int port);
 
+    /**
+     * @brief Sends BPDU through a port, with the root port index already known
+     */
+    virtual void sendBPDU(int port, int rootIndex);
+
     /**
      * @brief General processing
      */
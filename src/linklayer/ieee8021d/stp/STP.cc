@@ -18,6 +18,8 @@
 // Authors: ANSA Team, Benjamin Martin Seregi
 //
 
+#include <algorithm>
+
 #include "EtherFrame.h"
 #include "STP.h"
 #include "Ieee802Ctrl_m.h"
@@ -48,6 +50,7 @@ void STP::initialize(int stage)
         isRoot = true;
         topologyChangeNotification = false;
         topologyChangeRecvd = true;
+        fullSelectionNeeded = true;
 
         rootPriority = bridgePriority;
         rootAddress = bridgeAddress;
@@ -165,7 +168,7 @@ void STP::handleBPDU(BPDU * bpdu)
         }
     }
 
-    tryRoot();
+    updatePortRoles(arrivalGate);
     delete bpdu;
 }
 
@@ -264,39 +267,32 @@ void STP::generateTCN()
 bool STP::isSuperiorBPDU(int portNum, BPDU * bpdu)
 {
     Ieee8021dInterfaceData * port = getPortInterfaceData(portNum);
-    Ieee8021dInterfaceData * xBpdu = new Ieee8021dInterfaceData();
+    Ieee8021dInterfaceData xBpdu;
 
     int result;
 
-    xBpdu->setRootPriority(bpdu->getRootPriority());
-    xBpdu->setRootAddress(bpdu->getRootAddress());
-    xBpdu->setRootPathCost(bpdu->getRootPathCost() + port->getLinkCost());
-    xBpdu->setBridgePriority(bpdu->getBridgePriority());
-    xBpdu->setBridgeAddress(bpdu->getBridgeAddress());
-    xBpdu->setPortPriority(bpdu->getPortPriority());
-    xBpdu->setPortNum(bpdu->getPortNum());
+    xBpdu.setRootPriority(bpdu->getRootPriority());
+    xBpdu.setRootAddress(bpdu->getRootAddress());
+    xBpdu.setRootPathCost(bpdu->getRootPathCost() + port->getLinkCost());
+    xBpdu.setBridgePriority(bpdu->getBridgePriority());
+    xBpdu.setBridgeAddress(bpdu->getBridgeAddress());
+    xBpdu.setPortPriority(bpdu->getPortPriority());
+    xBpdu.setPortNum(bpdu->getPortNum());
 
-    result = comparePorts(port, xBpdu);
+    result = comparePorts(port, &xBpdu);
 
     // port is superior
     if (result > 0)
-    {
-        delete xBpdu;
         return false;
-    }
 
     if (result < 0)
     {
         // BPDU is superior
         port->setFdWhile(0); // renew info
         port->setState(Ieee8021dInterfaceData::DISCARDING);
-        setSuperiorBPDU(portNum, bpdu); // renew information
-        delete xBpdu;
-        return true;
     }
 
     setSuperiorBPDU(portNum, bpdu); // renew information
-    delete xBpdu;
     return true;
 }
 
@@ -473,17 +469,13 @@ bool STP::checkRootEligibility()
 
 void STP::tryRoot()
 {
+    fullSelectionNeeded = false;
     if (checkRootEligibility())
     {
         EV_DETAIL<< "Switch is elected as root switch." << endl;
         isRoot = true;
         setAllDesignated();
-        rootPriority = bridgePriority;
-        rootAddress = bridgeAddress;
-        rootPathCost = 0;
-        currentHelloTime = helloTime;
-        currentMaxAge = maxAge;
-        currentFwdDelay = forwardDelay;
+        setRootBridgeParameters();
     }
     else
     {
@@ -494,6 +486,86 @@ void STP::tryRoot()
 
 }
 
+void STP::setRootBridgeParameters()
+{
+    rootPriority = bridgePriority;
+    rootAddress = bridgeAddress;
+    rootPathCost = 0;
+    currentHelloTime = helloTime;
+    currentMaxAge = maxAge;
+    currentFwdDelay = forwardDelay;
+}
+
+void STP::updatePortRoles(unsigned int portNum)
+{
+    // Port information only improves or gets refreshed between two full
+    // selections (see fullSelectionNeeded), so the bridge cannot become root,
+    // and the root port can only be replaced by the port that has changed.
+    if (fullSelectionNeeded)
+    {
+        tryRoot();
+        return;
+    }
+
+    Ieee8021dInterfaceData * port = getPortInterfaceData(portNum);
+
+    if (isRoot)
+    {
+        if (compareBridgeIDs(port->getRootPriority(), port->getRootAddress(), bridgePriority, bridgeAddress) > 0)
+            tryRoot(); // better root found
+        else
+            setRootBridgeParameters();
+        return;
+    }
+
+    if (portNum == rootPort)
+    {
+        if (port->getRootPriority() != rootPriority || port->getRootAddress() != rootAddress
+                || port->getRootPathCost() != rootPathCost)
+            tryRoot(); // the root path changed, all designated ports must be reconsidered
+        else
+        {
+            currentMaxAge = port->getMaxAge();
+            currentFwdDelay = port->getFwdDelay();
+            currentHelloTime = port->getHelloTime();
+        }
+        return;
+    }
+
+    if (isBetterRootPort(portNum, rootPort))
+    {
+        tryRoot();
+        return;
+    }
+
+    // the root path is unchanged, only the role of this port can change
+    Ieee8021dInterfaceData bridgeGlobal;
+    bridgeGlobal.setBridgePriority(bridgePriority);
+    bridgeGlobal.setBridgeAddress(bridgeAddress);
+    bridgeGlobal.setRootAddress(rootAddress);
+    bridgeGlobal.setRootPriority(rootPriority);
+
+    port->setRole(Ieee8021dInterfaceData::NOTASSIGNED);
+    std::vector<unsigned int>::iterator it = std::lower_bound(desPorts.begin(), desPorts.end(), portNum);
+    if (it != desPorts.end() && *it == portNum)
+        it = desPorts.erase(it);
+    if (selectDesignatedPort(portNum, &bridgeGlobal))
+        desPorts.insert(it, portNum);
+}
+
+bool STP::isBetterRootPort(unsigned int portA, unsigned int portB)
+{
+    // same order as in selectRootPort()
+    Ieee8021dInterfaceData * a = getPortInterfaceData(portA);
+    Ieee8021dInterfaceData * b = getPortInterfaceData(portB);
+    int result = comparePorts(a, b);
+    if (result != 0)
+        return result > 0;
+    if (a->getPriority() != b->getPriority())
+        return a->getPriority() < b->getPriority();
+    return portA < portB;
+}
+
 int STP::compareBridgeIDs(unsigned int aPriority, MACAddress aAddress, unsigned int bPriority, MACAddress bAddress)
 {
     if (aPriority < bPriority)
@@ -621,44 +693,44 @@ void STP::selectDesignatedPorts()
 {
     // select designated ports
     desPorts.clear();
-    Ieee8021dInterfaceData * port;
-    Ieee8021dInterfaceData * bridgeGlobal = new Ieee8021dInterfaceData();
-    int result;
+    Ieee8021dInterfaceData bridgeGlobal;
 
-    bridgeGlobal->setBridgePriority(bridgePriority);
-    bridgeGlobal->setBridgeAddress(bridgeAddress);
-    bridgeGlobal->setRootAddress(rootAddress);
-    bridgeGlobal->setRootPriority(rootPriority);
+    bridgeGlobal.setBridgePriority(bridgePriority);
+    bridgeGlobal.setBridgeAddress(bridgeAddress);
+    bridgeGlobal.setRootAddress(rootAddress);
+    bridgeGlobal.setRootPriority(rootPriority);
 
     for (unsigned int i = 0; i < numPorts; i++)
-    {
-        port = getPortInterfaceData(i);
+        if (selectDesignatedPort(i, &bridgeGlobal))
+            desPorts.push_back(i);
+}
 
-        if (port->getRole() == Ieee8021dInterfaceData::ROOT || port->getRole() == Ieee8021dInterfaceData::DISABLED)
-            continue;
+bool STP::selectDesignatedPort(unsigned int portNum, Ieee8021dInterfaceData * bridgeGlobal)
+{
+    Ieee8021dInterfaceData * port = getPortInterfaceData(portNum);
 
-        bridgeGlobal->setPortPriority(port->getPriority());
-        bridgeGlobal->setPortNum(i);
+    if (port->getRole() == Ieee8021dInterfaceData::ROOT || port->getRole() == Ieee8021dInterfaceData::DISABLED)
+        return false;
 
-        bridgeGlobal->setRootPathCost(rootPathCost + port->getLinkCost());
+    bridgeGlobal->setPortPriority(port->getPriority());
+    bridgeGlobal->setPortNum(portNum);
 
-        result = comparePorts(bridgeGlobal, port);
+    bridgeGlobal->setRootPathCost(rootPathCost + port->getLinkCost());
 
-        if (result > 0)
-        {
-            EV_DETAIL<< "Port=" << i << " is elected as designated port." << endl;
-            desPorts.push_back(i);
-            port->setRole(Ieee8021dInterfaceData::DESIGNATED);
-            continue;
-        }
-        if (result < 0)
-        {
-            EV_DETAIL<< "Port=" << i << " goes into alternate role." << endl;
-            port->setRole(Ieee8021dInterfaceData::ALTERNATE);
-            continue;
-        }
+    int result = comparePorts(bridgeGlobal, port);
+
+    if (result > 0)
+    {
+        EV_DETAIL<< "Port=" << portNum << " is elected as designated port." << endl;
+        port->setRole(Ieee8021dInterfaceData::DESIGNATED);
+        return true;
     }
-    delete bridgeGlobal;
+    if (result < 0)
+    {
+        EV_DETAIL<< "Port=" << portNum << " goes into alternate role." << endl;
+        port->setRole(Ieee8021dInterfaceData::ALTERNATE);
+    }
+    return false;
 }
 
 void STP::setAllDesignated()
@@ -702,6 +774,7 @@ void STP::reset()
     currentMaxAge = maxAge;
     currentFwdDelay = forwardDelay;
     setAllDesignated();
+    fullSelectionNeeded = true;
 }
 
 void STP::start()
@@ -713,6 +786,7 @@ void STP::start()
     isRoot = true;
     topologyChangeNotification = true;
     topologyChangeRecvd = true;
+    fullSelectionNeeded = true;
     rootPriority = bridgePriority;
     rootAddress = bridgeAddress;
     rootPathCost = 0;
@@ -748,4 +822,7 @@ void STP::initInterfacedata(unsigned int portNum)
     ifd->setPortPriority(-1);
     ifd->setPortNum(-1);
     ifd->setLostBPDU(0);
+
+    // the port information may have become worse
+    fullSelectionNeeded = true;
 }
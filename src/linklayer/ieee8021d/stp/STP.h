@@ -60,6 +60,11 @@ class INET_API STP : public STPBase
         bool topologyChangeNotification;
         bool topologyChangeRecvd;
 
+        // Set when port information may have become worse, or roles were
+        // changed without a full root port and designated port selection;
+        // until the next tryRoot(), BPDUs cannot be handled incrementally
+        bool fullSelectionNeeded;
+
         PortInfo defaultPort;
         cMessage * tick;
 
@@ -125,6 +130,17 @@ class INET_API STP : public STPBase
         void initPortTable();
         void selectRootPort();
         void selectDesignatedPorts();
+        bool selectDesignatedPort(unsigned int portNum, Ieee8021dInterfaceData * bridgeGlobal);
+
+        /*
+         * Updates the port roles after the port information of the given port
+         * has been refreshed or improved by a BPDU. Produces the same result
+         * as tryRoot(), but only the given port is reconsidered unless the
+         * root port or the root bridge changes.
+         */
+        void updatePortRoles(unsigned int portNum);
+        bool isBetterRootPort(unsigned int portA, unsigned int portB);
+        void setRootBridgeParameters();
 
         /*
          * Set all ports to designated (for root switch)
@@ -36,6 +36,10 @@ STPTester::~STPTester()
 void STPTester::initialize()
 {
     checkTime=par("checkTime");
+    wasTree = false;
+    convergenceTime = SIMTIME_ZERO;
+    WATCH(wasTree);
+    WATCH(convergenceTime);
     scheduleAt(simTime() + checkTime, checkTimer);
 }
 
@@ -54,6 +58,9 @@ void STPTester::handleMessage(cMessage *msg)
             EV_DEBUG<<"Not all nodes are connected with each other"<<endl;
         if(isTreeGraph())
             EV_DEBUG<<"The network topology is a tree topology"<<endl;
+        if (isTreeGraph() && !wasTree)
+            convergenceTime = simTime();
+        wasTree = isTreeGraph();
         scheduleAt(simTime() + checkTime, msg);
     }
     else
@@ -61,6 +68,13 @@ void STPTester::handleMessage(cMessage *msg)
         opp_error("This module only handle selfmessages");
     }
 }
+void STPTester::finish()
+{
+    recordScalar("converged", wasTree);
+    if (wasTree)
+        recordScalar("convergence time", convergenceTime);
+}
+
 void STPTester::depthFirstSearch()
 {
     loop = false;
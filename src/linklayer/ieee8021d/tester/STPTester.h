@@ -31,6 +31,9 @@
  * enabled (state=FORWARDING) links only. Then it analyzes the resulting graph
  * for connectedness and loop free-ness, using a modified depth-first search
  * with cycle detection. The results can be obtained with getter methods.
+ *
+ * The check is repeated periodically; the time of the check since which the
+ * network has been a tree is recorded as the convergence time in finish().
  */
 // TODO: this module should be moved into the test folder somewhere
 class INET_API STPTester : public cSimpleModule
@@ -52,12 +55,16 @@ class INET_API STPTester : public cSimpleModule
         simtime_t checkTime;
         cMessage* checkTimer;
 
+        bool wasTree;                 // result of the previous check
+        simtime_t convergenceTime;    // time of the check since which the network is a tree
+
     public:
         // Includes network topology extraction
         STPTester();
         ~STPTester();
         virtual void initialize();
         virtual void handleMessage(cMessage *msg);
+        virtual void finish();
 
     protected:
         void dfsVisit(Topology::Node * node);
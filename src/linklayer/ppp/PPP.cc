@@ -27,6 +27,7 @@
 #include "NotificationBoard.h"
 #include "NotifierConsts.h"
 #include "NodeOperations.h"
+#include "SegmentationOffload.h"
 
 
 Define_Module(PPP);
@@ -95,6 +96,15 @@ void PPP::initialize(int stage)
         // if we're connected, get the gate with transmission rate
         datarateChannel = connected ? physOutGate->getTransmissionChannel() : NULL;
 
+        // in a parallel simulation, the delay of a link to an other partition provides the lookahead
+        if (connected && physOutGate->getPathEndGate()->getOwnerModule()->isPlaceholder())
+        {
+            cDatarateChannel *channel = dynamic_cast<cDatarateChannel *>(datarateChannel);
+            if (channel && channel->getDelay() == 0)
+                throw cRuntimeError("The channel %s connects to an other partition, it must have nonzero delay",
+                        channel->getFullPath().c_str());
+        }
+
         // register our interface entry in IInterfaceTable
         registerInterface();
 
@@ -154,6 +164,7 @@ InterfaceEntry *PPP::createInterfaceEntry()
     // capabilities
     e->setMulticast(true);
     e->setPointToPoint(true);
+    e->setSegmentationOffload(true);
 
     return e;
 }
@@ -201,24 +212,22 @@ void PPP::refreshOutGateConnection(bool connected)
                 datarateChannel->forceTransmissionFinishTime(SIMTIME_ZERO);
         }
 
+        // Clear inner queue (with an external queue, it may hold the pieces of a super-segment)
+        while (!txQueue.empty())
+        {
+            cMessage *msg = check_and_cast<cMessage *>(txQueue.pop());
+            EV << "Interface is not connected, dropping packet " << msg << endl;
+            numDroppedIfaceDown++;
+            emit(dropPkIfaceDownSignal, msg);
+            delete msg;
+        }
+
         if (queueModule)
         {
             // Clear external queue: send a request, and received packet will be deleted in handleMessage()
             if (0 == queueModule->getNumPendingRequests())
                 queueModule->requestPacket();
         }
-        else
-        {
-            //Clear inner queue
-            while (!txQueue.empty())
-            {
-                cMessage *msg = check_and_cast<cMessage *>(txQueue.pop());
-                EV << "Interface is not connected, dropping packet " << msg << endl;
-                numDroppedIfaceDown++;
-                emit(dropPkIfaceDownSignal, msg);
-                delete msg;
-            }
-        }
     }
 
     cChannel* oldChannel = datarateChannel;
@@ -260,6 +269,25 @@ void PPP::startTransmitting(cPacket *msg)
 {
     // if there's any control info, remove it; then encapsulate the packet
     delete msg->removeControlInfo();
+
+    // TCP super-segment: split it, transmit the first piece now and
+    // the others right after it, ahead of anything else in txQueue
+    if (SegmentationOffload::getSegmentCount(msg) > 1)
+    {
+        std::vector<cPacket *> pieces;
+        SegmentationOffload::split(msg, pieces);
+        EV << "Splitting super-segment into " << pieces.size() << " packets\n";
+
+        for (int i = pieces.size() - 1; i > 0; i--)
+        {
+            if (txQueue.empty())
+                txQueue.insert(pieces[i]);
+            else
+                txQueue.insertBefore(txQueue.front(), pieces[i]);
+        }
+        msg = pieces[0];
+    }
+
     PPPFrame *pppFrame = encapsulate(msg);
 
     if (ev.isGUI())
@@ -463,6 +491,12 @@ cPacket *PPP::decapsulate(PPPFrame *pppFrame)
 void PPP::flushQueue()
 {
     // code would look slightly nicer with a pop() function that returns NULL if empty
+    // (txQueue is also used with an external queue, for the pieces of a super-segment)
+    while (!txQueue.empty()) {
+        cMessage *msg = (cMessage *)txQueue.pop();
+        emit(dropPkIfaceDownSignal, msg);  //FIXME this signal lumps together packets from the network and packets from higher layers! separate them
+        delete msg;
+    }
     if (queueModule)
     {
         while (!queueModule->isEmpty()) {
@@ -473,27 +507,17 @@ void PPP::flushQueue()
         queueModule->clear(); // clear request count
         queueModule->requestPacket();
     }
-    else
-    {
-        while (!txQueue.empty()) {
-            cMessage *msg = (cMessage *)txQueue.pop();
-            emit(dropPkIfaceDownSignal, msg);  //FIXME this signal lumps together packets from the network and packets from higher layers! separate them
-            delete msg;
-        }
-    }
 }
 
 void PPP::clearQueue()
 {
     // code would look slightly nicer with a pop() function that returns NULL if empty
+    // (txQueue is also used with an external queue, for the pieces of a super-segment)
+    txQueue.clear();
     if (queueModule)
     {
         queueModule->clear(); // clear request count
         queueModule->requestPacket();
     }
-    else
-    {
-        txQueue.clear();
-    }
 }
 
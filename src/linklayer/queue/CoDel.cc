@@ -0,0 +1,105 @@
+//
+// Copyright (C) 2026 OpenSim Ltd
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program; if not, see <http://www.gnu.org/licenses/>.
+//
+
+#include "CoDel.h"
+
+
+void CoDel::configure(simtime_t target, simtime_t interval, int64 mtu)
+{
+    if (target <= 0 || interval <= 0)
+        throw cRuntimeError("CoDel: target and interval must be positive");
+    this->target = target;
+    this->interval = interval;
+    this->mtu = mtu;
+    reset();
+}
+
+void CoDel::reset()
+{
+    firstAboveTime = SIMTIME_ZERO;
+    dropNext = SIMTIME_ZERO;
+    count = 0;
+    lastCount = 0;
+    dropping = false;
+}
+
+cPacket *CoDel::doDequeue(cPacketQueue& queue, bool& okToDrop)
+{
+    okToDrop = false;
+    if (queue.empty())
+    {
+        firstAboveTime = SIMTIME_ZERO;
+        return NULL;
+    }
+
+    cPacket *packet = queue.pop();
+
+    simtime_t now = simTime();
+    simtime_t sojournTime = now - packet->getArrivalTime();
+    if (sojournTime < target || queue.getByteLength() <= mtu)
+    {
+        // went below target, or there is not enough in the queue to build a standing queue
+        firstAboveTime = SIMTIME_ZERO;
+    }
+    else if (firstAboveTime == SIMTIME_ZERO)
+    {
+        firstAboveTime = now + interval;
+    }
+    else if (now >= firstAboveTime)
+    {
+        okToDrop = true;
+    }
+    return packet;
+}
+
+cPacket *CoDel::dequeue(cPacketQueue& queue, std::vector<cPacket *>& droppedPackets)
+{
+    simtime_t now = simTime();
+    bool okToDrop;
+    cPacket *packet = doDequeue(queue, okToDrop);
+
+    if (dropping)
+    {
+        if (!okToDrop)
+            dropping = false;
+        while (dropping && now >= dropNext)
+        {
+            droppedPackets.push_back(packet);
+            count++;
+            packet = doDequeue(queue, okToDrop);
+            if (!okToDrop)
+                dropping = false;
+            else
+                dropNext = controlLaw(dropNext);
+        }
+    }
+    else if (okToDrop)
+    {
+        droppedPackets.push_back(packet);
+        packet = doDequeue(queue, okToDrop);
+        dropping = true;
+
+        // if the last dropping state ended recently, continue with a drop
+        // rate close to the one that controlled the queue then
+        unsigned int delta = count - lastCount;
+        count = (delta > 1 && now - dropNext < 16 * interval) ? delta : 1;
+        dropNext = controlLaw(now);
+        lastCount = count;
+    }
+    return packet;
+}
+
@@ -0,0 +1,74 @@
+//
+// Copyright (C) 2026 OpenSim Ltd
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program; if not, see <http://www.gnu.org/licenses/>.
+//
+
+#ifndef __INET_CODEL_H
+#define __INET_CODEL_H
+
+#include <vector>
+
+#include "INETDefs.h"
+
+
+/**
+ * The dequeue side of the Controlled Delay (CoDel) AQM algorithm, RFC 8289.
+ * Used by CoDelQueue for its single queue, and by FQCoDelQueue for each flow.
+ *
+ * The sojourn time of a packet is measured from its arrival time, which
+ * PassiveQueueBase sets when the packet is enqueued. When the sojourn time
+ * has been above target for at least an interval, packets are dropped at
+ * the head of the queue, with the interval between drops decreasing with
+ * the square root of the number of drops, until the sojourn time falls
+ * below target again.
+ */
+class INET_API CoDel
+{
+  protected:
+    // configuration
+    simtime_t target;
+    simtime_t interval;
+    int64 mtu;
+
+    // state
+    simtime_t firstAboveTime;   // when the sojourn time will have been above target for an interval, or 0
+    simtime_t dropNext;         // time of the next drop in dropping state
+    unsigned int count;         // number of drops since entering dropping state
+    unsigned int lastCount;     // count when the dropping state was last left
+    bool dropping;
+
+  protected:
+    simtime_t controlLaw(simtime_t t) const { return t + interval / sqrt((double)count); }
+    cPacket *doDequeue(cPacketQueue& queue, bool& okToDrop);
+
+  public:
+    CoDel() : target(0.005), interval(0.1), mtu(1500) { reset(); }
+
+    void configure(simtime_t target, simtime_t interval, int64 mtu);
+    void reset();
+
+    /**
+     * Removes and returns the next packet of the queue that is not dropped,
+     * or NULL if the queue becomes empty. The packets dropped by CoDel are
+     * appended to droppedPackets, and the caller is responsible for them.
+     */
+    cPacket *dequeue(cPacketQueue& queue, std::vector<cPacket *>& droppedPackets);
+
+    bool isDropping() const { return dropping; }
+    unsigned int getDropCount() const { return count; }
+};
+
+#endif
+
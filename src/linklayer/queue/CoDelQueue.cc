@@ -0,0 +1,96 @@
+//
+// Copyright (C) 2026 OpenSim Ltd
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program; if not, see <http://www.gnu.org/licenses/>.
+//
+
+#include "INETDefs.h"
+
+#include "CoDelQueue.h"
+
+
+Define_Module(CoDelQueue);
+
+simsignal_t CoDelQueue::queueLengthSignal = registerSignal("queueLength");
+simsignal_t CoDelQueue::sojournTimeSignal = registerSignal("sojournTime");
+
+void CoDelQueue::initialize()
+{
+    PassiveQueueBase::initialize();
+
+    queue.setName(par("queueName"));
+
+    //statistics
+    numCoDelDropped = 0;
+    WATCH(numCoDelDropped);
+    emit(queueLengthSignal, queue.length());
+
+    outGate = gate("out");
+
+    // configuration
+    frameCapacity = par("frameCapacity");
+    codel.configure(par("target").doubleValue(), par("interval").doubleValue(), par("mtu").longValue());
+}
+
+cMessage *CoDelQueue::enqueue(cMessage *msg)
+{
+    if (frameCapacity && queue.length() >= frameCapacity)
+    {
+        EV << "Queue full, dropping packet.\n";
+        return msg;
+    }
+
+    queue.insert(PK(msg));
+    emit(queueLengthSignal, queue.length());
+    return NULL;
+}
+
+cMessage *CoDelQueue::dequeue()
+{
+    std::vector<cPacket *> droppedPackets;
+    cPacket *packet = codel.dequeue(queue, droppedPackets);
+
+    for (unsigned int i = 0; i < droppedPackets.size(); i++)
+    {
+        EV << "CoDel dropping packet " << droppedPackets[i]->getName() << ", sojourn time "
+           << simTime() - droppedPackets[i]->getArrivalTime() << "\n";
+        numCoDelDropped++;
+        numQueueDropped++;
+        emit(dropPkByQueueSignal, droppedPackets[i]);
+        delete droppedPackets[i];
+    }
+
+    // statistics
+    emit(queueLengthSignal, queue.length());
+    if (packet)
+        emit(sojournTimeSignal, simTime() - packet->getArrivalTime());
+
+    return packet;
+}
+
+void CoDelQueue::sendOut(cMessage *msg)
+{
+    send(msg, outGate);
+}
+
+bool CoDelQueue::isEmpty()
+{
+    return queue.empty();
+}
+
+void CoDelQueue::finish()
+{
+    PassiveQueueBase::finish();
+    recordScalar("packets dropped by CoDel", numCoDelDropped);
+}
@@ -0,0 +1,70 @@
+//
+// Copyright (C) 2026 OpenSim Ltd
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program; if not, see <http://www.gnu.org/licenses/>.
+//
+
+#ifndef __INET_CODELQUEUE_H
+#define __INET_CODELQUEUE_H
+
+#include "INETDefs.h"
+
+#include "PassiveQueueBase.h"
+#include "CoDel.h"
+
+/**
+ * Queue with CoDel active queue management. See NED for more info.
+ */
+class INET_API CoDelQueue : public PassiveQueueBase
+{
+  protected:
+    // configuration
+    int frameCapacity;
+
+    // state
+    cPacketQueue queue;
+    CoDel codel;
+    cGate *outGate;
+
+    // statistics
+    int numCoDelDropped;
+    static simsignal_t queueLengthSignal;
+    static simsignal_t sojournTimeSignal;
+
+  protected:
+    virtual void initialize();
+    virtual void finish();
+
+    /**
+     * Redefined from PassiveQueueBase.
+     */
+    virtual cMessage *enqueue(cMessage *msg);
+
+    /**
+     * Redefined from PassiveQueueBase.
+     */
+    virtual cMessage *dequeue();
+
+    /**
+     * Redefined from PassiveQueueBase.
+     */
+    virtual void sendOut(cMessage *msg);
+
+    /**
+     * Redefined from IPassiveQueue.
+     */
+    virtual bool isEmpty();
+};
+
+#endif
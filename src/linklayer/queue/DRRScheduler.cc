@@ -0,0 +1,110 @@
+//
+// Copyright (C) 2026 OpenSim Ltd
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program; if not, see <http://www.gnu.org/licenses/>.
+//
+
+#include "DRRScheduler.h"
+#include "opp_utils.h"
+
+Define_Module(DRRScheduler);
+
+void DRRScheduler::initialize()
+{
+    SchedulerBase::initialize();
+
+    numInputs = gateSize("in");
+    ASSERT(numInputs == (int)inputQueues.size());
+
+    cStringTokenizer tokenizer(par("quanta"));
+    for (int i = 0; i < numInputs; ++i)
+    {
+        int quantum = tokenizer.hasMoreTokens() ? (int)OPP_Global::atoul(tokenizer.nextToken()) : (i > 0 ? quanta[i-1] : 0);
+        if (quantum <= 0)
+            throw cRuntimeError("Quantum of input %d must be positive", i);
+        quanta.push_back(quantum);
+    }
+    if (tokenizer.hasMoreTokens())
+        throw cRuntimeError("Too many values given in the quanta parameter.");
+
+    deficits.assign(numInputs, 0);
+    isActive.assign(numInputs, false);
+    for (int i = 0; i < numInputs; ++i)
+        if (!inputQueues[i]->isEmpty())
+            activateInput(i);
+
+    initClassStatistics();
+}
+
+void DRRScheduler::finish()
+{
+    recordClassStatistics();
+}
+
+void DRRScheduler::activateInput(int i)
+{
+    if (!isActive[i])
+    {
+        isActive[i] = true;
+        activeInputs.push_back(i);
+    }
+}
+
+void DRRScheduler::packetEnqueued(IPassiveQueue *inputQueue)
+{
+    Enter_Method("packetEnqueued(...)");
+
+    int i = getInputIndex(inputQueue);
+    if (i >= 0)
+        activateInput(i);
+    SchedulerBase::packetEnqueued(inputQueue);
+}
+
+bool DRRScheduler::schedulePacket()
+{
+    // The length of the packet at the head of an input is not known until
+    // it arrives, so the deficit counter is charged afterwards, and an input
+    // may be served as long as its counter is positive. The counter can go
+    // negative by at most one packet; that is paid back in the next round.
+    while (!activeInputs.empty())
+    {
+        int i = activeInputs.front();
+        if (inputQueues[i]->isEmpty())
+        {
+            // an idle input does not keep its credit (but keeps its debt)
+            activeInputs.pop_front();
+            isActive[i] = false;
+            if (deficits[i] > 0)
+                deficits[i] = 0;
+        }
+        else if (deficits[i] <= 0)
+        {
+            deficits[i] += quanta[i];
+            activeInputs.pop_front();
+            activeInputs.push_back(i);
+        }
+        else
+        {
+            inputQueues[i]->requestPacket();
+            return true;
+        }
+    }
+    return false;
+}
+
+void DRRScheduler::handleMessage(cMessage *msg)
+{
+    deficits[msg->getArrivalGate()->getIndex()] -= PK(msg)->getByteLength();
+    SchedulerBase::handleMessage(msg);
+}
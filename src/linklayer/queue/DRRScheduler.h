@@ -0,0 +1,53 @@
+//
+// Copyright (C) 2026 OpenSim Ltd
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program; if not, see <http://www.gnu.org/licenses/>.
+//
+
+#ifndef __INET_DRRSCHEDULER_H_
+#define __INET_DRRSCHEDULER_H_
+
+#include <list>
+#include <vector>
+
+#include "INETDefs.h"
+#include "SchedulerBase.h"
+
+/**
+ * This module implements a Deficit Round Robin Scheduler.
+ */
+class INET_API DRRScheduler : public SchedulerBase
+{
+  protected:
+    int numInputs;                 // number of input gates
+    std::vector<int> quanta;       // bytes added to the deficit counter in each round
+    std::vector<int> deficits;     // deficit counters in bytes, may be negative
+    std::vector<bool> isActive;    // whether the input is on the active list
+    std::list<int> activeInputs;   // round robin order of the inputs that have packets
+
+  public:
+    DRRScheduler() : numInputs(0) {}
+
+  protected:
+    virtual void initialize();
+    virtual void finish();
+    virtual void handleMessage(cMessage *msg);
+    virtual bool schedulePacket();
+    virtual void activateInput(int i);
+
+  public:
+    virtual void packetEnqueued(IPassiveQueue *inputQueue);
+};
+
+#endif
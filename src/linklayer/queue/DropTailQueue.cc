@@ -19,6 +19,7 @@
 #include "INETDefs.h"
 
 #include "DropTailQueue.h"
+#include "SegmentationOffload.h"
 
 
 Define_Module(DropTailQueue);
@@ -30,6 +31,8 @@ void DropTailQueue::initialize()
     PassiveQueueBase::initialize();
 
     queue.setName(par("queueName"));
+    numFrames = 0;
+    WATCH(numFrames);
 
     //statistics
     emit(queueLengthSignal, queue.length());
@@ -42,7 +45,8 @@ void DropTailQueue::initialize()
 
 cMessage *DropTailQueue::enqueue(cMessage *msg)
 {
-    if (frameCapacity && queue.length() >= frameCapacity)
+    int frames = SegmentationOffload::getSegmentCount(PK(msg));
+    if (frameCapacity && numFrames + frames > frameCapacity)
     {
         EV << "Queue full, dropping packet.\n";
         return msg;
@@ -50,6 +54,7 @@ cMessage *DropTailQueue::enqueue(cMessage *msg)
     else
     {
         queue.insert(msg);
+        numFrames += frames;
         emit(queueLengthSignal, queue.length());
         return NULL;
     }
@@ -60,7 +65,8 @@ cMessage *DropTailQueue::dequeue()
     if (queue.empty())
         return NULL;
 
-    cMessage *msg = (cMessage *)queue.pop();
+    cPacket *msg = (cPacket *)queue.pop();
+    numFrames -= SegmentationOffload::getSegmentCount(msg);
 
     // statistics
     emit(queueLengthSignal, queue.length());
@@ -34,6 +34,7 @@ class INET_API DropTailQueue : public PassiveQueueBase
 
     // state
     cQueue queue;
+    int numFrames;    // frames in the queue; a TCP super-segment counts as the segments it carries
     cGate *outGate;
 
     // statistics
@@ -0,0 +1,87 @@
+//
+// Copyright (C) 2026 OpenSim Ltd
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program; if not, see <http://www.gnu.org/licenses/>.
+//
+
+
+#include "INETDefs.h"
+
+#include "DropTailRingQueue.h"
+#include "SegmentationOffload.h"
+
+
+Define_Module(DropTailRingQueue);
+
+simsignal_t DropTailRingQueue::queueLengthSignal = registerSignal("queueLength");
+
+void DropTailRingQueue::initialize()
+{
+    PassiveQueueBase::initialize();
+
+    queue.setName(par("queueName"));
+    numFrames = 0;
+    WATCH(numFrames);
+
+    //statistics
+    emit(queueLengthSignal, queue.length());
+
+    outGate = gate("out");
+
+    // configuration
+    frameCapacity = par("frameCapacity");
+    queue.setCapacity(frameCapacity, par("byteCapacity").longValue());
+}
+
+cMessage *DropTailRingQueue::enqueue(cMessage *msg)
+{
+    cPacket *packet = PK(msg);
+    int frames = SegmentationOffload::getSegmentCount(packet);
+    if ((frameCapacity && numFrames + frames > frameCapacity) || queue.wouldOverflow(packet))
+    {
+        EV << "Queue full, dropping packet.\n";
+        return msg;
+    }
+    else
+    {
+        queue.insert(packet);
+        numFrames += frames;
+        emit(queueLengthSignal, queue.length());
+        return NULL;
+    }
+}
+
+cMessage *DropTailRingQueue::dequeue()
+{
+    if (queue.empty())
+        return NULL;
+
+    cPacket *msg = queue.pop();
+    numFrames -= SegmentationOffload::getSegmentCount(msg);
+
+    // statistics
+    emit(queueLengthSignal, queue.length());
+
+    return msg;
+}
+
+void DropTailRingQueue::sendOut(cMessage *msg)
+{
+    send(msg, outGate);
+}
+
+bool DropTailRingQueue::isEmpty()
+{
+    return queue.empty();
+}
@@ -0,0 +1,261 @@
+//
+// Copyright (C) 2026 OpenSim Ltd
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program; if not, see <http://www.gnu.org/licenses/>.
+//
+
+#include "INETDefs.h"
+
+#include "FQCoDelQueue.h"
+#ifdef WITH_IPv4
+  #include "IPv4Datagram.h"
+#endif
+#ifdef WITH_IPv6
+  #include "IPv6Datagram.h"
+#endif
+#ifdef WITH_UDP
+  #include "UDPPacket_m.h"
+#endif
+#ifdef WITH_TCP_COMMON
+  #include "TCPSegment.h"
+#endif
+
+
+Define_Module(FQCoDelQueue);
+
+simsignal_t FQCoDelQueue::queueLengthSignal = registerSignal("queueLength");
+simsignal_t FQCoDelQueue::sojournTimeSignal = registerSignal("sojournTime");
+
+static inline uint32 hashWord(uint32 hash, uint32 word)
+{
+    return (hash ^ word) * 16777619;
+}
+
+FQCoDelQueue::~FQCoDelQueue()
+{
+    for (unsigned int i = 0; i < flows.size(); i++)
+        delete flows[i];
+}
+
+void FQCoDelQueue::initialize()
+{
+    PassiveQueueBase::initialize();
+
+    queueLength = 0;
+    queueBytes = 0;
+
+    //statistics
+    numCoDelDropped = 0;
+    numOverflowDropped = 0;
+    WATCH(queueLength);
+    WATCH(queueBytes);
+    WATCH(numCoDelDropped);
+    WATCH(numOverflowDropped);
+    emit(queueLengthSignal, queueLength);
+
+    outGate = gate("out");
+
+    // configuration
+    frameCapacity = par("frameCapacity");
+    quantum = par("quantum");
+    if (quantum <= 0)
+        throw cRuntimeError("quantum must be positive");
+    int numFlows = par("numFlows");
+    if (numFlows <= 0)
+        throw cRuntimeError("numFlows must be positive");
+    simtime_t target = par("target").doubleValue();
+    simtime_t interval = par("interval").doubleValue();
+    int64 mtu = par("mtu").longValue();
+    for (int i = 0; i < numFlows; i++)
+    {
+        Flow *flow = new Flow();
+        flow->codel.configure(target, interval, mtu);
+        flows.push_back(flow);
+    }
+}
+
+int FQCoDelQueue::classifyPacket(cPacket *packet)
+{
+    uint32 hash = 2166136261u;
+    bool found = false;
+    for (cPacket *p = packet; p && !found; p = p->getEncapsulatedPacket())
+    {
+        cPacket *transportPacket = NULL;
+#ifdef WITH_IPv4
+        if (IPv4Datagram *datagram = dynamic_cast<IPv4Datagram *>(p))
+        {
+            hash = hashWord(hash, datagram->getSrcAddress().getInt());
+            hash = hashWord(hash, datagram->getDestAddress().getInt());
+            hash = hashWord(hash, datagram->getTransportProtocol());
+            transportPacket = datagram->getEncapsulatedPacket();
+            found = true;
+        }
+#endif
+#ifdef WITH_IPv6
+        if (IPv6Datagram *datagram = dynamic_cast<IPv6Datagram *>(p))
+        {
+            for (int i = 0; i < 4; i++)
+                hash = hashWord(hash, datagram->getSrcAddress().words()[i]);
+            for (int i = 0; i < 4; i++)
+                hash = hashWord(hash, datagram->getDestAddress().words()[i]);
+            hash = hashWord(hash, datagram->getTransportProtocol());
+            transportPacket = datagram->getEncapsulatedPacket();
+            found = true;
+        }
+#endif
+#ifdef WITH_UDP
+        if (UDPPacket *udp = dynamic_cast<UDPPacket *>(transportPacket))
+            hash = hashWord(hash, (udp->getSourcePort() << 16) | udp->getDestinationPort());
+#endif
+#ifdef WITH_TCP_COMMON
+        if (TCPSegment *tcp = dynamic_cast<TCPSegment *>(transportPacket))
+            hash = hashWord(hash, (tcp->getSrcPort() << 16) | tcp->getDestPort());
+#endif
+        (void)transportPacket;
+    }
+    if (!found)
+        return 0;
+
+    // final avalanche, so that the low bits depend on all input bits
+    hash ^= hash >> 16;
+    hash *= 0x85ebca6bu;
+    hash ^= hash >> 13;
+    hash *= 0xc2b2ae35u;
+    hash ^= hash >> 16;
+    return hash % flows.size();
+}
+
+cPacket *FQCoDelQueue::dropFromLongestFlow()
+{
+    Flow *longestFlow = NULL;
+    for (unsigned int i = 0; i < flows.size(); i++)
+        if (!longestFlow || flows[i]->queue.getByteLength() > longestFlow->queue.getByteLength())
+            longestFlow = flows[i];
+
+    ASSERT(longestFlow && !longestFlow->queue.empty());
+    cPacket *packet = longestFlow->queue.pop();
+    queueBytes -= packet->getByteLength();
+    queueLength--;
+    return packet;
+}
+
+cMessage *FQCoDelQueue::enqueue(cMessage *msg)
+{
+    cPacket *packet = PK(msg);
+    int index = classifyPacket(packet);
+    Flow *flow = flows[index];
+
+    flow->queue.insert(packet);
+    queueBytes += packet->getByteLength();
+    queueLength++;
+    if (flow->list == LIST_NONE)
+    {
+        flow->list = LIST_NEW;
+        flow->deficit = quantum;
+        newFlows.push_back(index);
+    }
+
+    if (frameCapacity && queueLength > frameCapacity)
+    {
+        EV << "Queue full, dropping packet of the longest flow.\n";
+        numOverflowDropped++;
+        emit(queueLengthSignal, queueLength - 1);
+        return dropFromLongestFlow();
+    }
+
+    emit(queueLengthSignal, queueLength);
+    return NULL;
+}
+
+cMessage *FQCoDelQueue::dequeue()
+{
+    while (true)
+    {
+        std::list<int> *list;
+        if (!newFlows.empty())
+            list = &newFlows;
+        else if (!oldFlows.empty())
+            list = &oldFlows;
+        else
+            return NULL;
+
+        int index = list->front();
+        Flow *flow = flows[index];
+        if (flow->deficit <= 0)
+        {
+            // used up its quantum in this round
+            flow->deficit += quantum;
+            list->pop_front();
+            oldFlows.push_back(index);
+            flow->list = LIST_OLD;
+            continue;
+        }
+
+        std::vector<cPacket *> droppedPackets;
+        int64 flowBytes = flow->queue.getByteLength();
+        cPacket *packet = flow->codel.dequeue(flow->queue, droppedPackets);
+        queueBytes -= flowBytes - flow->queue.getByteLength();
+        queueLength -= droppedPackets.size() + (packet ? 1 : 0);
+
+        for (unsigned int i = 0; i < droppedPackets.size(); i++)
+        {
+            EV << "CoDel dropping packet " << droppedPackets[i]->getName() << " of flow " << index << ", sojourn time "
+               << simTime() - droppedPackets[i]->getArrivalTime() << "\n";
+            numCoDelDropped++;
+            numQueueDropped++;
+            emit(dropPkByQueueSignal, droppedPackets[i]);
+            delete droppedPackets[i];
+        }
+
+        if (!packet)
+        {
+            // an emptied new flow goes to the end of the old flows, so that
+            // a flow cannot get priority by sending one packet at a time
+            list->pop_front();
+            if (list == &newFlows && !oldFlows.empty())
+            {
+                oldFlows.push_back(index);
+                flow->list = LIST_OLD;
+            }
+            else
+                flow->list = LIST_NONE;
+            continue;
+        }
+
+        flow->deficit -= packet->getByteLength();
+
+        // statistics
+        emit(queueLengthSignal, queueLength);
+        emit(sojournTimeSignal, simTime() - packet->getArrivalTime());
+
+        return packet;
+    }
+}
+
+void FQCoDelQueue::sendOut(cMessage *msg)
+{
+    send(msg, outGate);
+}
+
+bool FQCoDelQueue::isEmpty()
+{
+    return queueLength == 0;
+}
+
+void FQCoDelQueue::finish()
+{
+    PassiveQueueBase::finish();
+    recordScalar("packets dropped by CoDel", numCoDelDropped);
+    recordScalar("packets dropped on overflow", numOverflowDropped);
+}
@@ -0,0 +1,107 @@
+//
+// Copyright (C) 2026 OpenSim Ltd
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program; if not, see <http://www.gnu.org/licenses/>.
+//
+
+#ifndef __INET_FQCODELQUEUE_H
+#define __INET_FQCODELQUEUE_H
+
+#include <list>
+#include <vector>
+
+#include "INETDefs.h"
+
+#include "PassiveQueueBase.h"
+#include "CoDel.h"
+
+/**
+ * Flow queueing with CoDel (FQ-CoDel). See NED for more info.
+ */
+class INET_API FQCoDelQueue : public PassiveQueueBase
+{
+  protected:
+    enum FlowListId { LIST_NONE, LIST_NEW, LIST_OLD };
+
+    struct Flow
+    {
+        cPacketQueue queue;
+        int deficit;
+        FlowListId list;
+        CoDel codel;
+        Flow() : queue("flow"), deficit(0), list(LIST_NONE) {}
+    };
+
+    // configuration
+    int frameCapacity;
+    int quantum;
+
+    // state
+    std::vector<Flow *> flows;
+    std::list<int> newFlows;    // flows that became active recently, served first
+    std::list<int> oldFlows;
+    int queueLength;            // total number of queued packets
+    int64 queueBytes;           // total number of queued bytes
+    cGate *outGate;
+
+    // statistics
+    int numCoDelDropped;
+    int numOverflowDropped;
+    static simsignal_t queueLengthSignal;
+    static simsignal_t sojournTimeSignal;
+
+  public:
+    FQCoDelQueue() {}
+    virtual ~FQCoDelQueue();
+
+  protected:
+    virtual void initialize();
+    virtual void finish();
+
+    /**
+     * Returns the index of the flow of the packet: a hash of the addresses,
+     * transport protocol and ports of the IPv4 or IPv6 datagram in the
+     * packet (which may be the packet itself or any packet encapsulated in
+     * it), or 0 if it contains no datagram.
+     */
+    virtual int classifyPacket(cPacket *packet);
+
+    /**
+     * Drops the packet at the head of the flow that has the most bytes
+     * queued, and returns it.
+     */
+    virtual cPacket *dropFromLongestFlow();
+
+    /**
+     * Redefined from PassiveQueueBase.
+     */
+    virtual cMessage *enqueue(cMessage *msg);
+
+    /**
+     * Redefined from PassiveQueueBase.
+     */
+    virtual cMessage *dequeue();
+
+    /**
+     * Redefined from PassiveQueueBase.
+     */
+    virtual void sendOut(cMessage *msg);
+
+    /**
+     * Redefined from IPassiveQueue.
+     */
+    virtual bool isEmpty();
+};
+
+#endif
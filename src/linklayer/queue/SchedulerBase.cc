@@ -17,9 +17,12 @@
 //
 
 #include <algorithm>
+#include <sstream>
 
 #include "SchedulerBase.h"
 
+simsignal_t SchedulerBase::queueingTimeSignal = registerSignal("queueingTime");
+
 SchedulerBase::SchedulerBase()
     : packetsRequestedFromUs(0), packetsToBeRequestedFromInputs(0), outGate(NULL)
 {
@@ -27,6 +30,8 @@ SchedulerBase::SchedulerBase()
 
 SchedulerBase::~SchedulerBase()
 {
+    for (unsigned int i = 0; i < classStatistics.size(); i++)
+        delete classStatistics[i].queueingTimeVector;
 }
 
 void SchedulerBase::initialize()
@@ -43,6 +48,7 @@ void SchedulerBase::initialize()
             throw cRuntimeError("Scheduler input gate %d should be connected to an IPassiveQueue", i);
         inputModule->addListener(this);
         inputQueues.push_back(inputModule);
+        inputIndices[connectedGate->getOwnerModule()] = i;
     }
 
     outGate = gate("out");
@@ -56,9 +62,72 @@ void SchedulerBase::finalize()
         (*it)->removeListener(this);
 }
 
+int SchedulerBase::getInputIndex(IPassiveQueue *inputQueue)
+{
+    cComponent *inputModule = dynamic_cast<cComponent *>(inputQueue);
+    std::map<cComponent*, int>::iterator it = inputIndices.find(inputModule);
+    return it != inputIndices.end() ? it->second : -1;
+}
+
+void SchedulerBase::initClassStatistics()
+{
+    classStatistics.resize(inputQueues.size());
+    for (unsigned int i = 0; i < classStatistics.size(); i++)
+    {
+        ClassStatistics& stats = classStatistics[i];
+        stats.numPackets = 0;
+        stats.numBytes = 0;
+        std::stringstream os;
+        os << "queueing time of class " << i;
+        stats.queueingTime.setName(os.str().c_str());
+        stats.queueingTimeVector = new cOutVector(os.str().c_str());
+    }
+    // queues report the queueing time of a packet when they send it to us
+    for (std::map<cComponent*, int>::iterator it = inputIndices.begin(); it != inputIndices.end(); ++it)
+        it->first->subscribe(queueingTimeSignal, this);
+}
+
+void SchedulerBase::recordClassStatistics()
+{
+    simtime_t duration = simTime();
+    for (unsigned int i = 0; i < classStatistics.size(); i++)
+    {
+        ClassStatistics& stats = classStatistics[i];
+        std::stringstream os;
+        os << "class " << i << " ";
+        recordScalar((os.str() + "sent packets").c_str(), stats.numPackets);
+        recordScalar((os.str() + "sent bytes").c_str(), stats.numBytes);
+        if (duration > 0)
+            recordScalar((os.str() + "throughput").c_str(), stats.numBytes * 8 / SIMTIME_DBL(duration));
+        if (stats.queueingTime.getCount() > 0)
+        {
+            recordScalar((os.str() + "mean queueing time").c_str(), stats.queueingTime.getMean());
+            recordScalar((os.str() + "max queueing time").c_str(), stats.queueingTime.getMax());
+        }
+    }
+}
+
+void SchedulerBase::receiveSignal(cComponent *source, simsignal_t signalID, simtime_t_cref t)
+{
+    Enter_Method_Silent();
+
+    std::map<cComponent*, int>::iterator it = inputIndices.find(source);
+    if (signalID == queueingTimeSignal && it != inputIndices.end() && !classStatistics.empty())
+    {
+        classStatistics[it->second].queueingTime.collect(t);
+        classStatistics[it->second].queueingTimeVector->record(t);
+    }
+}
+
 void SchedulerBase::handleMessage(cMessage *msg)
 {
     ASSERT(packetsRequestedFromUs > 0);
+    if (!classStatistics.empty())
+    {
+        ClassStatistics& stats = classStatistics[msg->getArrivalGate()->getIndex()];
+        stats.numPackets++;
+        stats.numBytes += PK(msg)->getByteLength();
+    }
     packetsRequestedFromUs--;
     sendOut(msg);
 }
@@ -19,6 +19,8 @@
 #ifndef SCHEDULERBASE_H_
 #define SCHEDULERBASE_H_
 
+#include <map>
+
 #include "INETDefs.h"
 #include "IPassiveQueue.h"
 
@@ -34,17 +36,34 @@
  * They must be able to notice when a new packet arrives
  * at one of their inputs without dequeueing it, so they
  * hook themselves as listeners on their inputs.
+ *
+ * Subclasses may call initClassStatistics() to collect statistics for each
+ * input (class): the number of packets and bytes sent out, and the queueing
+ * time reported by the input queue in its queueingTime signal.
  */
-class INET_API SchedulerBase : public cSimpleModule, public IPassiveQueue, public IPassiveQueueListener
+class INET_API SchedulerBase : public cSimpleModule, public IPassiveQueue, public IPassiveQueueListener, public cListener
 {
     protected:
+        struct ClassStatistics
+        {
+            long numPackets;
+            int64 numBytes;
+            cStdDev queueingTime;
+            cOutVector *queueingTimeVector;
+        };
+
         // state
         int packetsRequestedFromUs;
         int packetsToBeRequestedFromInputs;
         std::vector<IPassiveQueue*> inputQueues;
+        std::map<cComponent*, int> inputIndices;  // input module -> input gate index
         cGate *outGate;
         std::list<IPassiveQueueListener*> listeners;
 
+        // statistics
+        std::vector<ClassStatistics> classStatistics;  // empty if not collected
+        static simsignal_t queueingTimeSignal;
+
     public:
         SchedulerBase();
         virtual ~SchedulerBase();
@@ -57,6 +76,23 @@ class INET_API SchedulerBase : public cSimpleModule, public IPassiveQueue, publi
       virtual void notifyListeners();
       virtual bool schedulePacket() = 0;
 
+      /**
+       * Returns the index of the input gate the given queue is connected to, or -1.
+       */
+      virtual int getInputIndex(IPassiveQueue *inputQueue);
+
+      /**
+       * Starts collecting per-class statistics; to be called from initialize().
+       */
+      virtual void initClassStatistics();
+
+      /**
+       * Records the per-class statistics as scalars; to be called from finish().
+       */
+      virtual void recordClassStatistics();
+
+      virtual void receiveSignal(cComponent *source, simsignal_t signalID, simtime_t_cref t);
+
     public:
       virtual void requestPacket();
       virtual int getNumPendingRequests() { return packetsRequestedFromUs; }
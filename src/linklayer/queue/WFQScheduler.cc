@@ -0,0 +1,113 @@
+//
+// Copyright (C) 2026 OpenSim Ltd
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program; if not, see <http://www.gnu.org/licenses/>.
+//
+
+#include <algorithm>
+
+#include "WFQScheduler.h"
+#include "opp_utils.h"
+
+Define_Module(WFQScheduler);
+
+void WFQScheduler::initialize()
+{
+    SchedulerBase::initialize();
+
+    numInputs = gateSize("in");
+    ASSERT(numInputs == (int)inputQueues.size());
+
+    cStringTokenizer tokenizer(par("weights"));
+    for (int i = 0; i < numInputs; ++i)
+    {
+        double weight = tokenizer.hasMoreTokens() ? OPP_Global::atod(tokenizer.nextToken()) : (i > 0 ? weights[i-1] : 0);
+        if (weight <= 0)
+            throw cRuntimeError("Weight of input %d must be positive", i);
+        weights.push_back(weight);
+    }
+    if (tokenizer.hasMoreTokens())
+        throw cRuntimeError("Too many values given in the weights parameter.");
+
+    startTags.assign(numInputs, 0);
+    finishTags.assign(numInputs, 0);
+    isBacklogged.assign(numInputs, false);
+    for (int i = 0; i < numInputs; ++i)
+        if (!inputQueues[i]->isEmpty())
+            activateInput(i);
+
+    initClassStatistics();
+}
+
+void WFQScheduler::finish()
+{
+    recordClassStatistics();
+}
+
+void WFQScheduler::activateInput(int i)
+{
+    if (!isBacklogged[i])
+    {
+        isBacklogged[i] = true;
+        startTags[i] = std::max(virtualTime, finishTags[i]);
+        schedule.insert(std::make_pair(startTags[i], i));
+    }
+}
+
+void WFQScheduler::packetEnqueued(IPassiveQueue *inputQueue)
+{
+    Enter_Method("packetEnqueued(...)");
+
+    int i = getInputIndex(inputQueue);
+    if (i >= 0)
+        activateInput(i);
+    SchedulerBase::packetEnqueued(inputQueue);
+}
+
+bool WFQScheduler::schedulePacket()
+{
+    // Start-time fair queueing: the input with the smallest start tag is
+    // served. Unlike finish tags, start tags do not depend on the length of
+    // the packet, which is not known until the packet arrives from the input.
+    while (!schedule.empty())
+    {
+        TagSet::iterator first = schedule.begin();
+        int i = first->second;
+        schedule.erase(first);
+        if (inputQueues[i]->isEmpty())
+        {
+            isBacklogged[i] = false;
+            continue;
+        }
+        // stays backlogged until the packet arrives, see handleMessage()
+        virtualTime = startTags[i];
+        inputQueues[i]->requestPacket();
+        return true;
+    }
+    return false;
+}
+
+void WFQScheduler::handleMessage(cMessage *msg)
+{
+    int i = msg->getArrivalGate()->getIndex();
+    finishTags[i] = startTags[i] + PK(msg)->getByteLength() / weights[i];
+    if (!inputQueues[i]->isEmpty())
+    {
+        startTags[i] = finishTags[i];
+        schedule.insert(std::make_pair(startTags[i], i));
+    }
+    else
+        isBacklogged[i] = false;
+    SchedulerBase::handleMessage(msg);
+}
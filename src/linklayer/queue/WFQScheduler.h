@@ -0,0 +1,58 @@
+//
+// Copyright (C) 2026 OpenSim Ltd
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program; if not, see <http://www.gnu.org/licenses/>.
+//
+
+#ifndef __INET_WFQSCHEDULER_H_
+#define __INET_WFQSCHEDULER_H_
+
+#include <set>
+#include <vector>
+
+#include "INETDefs.h"
+#include "SchedulerBase.h"
+
+/**
+ * This module implements a Weighted Fair Queueing Scheduler,
+ * using start-time fair queueing virtual time.
+ */
+class INET_API WFQScheduler : public SchedulerBase
+{
+  protected:
+    typedef std::set<std::pair<double, int> > TagSet;  // (start tag, input index)
+
+    int numInputs;                  // number of input gates
+    std::vector<double> weights;
+    std::vector<double> startTags;  // start tag of the head packet of each backlogged input
+    std::vector<double> finishTags; // finish tag of the last packet served from each input
+    std::vector<bool> isBacklogged; // input is in the schedule, or its packet is being requested
+    TagSet schedule;                // backlogged inputs ordered by start tag
+    double virtualTime;             // start tag of the last packet served
+
+  public:
+    WFQScheduler() : numInputs(0), virtualTime(0) {}
+
+  protected:
+    virtual void initialize();
+    virtual void finish();
+    virtual void handleMessage(cMessage *msg);
+    virtual bool schedulePacket();
+    virtual void activateInput(int i);
+
+  public:
+    virtual void packetEnqueued(IPassiveQueue *inputQueue);
+};
+
+#endif
@@ -35,6 +35,14 @@ Define_Module(IPv4NetworkConfigurator);
 inline bool isEmpty(const char *s) {return !s || !s[0];}
 inline bool isNotEmpty(const char *s) {return s && s[0];}
 
+// selects the modules with @node property; in a parallel simulation, the nodes
+// of other partitions are placeholder modules without submodules, so they are left out
+static bool selectLocalNode(cModule *module, void *)
+{
+    cProperty *property = module->getProperties()->get("node");
+    return property && opp_strcmp(property->getValue(cProperty::DEFAULTKEY, 0), "false") != 0 && !module->isPlaceholder();
+}
+
 static void printElapsedTime(const char *name, long startTime)
 {
     EV_INFO << "Time spent in IPv4NetworkConfigurator::" << name << ": " << ((double)(clock() - startTime) / CLOCKS_PER_SEC) << "s" << endl;
@@ -103,6 +111,8 @@ void IPv4NetworkConfigurator::computeConfiguration()
     T(extractTopology(topology));
     // read the configuration from XML; it will serve as input for address assignment
     T(readInterfaceConfiguration(topology));
+    // check the interfaces connected to other partitions of a parallel simulation
+    T(checkPartitionBoundaryInterfaces(topology));
     // assign addresses to IPv4 nodes
     if (assignAddressesParameter)
         T(assignAddresses(topology));
@@ -236,7 +246,7 @@ void IPv4NetworkConfigurator::configureRoutingTable(Node *node)
 void IPv4NetworkConfigurator::extractTopology(IPv4Topology& topology)
 {
     // extract topology
-    topology.extractByProperty("node");
+    topology.extractFromNetwork(selectLocalNode);
     EV_DEBUG << "Topology found " << topology.getNumNodes() << " nodes\n";
 
     // extract nodes, fill in interfaceTable and routingTable members in node
@@ -1111,6 +1121,35 @@ void IPv4NetworkConfigurator::readInterfaceConfiguration(IPv4Topology& topology)
     }
 }
 
+bool IPv4NetworkConfigurator::isPartitionBoundaryInterface(InterfaceInfo *interfaceInfo)
+{
+    int outputGateId = interfaceInfo->interfaceEntry->getNodeOutputGateId();
+    if (outputGateId == -1)
+        return false;
+    cGate *pathEndGate = interfaceInfo->node->module->gate(outputGateId)->getPathEndGate();
+    return pathEndGate->getOwnerModule()->isPlaceholder();
+}
+
+void IPv4NetworkConfigurator::checkPartitionBoundaryInterfaces(IPv4Topology& topology)
+{
+    // the configurator instances of the partitions see only their own nodes, so
+    // the two ends of a link between partitions are configured independently
+    if (!assignAddressesParameter)
+        return;
+    for (int i = 0; i < (int)topology.linkInfos.size(); i++)
+    {
+        LinkInfo *linkInfo = topology.linkInfos[i];
+        for (int j = 0; j < (int)linkInfo->interfaceInfos.size(); j++)
+        {
+            InterfaceInfo *interfaceInfo = linkInfo->interfaceInfos[j];
+            if (interfaceInfo->configure && isPartitionBoundaryInterface(interfaceInfo) &&
+                (interfaceInfo->addressSpecifiedBits != 0xFFFFFFFF || interfaceInfo->netmaskSpecifiedBits != 0xFFFFFFFF))
+                throw cRuntimeError("Interface %s is connected to an other partition of the parallel simulation, "
+                        "its address and netmask must be fully specified in the configuration", interfaceInfo->getFullPath().c_str());
+        }
+    }
+}
+
 void IPv4NetworkConfigurator::parseAddressAndSpecifiedBits(const char *addressAttr, uint32_t& outAddress, uint32_t& outAddressSpecifiedBits)
 {
     // change "10.0.x.x" to "10.0.0.0" (for address) and "255.255.0.0" (for specifiedBits)
@@ -249,6 +249,13 @@ class INET_API IPv4NetworkConfigurator : public cSimpleModule, public IPvXAddres
          */
         virtual void readInterfaceConfiguration(IPv4Topology& topology);
 
+        /**
+         * Checks that the addresses of the interfaces connected to other partitions
+         * of a parallel simulation are fully specified by the configuration.
+         */
+        virtual void checkPartitionBoundaryInterfaces(IPv4Topology& topology);
+        virtual bool isPartitionBoundaryInterface(InterfaceInfo *interfaceInfo);
+
         /**
          * Reads multicast-group elements from the configuration file and stores the result
          */
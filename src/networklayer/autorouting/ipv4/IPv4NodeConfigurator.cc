@@ -56,6 +56,15 @@ void IPv4NodeConfigurator::initialize(int stage)
             cModule *module = getModuleByPath(networkConfiguratorPath);
             if (!module)
                 throw cRuntimeError("Configurator module '%s' not found (check the 'networkConfiguratorModule' parameter)", networkConfiguratorPath);
+            // in a parallel simulation, use the element of the configurator vector in this partition
+            if (module->isPlaceholder() && module->isVector())
+            {
+                cModule *parent = module->getParentModule();
+                for (int i = 0; i < module->getVectorSize() && module->isPlaceholder(); i++)
+                    module = parent->getSubmodule(module->getName(), i);
+            }
+            if (module->isPlaceholder())
+                throw cRuntimeError("Configurator module '%s' is in an other partition of the parallel simulation", networkConfiguratorPath);
             networkConfigurator = check_and_cast<IPv4NetworkConfigurator *>(module);
         }
     }
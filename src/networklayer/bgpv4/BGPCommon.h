@@ -18,6 +18,8 @@
 #ifndef __INET_BGPCOMMON_H
 #define __INET_BGPCOMMON_H
 
+#include <vector>
+
 #include "IPv4Datagram.h"
 //#include "TCPSocket.h"
 #include "InterfaceEntry.h"
@@ -33,6 +35,7 @@ const unsigned char TCP_PORT            = 179;
 const unsigned char START_EVENT_KIND    = 81;
 const unsigned char CONNECT_RETRY_KIND  = 82;
 const unsigned char HOLD_TIME_KIND      = 83;
+const unsigned char UPDATE_BATCH_KIND   = 84;
 const unsigned char KEEP_ALIVE_KIND     = 89;
 const unsigned char NB_TIMERS           = 4;
 const unsigned char NB_STATS            = 6;
@@ -70,6 +73,38 @@ struct SessionInfo{
     bool            sessionEstablished;
 };
 
+/**
+ * Set of AS numbers, used as AS path filter (DenyAS configuration elements).
+ * AS numbers are 16 bits, so the set is a bitmap indexed by the AS number:
+ * lookups take constant time, and empty sets allocate no memory.
+ */
+class ASIDSet
+{
+private:
+    std::vector<bool> members;
+
+public:
+    bool empty() const  { return members.empty(); }
+    void insert(ASID as)
+    {
+        if (members.empty())
+            members.resize(1 << (8 * sizeof(ASID)), false);
+        members[as] = true;
+    }
+    bool contains(ASID as) const  { return !members.empty() && members[as]; }
+};
+
+/**
+ * A route in the Adj-RIB-Out of a session: the last route advertised (or
+ * to be advertised) to the peer for the prefix.
+ */
+struct AdjRIBOutEntry {
+    IPv4Address         prefix;
+    unsigned char       length;
+    std::vector<ASID>   asPath;     // includes our own AS
+    bool                pending;    // queued, but not sent yet
+};
+
 } // namespace BGP
 
 #endif
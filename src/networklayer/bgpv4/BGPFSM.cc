@@ -377,6 +377,7 @@ void Established::entry()
     std::cout << "Established::entry - send an update message" << std::endl;
     BGPSession& session = TopState::box().getModule();
     session._info.sessionEstablished = true;
+    session.clearAdjRIBOut();
 
     //if it's an EGP Session, send update messages with all routing information to BGP peer
     //if it's an IGP Session, send update message with only the BGP routes learned by EGP
@@ -402,14 +403,14 @@ void Established::entry()
                 continue;
             }
             BGPEntry = new BGP::RoutingTableEntry(rtEntry);
-            std::string entryh = rtEntry->getDestination().str();
-            std::string entryn = rtEntry->getNetmask().str();
             BGPEntry->addAS(session._info.ASValue);
             session.updateSendProcess(BGPEntry);
+            delete BGPEntry;
         }
     }
 
-    std::vector<BGP::RoutingTableEntry*> BGPRoutingTable = session.getBGPRoutingTable();
+    std::vector<BGP::RoutingTableEntry*> BGPRoutingTable;
+    session.getBGPRoutingTable().getValues(BGPRoutingTable);
     for (std::vector<BGP::RoutingTableEntry*>::iterator it = BGPRoutingTable.begin(); it != BGPRoutingTable.end(); it++)
     {
         session.updateSendProcess((*it));
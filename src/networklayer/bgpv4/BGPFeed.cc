@@ -0,0 +1,560 @@
+//
+// Copyright (C) 2026 OpenSim Ltd
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program; if not, see <http://www.gnu.org/licenses/>.
+//
+
+#include <map>
+
+#include "BGPFeed.h"
+
+#include "BGPOpen.h"
+#include "BGPKeepAlive.h"
+
+
+Define_Module(BGPFeed);
+
+#define MSGKIND_KEEP_ALIVE  1
+#define MSGKIND_BATCH       2
+
+// RFC 6396: MRT record types
+#define MRT_HEADER_OCTETS       12
+#define MRT_TABLE_DUMP          12
+#define MRT_AFI_IPv4            1
+#define MRT_TABLE_DUMP_V2       13
+#define MRT_RIB_IPV4_UNICAST    2
+
+// RFC 6793: replaces 4-octet AS numbers in 2-octet AS paths
+#define AS_TRANS                23456
+
+
+static inline uint32 getUInt16(const unsigned char *data)
+{
+    return (data[0] << 8) | data[1];
+}
+
+static inline uint32 getUInt32(const unsigned char *data)
+{
+    return ((uint32)data[0] << 24) | (data[1] << 16) | (data[2] << 8) | data[3];
+}
+
+static inline BGP::ASID toASID(uint32 as)
+{
+    return as > 0xFFFF ? AS_TRANS : as;
+}
+
+BGPFeed::BGPFeed()
+{
+    file = NULL;
+    keepAliveTimer = NULL;
+    batchTimer = NULL;
+}
+
+BGPFeed::~BGPFeed()
+{
+    cancelAndDelete(keepAliveTimer);
+    cancelAndDelete(batchTimer);
+    closeFeedFile();
+}
+
+void BGPFeed::initialize(int stage)
+{
+    cSimpleModule::initialize(stage);
+
+    if (stage == 0)
+    {
+        const char *format = par("feedFormat");
+        if (!strcmp(format, "text"))
+            feedFormat = TEXT_FORMAT;
+        else if (!strcmp(format, "mrt"))
+            feedFormat = MRT_FORMAT;
+        else
+            throw cRuntimeError("Unknown feed format '%s'", format);
+        localAS = par("localAS");
+        holdTime = par("holdTime");
+        keepAliveTime = par("keepAliveTime");
+        maxPrefixes = par("maxPrefixes");
+        batchSize = par("batchSize");
+        batchInterval = par("batchInterval");
+        if (batchSize <= 0)
+            throw cRuntimeError("Invalid batchSize %d", batchSize);
+
+        established = false;
+        numPrefixesSent = numSkippedRecords = 0;
+        updateMsgSent = updateMsgRcv = 0;
+        feedCompleted = false;
+        keepAliveTimer = new cMessage("BGP Keep Alive Timer", MSGKIND_KEEP_ALIVE);
+        batchTimer = new cMessage("BGP Feed Batch", MSGKIND_BATCH);
+
+        openFeedFile(par("feedFile"));
+
+        WATCH(established);
+        WATCH(numPrefixesSent);
+        WATCH(updateMsgSent);
+    }
+    else if (stage == 3)
+    {
+        // wait for the connection of the peer
+        socket.setOutputGate(gate("tcpOut"));
+        socket.readDataTransferModePar(*this);
+        socket.setCallbackObject(this);
+        socket.bind(BGP::TCP_PORT);
+        socket.listenOnce();
+    }
+}
+
+void BGPFeed::handleMessage(cMessage *msg)
+{
+    if (msg == keepAliveTimer)
+    {
+        sendKeepAliveMessage();
+        scheduleAt(simTime() + keepAliveTime, keepAliveTimer);
+    }
+    else if (msg == batchTimer)
+    {
+        sendNextBatch();
+    }
+    else
+    {
+        socket.processMessage(msg);
+    }
+}
+
+void BGPFeed::finish()
+{
+    recordScalar("PrefixesSent", numPrefixesSent);
+    recordScalar("SkippedRecords", numSkippedRecords);
+    recordScalar("UpdateMsgSent", updateMsgSent);
+    recordScalar("UpdateMsgRcv", updateMsgRcv);
+    if (feedCompleted)
+        recordScalar("FeedDuration", feedEndTime - feedStartTime);
+}
+
+void BGPFeed::socketEstablished(int connId, void *yourPtr)
+{
+    // the peer sends its OPEN message first
+    EV << "Connection established with BGP peer " << socket.getRemoteAddress() << endl;
+}
+
+void BGPFeed::socketDataArrived(int connId, void *yourPtr, cPacket *msg, bool urgent)
+{
+    BGPHeader *header = check_and_cast<BGPHeader *>(msg);
+    switch (header->getType())
+    {
+        case BGP_OPEN:
+            EV << "Processing BGP OPEN message" << endl;
+            sendOpenMessage();
+            sendKeepAliveMessage();
+            cancelEvent(keepAliveTimer);
+            scheduleAt(simTime() + keepAliveTime, keepAliveTimer);
+            break;
+        case BGP_KEEPALIVE:
+            EV << "Processing BGP Keep Alive message" << endl;
+            if (!established)
+            {
+                // the peer accepted our OPEN message: start the feed
+                established = true;
+                feedStartTime = simTime();
+                scheduleAt(simTime(), batchTimer);
+            }
+            break;
+        case BGP_UPDATE:
+            // the routes of the peer are ignored
+            updateMsgRcv++;
+            break;
+        default:
+            throw cRuntimeError("Invalid BGP message type %d", header->getType());
+    }
+    delete msg;
+}
+
+void BGPFeed::socketPeerClosed(int connId, void *yourPtr)
+{
+    EV << "BGP peer closed the connection" << endl;
+    socket.close();
+    socketFailure(connId, yourPtr, 0);
+}
+
+void BGPFeed::socketFailure(int connId, void *yourPtr, int code)
+{
+    EV << "BGP session broken, the feed is stopped" << endl;
+    established = false;
+    cancelEvent(keepAliveTimer);
+    cancelEvent(batchTimer);
+}
+
+void BGPFeed::sendOpenMessage()
+{
+    BGPOpenMessage *openMsg = new BGPOpenMessage("BGPOpen");
+    openMsg->setMyAS(localAS);
+    openMsg->setHoldTime(holdTime);
+    openMsg->setBGPIdentifier(socket.getLocalAddress().get4());
+    socket.send(openMsg);
+}
+
+void BGPFeed::sendKeepAliveMessage()
+{
+    socket.send(new BGPKeepAliveMessage("BGPKeepAlive"));
+}
+
+void BGPFeed::sendNextBatch()
+{
+    // RFC 4271, 9.2: routes with the same path attributes can be advertised in one UPDATE message
+    typedef std::map<std::pair<unsigned char, std::vector<BGP::ASID> >, std::vector<BGPUpdateNLRI> > RouteGroups;
+    RouteGroups routeGroups;
+    Route route;
+    bool endOfFeed = false;
+    int count = 0;
+    while (count < batchSize)
+    {
+        if ((maxPrefixes >= 0 && numPrefixesSent + count >= maxPrefixes) || !readRoute(route))
+        {
+            endOfFeed = true;
+            break;
+        }
+        // like any BGP speaker, set our AS in first position if it is not already
+        if (route.asPath.empty() || route.asPath[0] != localAS)
+            route.asPath.insert(route.asPath.begin(), localAS);
+        BGPUpdateNLRI nlri;
+        nlri.prefix = route.prefix;
+        nlri.length = route.length;
+        routeGroups[std::make_pair(route.origin, route.asPath)].push_back(nlri);
+        count++;
+    }
+
+    for (RouteGroups::iterator it = routeGroups.begin(); it != routeGroups.end(); it++)
+        sendUpdateMessages(it->first.first, it->first.second, it->second);
+    numPrefixesSent += count;
+
+    if (endOfFeed)
+    {
+        EV << "End of the feed, " << numPrefixesSent << " prefixes sent" << endl;
+        closeFeedFile();
+        feedCompleted = true;
+        feedEndTime = simTime();
+    }
+    else
+    {
+        scheduleAt(simTime() + batchInterval, batchTimer);
+    }
+}
+
+void BGPFeed::sendUpdateMessages(unsigned char origin, const std::vector<BGP::ASID>& asPath, const std::vector<BGPUpdateNLRI>& routes)
+{
+    BGPUpdatePathAttributeList content;
+    content.setAsPathArraySize(1);
+    content.getAsPath(0).setValueArraySize(1);
+    content.getAsPath(0).getValue(0).setType(BGP::AS_SEQUENCE);
+    content.getAsPath(0).getValue(0).setAsValueArraySize(asPath.size());
+    content.getAsPath(0).getValue(0).setLength(asPath.size());
+    for (unsigned int i = 0; i < asPath.size(); i++)
+        content.getAsPath(0).getValue(0).setAsValue(i, asPath[i]);
+    content.getOrigin().setValue(origin);
+    content.getNextHop().setValue(socket.getLocalAddress().get4());
+
+    unsigned int i = 0;
+    while (i < routes.size())
+    {
+        BGPUpdateMessage *updateMsg = new BGPUpdateMessage("BGPUpdate");
+        updateMsg->setPathAttributeListArraySize(1);
+        updateMsg->setPathAttributeList(content);
+        // as many prefixes as fit into the maximum message size
+        unsigned int nlriCount = (BGP_MAX_MESSAGE_OCTETS - updateMsg->getByteLength()) / BGP_NLRI_OCTETS;
+        if (nlriCount > routes.size() - i)
+            nlriCount = routes.size() - i;
+        updateMsg->setNLRIArraySize(nlriCount);
+        for (unsigned int k = 0; k < nlriCount; k++, i++)
+            updateMsg->setNLRI(k, routes[i]);
+        socket.send(updateMsg);
+        updateMsgSent++;
+    }
+}
+
+void BGPFeed::openFeedFile(const char *fileName)
+{
+#ifdef HAVE_ZLIB
+    file = gzopen(fileName, "rb");
+#else
+    size_t length = strlen(fileName);
+    if (length > 3 && !strcmp(fileName + length - 3, ".gz"))
+        throw cRuntimeError("Cannot read compressed feed file '%s': INET was compiled without zlib", fileName);
+    file = fopen(fileName, "rb");
+#endif
+    if (!file)
+        throw cRuntimeError("Cannot open feed file '%s'", fileName);
+}
+
+void BGPFeed::closeFeedFile()
+{
+    if (file)
+    {
+#ifdef HAVE_ZLIB
+        gzclose(file);
+#else
+        fclose(file);
+#endif
+        file = NULL;
+    }
+}
+
+bool BGPFeed::readLine(std::string& line)
+{
+    char buffer[1024];
+    line.clear();
+#ifdef HAVE_ZLIB
+    while (gzgets(file, buffer, sizeof(buffer)) != NULL)
+#else
+    while (fgets(buffer, sizeof(buffer), file) != NULL)
+#endif
+    {
+        line += buffer;
+        if (line[line.size() - 1] == '\n')
+            return true;
+    }
+    return !line.empty();
+}
+
+bool BGPFeed::readBytes(unsigned char *buffer, unsigned int length)
+{
+#ifdef HAVE_ZLIB
+    return gzread(file, buffer, length) == (int)length;
+#else
+    return fread(buffer, 1, length, file) == length;
+#endif
+}
+
+bool BGPFeed::readRoute(Route& route)
+{
+    if (!file)
+        return false;
+    while (true)
+    {
+        if (feedFormat == TEXT_FORMAT)
+        {
+            std::string line;
+            if (!readLine(line))
+                return false;
+            std::string::size_type begin = line.find_first_not_of(" \t\r\n");
+            if (begin == std::string::npos || line[begin] == '#')
+                continue;
+            line = line.substr(begin, line.find_last_not_of(" \t\r\n") + 1 - begin);
+            if (parseTextRoute(line, route))
+                return true;
+            EV << "Skipping feed line: " << line << endl;
+        }
+        else
+        {
+            // common header: timestamp (4), type (2), subtype (2), length (4)
+            unsigned char header[MRT_HEADER_OCTETS];
+            if (!readBytes(header, MRT_HEADER_OCTETS))
+                return false;
+            uint32 length = getUInt32(header + 8);
+            if (length > (1 << 24))
+                throw cRuntimeError("Invalid MRT record length %u in the feed file", length);
+            recordBuffer.resize(length + 1);
+            if (!readBytes(&recordBuffer[0], length))
+                throw cRuntimeError("Truncated MRT record in the feed file");
+            if (parseMRTRecord(getUInt16(header + 4), getUInt16(header + 6), &recordBuffer[0], length, route))
+                return true;
+        }
+        numSkippedRecords++;
+    }
+}
+
+bool BGPFeed::parseTextRoute(const std::string& line, Route& route)
+{
+    std::string prefix, asPath, origin;
+    if (line.find('|') != std::string::npos)
+    {
+        // TABLE_DUMP2|<time>|B|<peer address>|<peer AS>|<prefix>|<AS path>|<origin>|<next hop>|...
+        std::vector<std::string> fields;
+        std::string::size_type begin = 0, end;
+        while ((end = line.find('|', begin)) != std::string::npos)
+        {
+            fields.push_back(line.substr(begin, end - begin));
+            begin = end + 1;
+        }
+        fields.push_back(line.substr(begin));
+        if (fields.size() < 8)
+            return false;   // withdrawals, state changes
+        prefix = fields[5];
+        asPath = fields[6];
+        origin = fields[7];
+    }
+    else
+    {
+        std::string::size_type end = line.find_first_of(" \t");
+        prefix = line.substr(0, end);
+        if (end != std::string::npos)
+            asPath = line.substr(end + 1);
+    }
+
+    std::string::size_type slash = prefix.find('/');
+    if (slash == std::string::npos)
+        return false;
+    std::string address = prefix.substr(0, slash);
+    if (!IPv4Address::isWellFormed(address.c_str()))
+        return false;   // e.g. IPv6 prefixes
+    char *end;
+    long length = strtol(prefix.c_str() + slash + 1, &end, 10);
+    if (*end || end == prefix.c_str() + slash + 1 || length < 0 || length > 32)
+        return false;
+    route.length = length;
+    route.prefix = IPv4Address(address.c_str()).doAnd(IPv4Address::makeNetmask(length));
+
+    route.asPath.clear();
+    cStringTokenizer tokenizer(asPath.c_str(), " \t");
+    while (tokenizer.hasMoreTokens())
+    {
+        BGP::ASID as = parseAS(tokenizer.nextToken());
+        if (as == 0)
+            return false;
+        route.asPath.push_back(as);
+    }
+
+    if (origin.empty() || origin == "IGP")
+        route.origin = BGP::IGP;
+    else if (origin == "EGP")
+        route.origin = BGP::EGP;
+    else if (origin == "INCOMPLETE")
+        route.origin = BGP::Incomplete;
+    else
+        return false;
+    return true;
+}
+
+BGP::ASID BGPFeed::parseAS(const std::string& text)
+{
+    // AS sets ("{1,2,3}") are not modelled: the first AS stands for the set,
+    // which counts as one AS in the path length anyway
+    const char *begin = text.c_str();
+    if (*begin == '{')
+        begin++;
+    char *end;
+    unsigned long as = strtoul(begin, &end, 10);
+    if (end == begin)
+        return 0;
+    if (*end == '.')
+    {
+        // asdot notation
+        const char *low = end + 1;
+        as = as * 65536 + strtoul(low, &end, 10);
+        if (end == low)
+            return 0;
+    }
+    if (*end && *end != ',' && *end != '}')
+        return 0;
+    return toASID(as);
+}
+
+bool BGPFeed::parseMRTRecord(unsigned short type, unsigned short subtype, const unsigned char *data, unsigned int length, Route& route)
+{
+    route.asPath.clear();
+    route.origin = BGP::IGP;
+    if (type == MRT_TABLE_DUMP && subtype == MRT_AFI_IPv4)
+    {
+        // view (2), sequence (2), prefix (4), prefix length (1), status (1), originated time (4),
+        // peer address (4), peer AS (2), attribute length (2), attributes with 2-octet AS numbers
+        if (length < 22)
+            return false;
+        route.length = data[8];
+        unsigned int attrLength = getUInt16(data + 20);
+        if (route.length > 32 || 22 + attrLength > length)
+            return false;
+        route.prefix = IPv4Address(getUInt32(data + 4)).doAnd(IPv4Address::makeNetmask(route.length));
+        return parsePathAttributes(data + 22, attrLength, 2, route);
+    }
+    else if (type == MRT_TABLE_DUMP_V2 && subtype == MRT_RIB_IPV4_UNICAST)
+    {
+        // sequence (4), prefix length (1), prefix (variable), entry count (2), RIB entries
+        if (length < 5)
+            return false;
+        route.length = data[4];
+        unsigned int prefixOctets = (route.length + 7) / 8;
+        if (route.length > 32 || 5 + prefixOctets + 2 > length)
+            return false;
+        uint32 prefix = 0;
+        for (unsigned int i = 0; i < 4; i++)
+            prefix = (prefix << 8) | (i < prefixOctets ? data[5 + i] : 0);
+        route.prefix = IPv4Address(prefix).doAnd(IPv4Address::makeNetmask(route.length));
+
+        // first RIB entry: peer index (2), originated time (4), attribute length (2),
+        // attributes with 4-octet AS numbers
+        const unsigned char *entry = data + 5 + prefixOctets;
+        unsigned int entryCount = getUInt16(entry);
+        entry += 2;
+        if (entryCount == 0 || entry + 8 > data + length)
+            return false;
+        unsigned int attrLength = getUInt16(entry + 6);
+        if (entry + 8 + attrLength > data + length)
+            return false;
+        return parsePathAttributes(entry + 8, attrLength, 4, route);
+    }
+    // PEER_INDEX_TABLE, IPv6 and multicast RIBs, BGP4MP messages
+    return false;
+}
+
+bool BGPFeed::parsePathAttributes(const unsigned char *data, unsigned int length, unsigned int asSize, Route& route)
+{
+    const unsigned char *end = data + length;
+    while (data + 3 <= end)
+    {
+        // flags (1), type code (1), length (1, or 2 with the Extended Length bit)
+        unsigned char flags = data[0];
+        unsigned char typeCode = data[1];
+        unsigned int attrLength;
+        if (flags & 0x10)
+        {
+            if (data + 4 > end)
+                return false;
+            attrLength = getUInt16(data + 2);
+            data += 4;
+        }
+        else
+        {
+            attrLength = data[2];
+            data += 3;
+        }
+        if (data + attrLength > end)
+            return false;
+
+        if (typeCode == ORIGIN)
+        {
+            if (attrLength != 1 || data[0] > BGP::Incomplete)
+                return false;
+            route.origin = data[0];
+        }
+        else if (typeCode == AS_PATH)
+        {
+            // segments: type (1), AS count (1), AS numbers
+            const unsigned char *segment = data;
+            while (segment + 2 <= data + attrLength)
+            {
+                unsigned char segmentType = segment[0];
+                unsigned int count = segment[1];
+                segment += 2;
+                if (segment + count * asSize > data + attrLength)
+                    return false;
+                // AS sets are not modelled, see parseAS()
+                unsigned int usedCount = (segmentType == BGP::AS_SET && count > 1) ? 1 : count;
+                for (unsigned int i = 0; i < usedCount; i++)
+                    route.asPath.push_back(toASID(asSize == 2 ? getUInt16(segment + i * asSize) : getUInt32(segment + i * asSize)));
+                segment += count * asSize;
+            }
+        }
+        data += attrLength;
+    }
+    return true;
+}
+
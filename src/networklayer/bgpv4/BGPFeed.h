@@ -0,0 +1,132 @@
+//
+// Copyright (C) 2026 OpenSim Ltd
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program; if not, see <http://www.gnu.org/licenses/>.
+//
+
+#ifndef __INET_BGPFEED_H
+#define __INET_BGPFEED_H
+
+#include <stdio.h>
+#include <string>
+#include <vector>
+
+#ifdef HAVE_ZLIB
+#include <zlib.h>
+#endif
+
+#include "INETDefs.h"
+
+#include "TCPSocket.h"
+#include "BGPCommon.h"
+#include "BGPUpdate.h"
+
+
+/**
+ * Minimal BGP speaker that feeds the routes of a routing table dump to a
+ * BGPRouting peer. See the NED file for more information.
+ */
+class INET_API BGPFeed : public cSimpleModule, public TCPSocket::CallbackInterface
+{
+  protected:
+    struct Route {
+        IPv4Address             prefix;
+        unsigned char           length;
+        unsigned char           origin;
+        std::vector<BGP::ASID>  asPath;
+    };
+
+    enum FeedFormat { TEXT_FORMAT, MRT_FORMAT };
+
+    // parameters
+    FeedFormat      feedFormat;
+    BGP::ASID       localAS;
+    simtime_t       holdTime;
+    simtime_t       keepAliveTime;
+    long            maxPrefixes;        // -1: the whole file
+    int             batchSize;          // prefixes read and sent per batch
+    simtime_t       batchInterval;
+
+    // state
+#ifdef HAVE_ZLIB
+    gzFile          file;               // reads uncompressed files as well
+#else
+    FILE*           file;
+#endif
+    std::vector<unsigned char> recordBuffer;
+    TCPSocket       socket;
+    bool            established;
+    cMessage*       keepAliveTimer;
+    cMessage*       batchTimer;
+
+    // statistics
+    long            numPrefixesSent;
+    long            numSkippedRecords;  // malformed lines, or MRT records of other types
+    unsigned long   updateMsgSent;
+    unsigned long   updateMsgRcv;
+    bool            feedCompleted;
+    simtime_t       feedStartTime;
+    simtime_t       feedEndTime;
+
+  public:
+    BGPFeed();
+    virtual ~BGPFeed();
+
+  protected:
+    virtual int numInitStages() const { return 4; }
+    virtual void initialize(int stage);
+    virtual void handleMessage(cMessage *msg);
+    virtual void finish();
+
+    virtual void socketEstablished(int connId, void *yourPtr);
+    virtual void socketDataArrived(int connId, void *yourPtr, cPacket *msg, bool urgent);
+    virtual void socketPeerClosed(int connId, void *yourPtr);
+    virtual void socketClosed(int connId, void *yourPtr) {}
+    virtual void socketFailure(int connId, void *yourPtr, int code);
+
+    virtual void sendOpenMessage();
+    virtual void sendKeepAliveMessage();
+    /**
+     * Reads the next batch of routes from the file and sends them to the peer
+     * in UPDATE messages, grouped by path attributes.
+     */
+    virtual void sendNextBatch();
+    virtual void sendUpdateMessages(unsigned char origin, const std::vector<BGP::ASID>& asPath, const std::vector<BGPUpdateNLRI>& routes);
+
+    virtual void openFeedFile(const char *fileName);
+    virtual void closeFeedFile();
+    virtual bool readLine(std::string& line);
+    virtual bool readBytes(unsigned char *buffer, unsigned int length);
+
+    /**
+     * Reads the next route of the file. Returns false at the end of the file.
+     */
+    virtual bool readRoute(Route& route);
+    /**
+     * Parses a line of a text feed: either "<prefix>/<length> [<AS> ...]",
+     * or the one-line-per-route output of "bgpdump -m".
+     */
+    virtual bool parseTextRoute(const std::string& line, Route& route);
+    /**
+     * Parses an MRT record: TABLE_DUMP (RFC 6396, 4.2) with the IPv4 address
+     * family, or TABLE_DUMP_V2 RIB_IPV4_UNICAST (RFC 6396, 4.3.2). Only the
+     * first RIB entry of a TABLE_DUMP_V2 record is used.
+     */
+    virtual bool parseMRTRecord(unsigned short type, unsigned short subtype, const unsigned char *data, unsigned int length, Route& route);
+    virtual bool parsePathAttributes(const unsigned char *data, unsigned int length, unsigned int asSize, Route& route);
+    virtual BGP::ASID parseAS(const std::string& text);
+};
+
+#endif
+
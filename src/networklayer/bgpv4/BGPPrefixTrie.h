@@ -0,0 +1,254 @@
+//
+// Copyright (C) 2026 OpenSim Ltd
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program; if not, see <http://www.gnu.org/licenses/>.
+//
+
+#ifndef __INET_BGPPREFIXTRIE_H
+#define __INET_BGPPREFIXTRIE_H
+
+#include <ostream>
+#include <vector>
+
+#include "IPv4Address.h"
+
+
+namespace BGP {
+
+/**
+ * Routing information base indexed by IPv4 prefix (address and prefix
+ * length). Used for the Loc-RIB, the Adj-RIB-Out of the sessions and the
+ * prefix filters of BGPRouting.
+ *
+ * The table is a path compressed binary trie (Patricia trie): every node
+ * is either a stored prefix or a branching point, so there are less than
+ * 2N nodes for N prefixes, and lookups, insertions and removals take at
+ * most 33 steps regardless of the table size. The table does not own the
+ * stored objects.
+ */
+template<typename T>
+class PrefixTrie
+{
+private:
+    struct Node {
+        uint32          prefix;     // masked to length
+        unsigned char   length;
+        T*              value;      // NULL for branching nodes
+        Node*           child[2];
+        Node(uint32 prefix, unsigned char length, T* value) : prefix(prefix), length(length), value(value)
+        {
+            child[0] = child[1] = NULL;
+        }
+    };
+
+    Node*   root;
+    size_t  count;
+    size_t  nodeCount;      // stored prefixes and branching nodes
+
+    static uint32 mask(uint32 address, unsigned char length)
+    {
+        return length == 0 ? 0 : address & (0xFFFFFFFFU << (32 - length));
+    }
+
+    // the bit following the first 'length' bits, i.e. the child to descend into
+    static int bit(uint32 address, unsigned char length)
+    {
+        return (address >> (31 - length)) & 1;
+    }
+
+    static unsigned char commonLength(uint32 address1, unsigned char length1, uint32 address2, unsigned char length2)
+    {
+        uint32 diff = address1 ^ address2;
+        unsigned char length = 0;
+        while (length < 32 && !(diff & 0x80000000U)) {
+            diff <<= 1;
+            length++;
+        }
+        if (length > length1)
+            length = length1;
+        if (length > length2)
+            length = length2;
+        return length;
+    }
+
+    // returns the link pointing to the node of the prefix, or to NULL if the prefix is not stored
+    Node** findLink(uint32 prefix, unsigned char length, Node**& parentLink) const
+    {
+        Node** link = const_cast<Node**>(&root);
+        parentLink = NULL;
+        while (*link != NULL && (*link)->length <= length && mask(prefix, (*link)->length) == (*link)->prefix) {
+            if ((*link)->length == length) {
+                return link;
+            }
+            parentLink = link;
+            link = &(*link)->child[bit(prefix, (*link)->length)];
+        }
+        return NULL;
+    }
+
+    // removes the branching node at the link if it has less than two children
+    void compact(Node** link)
+    {
+        Node* node = *link;
+        if (node->value != NULL || (node->child[0] != NULL && node->child[1] != NULL)) {
+            return;
+        }
+        *link = node->child[0] != NULL ? node->child[0] : node->child[1];
+        delete node;
+        nodeCount--;
+    }
+
+    static void collect(const Node* node, std::vector<T*>& values)
+    {
+        if (node == NULL) {
+            return;
+        }
+        if (node->value != NULL) {
+            values.push_back(node->value);
+        }
+        collect(node->child[0], values);
+        collect(node->child[1], values);
+    }
+
+    static void destroy(Node* node)
+    {
+        if (node != NULL) {
+            destroy(node->child[0]);
+            destroy(node->child[1]);
+            delete node;
+        }
+    }
+
+    PrefixTrie(const PrefixTrie&);
+    PrefixTrie& operator=(const PrefixTrie&);
+
+public:
+    PrefixTrie() : root(NULL), count(0), nodeCount(0) {}
+    ~PrefixTrie()  { clear(); }
+
+    bool   empty() const  { return count == 0; }
+    size_t size() const  { return count; }
+
+    /**
+     * Returns the memory allocated for the nodes of the table in bytes,
+     * excluding the stored objects.
+     */
+    size_t getMemoryUsage() const  { return nodeCount * sizeof(Node); }
+
+    /**
+     * Returns the object stored with the prefix, or NULL. Host bits of the
+     * address are ignored.
+     */
+    T* get(const IPv4Address& address, unsigned char length) const
+    {
+        Node** parentLink;
+        Node** link = findLink(mask(address.getInt(), length), length, parentLink);
+        return link != NULL ? (*link)->value : NULL;
+    }
+
+    /**
+     * Stores the object with the prefix, replacing the one stored previously.
+     */
+    void set(const IPv4Address& address, unsigned char length, T* value)
+    {
+        ASSERT(value != NULL && length <= 32);
+        uint32 prefix = mask(address.getInt(), length);
+        Node** link = &root;
+        while (*link != NULL) {
+            Node* node = *link;
+            unsigned char common = commonLength(prefix, length, node->prefix, node->length);
+            if (common == node->length) {
+                if (node->length == length) {
+                    if (node->value == NULL) {
+                        count++;
+                    }
+                    node->value = value;
+                    return;
+                }
+                link = &node->child[bit(prefix, node->length)];
+            }
+            else if (common == length) {
+                // the new prefix contains the one of the node
+                Node* newNode = new Node(prefix, length, value);
+                newNode->child[bit(node->prefix, length)] = node;
+                *link = newNode;
+                count++;
+                nodeCount++;
+                return;
+            }
+            else {
+                // the prefixes diverge after their common part: add a branching node
+                Node* branch = new Node(mask(prefix, common), common, NULL);
+                branch->child[bit(prefix, common)] = new Node(prefix, length, value);
+                branch->child[bit(node->prefix, common)] = node;
+                *link = branch;
+                count++;
+                nodeCount += 2;
+                return;
+            }
+        }
+        *link = new Node(prefix, length, value);
+        count++;
+        nodeCount++;
+    }
+
+    /**
+     * Removes the prefix from the table. Returns false if it was not found.
+     */
+    bool remove(const IPv4Address& address, unsigned char length)
+    {
+        Node** parentLink;
+        Node** link = findLink(mask(address.getInt(), length), length, parentLink);
+        if (link == NULL || (*link)->value == NULL) {
+            return false;
+        }
+        (*link)->value = NULL;
+        count--;
+        compact(link);
+        // a leaf was removed: its parent may have become a useless branching node
+        if (*link == NULL && parentLink != NULL) {
+            compact(parentLink);
+        }
+        return true;
+    }
+
+    /**
+     * Appends the stored objects to the vector, ordered by prefix address
+     * (and shorter prefixes first among prefixes with the same address).
+     */
+    void getValues(std::vector<T*>& values) const
+    {
+        values.reserve(values.size() + count);
+        collect(root, values);
+    }
+
+    void clear()
+    {
+        destroy(root);
+        root = NULL;
+        count = 0;
+        nodeCount = 0;
+    }
+};
+
+template<typename T>
+inline std::ostream& operator<<(std::ostream& os, const PrefixTrie<T>& trie)
+{
+    return os << trie.size() << " prefixes";
+}
+
+} // namespace BGP
+
+#endif // __INET_BGPPREFIXTRIE_H
+
@@ -15,6 +15,8 @@
 // along with this program; if not, see <http://www.gnu.org/licenses/>.
 //
 
+#include <platdep/timeutil.h>
+
 #include "BGPRouting.h"
 
 #include "ModuleAccess.h"
@@ -32,9 +34,17 @@ BGPRouting::~BGPRouting(void)
     {
         (*sessionIterator).second->~BGPSession();
     }
-    _BGPRoutingTable.erase(_BGPRoutingTable.begin(), _BGPRoutingTable.end());
-    _prefixListIN.erase(_prefixListIN.begin(), _prefixListIN.end());
-    _prefixListOUT.erase(_prefixListOUT.begin(), _prefixListOUT.end());
+    _BGPRoutingTable.clear();
+
+    std::vector<BGP::RoutingTableEntry*> prefixList;
+    _prefixListIN.getValues(prefixList);
+    _prefixListOUT.getValues(prefixList);
+    for (std::vector<BGP::RoutingTableEntry*>::iterator it = prefixList.begin(); it != prefixList.end(); it++)
+    {
+        delete (*it);
+    }
+    _prefixListIN.clear();
+    _prefixListOUT.clear();
 }
 
 void BGPRouting::initialize(int stage)
@@ -53,11 +63,13 @@ void BGPRouting::initialize(int stage)
         _rt = RoutingTableAccess().get();
         _inft = InterfaceTableAccess().get();
 
+        _updateBatchDelay = par("updateBatchDelay");
+
         // read BGP configuration
         cXMLElement *bgpConfig = par("bgpConfig").xmlValue();
         loadConfigFromXML(bgpConfig);
         createWatch("myAutonomousSystem", _myAS);
-        WATCH_PTRVECTOR(_BGPRoutingTable);
+        WATCH(_BGPRoutingTable);
     }
 }
 
@@ -100,6 +112,10 @@ void BGPRouting::handleTimer(cMessage *timer)
                 EV << "Expiring Keep Alive timer" << std::endl;
                 pSession->getFSM()->KeepaliveTimer_Expires();
                 break;
+            case BGP::UPDATE_BATCH_KIND:
+                EV << "Sending queued UPDATE messages" << std::endl;
+                pSession->sendUpdateMessages();
+                break;
             default :
                 throw cRuntimeError("Invalid timer kind %d", timer->getKind());
         }
@@ -124,6 +140,31 @@ void BGPRouting::finish()
     recordScalar("KeepAliveMsgRcv", statTab[3]);
     recordScalar("UpdateMsgSent", statTab[4]);
     recordScalar("UpdateMsgRcv", statTab[5]);
+
+    // size of the Loc-RIB: the entries are shared with the IPv4 routing table
+    std::vector<BGP::RoutingTableEntry*> entries;
+    _BGPRoutingTable.getValues(entries);
+    unsigned long locRIBBytes = _BGPRoutingTable.getMemoryUsage();
+    for (std::vector<BGP::RoutingTableEntry*>::iterator it = entries.begin(); it != entries.end(); it++)
+    {
+        locRIBBytes += sizeof(BGP::RoutingTableEntry) + (*it)->getASCount() * sizeof(BGP::ASID);
+    }
+    recordScalar("LocRIBPrefixes", entries.size());
+    if (!entries.empty())
+    {
+        recordScalar("LocRIBBytesPerPrefix", (double)locRIBBytes / entries.size());
+    }
+
+    if (_updateMsgProcessed > 0)
+    {
+        // from the first received UPDATE message to the last change of the Loc-RIB
+        recordScalar("ConvergenceTime", _lastLocRIBChangeTime > _firstUpdateTime ? _lastLocRIBChangeTime - _firstUpdateTime : SIMTIME_ZERO);
+        recordScalar("UpdateMsgProcessingTime", _updateProcessingTime);
+        if (_updateProcessingTime > 0)
+        {
+            recordScalar("UpdateMsgProcessedPerSecond", _updateMsgProcessed / _updateProcessingTime);
+        }
+    }
 }
 
 void BGPRouting::listenConnectionFromPeer(BGP::SessionID sessionID)
@@ -267,40 +308,57 @@ void BGPRouting::processMessage(const BGPKeepAliveMessage& msg)
 void BGPRouting::processMessage(const BGPUpdateMessage& msg)
 {
     EV << "Processing BGP Update message" << std::endl;
+    timeval startTime;
+    gettimeofday(&startTime, NULL);
+    if (_updateMsgProcessed == 0)
+    {
+        _firstUpdateTime = simTime();
+    }
     _BGPSessions[_currSessionId]->getFSM()->UpdateMsgEvent();
 
-    unsigned char               decisionProcessResult;
-    IPv4Address                 netMask(IPv4Address::ALLONES_ADDRESS);
-    BGP::RoutingTableEntry*     entry = new BGP::RoutingTableEntry();
-    const unsigned char         length = msg.getNLRI().length;
-    unsigned int                ASValueCount = msg.getPathAttributeList(0).getAsPath(0).getValue(0).getAsValueArraySize();
+    const BGPASPathSegment&     asPath = msg.getPathAttributeList(0).getAsPath(0).getValue(0);
+    unsigned int                ASValueCount = asPath.getAsValueArraySize();
 
-    entry->setDestination(msg.getNLRI().prefix);
-    netMask = IPv4Address::makeNetmask(length);
-    entry->setNetmask(netMask);
-    for (unsigned int j=0; j < ASValueCount; j++)
+    // the path attributes apply to every prefix of the message
+    for (unsigned int i = 0; i < msg.getNLRIArraySize(); i++)
     {
-        entry->addAS(msg.getPathAttributeList(0).getAsPath(0).getValue(0).getAsValue(j));
-    }
+        unsigned char               decisionProcessResult;
+        BGP::RoutingTableEntry*     entry = new BGP::RoutingTableEntry();
+
+        entry->setDestination(msg.getNLRI(i).prefix);
+        entry->setNetmask(IPv4Address::makeNetmask(msg.getNLRI(i).length));
+        for (unsigned int j=0; j < ASValueCount; j++)
+        {
+            entry->addAS(asPath.getAsValue(j));
+        }
 
-    decisionProcessResult = asLoopDetection(entry, _myAS);
+        decisionProcessResult = asLoopDetection(entry, _myAS);
 
-    if (decisionProcessResult == BGP::ASLOOP_NO_DETECTED)
-    {
-        // RFC 4271, 9.1.  Decision Process
-        decisionProcessResult = decisionProcess(msg, entry, _currSessionId);
-        //RFC 4271, 9.2.  Update-Send Process
-        if (decisionProcessResult != 0)
+        if (decisionProcessResult == BGP::ASLOOP_NO_DETECTED)
         {
-            updateSendProcess(decisionProcessResult, _currSessionId, entry);
+            // RFC 4271, 9.1.  Decision Process
+            decisionProcessResult = decisionProcess(msg, entry, _currSessionId);
+            //RFC 4271, 9.2.  Update-Send Process
+            if (decisionProcessResult != 0)
+            {
+                _lastLocRIBChangeTime = simTime();
+                updateSendProcess(decisionProcessResult, _currSessionId, entry);
+                continue;
+            }
         }
+        // the route is not used
+        delete entry;
     }
+    _updateMsgProcessed++;
+    timeval endTime;
+    gettimeofday(&endTime, NULL);
+    _updateProcessingTime += (endTime.tv_sec - startTime.tv_sec) + (endTime.tv_usec - startTime.tv_usec) / 1e6;
 }
 
 unsigned char BGPRouting::decisionProcess(const BGPUpdateMessage& msg, BGP::RoutingTableEntry* entry, BGP::SessionID sessionIndex)
 {
     //Don't add the route if it exists in PrefixListINTable or in ASListINTable
-    if (isInTable(_prefixListIN, entry) != (unsigned long)-1 || isInASList(_ASListIN, entry))
+    if (findInTable(_prefixListIN, entry) != NULL || isInASList(_ASListIN, entry))
     {
         return 0;
     }
@@ -312,17 +370,17 @@ unsigned char BGPRouting::decisionProcess(const BGPUpdateMessage& msg, BGP::Rout
 
     //if the route already exist in BGP routing table, tieBreakingProcess();
     //(RFC 4271: 9.1.2.2 Breaking Ties)
-    unsigned long BGPindex = isInTable(_BGPRoutingTable, entry);
-    if (BGPindex != (unsigned long)-1)
+    BGP::RoutingTableEntry* oldEntry = findInTable(_BGPRoutingTable, entry);
+    if (oldEntry != NULL)
     {
-        if (tieBreakingProcess(_BGPRoutingTable[BGPindex], entry))
+        if (tieBreakingProcess(oldEntry, entry))
         {
             return 0;
         }
         else
         {
             entry->setInterface(_BGPSessions[sessionIndex]->getLinkIntf());
-            _BGPRoutingTable.push_back(entry);
+            _BGPRoutingTable.set(entry->getDestination(), entry->getNetmask().getNetmaskLength(), entry);
             _rt->addRoute(entry);
             return BGP::ROUTE_DESTINATION_CHANGED;
         }
@@ -350,12 +408,10 @@ unsigned char BGPRouting::decisionProcess(const BGPUpdateMessage& msg, BGP::Rout
     }
 
     entry->setInterface(_BGPSessions[sessionIndex]->getLinkIntf());
-    _BGPRoutingTable.push_back(entry);
+    _BGPRoutingTable.set(entry->getDestination(), entry->getNetmask().getNetmaskLength(), entry);
 
     if (_BGPSessions[sessionIndex]->getType() == BGP::EGP)
     {
-        std::string entryh = entry->getDestination().str();
-        std::string entryn = entry->getNetmask().str();
         _rt->addRoute(entry);
         //insertExternalRoute on OSPF ExternalRoutingTable if OSPF exist on this BGP router
         if (ospfExist(_rt))
@@ -398,67 +454,48 @@ bool BGPRouting::tieBreakingProcess(BGP::RoutingTableEntry* oldEntry, BGP::Routi
 void BGPRouting::updateSendProcess(const unsigned char type, BGP::SessionID sessionIndex, BGP::RoutingTableEntry* entry)
 {
     //Don't send the update Message if the route exists in listOUTTable
+    if (findInTable(_prefixListOUT, entry) != NULL || isInASList(_ASListOUT, entry))
+    {
+        return;
+    }
+
+    //RFC 4271 : set My AS in first position if it is not already
+    unsigned int nbAS = entry->getASCount();
+    std::vector<BGP::ASID> asPath;
+    asPath.reserve(nbAS+1);
+    if (entry->getAS(0) != _myAS)
+    {
+        asPath.push_back(_myAS);
+    }
+    for (unsigned int j = 0; j < nbAS; j++)
+    {
+        asPath.push_back(entry->getAS(j));
+    }
+    IPv4Address netMask = entry->getNetmask();
+    IPv4Address prefix = entry->getDestination().doAnd(netMask);
+    unsigned char length = (unsigned char) netMask.getNetmaskLength();
+
     //SESSION = EGP : send an update message to all BGP Peer (EGP && IGP)
     //if it is not the currentSession and if the session is already established
     //SESSION = IGP : send an update message to External BGP Peer (EGP) only
     //if it is not the currentSession and if the session is already established
+    BGP::type sessionType = _BGPSessions[sessionIndex]->getType();
     for (std::map<BGP::SessionID, BGPSession*>::iterator sessionIt = _BGPSessions.begin();
         sessionIt != _BGPSessions.end(); sessionIt ++)
     {
-        if (isInTable(_prefixListOUT, entry) != (unsigned long)-1 || isInASList(_ASListOUT, entry) ||
-            ((*sessionIt).first == sessionIndex && type != BGP::NEW_SESSION_ESTABLISHED ) ||
+        if (((*sessionIt).first == sessionIndex && type != BGP::NEW_SESSION_ESTABLISHED ) ||
             (type == BGP::NEW_SESSION_ESTABLISHED && (*sessionIt).first != sessionIndex ) ||
             !(*sessionIt).second->isEstablished() )
         {
             continue;
         }
-        if ((_BGPSessions[sessionIndex]->getType()==BGP::IGP && (*sessionIt).second->getType()==BGP::EGP ) ||
-            _BGPSessions[sessionIndex]->getType() == BGP::EGP ||
+        if ((sessionType == BGP::IGP && (*sessionIt).second->getType() == BGP::EGP ) ||
+            sessionType == BGP::EGP ||
             type == BGP::ROUTE_DESTINATION_CHANGED ||
             type == BGP::NEW_SESSION_ESTABLISHED )
         {
-            BGPUpdateNLRI                   NLRI;
-            BGPUpdatePathAttributeList  content;
-
-            unsigned int nbAS = entry->getASCount();
-            content.setAsPathArraySize(1);
-            content.getAsPath(0).setValueArraySize(1);
-            content.getAsPath(0).getValue(0).setType(BGP::AS_SEQUENCE);
-            //RFC 4271 : set My AS in first position if it is not already
-            if (entry->getAS(0) != _myAS)
-            {
-                content.getAsPath(0).getValue(0).setAsValueArraySize(nbAS+1);
-                content.getAsPath(0).getValue(0).setLength(1);
-                content.getAsPath(0).getValue(0).setAsValue(0, _myAS);
-                for (unsigned int j = 1; j < nbAS+1; j++)
-                {
-                    content.getAsPath(0).getValue(0).setAsValue(j, entry->getAS(j-1));
-                }
-            }
-            else
-            {
-                content.getAsPath(0).getValue(0).setAsValueArraySize(nbAS);
-                content.getAsPath(0).getValue(0).setLength(1);
-                for (unsigned int j = 0; j < nbAS; j++)
-                {
-                    content.getAsPath(0).getValue(0).setAsValue(j, entry->getAS(j));
-                }
-            }
-
-            InterfaceEntry*  iftEntry = (*sessionIt).second->getLinkIntf();
-            content.getOrigin().setValue((*sessionIt).second->getType());
-            content.getNextHop().setValue(iftEntry->ipv4Data()->getIPAddress());
-            IPv4Address netMask = entry->getNetmask();
-            NLRI.prefix = entry->getDestination().doAnd(netMask);
-            NLRI.length = (unsigned char) netMask.getNetmaskLength();
-            {
-                BGPUpdateMessage* updateMsg = new BGPUpdateMessage("BGPUpdate");
-                updateMsg->setPathAttributeListArraySize(1);
-                updateMsg->setPathAttributeList(content);
-                updateMsg->setNLRI(NLRI);
-                (*sessionIt).second->getSocket()->send(updateMsg);
-                (*sessionIt).second->addUpdateMsgSent();
-            }
+            // the UPDATE message is sent by the session, together with the other queued routes
+            (*sessionIt).second->queueUpdate(prefix, length, asPath);
         }
     }
 }
@@ -573,21 +610,23 @@ std::vector<const char *> BGPRouting::loadASConfig(cXMLElementList& ASConfig)
         }
         if (nodeName == "DenyRoute" || nodeName == "DenyRouteIN" || nodeName == "DenyRouteOUT")
         {
-            BGP::RoutingTableEntry* entry = new BGP::RoutingTableEntry();
-            entry->setDestination(IPv4Address((*ASConfigIt)->getAttribute("Address")));
-            entry->setNetmask(IPv4Address((*ASConfigIt)->getAttribute("Netmask")));
-            if (nodeName == "DenyRouteIN")
-            {
-                _prefixListIN.push_back(entry);
-            }
-            else if (nodeName == "DenyRouteOUT")
+            IPv4Address address((*ASConfigIt)->getAttribute("Address"));
+            IPv4Address netmask((*ASConfigIt)->getAttribute("Netmask"));
+            if (nodeName == "DenyRoute" || nodeName == "DenyRouteIN")
             {
-                _prefixListOUT.push_back(entry);
+                BGP::RoutingTableEntry* entry = new BGP::RoutingTableEntry();
+                entry->setDestination(address);
+                entry->setNetmask(netmask);
+                delete _prefixListIN.get(address, netmask.getNetmaskLength());
+                _prefixListIN.set(address, netmask.getNetmaskLength(), entry);
             }
-            else
+            if (nodeName == "DenyRoute" || nodeName == "DenyRouteOUT")
             {
-                _prefixListIN.push_back(entry);
-                _prefixListOUT.push_back(entry);
+                BGP::RoutingTableEntry* entry = new BGP::RoutingTableEntry();
+                entry->setDestination(address);
+                entry->setNetmask(netmask);
+                delete _prefixListOUT.get(address, netmask.getNetmaskLength());
+                _prefixListOUT.set(address, netmask.getNetmaskLength(), entry);
             }
         }
         else if (nodeName == "DenyAS" || nodeName == "DenyASIN" || nodeName == "DenyASOUT")
@@ -595,16 +634,16 @@ std::vector<const char *> BGPRouting::loadASConfig(cXMLElementList& ASConfig)
             BGP::ASID ASCur = atoi((*ASConfigIt)->getNodeValue());
             if (nodeName == "DenyASIN")
             {
-                _ASListIN.push_back(ASCur);
+                _ASListIN.insert(ASCur);
             }
             else if (nodeName == "DenyASOUT")
             {
-                _ASListOUT.push_back(ASCur);
+                _ASListOUT.insert(ASCur);
             }
             else
             {
-                _ASListIN.push_back(ASCur);
-                _ASListOUT.push_back(ASCur);
+                _ASListIN.insert(ASCur);
+                _ASListOUT.insert(ASCur);
             }
         }
         else
@@ -733,9 +772,9 @@ BGP::SessionID BGPRouting::createSession(BGP::type typeSession, const char* peer
 }
 
 
-BGP::SessionID BGPRouting::findIdFromPeerAddr(std::map<BGP::SessionID, BGPSession*> sessions, IPv4Address peerAddr)
+BGP::SessionID BGPRouting::findIdFromPeerAddr(const std::map<BGP::SessionID, BGPSession*>& sessions, const IPv4Address& peerAddr)
 {
-    for (std::map<BGP::SessionID, BGPSession*>::iterator sessionIterator = sessions.begin();
+    for (std::map<BGP::SessionID, BGPSession*>::const_iterator sessionIterator = sessions.begin();
         sessionIterator != sessions.end(); sessionIterator ++)
     {
         if ((*sessionIterator).second->getPeerAddr().equals(peerAddr))
@@ -748,18 +787,16 @@ BGP::SessionID BGPRouting::findIdFromPeerAddr(std::map<BGP::SessionID, BGPSessio
 
 /*delete BGP Routing entry, if the route deleted correctly return true, false else*/
 bool BGPRouting::deleteBGPRoutingEntry(BGP::RoutingTableEntry* entry){
-    for (std::vector<BGP::RoutingTableEntry*>::iterator it = _BGPRoutingTable.begin();
-         it != _BGPRoutingTable.end(); it++)
+    if (!_BGPRoutingTable.remove(entry->getDestination(), entry->getNetmask().getNetmaskLength()))
     {
-        if (((*it)->getDestination().getInt() & (*it)->getNetmask().getInt()) ==
-            (entry->getDestination().getInt() & entry->getNetmask().getInt()))
-        {
-            _BGPRoutingTable.erase(it);
-            _rt->deleteRoute(entry);
-            return true;
-        }
+        return false;
     }
-    return false;
+    // routes learned from IGP sessions are not in the IPv4 routing table
+    if (!_rt->deleteRoute(entry))
+    {
+        delete entry;
+    }
+    return true;
 }
 
 /*return index of the IPv4 table if the route is found, -1 else*/
@@ -788,9 +825,9 @@ int BGPRouting::isInInterfaceTable(IInterfaceTable* ifTable, IPv4Address addr)
     return -1;
 }
 
-BGP::SessionID BGPRouting::findIdFromSocketConnId(std::map<BGP::SessionID, BGPSession*> sessions, int connId)
+BGP::SessionID BGPRouting::findIdFromSocketConnId(const std::map<BGP::SessionID, BGPSession*>& sessions, int connId)
 {
-    for (std::map<BGP::SessionID, BGPSession*>::iterator sessionIterator = sessions.begin();
+    for (std::map<BGP::SessionID, BGPSession*>::const_iterator sessionIterator = sessions.begin();
         sessionIterator != sessions.end(); sessionIterator ++)
     {
         TCPSocket* socket = (*sessionIterator).second->getSocket();
@@ -802,32 +839,24 @@ BGP::SessionID BGPRouting::findIdFromSocketConnId(std::map<BGP::SessionID, BGPSe
     return -1;
 }
 
-/*return index of the table if the route is found, -1 else*/
-unsigned long BGPRouting::isInTable(std::vector<BGP::RoutingTableEntry*> rtTable, BGP::RoutingTableEntry* entry)
+/*return the entry of the table if the route is found, NULL else*/
+BGP::RoutingTableEntry* BGPRouting::findInTable(const BGP::PrefixTrie<BGP::RoutingTableEntry>& rtTable, const BGP::RoutingTableEntry* entry)
 {
-    for (unsigned long i = 0; i < rtTable.size(); i++)
-    {
-        BGP::RoutingTableEntry* entryCur = rtTable[i];
-        if ((entry->getDestination().getInt() & entry->getNetmask().getInt()) ==
-            (entryCur->getDestination().getInt() & entryCur->getNetmask().getInt()))
-        {
-            return i;
-        }
-    }
-    return -1;
+    return rtTable.get(entry->getDestination(), entry->getNetmask().getNetmaskLength());
 }
 
 /*return true if the AS is found, false else*/
-bool BGPRouting::isInASList(std::vector<BGP::ASID> ASList, BGP::RoutingTableEntry* entry)
+bool BGPRouting::isInASList(const BGP::ASIDSet& ASList, const BGP::RoutingTableEntry* entry)
 {
-    for (std::vector<BGP::ASID>::iterator it = ASList.begin(); it != ASList.end(); it++)
+    if (ASList.empty())
+    {
+        return false;
+    }
+    for (unsigned int i = 0; i < entry->getASCount(); i++)
     {
-        for (unsigned int i = 0; i < entry->getASCount(); i++)
+        if (ASList.contains(entry->getAS(i)))
         {
-            if ((*it) == entry->getAS(i))
-            {
-                return true;
-            }
+            return true;
         }
     }
     return false;
@@ -27,6 +27,7 @@
 #include "OSPFRoutingAccess.h"
 #include "BGPRoutingTableEntry.h"
 #include "BGPCommon.h"
+#include "BGPPrefixTrie.h"
 #include "IPv4InterfaceData.h"
 #include "IPv4Address.h"
 #include "BGPOpen.h"
@@ -41,7 +42,8 @@ class INET_API BGPRouting : public cSimpleModule, public ILifecycle, public TCPS
 {
 public:
     BGPRouting()
-        : _myAS(0), _inft(0), _rt(0) {}
+        : _myAS(0), _inft(0), _rt(0), _updateBatchDelay(0),
+          _updateMsgProcessed(0), _updateProcessingTime(0) {}
 
     virtual ~BGPRouting();
 
@@ -66,7 +68,8 @@ protected:
     cMessage*       getCancelEvent(cMessage* msg)               { return cancelEvent(msg);}
     cGate*          getGate(const char* gateName)               { return gate(gateName);}
     IRoutingTable*  getIPRoutingTable()                         { return _rt;}
-    std::vector<BGP::RoutingTableEntry*> getBGPRoutingTable()   { return _BGPRoutingTable;}
+    const BGP::PrefixTrie<BGP::RoutingTableEntry>& getBGPRoutingTable() { return _BGPRoutingTable;}
+    simtime_t       getUpdateBatchDelay()                       { return _updateBatchDelay;}
     /**
      * \brief active listenSocket for a given session (used by BGPFSM)
      */
@@ -114,8 +117,13 @@ private:
     bool tieBreakingProcess(BGP::RoutingTableEntry* oldEntry, BGP::RoutingTableEntry* entry);
 
     BGP::SessionID createSession(BGP::type typeSession, const char* peerAddr);
-    bool isInASList(std::vector<BGP::ASID> ASList, BGP::RoutingTableEntry* entry);
-    unsigned long   isInTable(std::vector<BGP::RoutingTableEntry*> rtTable, BGP::RoutingTableEntry* entry);
+    bool isInASList(const BGP::ASIDSet& ASList, const BGP::RoutingTableEntry* entry);
+    /**
+     * \brief find the entry of the table with the same prefix as the route
+     *
+     * \return the entry if it is found, NULL else
+     */
+    BGP::RoutingTableEntry* findInTable(const BGP::PrefixTrie<BGP::RoutingTableEntry>& rtTable, const BGP::RoutingTableEntry* entry);
 
     std::vector<const char *> loadASConfig(cXMLElementList& ASConfig);
     void loadSessionConfig(cXMLElementList& sessionList, simtime_t* delayTab);
@@ -124,10 +132,10 @@ private:
     bool ospfExist(IRoutingTable* rtTable);
     void loadTimerConfig(cXMLElementList& timerConfig, simtime_t* delayTab);
     unsigned char asLoopDetection(BGP::RoutingTableEntry* entry, BGP::ASID myAS);
-    BGP::SessionID findIdFromPeerAddr(std::map<BGP::SessionID, BGPSession*> sessions, IPv4Address peerAddr);
+    BGP::SessionID findIdFromPeerAddr(const std::map<BGP::SessionID, BGPSession*>& sessions, const IPv4Address& peerAddr);
     int isInRoutingTable(IRoutingTable* rtTable, IPv4Address addr);
     int isInInterfaceTable(IInterfaceTable* rtTable, IPv4Address addr);
-    BGP::SessionID findIdFromSocketConnId(std::map<BGP::SessionID, BGPSession*> sessions, int connId);
+    BGP::SessionID findIdFromSocketConnId(const std::map<BGP::SessionID, BGPSession*>& sessions, int connId);
     unsigned int calculateStartDelay(int rtListSize, unsigned char rtPosition, unsigned char rtPeerPosition);
 
     TCPSocketMap                            _socketMap;
@@ -136,12 +144,19 @@ private:
 
     IInterfaceTable*                        _inft;
     IRoutingTable*                          _rt;                // The IP routing table
-    std::vector<BGP::RoutingTableEntry*>    _BGPRoutingTable;   // The BGP routing table
-    std::vector<BGP::RoutingTableEntry*>    _prefixListIN;
-    std::vector<BGP::RoutingTableEntry*>    _prefixListOUT;
-    std::vector<BGP::ASID>                  _ASListIN;
-    std::vector<BGP::ASID>                  _ASListOUT;
+    BGP::PrefixTrie<BGP::RoutingTableEntry> _BGPRoutingTable;   // The BGP routing table (Loc-RIB)
+    BGP::PrefixTrie<BGP::RoutingTableEntry> _prefixListIN;
+    BGP::PrefixTrie<BGP::RoutingTableEntry> _prefixListOUT;
+    BGP::ASIDSet                            _ASListIN;
+    BGP::ASIDSet                            _ASListOUT;
     std::map<BGP::SessionID, BGPSession*>   _BGPSessions;
+    simtime_t                               _updateBatchDelay;  // UPDATE messages are sent in batches, after this delay
+
+    // statistics of the received UPDATE messages
+    unsigned long                           _updateMsgProcessed;
+    double                                  _updateProcessingTime;  // wall-clock time spent in processing them, in seconds
+    simtime_t                               _firstUpdateTime;
+    simtime_t                               _lastLocRIBChangeTime;
 
     static const int  BGP_TCP_CONNECT_VALID = 71;
     static const int  BGP_TCP_CONNECT_CONFIRM = 72;
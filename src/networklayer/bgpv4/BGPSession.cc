@@ -23,7 +23,7 @@ BGPSession::BGPSession(BGPRouting& _bgpRouting)
     : _bgpRouting(_bgpRouting), _ptrStartEvent(0), _connectRetryCounter(0)
     , _connectRetryTime(BGP_RETRY_TIME), _ptrConnectRetryTimer(0)
     , _holdTime(BGP_HOLD_TIME), _ptrHoldTimer(0)
-    , _keepAliveTime(BGP_KEEP_ALIVE), _ptrKeepAliveTimer(0)
+    , _keepAliveTime(BGP_KEEP_ALIVE), _ptrKeepAliveTimer(0), _ptrUpdateBatchTimer(0)
     , _openMsgSent(0), _openMsgRcv(0), _keepAliveMsgSent(0)
     , _keepAliveMsgRcv(0), _updateMsgSent(0), _updateMsgRcv(0)
 {
@@ -34,10 +34,12 @@ BGPSession::BGPSession(BGPRouting& _bgpRouting)
 
 BGPSession::~BGPSession()
 {
+    clearAdjRIBOut();
     _bgpRouting.getCancelAndDelete(_ptrConnectRetryTimer);
     _bgpRouting.getCancelAndDelete(_ptrStartEvent);
     _bgpRouting.getCancelAndDelete(_ptrHoldTimer);
     _bgpRouting.getCancelAndDelete(_ptrKeepAliveTimer);
+    _bgpRouting.getCancelAndDelete(_ptrUpdateBatchTimer);
     _info.socket->~TCPSocket();
     _info.socketListen->~TCPSocket();
 }
@@ -72,10 +74,12 @@ void BGPSession::setTimers(simtime_t* delayTab)
     _ptrConnectRetryTimer = new cMessage("BGP Connect Retry", BGP::CONNECT_RETRY_KIND);
     _ptrHoldTimer = new cMessage("BGP Hold Timer", BGP::HOLD_TIME_KIND);
     _ptrKeepAliveTimer = new cMessage("BGP Keep Alive Timer", BGP::KEEP_ALIVE_KIND);
+    _ptrUpdateBatchTimer = new cMessage("BGP Update Batch Timer", BGP::UPDATE_BATCH_KIND);
 
     _ptrConnectRetryTimer->setContextPointer(this);
     _ptrHoldTimer->setContextPointer(this);
     _ptrKeepAliveTimer->setContextPointer(this);
+    _ptrUpdateBatchTimer->setContextPointer(this);
 }
 
 void BGPSession::startConnection()
@@ -136,6 +140,107 @@ void BGPSession::sendKeepAliveMessage()
     _keepAliveMsgSent ++;
 }
 
+void BGPSession::queueUpdate(const IPv4Address& prefix, unsigned char length, const std::vector<BGP::ASID>& asPath)
+{
+    BGP::AdjRIBOutEntry* entry = _adjRIBOut.get(prefix, length);
+    if (entry == NULL)
+    {
+        entry = new BGP::AdjRIBOutEntry();
+        entry->prefix = prefix.doAnd(IPv4Address::makeNetmask(length));
+        entry->length = length;
+        entry->pending = false;
+        _adjRIBOut.set(prefix, length, entry);
+    }
+    else if (entry->asPath == asPath)
+    {
+        // the peer already has this route, or it is queued already
+        return;
+    }
+    entry->asPath = asPath;
+    if (!entry->pending)
+    {
+        entry->pending = true;
+        _pendingUpdates.push_back(entry);
+    }
+    if (!_ptrUpdateBatchTimer->isScheduled())
+    {
+        _bgpRouting.getScheduleAt(_bgpRouting.getSimTime() + _bgpRouting.getUpdateBatchDelay(), _ptrUpdateBatchTimer);
+    }
+}
+
+void BGPSession::sendUpdateMessages()
+{
+    // RFC 4271, 9.2: routes with the same path attributes can be advertised in one UPDATE message.
+    // The other path attributes are the same for every route sent on this session.
+    typedef std::map<std::vector<BGP::ASID>, std::vector<BGP::AdjRIBOutEntry*> > RouteGroups;
+    RouteGroups routeGroups;
+    for (std::vector<BGP::AdjRIBOutEntry*>::iterator it = _pendingUpdates.begin(); it != _pendingUpdates.end(); it++)
+    {
+        (*it)->pending = false;
+        routeGroups[(*it)->asPath].push_back(*it);
+    }
+    _pendingUpdates.clear();
+
+    for (RouteGroups::iterator groupIt = routeGroups.begin(); groupIt != routeGroups.end(); groupIt++)
+    {
+        const std::vector<BGP::ASID>& asPath = (*groupIt).first;
+        const std::vector<BGP::AdjRIBOutEntry*>& routes = (*groupIt).second;
+
+        BGPUpdatePathAttributeList content;
+        content.setAsPathArraySize(1);
+        content.getAsPath(0).setValueArraySize(1);
+        content.getAsPath(0).getValue(0).setType(BGP::AS_SEQUENCE);
+        content.getAsPath(0).getValue(0).setAsValueArraySize(asPath.size());
+        content.getAsPath(0).getValue(0).setLength(1);
+        for (unsigned int j = 0; j < asPath.size(); j++)
+        {
+            content.getAsPath(0).getValue(0).setAsValue(j, asPath[j]);
+        }
+        content.getOrigin().setValue(_info.sessionType);
+        content.getNextHop().setValue(_info.linkIntf->ipv4Data()->getIPAddress());
+
+        unsigned int i = 0;
+        while (i < routes.size())
+        {
+            BGPUpdateMessage* updateMsg = new BGPUpdateMessage("BGPUpdate");
+            updateMsg->setPathAttributeListArraySize(1);
+            updateMsg->setPathAttributeList(content);
+            // as many prefixes as fit into the maximum message size
+            unsigned int nlriCount = (BGP_MAX_MESSAGE_OCTETS - updateMsg->getByteLength()) / BGP_NLRI_OCTETS;
+            if (nlriCount > routes.size() - i)
+            {
+                nlriCount = routes.size() - i;
+            }
+            updateMsg->setNLRIArraySize(nlriCount);
+            for (unsigned int k = 0; k < nlriCount; k++, i++)
+            {
+                BGPUpdateNLRI NLRI;
+                NLRI.prefix = routes[i]->prefix;
+                NLRI.length = routes[i]->length;
+                updateMsg->setNLRI(k, NLRI);
+            }
+            _info.socket->send(updateMsg);
+            _updateMsgSent ++;
+        }
+    }
+}
+
+void BGPSession::clearAdjRIBOut()
+{
+    std::vector<BGP::AdjRIBOutEntry*> entries;
+    _adjRIBOut.getValues(entries);
+    for (std::vector<BGP::AdjRIBOutEntry*>::iterator it = entries.begin(); it != entries.end(); it++)
+    {
+        delete (*it);
+    }
+    _adjRIBOut.clear();
+    _pendingUpdates.clear();
+    if (_ptrUpdateBatchTimer)
+    {
+        _bgpRouting.getCancelEvent(_ptrUpdateBatchTimer);
+    }
+}
+
 void BGPSession::getStatistics(unsigned int* statTab)
 {
     statTab[0] += _openMsgSent;
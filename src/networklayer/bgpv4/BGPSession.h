@@ -23,6 +23,7 @@
 #include "INETDefs.h"
 
 #include "BGPCommon.h"
+#include "BGPPrefixTrie.h"
 #include "TCPSocket.h"
 #include "BGPRouting.h"
 #include "BGPFSM.h"
@@ -40,6 +41,17 @@ public:
     void            restartsConnectRetryTimer(bool start = true);
     void            sendOpenMessage();
     void            sendKeepAliveMessage();
+    /**
+     * \brief RFC 4271, 9.2 : stores the route in the Adj-RIB-Out and queues it for
+     * advertisement, unless the same route was already advertised to the peer.
+     * Queued routes are sent by sendUpdateMessages() after the update batch delay.
+     */
+    void            queueUpdate(const IPv4Address& prefix, unsigned char length, const std::vector<BGP::ASID>& asPath);
+    /**
+     * \brief sends the queued routes, routes with the same AS path share the UPDATE messages
+     */
+    void            sendUpdateMessages();
+    void            clearAdjRIBOut();
     void            addUpdateMsgSent()                          { _updateMsgSent ++;}
     void            listenConnectionFromPeer()                  { _bgpRouting.listenConnectionFromPeer(_info.sessionID);}
     void            openTCPConnectionToPeer()                   { _bgpRouting.openTCPConnectionToPeer(_info.sessionID);}
@@ -62,7 +74,7 @@ public:
     TCPSocket*      getSocket()                                 { return _info.socket;}
     TCPSocket*      getSocketListen()                           { return _info.socketListen;}
     IRoutingTable*  getIPRoutingTable()                         { return _bgpRouting.getIPRoutingTable();}
-    std::vector<BGP::RoutingTableEntry*> getBGPRoutingTable()   { return _bgpRouting.getBGPRoutingTable();}
+    const BGP::PrefixTrie<BGP::RoutingTableEntry>& getBGPRoutingTable() { return _bgpRouting.getBGPRoutingTable();}
     Macho::Machine<BGPFSM::TopState>&    getFSM()               { return *_fsm;}
     bool checkExternalRoute(const IPv4Route* ospfRoute)           { return _bgpRouting.checkExternalRoute(ospfRoute);}
     void updateSendProcess(BGP::RoutingTableEntry* entry)       { return _bgpRouting.updateSendProcess(BGP::NEW_SESSION_ESTABLISHED, _info.sessionID, entry);}
@@ -86,6 +98,11 @@ private:
     cMessage *      _ptrHoldTimer;
     simtime_t       _keepAliveTime;
     cMessage *      _ptrKeepAliveTimer;
+    cMessage *      _ptrUpdateBatchTimer;
+
+    //Adj-RIB-Out
+    BGP::PrefixTrie<BGP::AdjRIBOutEntry> _adjRIBOut;
+    std::vector<BGP::AdjRIBOutEntry*>    _pendingUpdates;
 
     //Statistics
     unsigned int    _openMsgSent;
@@ -74,6 +74,7 @@ InterfaceEntry::InterfaceEntry(cModule* ifmod)
     multicast = false;
     pointToPoint = false;
     loopback = false;
+    segmentationOffload = false;
     datarate = 0;
 
     ipv4data = NULL;
@@ -103,6 +104,7 @@ std::string InterfaceEntry::info() const
     if (isMulticast()) out << " MULTICAST";
     if (isPointToPoint()) out << " POINTTOPOINT";
     if (isLoopback()) out << " LOOPBACK";
+    if (isSegmentationOffload()) out << " SEGOFFLOAD";
     out << "  macAddr:";
     if (getMacAddress().isUnspecified())
         out << "n/a";
@@ -140,6 +142,7 @@ std::string InterfaceEntry::detailedInfo() const
     if (isMulticast()) out << "MULTICAST ";
     if (isPointToPoint()) out << "POINTTOPOINT ";
     if (isLoopback()) out << "LOOPBACK ";
+    if (isSegmentationOffload()) out << "SEGOFFLOAD ";
     out << "\n";
     out << "  macAddr:";
     if (getMacAddress().isUnspecified())
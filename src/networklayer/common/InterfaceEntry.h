@@ -109,6 +109,7 @@ class INET_API InterfaceEntry : public cNamedObject
     bool multicast;       ///< interface supports multicast
     bool pointToPoint;    ///< interface is point-to-point link
     bool loopback;        ///< interface is loopback interface
+    bool segmentationOffload; ///< interface splits TCP super-segments itself (see SegmentationOffload); IP checks only that the pieces fit into the MTU
     double datarate;      ///< data rate in bit/s
     MACAddress macAddr;   ///< link-layer address (for now, only IEEE 802 MAC addresses are supported)
     InterfaceToken token; ///< for IPv6 stateless autoconfig (RFC 1971), interface identifier (RFC 2462)
@@ -130,7 +131,7 @@ class INET_API InterfaceEntry : public cNamedObject
     enum {F_CARRIER, F_STATE,
           F_NAME, F_NODE_IN_GATEID, F_NODE_OUT_GATEID, F_NETW_GATEIDX,
           F_LOOPBACK, F_BROADCAST, F_MULTICAST, F_POINTTOPOINT,
-          F_DATARATE, F_MTU, F_MACADDRESS, F_TOKEN,
+          F_DATARATE, F_MTU, F_MACADDRESS, F_TOKEN, F_SEGMENTATION_OFFLOAD,
           F_IPV4_DATA, F_IPV6_DATA, F_ISIS_DATA, F_TRILL_DATA, F_IEEE8021D_DATA};
 
   protected:
@@ -179,6 +180,7 @@ class INET_API InterfaceEntry : public cNamedObject
     bool isMulticast() const          {return multicast;}
     bool isPointToPoint() const       {return pointToPoint;}
     bool isLoopback() const           {return loopback;}
+    bool isSegmentationOffload() const {return segmentationOffload;}
     double getDatarate() const        {return datarate;}
     const MACAddress& getMacAddress() const  {return macAddr;}
     const InterfaceToken& getInterfaceToken() const {return token;}
@@ -197,6 +199,7 @@ class INET_API InterfaceEntry : public cNamedObject
     virtual void setMulticast(bool b)    {if (multicast!=b) {multicast = b; configChanged(F_MULTICAST);}}
     virtual void setPointToPoint(bool b) {if (pointToPoint!=b) {pointToPoint = b; configChanged(F_POINTTOPOINT);}}
     virtual void setLoopback(bool b)     {if (loopback!=b) {loopback = b; configChanged(F_LOOPBACK);}}
+    virtual void setSegmentationOffload(bool b) {if (segmentationOffload!=b) {segmentationOffload = b; configChanged(F_SEGMENTATION_OFFLOAD);}}
     virtual void setDatarate(double d)   {if (datarate!=d) {datarate = d; configChanged(F_DATARATE);}}
     virtual void setMACAddress(const MACAddress& addr) {if (macAddr!=addr) {macAddr = addr; configChanged(F_MACADDRESS);}}
     virtual void setInterfaceToken(const InterfaceToken& t) {token = t; configChanged(F_TOKEN);}
@@ -0,0 +1,124 @@
+//
+// Copyright (C) 2026 OpenSim Ltd
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program; if not, see <http://www.gnu.org/licenses/>.
+//
+
+#include "SegmentationOffload.h"
+
+#ifdef WITH_TCP_COMMON
+#include "TCPSegment.h"
+#endif
+
+#ifdef WITH_IPv4
+#include "IPv4Datagram.h"
+#endif
+
+#ifdef WITH_IPv6
+#include "IPv6Datagram.h"
+#endif
+
+
+int SegmentationOffload::getSegmentCount(cPacket *datagram)
+{
+#ifdef WITH_TCP_COMMON
+    TCPSegment *tcpseg = dynamic_cast<TCPSegment *>(datagram->getEncapsulatedPacket());
+    if (tcpseg)
+        return tcpseg->getSegmentCount();
+#endif
+    return 1;
+}
+
+int SegmentationOffload::getNetworkHeaderLength(cPacket *datagram)
+{
+#ifdef WITH_IPv4
+    IPv4Datagram *ipv4Datagram = dynamic_cast<IPv4Datagram *>(datagram);
+    if (ipv4Datagram)
+        return ipv4Datagram->getHeaderLength();
+#endif
+#ifdef WITH_IPv6
+    IPv6Datagram *ipv6Datagram = dynamic_cast<IPv6Datagram *>(datagram);
+    if (ipv6Datagram)
+        return ipv6Datagram->calculateHeaderByteLength();
+#endif
+    throw cRuntimeError("SegmentationOffload: unknown network protocol of (%s)%s",
+            datagram->getClassName(), datagram->getName());
+}
+
+int SegmentationOffload::getSegmentLength(cPacket *datagram)
+{
+#ifdef WITH_TCP_COMMON
+    TCPSegment *tcpseg = dynamic_cast<TCPSegment *>(datagram->getEncapsulatedPacket());
+    if (tcpseg)
+        return getNetworkHeaderLength(datagram) + tcpseg->getHeaderLength() + tcpseg->getPayloadLength() / tcpseg->getSegmentCount();
+#endif
+    return datagram->getByteLength();
+}
+
+void SegmentationOffload::addPieceHeaders(cPacket *datagram)
+{
+    int count = getSegmentCount(datagram);
+    if (count > 1)
+        datagram->addByteLength((int64)(count - 1) * getNetworkHeaderLength(datagram));
+}
+
+void SegmentationOffload::split(cPacket *datagram, std::vector<cPacket *>& result)
+{
+#ifdef WITH_TCP_COMMON
+    // the length of the datagram may include the headers of all pieces (see addPieceHeaders())
+    int headerLength = getNetworkHeaderLength(datagram);
+    TCPSegment *tcpseg = check_and_cast<TCPSegment *>(datagram->decapsulate());
+    datagram->setByteLength(headerLength);
+    unsigned int count = tcpseg->getSegmentCount();
+    ulong segmentPayload = tcpseg->getPayloadLength() / count;
+
+    // super-segments are only created in bytecount mode, from full-sized segments
+    ASSERT(count > 1 && segmentPayload * count == tcpseg->getPayloadLength());
+    ASSERT(tcpseg->getPayloadArraySize() == 0);
+
+    uint32 seq = tcpseg->getSequenceNo();
+    bool fin = tcpseg->getFinBit();
+
+#ifdef WITH_IPv4
+    // IPv4 reserved an identification for each piece (see IPv4::encapsulate())
+    IPv4Datagram *ipv4Datagram = dynamic_cast<IPv4Datagram *>(datagram);
+    int identification = ipv4Datagram ? ipv4Datagram->getIdentification() : 0;
+#endif
+
+    for (unsigned int i = 0; i < count; i++)
+    {
+        bool last = (i == count - 1);
+
+        // datagram has no payload at this point, so duplicating it is cheap
+        TCPSegment *segment = last ? tcpseg : tcpseg->dup();
+        cPacket *piece = last ? datagram : datagram->dup();
+
+        segment->setSequenceNo(seq + i * segmentPayload);
+        segment->setPayloadLength(segmentPayload);
+        segment->setFinBit(last && fin);
+        segment->setSegmentCount(1);
+        segment->setByteLength(segment->getHeaderLength() + segmentPayload);
+
+        piece->encapsulate(segment);
+#ifdef WITH_IPv4
+        if (ipv4Datagram)
+            static_cast<IPv4Datagram *>(piece)->setIdentification(identification + i);
+#endif
+        result.push_back(piece);
+    }
+#else
+    throw cRuntimeError("SegmentationOffload: cannot split (%s)%s, TCP support is not compiled in",
+            datagram->getClassName(), datagram->getName());
+#endif
+}
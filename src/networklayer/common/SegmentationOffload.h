@@ -0,0 +1,73 @@
+//
+// Copyright (C) 2026 OpenSim Ltd
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program; if not, see <http://www.gnu.org/licenses/>.
+//
+
+#ifndef __INET_SEGMENTATIONOFFLOAD_H
+#define __INET_SEGMENTATIONOFFLOAD_H
+
+#include <vector>
+
+#include "INETDefs.h"
+
+
+/**
+ * Utility functions for TCP super-segments (see TCPSegment's segmentCount
+ * field and the superSegmentSize parameter of ~TCP).
+ *
+ * A super-segment travels as one network-layer datagram down to the
+ * interface, and it is split into ordinary datagrams right before they
+ * are serialized: by the link layer if the interface has segmentation
+ * offload (InterfaceEntry::isSegmentationOffload()), or by IP otherwise.
+ */
+class INET_API SegmentationOffload
+{
+  public:
+    /**
+     * Returns the number of TCP segments carried by the given network-layer
+     * datagram (IPv4 or IPv6): the segmentCount of the encapsulated
+     * TCPSegment, or 1 if it does not contain a super-segment.
+     */
+    static int getSegmentCount(cPacket *datagram);
+
+    /**
+     * Returns the byte length of one of the datagrams the given super-segment
+     * datagram will be split into: the network and TCP headers plus the
+     * payload of one segment. This is what has to fit into the MTU.
+     */
+    static int getSegmentLength(cPacket *datagram);
+
+    /**
+     * Adds the network headers of the pieces but the first one to the length
+     * of a super-segment datagram, so that it is the total length of the
+     * datagrams it will be split into (the TCP headers are already counted by
+     * TCP). IP calls it when the interface will split the datagram, so that
+     * the queues of the interface count the bytes that will be sent.
+     */
+    static void addPieceHeaders(cPacket *datagram);
+
+    /**
+     * Splits a datagram that carries a super-segment into datagrams carrying
+     * ordinary segments, and appends them to 'result' in sequence order.
+     * The datagram object itself is reused as the last piece. IPv4 pieces
+     * get consecutive identifications, starting with that of the datagram.
+     */
+    static void split(cPacket *datagram, std::vector<cPacket *>& result);
+
+  protected:
+    static int getNetworkHeaderLength(cPacket *datagram);
+};
+
+#endif
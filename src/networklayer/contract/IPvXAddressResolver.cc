@@ -119,6 +119,9 @@ bool IPvXAddressResolver::tryResolve(const char *s, IPvXAddress& result, int add
     cModule *mod = simulation.getModuleByPath(modname.c_str());
     if (!mod)
         throw cRuntimeError("IPvXAddressResolver: module `%s' not found", modname.c_str());
+    if (mod->isPlaceholder())
+        throw cRuntimeError("IPvXAddressResolver: module `%s' is in an other partition of the parallel simulation, "
+                "its address cannot be resolved (use a numeric address)", modname.c_str());
 
 
     // check protocol
@@ -141,6 +144,8 @@ bool IPvXAddressResolver::tryResolve(const char *s, IPvXAddress& result, int add
         cModule *destnode = simulation.getModuleByPath(destnodename.c_str());
         if (!destnode)
             throw cRuntimeError("IPvXAddressResolver: destination module `%s' not found", destnodename.c_str());
+        if (destnode->isPlaceholder())
+            throw cRuntimeError("IPvXAddressResolver: destination module `%s' is in an other partition of the parallel simulation", destnodename.c_str());
         result = addressOf(mod, destnode, addrType);
     }
     else if (ifname.empty())
@@ -35,6 +35,7 @@
 #include "NodeOperations.h"
 #include "NodeStatus.h"
 #include "NotificationBoard.h"
+#include "SegmentationOffload.h"
 
 Define_Module(IPv4);
 
@@ -700,6 +701,20 @@ void IPv4::fragmentPostRouting(IPv4Datagram *datagram, const InterfaceEntry *ie,
 
 void IPv4::fragmentAndSend(IPv4Datagram *datagram, const InterfaceEntry *ie, IPv4Address nextHopAddr)
 {
+    // TCP super-segment: the interface splits it if it can and the pieces fit
+    // into its MTU, otherwise we split it here and send the pieces as separate
+    // datagrams (fragmenting them if needed)
+    bool isSuperSegment = SegmentationOffload::getSegmentCount(datagram) > 1;
+    if (isSuperSegment && (!ie->isSegmentationOffload() ||
+            (ie->getMTU() != 0 && SegmentationOffload::getSegmentLength(datagram) > ie->getMTU())))
+    {
+        std::vector<cPacket *> pieces;
+        SegmentationOffload::split(datagram, pieces);
+        for (unsigned int i = 0; i < pieces.size(); i++)
+            fragmentAndSend(check_and_cast<IPv4Datagram *>(pieces[i]), ie, nextHopAddr);
+        return;
+    }
+
     // fill in source address
     if (datagram->getSrcAddress().isUnspecified())
         datagram->setSrcAddress(ie->ipv4Data()->getIPAddress());
@@ -720,9 +735,12 @@ void IPv4::fragmentAndSend(IPv4Datagram *datagram, const InterfaceEntry *ie, IPv
 
     int mtu = ie->getMTU();
 
-    // send datagram straight out if it doesn't require fragmentation (note: mtu==0 means infinite mtu)
-    if (mtu == 0 || datagram->getByteLength() <= mtu)
+    // send datagram straight out if it doesn't require fragmentation (note: mtu==0 means infinite mtu;
+    // super-segments are split into MTU-sized pieces by the interface)
+    if (mtu == 0 || datagram->getByteLength() <= mtu || isSuperSegment)
     {
+        if (isSuperSegment)
+            SegmentationOffload::addPieceHeaders(datagram);
         sendDatagramToOutput(datagram, ie, nextHopAddr);
         return;
     }
@@ -803,7 +821,9 @@ IPv4Datagram *IPv4::encapsulate(cPacket *transportPacket, IPv4ControlInfo *contr
     // set other fields
     datagram->setTypeOfService(controlInfo->getTypeOfService());
 
-    datagram->setIdentification(curFragmentId++);
+    // a TCP super-segment gets an identification for each datagram it will be split into
+    datagram->setIdentification(curFragmentId);
+    curFragmentId += SegmentationOffload::getSegmentCount(datagram);
     datagram->setMoreFragments(false);
     datagram->setDontFragment(controlInfo->getDontFragment());
     datagram->setFragmentOffset(0);
@@ -182,6 +182,24 @@ class INET_API IRoutingTable
      */
     virtual bool deleteRoute(IPv4Route *entry) = 0;
 
+    /**
+     * Starts a batch of unicast route changes, to be closed with
+     * commitRouteChanges(). Within the batch, addRoute(), removeRoute(),
+     * deleteRoute() and route modifications do not invalidate the caches
+     * and do not update the display string, and the NF_IPv4_ROUTE_ADDED and
+     * NF_IPv4_ROUTE_CHANGED notifications are collected and fired only once
+     * per route at commit. NF_IPv4_ROUTE_DELETED is still fired immediately,
+     * while the route object is alive, except for routes added within the
+     * same batch: these are neither announced nor reported as deleted.
+     * Batches may be nested; the outermost commit completes the batch.
+     */
+    virtual void beginRouteChanges() = 0;
+
+    /**
+     * Completes the batch started with beginRouteChanges().
+     */
+    virtual void commitRouteChanges() = 0;
+
     /**
      * Returns the total number of multicast routes.
      */
@@ -56,6 +56,8 @@ RoutingTable::RoutingTable()
 {
     ift = NULL;
     nb = NULL;
+    routeChangesDepth = 0;
+    routesChangedInBatch = false;
 }
 
 RoutingTable::~RoutingTable()
@@ -234,7 +236,7 @@ void RoutingTable::deleteInterfaceRoutes(InterfaceEntry *entry)
         {
             it = routes.erase(it);
             ASSERT(route->getRoutingTable() == this); // still filled in, for the listeners' benefit
-            nb->fireChangeNotification(NF_IPv4_ROUTE_DELETED, route);
+            fireRouteDeleted(route);
             delete route;
             changed = true;
         }
@@ -282,6 +284,94 @@ void RoutingTable::invalidateCache()
     localBroadcastAddresses.clear();
 }
 
+void RoutingTable::unicastRoutesChanged()
+{
+    if (routeChangesDepth > 0)
+    {
+        // the routing cache may refer to deleted routes, so it cannot wait for
+        // the commit; it is usually empty within a batch, so this is cheap
+        routingCache.clear();
+        routesChangedInBatch = true;
+    }
+    else
+    {
+        invalidateCache();
+        updateDisplayString();
+    }
+}
+
+void RoutingTable::fireRouteAdded(IPv4Route *entry)
+{
+    if (routeChangesDepth > 0)
+    {
+        if (pendingAddedSet.insert(entry).second)
+            pendingAddedRoutes.push_back(entry);
+    }
+    else
+        nb->fireChangeNotification(NF_IPv4_ROUTE_ADDED, entry);
+}
+
+void RoutingTable::fireRouteChanged(IPv4Route *entry)
+{
+    if (routeChangesDepth > 0)
+    {
+        // a route added in this batch is announced with its final contents anyway
+        if (pendingAddedSet.find(entry) == pendingAddedSet.end() && pendingChangedSet.insert(entry).second)
+            pendingChangedRoutes.push_back(entry);
+    }
+    else
+        nb->fireChangeNotification(NF_IPv4_ROUTE_CHANGED, entry); // TODO include fieldCode in the notification
+}
+
+void RoutingTable::fireRouteDeleted(IPv4Route *entry)
+{
+    // the vectors may still contain entry, but it is skipped at commit because
+    // it is no longer in the sets
+    pendingChangedSet.erase(entry);
+    if (pendingAddedSet.erase(entry) == 0)
+        nb->fireChangeNotification(NF_IPv4_ROUTE_DELETED, entry);
+}
+
+void RoutingTable::beginRouteChanges()
+{
+    Enter_Method("beginRouteChanges()");
+
+    routeChangesDepth++;
+}
+
+void RoutingTable::commitRouteChanges()
+{
+    Enter_Method("commitRouteChanges()");
+
+    if (routeChangesDepth == 0)
+        error("commitRouteChanges(): no beginRouteChanges() call to match");
+    if (--routeChangesDepth > 0)
+        return;
+
+    if (routesChangedInBatch)
+    {
+        routesChangedInBatch = false;
+        invalidateCache();
+        updateDisplayString();
+    }
+
+    // listeners may change the routing table, even start a new batch,
+    // so the notifications are fired from local copies
+    std::vector<IPv4Route *> addedRoutes;
+    std::vector<IPv4Route *> changedRoutes;
+    addedRoutes.swap(pendingAddedRoutes);
+    changedRoutes.swap(pendingChangedRoutes);
+
+    // each route is fired at most once, and only if it is still pending,
+    // i.e. it was not deleted in the meantime (neither by a listener)
+    for (unsigned int i = 0; i < addedRoutes.size(); i++)
+        if (pendingAddedSet.erase(addedRoutes[i]))
+            nb->fireChangeNotification(NF_IPv4_ROUTE_ADDED, addedRoutes[i]);
+    for (unsigned int i = 0; i < changedRoutes.size(); i++)
+        if (pendingChangedSet.erase(changedRoutes[i]))
+            nb->fireChangeNotification(NF_IPv4_ROUTE_CHANGED, changedRoutes[i]);
+}
+
 void RoutingTable::printRoutingTable() const
 {
     EV << "-- Routing table --\n";
@@ -468,7 +558,7 @@ void RoutingTable::purge()
         {
             it = routes.erase(it);
             ASSERT(route->getRoutingTable() == this); // still filled in, for the listeners' benefit
-            nb->fireChangeNotification(NF_IPv4_ROUTE_DELETED, route);
+            fireRouteDeleted(route);
             delete route;
             deleted = true;
         }
@@ -654,10 +744,9 @@ void RoutingTable::addRoute(IPv4Route *entry)
 
     internalAddRoute(entry);
 
-    invalidateCache();
-    updateDisplayString();
+    unicastRoutesChanged();
 
-    nb->fireChangeNotification(NF_IPv4_ROUTE_ADDED, entry);
+    fireRouteAdded(entry);
 }
 
 IPv4Route *RoutingTable::internalRemoveRoute(IPv4Route *entry)
@@ -679,10 +768,9 @@ IPv4Route *RoutingTable::removeRoute(IPv4Route *entry)
 
     if (entry != NULL)
     {
-        invalidateCache();
-        updateDisplayString();
+        unicastRoutesChanged();
         ASSERT(entry->getRoutingTable() == this); // still filled in, for the listeners' benefit
-        nb->fireChangeNotification(NF_IPv4_ROUTE_DELETED, entry);
+        fireRouteDeleted(entry);
         entry->setRoutingTable(NULL);
     }
     return entry;
@@ -696,10 +784,9 @@ bool RoutingTable::deleteRoute(IPv4Route *entry)
 
     if (entry != NULL)
     {
-        invalidateCache();
-        updateDisplayString();
+        unicastRoutesChanged();
         ASSERT(entry->getRoutingTable() == this); // still filled in, for the listeners' benefit
-        nb->fireChangeNotification(NF_IPv4_ROUTE_DELETED, entry);
+        fireRouteDeleted(entry);
         delete entry;
     }
     return entry != NULL;
@@ -827,10 +914,9 @@ void RoutingTable::routeChanged(IPv4Route *entry, int fieldCode)
         ASSERT(entry != NULL);  // failure means inconsistency: route was not found in this routing table
         internalAddRoute(entry);
 
-        invalidateCache();
-        updateDisplayString();
+        unicastRoutesChanged();
     }
-    nb->fireChangeNotification(NF_IPv4_ROUTE_CHANGED, entry); // TODO include fieldCode in the notification
+    fireRouteChanged(entry);
 }
 
 void RoutingTable::multicastRouteChanged(IPv4MulticastRoute *entry, int fieldCode)
@@ -859,7 +945,7 @@ void RoutingTable::updateNetmaskRoutes()
             IPv4Route *route = *it;
             routes.erase(it);
             ASSERT(route->getRoutingTable() == this); // still filled in, for the listeners' benefit
-            nb->fireChangeNotification(NF_IPv4_ROUTE_DELETED, route);
+            fireRouteDeleted(route);
             delete route;
         }
     }
@@ -29,6 +29,7 @@
 #define __ROUTINGTABLE_H
 
 #include <vector>
+#include <set>
 
 #include "INETDefs.h"
 
@@ -96,6 +97,14 @@ class INET_API RoutingTable: public cSimpleModule, public IRoutingTable, protect
     // JcM add: to handle the local broadcast address
     mutable AddressSet localBroadcastAddresses;
 
+    // batched route changes (see beginRouteChanges())
+    int routeChangesDepth;                      // nesting depth of beginRouteChanges() calls
+    bool routesChangedInBatch;                  // cache invalidation and display update are due at commit
+    std::vector<IPv4Route *> pendingAddedRoutes;    // NF_IPv4_ROUTE_ADDED to be fired at commit, in order
+    std::vector<IPv4Route *> pendingChangedRoutes;  // NF_IPv4_ROUTE_CHANGED to be fired at commit, in order
+    std::set<IPv4Route *> pendingAddedSet;      // members of the above vectors that are still pending
+    std::set<IPv4Route *> pendingChangedSet;
+
   private:
     // The vectors storing routes are ordered by prefix length, administrative distance, and metric.
     // Subclasses should use internalAdd[Multicast]Route() and internalRemove[Multicast]Route() methods
@@ -130,6 +139,18 @@ class INET_API RoutingTable: public cSimpleModule, public IRoutingTable, protect
     // invalidates routing cache and local addresses cache
     virtual void invalidateCache();
 
+    // invalidates the caches and updates the display string after a change of
+    // the unicast routes, or only drops the routing cache within a batch
+    void unicastRoutesChanged();
+
+    // fires NF_IPv4_ROUTE_ADDED/CHANGED, or defers it to the end of the batch
+    void fireRouteAdded(IPv4Route *entry);
+    void fireRouteChanged(IPv4Route *entry);
+
+    // fires NF_IPv4_ROUTE_DELETED unless the route was added in the current
+    // batch, and drops its pending notifications
+    void fireRouteDeleted(IPv4Route *entry);
+
     // helper for sorting routing table, used by addRoute()
     static bool routeLessThan(const IPv4Route *a, const IPv4Route *b);
 
@@ -307,6 +328,17 @@ class INET_API RoutingTable: public cSimpleModule, public IRoutingTable, protect
      */
     virtual bool deleteRoute(IPv4Route *entry);
 
+    /**
+     * Starts a batch of route changes. See IRoutingTable::beginRouteChanges().
+     */
+    virtual void beginRouteChanges();
+
+    /**
+     * Completes a batch of route changes: invalidates the caches, updates
+     * the display string and fires the collected notifications.
+     */
+    virtual void commitRouteChanges();
+
     /**
      * Returns the total number of multicast routes.
      */
@@ -43,6 +43,7 @@
 
 #include "ModuleAccess.h"
 #include "NodeStatus.h"
+#include "SegmentationOffload.h"
 
 #define FRAGMENT_TIMEOUT 60   // 60 sec, from IPv6 RFC
 
@@ -734,11 +735,27 @@ void IPv6::fragmentAndSend(IPv6Datagram *datagram, const InterfaceEntry *ie, con
     #endif /* WITH_xMIPv6 */
     }
 
+    // TCP super-segment: the interface splits it if it can and the pieces fit
+    // into its MTU, otherwise we split it here and send the pieces as separate
+    // datagrams (fragmenting them if needed)
+    bool isSuperSegment = SegmentationOffload::getSegmentCount(datagram) > 1;
+    if (isSuperSegment && (!ie->isSegmentationOffload() || SegmentationOffload::getSegmentLength(datagram) > ie->getMTU()))
+    {
+        std::vector<cPacket *> pieces;
+        SegmentationOffload::split(datagram, pieces);
+        for (unsigned int i = 0; i < pieces.size(); i++)
+            fragmentAndSend(check_and_cast<IPv6Datagram *>(pieces[i]), ie, nextHopAddr, fromHL);
+        return;
+    }
+
     int mtu = ie->getMTU();
 
-    // check if datagram does not require fragmentation
-    if (datagram->getByteLength() <= mtu)
+    // check if datagram does not require fragmentation (super-segments are
+    // split into MTU-sized pieces by the interface)
+    if (datagram->getByteLength() <= mtu || isSuperSegment)
     {
+        if (isSuperSegment)
+            SegmentationOffload::addPieceHeaders(datagram);
         sendDatagramToOutput(datagram, ie, nextHopAddr);
         return;
     }
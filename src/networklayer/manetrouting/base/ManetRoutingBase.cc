@@ -210,6 +210,7 @@ void ManetRoutingBase::registerRoutingModule()
     {
         IPv4Route *entry;
         // clean the route table wlan interface entry
+        inet_rt->beginRouteChanges();
         for (int i=inet_rt->getNumRoutes()-1; i>=0; i--)
         {
             entry = inet_rt->getRoute(i);
@@ -219,6 +220,7 @@ void ManetRoutingBase::registerRoutingModule()
                 inet_rt->deleteRoute(entry);
             }
         }
+        inet_rt->commitRouteChanges();
     }
     if (par("autoassignAddress") && !mac_layer_)
     {
@@ -607,7 +609,15 @@ void ManetRoutingBase::omnet_chg_rte(const ManetAddress &dst, const ManetAddress
                 && oldentry->getInterface() == ie
                 && oldentry->getSourceType() == sourceType)
             return;
-        inet_rt->deleteRoute(oldentry);
+        // update the route in place, so that it is notified once as changed
+        inet_rt->beginRouteChanges();
+        oldentry->setNetmask(netmask);
+        oldentry->setGateway(gateway);
+        oldentry->setMetric(hops);
+        oldentry->setInterface(ie);
+        oldentry->setSourceType(sourceType);
+        inet_rt->commitRouteChanges();
+        return;
     }
 
     IPv4Route *entry = new IPv4Route();
@@ -689,7 +699,15 @@ void ManetRoutingBase::omnet_chg_rte(const ManetAddress &dst, const ManetAddress
                 && oldentry->getInterface() == ie
                 && oldentry->getSourceType() == sourceType)
             return;
-        inet_rt->deleteRoute(oldentry);
+        // update the route in place, so that it is notified once as changed
+        inet_rt->beginRouteChanges();
+        oldentry->setNetmask(netmask);
+        oldentry->setGateway(gateway);
+        oldentry->setMetric(hops);
+        oldentry->setInterface(ie);
+        oldentry->setSourceType(sourceType);
+        inet_rt->commitRouteChanges();
+        return;
     }
 
     IPv4Route *entry = new IPv4Route();
@@ -756,6 +774,7 @@ void ManetRoutingBase::omnet_clean_rte()
     if (mac_layer_)
         return;
     // clean the route table wlan interface entry
+    inet_rt->beginRouteChanges();
     for (int i=inet_rt->getNumRoutes()-1; i>=0; i--)
     {
         entry = inet_rt->getRoute(i);
@@ -764,6 +783,47 @@ void ManetRoutingBase::omnet_clean_rte()
             inet_rt->deleteRoute(entry);
         }
     }
+    inet_rt->commitRouteChanges();
+}
+
+void ManetRoutingBase::omnet_clean_rte_except(const std::set<ManetAddress> &keptDestinations)
+{
+    if (!isRegistered)
+        opp_error("Manet routing protocol is not register");
+
+    if (mac_layer_)
+        return;
+    inet_rt->beginRouteChanges();
+    for (int i=inet_rt->getNumRoutes()-1; i>=0; i--)
+    {
+        IPv4Route *entry = inet_rt->getRoute(i);
+        if (strstr(entry->getInterface()->getName(), "wlan")!=NULL
+                && keptDestinations.find(ManetAddress(entry->getDestination())) == keptDestinations.end())
+        {
+            inet_rt->deleteRoute(entry);
+        }
+    }
+    inet_rt->commitRouteChanges();
+}
+
+void ManetRoutingBase::omnet_begin_rte_changes()
+{
+    if (!isRegistered)
+        opp_error("Manet routing protocol is not register");
+
+    if (mac_layer_)
+        return;
+    inet_rt->beginRouteChanges();
+}
+
+void ManetRoutingBase::omnet_commit_rte_changes()
+{
+    if (!isRegistered)
+        opp_error("Manet routing protocol is not register");
+
+    if (mac_layer_)
+        return;
+    inet_rt->commitRouteChanges();
 }
 
 //
@@ -183,6 +183,18 @@ class INET_API ManetRoutingBase : public cSimpleModule, public INotifiable, prot
     /// Erase all entries for wlan* interfaces in the routing table
     virtual void omnet_clean_rte();
 
+    /// Erase the entries for wlan* interfaces in the routing table, except the ones to keptDestinations
+    virtual void omnet_clean_rte_except(const std::set<ManetAddress> &keptDestinations);
+
+    /**
+     * Bracket a series of omnet_chg_rte() calls, e.g. a routing table
+     * recomputation, so that the IPv4 routing table invalidates its caches
+     * and fires the route added/changed notifications once for the whole
+     * series (see IRoutingTable::beginRouteChanges()). Calls may be nested.
+     */
+    virtual void omnet_begin_rte_changes();
+    virtual void omnet_commit_rte_changes();
+
     /**
      *  @name Cross layer routines
      */
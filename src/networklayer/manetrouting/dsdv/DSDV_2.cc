@@ -67,6 +67,7 @@ void DSDV_2::initialize(int stage)
         {
             IPv4Route *entry;
             // clean the route table wlan interface entry
+            rt->beginRouteChanges();
             for (int i=rt->getNumRoutes()-1; i>=0; i--)
             {
                 entry = rt->getRoute(i);
@@ -76,6 +77,7 @@ void DSDV_2::initialize(int stage)
                     rt->deleteRoute(entry);
                 }
             }
+            rt->commitRouteChanges();
         }
         interface80211ptr->ipv4Data()->joinMulticastGroup(IPv4Address::LL_MANET_ROUTERS);
 
@@ -354,6 +356,9 @@ void DSDV_2::handleMessage(cMessage *msg)
                     || (entrada_routing != NULL && (msgsequencenumber>(entrada_routing->getSequencenumber()) || (msgsequencenumber == (entrada_routing->getSequencenumber()) && numHops < (entrada_routing->getMetric())))))
             {
 
+                // replace the old entry in one batch
+                rt->beginRouteChanges();
+
                 //remove old entry
                 if (entrada_routing != NULL)
                     rt->deleteRoute(entrada_routing);
@@ -372,6 +377,7 @@ void DSDV_2::handleMessage(cMessage *msg)
                     e->setExpiryTime(simTime()+routeLifetime);
                     rt->addRoute(e);
                 }
+                rt->commitRouteChanges();
 #ifdef      NOforwardHello
                 recHello->setNextIPAddress(source);
                 numHops++;
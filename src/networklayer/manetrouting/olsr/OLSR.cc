@@ -32,6 +32,8 @@
 
 #include <math.h>
 #include <limits.h>
+#include <deque>
+#include <set>
 
 #include "UDPPacket.h"
 #include "IPv4Datagram.h"
@@ -440,9 +442,33 @@ OLSR_MsgTimer::expire()
     delete this;
 }
 
+///
+/// \brief Computes the routing table with the changes collected in the batching window.
+///
+void
+OLSR_RtableTimer::expire()
+{
+    agent_->rtableComputationPending = false;
+    agent_->compute_rtable();
+}
+
 
 /********** OLSR class **********/
 
+OLSR::OLSR()
+{
+    incrementalComputation = false;
+    rtableComputationDelay = 0;
+    rtableTimer = NULL;
+    rtableComputationPending = false;
+    rtableNbVersion = 0;
+    mprNbVersion = 0;
+    numRtableComputations = 0;
+    numRtableIncrementalComputations = 0;
+    numRtableComputationsAvoided = 0;
+    numMprComputations = 0;
+    numMprComputationsAvoided = 0;
+}
 
 
 ///
@@ -501,6 +527,11 @@ void OLSR::initialize(int stage)
 
         optimizedMid = par("optimizedMid");
 
+        incrementalComputation = par("incrementalComputation");
+        rtableComputationDelay = par("rtableComputationDelay");
+        if (rtableComputationDelay > 0)
+            rtableTimer = new OLSR_RtableTimer(this);
+
         // Starts all timers
 
         helloTimer = new OLSR_HelloTimer(); ///< Timer for sending HELLO messages.
@@ -508,6 +539,7 @@ void OLSR::initialize(int stage)
         midTimer = new OLSR_MidTimer(); ///< Timer for sending MID messages.
 
         state_ptr = new OLSR_state();
+        state_ptr->set_record_topology_changes(incrementalComputation);
 
 
         for (int i = 0; i< getNumWlanInterfaces(); i++)
@@ -1055,6 +1087,18 @@ OLSR::mpr_computation()
 void
 OLSR::mpr_computation()
 {
+    // The MPR set depends only on the Neighbor and 2-hop Neighbor Sets
+    if (incrementalComputation)
+    {
+        if (mprNbVersion == state_.nb_version())
+        {
+            numMprComputationsAvoided++;
+            return;
+        }
+        mprNbVersion = state_.nb_version();
+    }
+    numMprComputations++;
+
     // MPR computation should be done for each interface. See section 8.3.1
     // (RFC 3626) for details.
     state_.clear_mprset();
@@ -1269,16 +1313,53 @@ OLSR::mpr_computation()
 }
 #endif
 ///
-/// \brief Creates the routing table of the node following RFC 3626 hints.
+/// \brief Requests the computation of the routing table.
+///
+/// If rtableComputationDelay is set, the routing table is computed at the end
+/// of the batching window, together with the changes of further requests.
 ///
 void
 OLSR::rtable_computation()
 {
+    if (rtableComputationDelay > 0)
+    {
+        if (rtableComputationPending)
+            numRtableComputationsAvoided++;
+        else
+        {
+            rtableComputationPending = true;
+            rtableTimer->resched(rtableComputationDelay);
+        }
+        return;
+    }
+    compute_rtable();
+}
+
+///
+/// \brief Creates the routing table of the node following RFC 3626 hints.
+///
+void
+OLSR::compute_rtable()
+{
+    // the routing table of the node is updated in one batch
+    omnet_begin_rte_changes();
+    if (incrementalComputation)
+    {
+        rtable_incremental_computation();
+        omnet_commit_rte_changes();
+        return;
+    }
+    numRtableComputations++;
+
     nsaddr_t netmask(IPv4Address::ALLONES_ADDRESS);
     // 1. All the entries from the routing table are removed.
     //
 
-    if (par("DelOnlyRtEntriesInrtable_").boolValue())
+    // The IP table is cleaned after the computation, keeping the routes that are
+    // computed again (these are updated in place), so that only the changed
+    // routes are notified.
+    bool cleanIpTable = !par("DelOnlyRtEntriesInrtable_").boolValue();
+    if (!cleanIpTable)
     {
         for (rtable_t::const_iterator itRtTable = rtable_.getInternalTable()->begin();itRtTable != rtable_.getInternalTable()->begin();++itRtTable)
         {
@@ -1286,8 +1367,6 @@ OLSR::rtable_computation()
             omnet_chg_rte(addr, addr,netmask,1, true, addr);
         }
     }
-    else
-        omnet_clean_rte(); // clean IP tables
 
     rtable_.clear();
 
@@ -1476,7 +1555,314 @@ OLSR::rtable_computation()
         if (!added)
             break;
     }
+
+    if (cleanIpTable)
+    {
+        std::set<nsaddr_t> destinations;
+        for (rtable_t::const_iterator it = rtable_.getInternalTable()->begin(); it != rtable_.getInternalTable()->end(); ++it)
+            destinations.insert(it->first);
+        omnet_clean_rte_except(destinations); // clean IP tables
+    }
     setTopologyChanged(false);
+    omnet_commit_rte_changes();
+}
+
+///
+/// \brief Records that the route to dest is going to change.
+///
+/// oldRoutes keeps the route of the previous computation for each changed
+/// destination (NULL if there was no route), so that only the changed routes
+/// are updated in the routing table of the node.
+///
+static void markRoute(rtable_t &oldRoutes, const nsaddr_t &dest)
+{
+    if (oldRoutes.find(dest) == oldRoutes.end())
+        oldRoutes[dest] = NULL;
+}
+
+///
+/// \brief Removes the route to dest from the table, keeping it in oldRoutes if it
+/// is the route of the previous computation.
+///
+static void detachRoute(rtable_t &table, rtable_t &oldRoutes, const nsaddr_t &dest)
+{
+    rtable_t::iterator it = table.find(dest);
+    if (it == table.end())
+        return;
+    if (oldRoutes.find(dest) == oldRoutes.end())
+        oldRoutes[dest] = it->second;
+    else
+        delete it->second;
+    table.erase(it);
+}
+
+///
+/// \brief Updates the routing table after the changes of the internal state.
+///
+/// If the Link, Neighbor, 2-hop Neighbor or Interface Association Set changed,
+/// the whole table is computed again. If only the Topology Set changed, only the
+/// routes affected by the changed topology tuples are computed: the routes across
+/// a removed tuple are computed again, and the routes which became shorter with
+/// an added tuple are updated. Routes of equal length are kept, so the next hop
+/// may differ from that of a full computation. Only the changed routes are
+/// updated in the routing table of the node.
+///
+void
+OLSR::rtable_incremental_computation()
+{
+    topologylinks_t &addedLinks = state_.added_links();
+    topologylinks_t &removedLinks = state_.removed_links();
+    rtable_t oldRoutes;
+
+    if (rtableNbVersion != state_.nb_version())
+    {
+        numRtableComputations++;
+        oldRoutes.swap(rtable_.rt_);
+        rtable_add_neighbor_routes(oldRoutes);
+        rtable_add_topology_routes(oldRoutes);
+    }
+    else if (addedLinks.empty() && removedLinks.empty())
+    {
+        numRtableComputationsAvoided++;
+        setTopologyChanged(false);
+        return;
+    }
+    else
+    {
+        numRtableIncrementalComputations++;
+
+        // 1. The routes using a removed topology tuple (unless it was added again),
+        // and the routes across their destinations are removed.
+        std::set<nsaddr_t> lost;
+        for (topologylinks_t::iterator it = removedLinks.begin(); it != removedLinks.end(); it++)
+        {
+            OLSR_rt_entry* entry = rtable_.lookup(it->second);
+            if (entry != NULL && entry->dist() > 2 && entry->route.back() == it->first
+                    && state_.find_topology_tuple(it->second, it->first) == NULL)
+                lost.insert(it->second);
+        }
+        if (!lost.empty())
+        {
+            std::vector<nsaddr_t> lostRoutes;
+            for (rtable_t::iterator it = rtable_.rt_.begin(); it != rtable_.rt_.end(); it++)
+            {
+                OLSR_rt_entry* entry = it->second;
+                if (entry->dist() <= 2)
+                    continue;
+                bool isLost = lost.find(get_main_addr(entry->dest_addr())) != lost.end();
+                for (uint32_t i = 0; !isLost && i < entry->route.size(); i++)
+                    isLost = lost.find(entry->route[i]) != lost.end();
+                if (isLost)
+                    lostRoutes.push_back(it->first);
+            }
+            for (uint32_t i = 0; i < lostRoutes.size(); i++)
+                detachRoute(rtable_.rt_, oldRoutes, lostRoutes[i]);
+        }
+
+        // 2. Routes are searched for the destinations without route.
+        rtable_add_topology_routes(oldRoutes);
+
+        // 3. The routes which became shorter, starting from the last addresses of the
+        // added topology tuples and from the new routes, are updated.
+        std::map<nsaddr_t, std::vector<nsaddr_t> > links; // last address -> destination addresses
+        for (topologyset_t::iterator it = topologyset().begin(); it != topologyset().end(); it++)
+            links[(*it)->last_addr()].push_back((*it)->dest_addr());
+
+        std::deque<nsaddr_t> pending;
+        for (topologylinks_t::iterator it = addedLinks.begin(); it != addedLinks.end(); it++)
+            pending.push_back(it->first);
+        for (rtable_t::iterator it = oldRoutes.begin(); it != oldRoutes.end(); it++)
+            pending.push_back(it->first);
+
+        bool shorter = false;
+        while (!pending.empty())
+        {
+            nsaddr_t last = pending.front();
+            pending.pop_front();
+            OLSR_rt_entry* lastEntry = rtable_.lookup(last);
+            std::map<nsaddr_t, std::vector<nsaddr_t> >::iterator itLinks = links.find(last);
+            if (lastEntry == NULL || lastEntry->dist() < 2 || itLinks == links.end())
+                continue;
+            for (uint32_t i = 0; i < itLinks->second.size(); i++)
+            {
+                nsaddr_t dest = itLinks->second[i];
+                OLSR_rt_entry* entry = rtable_.lookup(dest);
+                if (dest == last || (entry != NULL && entry->dist() <= lastEntry->dist() + 1))
+                    continue;
+                detachRoute(rtable_.rt_, oldRoutes, dest);
+                // the routes to the other interfaces of dest are added again below
+                for (ifaceassocset_t::iterator it = ifaceassocset().begin(); it != ifaceassocset().end(); it++)
+                {
+                    OLSR_iface_assoc_tuple* tuple = *it;
+                    OLSR_rt_entry* ifaceEntry = rtable_.lookup(tuple->iface_addr());
+                    if (tuple->main_addr() == dest && tuple->iface_addr() != last && ifaceEntry != NULL && ifaceEntry->dist() > 2)
+                        detachRoute(rtable_.rt_, oldRoutes, tuple->iface_addr());
+                }
+                rtable_.add_entry(dest,
+                                  lastEntry->next_addr(),
+                                  lastEntry->iface_addr(),
+                                  lastEntry->dist() + 1, lastEntry->local_iface_index(), lastEntry);
+                pending.push_back(dest);
+                shorter = true;
+            }
+        }
+        if (shorter)
+            rtable_add_topology_routes(oldRoutes);
+    }
+
+    rtable_apply_changes(oldRoutes);
+    state_.clear_topology_changes();
+    rtableNbVersion = state_.nb_version();
+    setTopologyChanged(false);
+}
+
+///
+/// \brief Adds the routes to the symmetric neighbors and to the 2-hop neighbors
+/// (steps 2 and 3 of the routing table calculation) to the routing table.
+///
+void
+OLSR::rtable_add_neighbor_routes(rtable_t &oldRoutes)
+{
+    for (nbset_t::iterator it = nbset().begin(); it != nbset().end(); it++)
+    {
+        OLSR_nb_tuple* nb_tuple = *it;
+        if (nb_tuple->getStatus() != OLSR_STATUS_SYM)
+            continue;
+        bool nb_main_addr = false;
+        OLSR_link_tuple* lt = NULL;
+        for (linkset_t::iterator it2 = linkset().begin(); it2 != linkset().end(); it2++)
+        {
+            OLSR_link_tuple* link_tuple = *it2;
+            if (get_main_addr(link_tuple->nb_iface_addr()) == nb_tuple->nb_main_addr() && link_tuple->time() >= CURRENT_TIME)
+            {
+                lt = link_tuple;
+                markRoute(oldRoutes, link_tuple->nb_iface_addr());
+                rtable_.add_entry(link_tuple->nb_iface_addr(),
+                                  link_tuple->nb_iface_addr(),
+                                  link_tuple->local_iface_addr(),
+                                  1, link_tuple->local_iface_index());
+                if (link_tuple->nb_iface_addr() == nb_tuple->nb_main_addr())
+                    nb_main_addr = true;
+            }
+        }
+        if (!nb_main_addr && lt != NULL)
+        {
+            markRoute(oldRoutes, nb_tuple->nb_main_addr());
+            rtable_.add_entry(nb_tuple->nb_main_addr(),
+                              lt->nb_iface_addr(),
+                              lt->local_iface_addr(),
+                              1, lt->local_iface_index());
+        }
+    }
+
+    for (nb2hopset_t::iterator it = nb2hopset().begin(); it != nb2hopset().end(); it++)
+    {
+        OLSR_nb2hop_tuple* nb2hop_tuple = *it;
+        if (state_.find_sym_nb_tuple(nb2hop_tuple->nb_main_addr()) == NULL
+                || state_.find_nb_tuple(nb2hop_tuple->nb_main_addr(), OLSR_WILL_NEVER) != NULL
+                || state_.find_sym_nb_tuple(nb2hop_tuple->nb2hop_addr()) != NULL)
+            continue;
+
+        OLSR_rt_entry* entry = rtable_.lookup(nb2hop_tuple->nb_main_addr());
+        assert(entry != NULL);
+        markRoute(oldRoutes, nb2hop_tuple->nb2hop_addr());
+        rtable_.add_entry(nb2hop_tuple->nb2hop_addr(),
+                          entry->next_addr(),
+                          entry->iface_addr(),
+                          2, entry->local_iface_index());
+    }
+}
+
+///
+/// \brief Adds the routes to the destinations of the Topology Set and to the
+/// interfaces of the Interface Association Set which have no route yet (steps 4
+/// and 5 of the routing table calculation) to the routing table.
+///
+void
+OLSR::rtable_add_topology_routes(rtable_t &oldRoutes)
+{
+    // only the topology tuples whose destination has no route are of interest
+    std::vector<OLSR_topology_tuple*> tuples;
+    for (topologyset_t::iterator it = topologyset().begin(); it != topologyset().end(); it++)
+        if (rtable_.lookup((*it)->dest_addr()) == NULL)
+            tuples.push_back(*it);
+
+    uint32_t maxDist = 0;
+    for (rtable_t::iterator it = rtable_.rt_.begin(); it != rtable_.rt_.end(); it++)
+        maxDist = MAX(maxDist, it->second->dist());
+
+    for (uint32_t h = 2;; h++)
+    {
+        bool added = false;
+
+        for (uint32_t i = 0; i < tuples.size(); i++)
+        {
+            OLSR_topology_tuple* topology_tuple = tuples[i];
+            OLSR_rt_entry* entry1 = rtable_.lookup(topology_tuple->dest_addr());
+            OLSR_rt_entry* entry2 = rtable_.lookup(topology_tuple->last_addr());
+            if (entry1 == NULL && entry2 != NULL && entry2->dist() == h)
+            {
+                markRoute(oldRoutes, topology_tuple->dest_addr());
+                rtable_.add_entry(topology_tuple->dest_addr(),
+                                  entry2->next_addr(),
+                                  entry2->iface_addr(),
+                                  h+1, entry2->local_iface_index(), entry2);
+                maxDist = MAX(maxDist, h+1);
+                added = true;
+            }
+        }
+
+        for (ifaceassocset_t::iterator it = ifaceassocset().begin(); it != ifaceassocset().end(); it++)
+        {
+            OLSR_iface_assoc_tuple* tuple = *it;
+            OLSR_rt_entry* entry1 = rtable_.lookup(tuple->main_addr());
+            OLSR_rt_entry* entry2 = rtable_.lookup(tuple->iface_addr());
+            if (entry1 != NULL && entry2 == NULL)
+            {
+                markRoute(oldRoutes, tuple->iface_addr());
+                rtable_.add_entry(tuple->iface_addr(),
+                                  entry1->next_addr(),
+                                  entry1->iface_addr(),
+                                  entry1->dist(), entry1->local_iface_index(), entry1);
+                added = true;
+            }
+        }
+
+        // unlike in a full computation, there may be routes longer than h+1 already
+        if (!added && h >= maxDist)
+            break;
+    }
+}
+
+///
+/// \brief Updates the routing table of the node with the routes which differ from
+/// the ones in oldRoutes, and frees oldRoutes.
+///
+void
+OLSR::rtable_apply_changes(rtable_t &oldRoutes)
+{
+    nsaddr_t netmask(IPv4Address::ALLONES_ADDRESS);
+
+    for (rtable_t::iterator it = oldRoutes.begin(); it != oldRoutes.end(); it++)
+    {
+        OLSR_rt_entry* oldEntry = it->second;
+        OLSR_rt_entry* entry = rtable_.lookup(it->first);
+        if (entry == NULL)
+        {
+            if (oldEntry != NULL)
+                deleteIpEntry(it->first);
+        }
+        else if (oldEntry == NULL || oldEntry->next_addr() != entry->next_addr() || oldEntry->dist() != entry->dist()
+                || oldEntry->iface_addr() != entry->iface_addr() || oldEntry->local_iface_index() != entry->local_iface_index())
+        {
+            if (!useIndex)
+                omnet_chg_rte(it->first, entry->next_addr(), netmask, entry->dist(), false, entry->iface_addr());
+            else
+                omnet_chg_rte(it->first, entry->next_addr(), netmask, entry->dist(), false, entry->local_iface_index());
+        }
+        delete oldEntry;
+    }
+    oldRoutes.clear();
 }
 
 ///
@@ -2094,8 +2480,11 @@ OLSR::populate_nbset(OLSR_msg& msg)
     OLSR_hello& hello = msg.hello();
 
     OLSR_nb_tuple* nb_tuple = state_.find_nb_tuple(msg.orig_addr());
-    if (nb_tuple != NULL)
+    if (nb_tuple != NULL && nb_tuple->willingness() != hello.willingness())
+    {
         nb_tuple->willingness() = hello.willingness();
+        state_.nb_changed();
+    }
     return false;
 }
 
@@ -2425,12 +2814,15 @@ OLSR::updated_link_tuple(OLSR_link_tuple* tuple, uint8_t willingness)
 
     if (nb_tuple != NULL)
     {
+        int oldStatus = nb_tuple->getStatus();
         if (use_mac() && tuple->lost_time() >= now)
             nb_tuple->getStatus() = OLSR_STATUS_NOT_SYM;
         else if (tuple->sym_time() >= now)
             nb_tuple->getStatus() = OLSR_STATUS_SYM;
         else
             nb_tuple->getStatus() = OLSR_STATUS_NOT_SYM;
+        if (nb_tuple->getStatus() != oldStatus)
+            state_.nb_changed();
 
         debug("%f: Node %s has updated link tuple: nb_addr = %s status = %s\n", now, getNodeId(ra_addr()),
                 getNodeId(tuple->nb_iface_addr()), ((nb_tuple->getStatus() == OLSR_STATUS_SYM) ? "sym" : "not_sym"));
@@ -2790,6 +3182,11 @@ void OLSR:: processLinkBreak(const cObject *details)
 
 void OLSR::finish()
 {
+    recordScalar("rtableComputations", numRtableComputations);
+    recordScalar("rtableIncrementalComputations", numRtableIncrementalComputations);
+    recordScalar("rtableComputationsAvoided", numRtableComputationsAvoided);
+    recordScalar("mprComputations", numMprComputations);
+    recordScalar("mprComputationsAvoided", numMprComputationsAvoided);
     /*
     rtable_.clear();
     msgs_.clear();
@@ -2849,6 +3246,8 @@ OLSR::~OLSR()
             tcTimer = NULL;
         else if (midTimer==timer)
             midTimer = NULL;
+        else if (rtableTimer==timer)
+            rtableTimer = NULL;
         delete timer;
     }
 
@@ -2867,6 +3266,11 @@ OLSR::~OLSR()
         delete midTimer;
         midTimer = NULL;
     }
+    if (rtableTimer)
+    {
+        delete rtableTimer;
+        rtableTimer = NULL;
+    }
 
     if (timerQueuePtr)
     {
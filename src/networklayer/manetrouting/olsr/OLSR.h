@@ -325,6 +325,15 @@ class OLSR_IfaceAssocTupleTimer : public OLSR_Timer
 
 };
 
+/// Timer for computing the routing table at the end of the change batching window.
+class OLSR_RtableTimer : public OLSR_Timer
+{
+  public:
+    OLSR_RtableTimer(OLSR* agent) : OLSR_Timer(agent) {}
+    OLSR_RtableTimer():OLSR_Timer() {}
+    virtual void expire();
+};
+
 /********** OLSR Agent **********/
 
 
@@ -374,6 +383,7 @@ class OLSR : public ManetRoutingBase
     friend class OLSR_TopologyTupleTimer;
     friend class OLSR_IfaceAssocTupleTimer;
     friend class OLSR_MsgTimer;
+    friend class OLSR_RtableTimer;
     friend class OLSR_Timer;
   protected:
 
@@ -419,6 +429,24 @@ class OLSR : public ManetRoutingBase
 
     bool optimizedMid;
 
+    /// Computes the routing table and the MPR set only if their inputs changed, and
+    /// recomputes only the routes affected by the changes of the Topology Set.
+    bool incrementalComputation;
+    /// Length of the window in which changes are collected before computing the routing table.
+    double rtableComputationDelay;
+    OLSR_RtableTimer *rtableTimer;
+    bool rtableComputationPending;
+    /// Value of the Neighbor Set version at the last routing table / MPR computation.
+    unsigned long rtableNbVersion;
+    unsigned long mprNbVersion;
+
+    // statistics
+    long numRtableComputations;             ///< full computations of the routing table
+    long numRtableIncrementalComputations;  ///< computations updating only the affected routes
+    long numRtableComputationsAvoided;      ///< skipped because nothing changed, or merged in the batching window
+    long numMprComputations;
+    long numMprComputationsAvoided;
+
   protected:
 // Omnet INET vaiables and functions
     char nodeName[50];
@@ -471,6 +499,11 @@ class OLSR : public ManetRoutingBase
 
     virtual void        mpr_computation();
     virtual void        rtable_computation();
+    virtual void        compute_rtable();
+    virtual void        rtable_incremental_computation();
+    virtual void        rtable_add_neighbor_routes(rtable_t &oldRoutes);
+    virtual void        rtable_add_topology_routes(rtable_t &oldRoutes);
+    virtual void        rtable_apply_changes(rtable_t &oldRoutes);
 
     virtual bool        process_hello(OLSR_msg&, const nsaddr_t &, const nsaddr_t &, const int &);
     virtual bool        process_tc(OLSR_msg&, const nsaddr_t &, const int &);
@@ -532,7 +565,7 @@ class OLSR : public ManetRoutingBase
     const char * getNodeId(const nsaddr_t &addr);
 
   public:
-    OLSR() {}
+    OLSR();
     virtual ~OLSR();
 
 
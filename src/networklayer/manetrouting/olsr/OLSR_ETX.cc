@@ -1212,8 +1212,14 @@ OLSR_ETX::rtable_dijkstra_computation()
     // Declare a class that will run the dijkstra algorithm
     Dijkstra *dijkstra = new Dijkstra();
 
-    // All the entries from the routing table are removed.
-    if (par("DelOnlyRtEntriesInrtable_").boolValue())
+    // the routing table of the node is updated in one batch
+    omnet_begin_rte_changes();
+
+    // All the entries from the routing table are removed. The IP table is
+    // cleaned after the computation, keeping the routes that are computed
+    // again, so that only the changed routes are notified.
+    bool cleanIpTable = !par("DelOnlyRtEntriesInrtable_").boolValue();
+    if (!cleanIpTable)
     {
         for (rtable_t::const_iterator itRtTable = rtable_.getInternalTable()->begin();itRtTable != rtable_.getInternalTable()->begin();++itRtTable)
         {
@@ -1221,8 +1227,6 @@ OLSR_ETX::rtable_dijkstra_computation()
             omnet_chg_rte(addr, addr,netmask,1, true, addr);
         }
     }
-    else
-        omnet_clean_rte(); // clean IP tables
     rtable_.clear();
 
 
@@ -1447,6 +1451,15 @@ OLSR_ETX::rtable_dijkstra_computation()
     // destroy the dijkstra class we've created
     // dijkstra->clear ();
     delete dijkstra;
+
+    if (cleanIpTable)
+    {
+        std::set<nsaddr_t> destinations;
+        for (rtable_t::const_iterator it = rtable_.getInternalTable()->begin(); it != rtable_.getInternalTable()->end(); ++it)
+            destinations.insert(it->first);
+        omnet_clean_rte_except(destinations); // clean IP tables
+    }
+    omnet_commit_rte_changes();
 }
 
 ///
@@ -129,6 +129,7 @@ OLSR_state::erase_nb_tuple(OLSR_nb_tuple* tuple)
         if (*it == tuple)
         {
             nbset_.erase(it);
+            nb_version_++;
             break;
         }
     }
@@ -143,6 +144,7 @@ OLSR_state::erase_nb_tuple(const nsaddr_t & main_addr)
         if (tuple->nb_main_addr() == main_addr)
         {
             it = nbset_.erase(it);
+            nb_version_++;
             break;
         }
     }
@@ -152,6 +154,7 @@ void
 OLSR_state::insert_nb_tuple(OLSR_nb_tuple* tuple)
 {
     nbset_.push_back(tuple);
+    nb_version_++;
 }
 
 /********** Neighbor 2 Hop Set Manipulation **********/
@@ -176,6 +179,7 @@ OLSR_state::erase_nb2hop_tuple(OLSR_nb2hop_tuple* tuple)
         if (*it == tuple)
         {
             nb2hopset_.erase(it);
+            nb_version_++;
             break;
         }
     }
@@ -191,6 +195,7 @@ OLSR_state::erase_nb2hop_tuples(const nsaddr_t & nb_main_addr, const nsaddr_t &
         if (tuple->nb_main_addr() == nb_main_addr && tuple->nb2hop_addr() == nb2hop_addr)
         {
             it = nb2hopset_.erase(it);
+            nb_version_++;
             returnValue = true;
             if (nb2hopset_.empty())
                 break;
@@ -212,6 +217,7 @@ OLSR_state::erase_nb2hop_tuples(const nsaddr_t & nb_main_addr)
         if (tuple->nb_main_addr() == nb_main_addr)
         {
             it = nb2hopset_.erase(it);
+            nb_version_++;
             topologyChanged = true;
             if (nb2hopset_.empty())
                 break;
@@ -227,6 +233,7 @@ void
 OLSR_state::insert_nb2hop_tuple(OLSR_nb2hop_tuple* tuple)
 {
     nb2hopset_.push_back(tuple);
+    nb_version_++;
 }
 
 /********** MPR Set Manipulation **********/
@@ -322,6 +329,7 @@ OLSR_state::erase_link_tuple(OLSR_link_tuple* tuple)
         if (*it == tuple)
         {
             linkset_.erase(it);
+            nb_version_++;
             break;
         }
     }
@@ -331,6 +339,7 @@ void
 OLSR_state::insert_link_tuple(OLSR_link_tuple* tuple)
 {
     linkset_.push_back(tuple);
+    nb_version_++;
 }
 
 /********** Topology Set Manipulation **********/
@@ -367,6 +376,8 @@ OLSR_state::erase_topology_tuple(OLSR_topology_tuple* tuple)
         if (*it == tuple)
         {
             topologyset_.erase(it);
+            if (record_topology_changes_)
+                removed_links_.push_back(std::make_pair(tuple->last_addr(), tuple->dest_addr()));
             break;
         }
     }
@@ -412,6 +423,8 @@ OLSR_state::erase_older_topology_tuples(const nsaddr_t & last_addr, uint16_t ans
         if (tuple->last_addr() == last_addr && tuple->seq() < ansn)
         {
             it = topologyset_.erase(it);
+            if (record_topology_changes_)
+                removed_links_.push_back(std::make_pair(tuple->last_addr(), tuple->dest_addr()));
             if (topologyset_.empty())
                 break;
         }
@@ -425,6 +438,15 @@ void
 OLSR_state::insert_topology_tuple(OLSR_topology_tuple* tuple)
 {
     topologyset_.push_back(tuple);
+    if (record_topology_changes_)
+        added_links_.push_back(std::make_pair(tuple->last_addr(), tuple->dest_addr()));
+}
+
+void
+OLSR_state::clear_topology_changes()
+{
+    added_links_.clear();
+    removed_links_.clear();
 }
 
 /********** Interface Association Set Manipulation **********/
@@ -453,6 +475,7 @@ OLSR_state::erase_ifaceassoc_tuple(OLSR_iface_assoc_tuple* tuple)
         if (*it == tuple)
         {
             ifaceassocset_.erase(it);
+            nb_version_++;
             break;
         }
     }
@@ -462,6 +485,7 @@ void
 OLSR_state::insert_ifaceassoc_tuple(OLSR_iface_assoc_tuple* tuple)
 {
     ifaceassocset_.push_back(tuple);
+    nb_version_++;
 }
 
 void OLSR_state::clear_all()
@@ -497,6 +521,11 @@ void OLSR_state::clear_all()
 
 OLSR_state::OLSR_state(OLSR_state * st)
 {
+    nb_version_ = st->nb_version_;
+    record_topology_changes_ = st->record_topology_changes_;
+    added_links_ = st->added_links_;
+    removed_links_ = st->removed_links_;
+
     for (linkset_t::iterator it = st->linkset_.begin(); it != st->linkset_.end(); it++)
     {
         OLSR_link_tuple* tuple = *it;
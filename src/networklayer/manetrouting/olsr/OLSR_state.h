@@ -28,8 +28,13 @@
 
 #include "INETDefs.h"
 
+#include <vector>
+
 #include "OLSR_repositories.h"
 
+/// (last address, destination address) pairs of topology tuples.
+typedef std::vector<std::pair<nsaddr_t, nsaddr_t> > topologylinks_t;
+
 /// This class encapsulates all data structures needed for maintaining internal state of an OLSR node.
 class OLSR_state : public cObject
 {
@@ -45,6 +50,13 @@ class OLSR_state : public cObject
     dupset_t    dupset_;    ///< Duplicate Set (RFC 3626, section 3.4).
     ifaceassocset_t ifaceassocset_; ///< Interface Association Set (RFC 3626, section 4.1).
 
+    /// Incremented on every change of the Link, Neighbor, 2-hop Neighbor and Interface Association Sets.
+    unsigned long   nb_version_;
+    /// Enables recording the changes of the Topology Set in added_links_ and removed_links_.
+    bool        record_topology_changes_;
+    topologylinks_t added_links_;   ///< Topology tuples inserted since the changes were last cleared.
+    topologylinks_t removed_links_; ///< Topology tuples erased since the changes were last cleared.
+
     inline  linkset_t&      linkset()   { return linkset_; }
     inline  mprset_t&       mprset()    { return mprset_; }
     inline  mprselset_t&        mprselset() { return mprselset_; }
@@ -54,6 +66,13 @@ class OLSR_state : public cObject
     inline  dupset_t&       dupset()    { return dupset_; }
     inline  ifaceassocset_t&    ifaceassocset() { return ifaceassocset_; }
 
+    inline  unsigned long       nb_version()    { return nb_version_; }
+    inline  void            nb_changed()    { nb_version_++; }
+    inline  void            set_record_topology_changes(bool b) { record_topology_changes_ = b; clear_topology_changes(); }
+    inline  topologylinks_t&    added_links()   { return added_links_; }
+    inline  topologylinks_t&    removed_links() { return removed_links_; }
+    void            clear_topology_changes();
+
     OLSR_mprsel_tuple*  find_mprsel_tuple(const nsaddr_t &);
     void            erase_mprsel_tuple(OLSR_mprsel_tuple*);
     bool            erase_mprsel_tuples(const nsaddr_t &);
@@ -98,7 +117,7 @@ class OLSR_state : public cObject
     void            insert_ifaceassoc_tuple(OLSR_iface_assoc_tuple*);
     void            clear_all();
 
-    OLSR_state() {}
+    OLSR_state() : nb_version_(0), record_topology_changes_(false) {}
     ~OLSR_state();
     OLSR_state(OLSR_state *);
     virtual OLSR_state * dup() {return new OLSR_state(this);}
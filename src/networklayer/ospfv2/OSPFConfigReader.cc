@@ -447,6 +447,16 @@ bool OSPFConfigReader::loadConfigFromXML(cXMLElement *asConfig, OSPF::Router *os
     bool rfc1583Compatible = getBoolAttrOrPar(*routerNode, "RFC1583Compatible");
     ospfRouter->setRFC1583Compatibility(rfc1583Compatible);
 
+    simtime_t spfInitialDelay = par("spfInitialDelay").doubleValue();
+    simtime_t spfHoldTime = par("spfHoldTime").doubleValue();
+    simtime_t spfMaxHoldTime = par("spfMaxHoldTime").doubleValue();
+    if ((spfInitialDelay < SIMTIME_ZERO) || (spfHoldTime < SIMTIME_ZERO) || (spfMaxHoldTime < spfHoldTime)) {
+        throw cRuntimeError("Invalid SPF throttling parameters: spfInitialDelay=%s, spfHoldTime=%s, spfMaxHoldTime=%s",
+                spfInitialDelay.str().c_str(), spfHoldTime.str().c_str(), spfMaxHoldTime.str().c_str());
+    }
+    ospfRouter->setSPFDelays(spfInitialDelay, spfHoldTime, spfMaxHoldTime);
+    ospfRouter->setIncrementalSPF(par("incrementalSPF").boolValue());
+
     std::set<OSPF::AreaID> areaList;
     getAreaListFromXML(*routerNode, areaList);
 
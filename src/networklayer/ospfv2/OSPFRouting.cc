@@ -90,6 +90,18 @@ void OSPFRouting::handleMessageWhenDown(cMessage *msg)
     delete msg;
 }
 
+void OSPFRouting::finish()
+{
+    if (ospfRouter)
+    {
+        recordScalar("SPF requests", ospfRouter->getSPFRequestCount());
+        recordScalar("SPF calculations", ospfRouter->getSPFCount());
+        recordScalar("incremental SPF calculations", ospfRouter->getIncrementalSPFCount());
+        recordScalar("SPF calculation time", ospfRouter->getSPFCalculationTime());
+        recordScalar("changed routes", ospfRouter->getChangedRouteCount());
+    }
+}
+
 bool OSPFRouting::handleOperationStage(LifecycleOperation *operation, int stage, IDoneCallback *doneCallback)
 {
     Enter_Method_Silent();
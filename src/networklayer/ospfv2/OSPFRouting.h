@@ -35,7 +35,7 @@
  */
 class OSPFRouting :  public cSimpleModule, public ILifecycle
 {
-  private:
+  protected:
     bool isUp;
     OSPF::Router *ospfRouter; // root object of the OSPF data structure
 
@@ -56,11 +56,17 @@ class OSPFRouting :  public cSimpleModule, public ILifecycle
      */
     bool checkExternalRoute(const IPv4Address& route);
 
+    /**
+     * Returns the OSPF data structure, or NULL while the node is down.
+     */
+    const OSPF::Router *getOSPFRouter() const { return ospfRouter; }
+
   protected:
     virtual int numInitStages() const { return 5; }
     virtual void initialize(int stage);
     virtual void handleMessage(cMessage *msg);
     virtual void handleMessageWhenDown(cMessage *msg);
+    virtual void finish();
     virtual bool handleOperationStage(LifecycleOperation *operation, int stage, IDoneCallback *doneCallback);
     virtual void createOspfRouter();
     virtual bool isNodeUp();
@@ -330,6 +330,6 @@ void OSPF::HelloHandler::processPacket(OSPFPacket* packet, OSPF::Interface* intf
     }
 
     if (shouldRebuildRoutingTable) {
-        router->rebuildRoutingTable();
+        router->scheduleRoutingTableRebuild();
     }
 }
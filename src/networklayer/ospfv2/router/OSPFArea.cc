@@ -18,6 +18,7 @@
 #include "OSPFArea.h"
 #include "OSPFRouter.h"
 #include <memory.h>
+#include <algorithm>
 
 OSPF::Area::Area(OSPF::AreaID id) :
     areaID(id),
@@ -256,15 +257,15 @@ OSPF::Interface*  OSPF::Area::findVirtualLink(OSPF::RouterID routerID)
 bool OSPF::Area::installRouterLSA(OSPFRouterLSA* lsa)
 {
     OSPF::LinkStateID linkStateID = lsa->getHeader().getLinkStateID();
-    std::map<OSPF::LinkStateID, OSPF::RouterLSA*>::iterator lsaIt = routerLSAsByID.find(linkStateID);
-    if (lsaIt != routerLSAsByID.end()) {
+    OSPF::RouterLSA* routerLSA = findRouterLSA(linkStateID);
+    if (routerLSA != NULL) {
         OSPF::LSAKeyType lsaKey;
 
         lsaKey.linkStateID = lsa->getHeader().getLinkStateID();
         lsaKey.advertisingRouter = lsa->getHeader().getAdvertisingRouter();
 
         removeFromAllRetransmissionLists(lsaKey);
-        return lsaIt->second->update(lsa);
+        return routerLSA->update(lsa);
     } else {
         OSPF::RouterLSA* lsaCopy = new OSPF::RouterLSA(*lsa);
         routerLSAsByID[linkStateID] = lsaCopy;
@@ -276,15 +277,15 @@ bool OSPF::Area::installRouterLSA(OSPFRouterLSA* lsa)
 bool OSPF::Area::installNetworkLSA(OSPFNetworkLSA* lsa)
 {
     OSPF::LinkStateID linkStateID = lsa->getHeader().getLinkStateID();
-    std::map<OSPF::LinkStateID, OSPF::NetworkLSA*>::iterator lsaIt = networkLSAsByID.find(linkStateID);
-    if (lsaIt != networkLSAsByID.end()) {
+    OSPF::NetworkLSA* networkLSA = findNetworkLSA(linkStateID);
+    if (networkLSA != NULL) {
         OSPF::LSAKeyType lsaKey;
 
         lsaKey.linkStateID = lsa->getHeader().getLinkStateID();
         lsaKey.advertisingRouter = lsa->getHeader().getAdvertisingRouter();
 
         removeFromAllRetransmissionLists(lsaKey);
-        return lsaIt->second->update(lsa);
+        return networkLSA->update(lsa);
     } else {
         OSPF::NetworkLSA* lsaCopy = new OSPF::NetworkLSA(*lsa);
         networkLSAsByID[linkStateID] = lsaCopy;
@@ -300,15 +301,10 @@ bool OSPF::Area::installSummaryLSA(OSPFSummaryLSA* lsa)
     lsaKey.linkStateID = lsa->getHeader().getLinkStateID();
     lsaKey.advertisingRouter = lsa->getHeader().getAdvertisingRouter();
 
-    std::map<OSPF::LSAKeyType, OSPF::SummaryLSA*, OSPF::LSAKeyType_Less>::iterator lsaIt = summaryLSAsByID.find(lsaKey);
-    if (lsaIt != summaryLSAsByID.end()) {
-        OSPF::LSAKeyType lsaKey;
-
-        lsaKey.linkStateID = lsa->getHeader().getLinkStateID();
-        lsaKey.advertisingRouter = lsa->getHeader().getAdvertisingRouter();
-
+    OSPF::SummaryLSA* summaryLSA = findSummaryLSA(lsaKey);
+    if (summaryLSA != NULL) {
         removeFromAllRetransmissionLists(lsaKey);
-        return lsaIt->second->update(lsa);
+        return summaryLSA->update(lsa);
     } else {
         OSPF::SummaryLSA* lsaCopy = new OSPF::SummaryLSA(*lsa);
         summaryLSAsByID[lsaKey] = lsaCopy;
@@ -319,7 +315,7 @@ bool OSPF::Area::installSummaryLSA(OSPFSummaryLSA* lsa)
 
 OSPF::RouterLSA* OSPF::Area::findRouterLSA(OSPF::LinkStateID linkStateID)
 {
-    std::map<OSPF::LinkStateID, OSPF::RouterLSA*>::iterator lsaIt = routerLSAsByID.find(linkStateID);
+    OpenHashMap<OSPF::LinkStateID, OSPF::RouterLSA*, OSPF::LinkStateIDHash>::iterator lsaIt = routerLSAsByID.find(linkStateID);
     if (lsaIt != routerLSAsByID.end()) {
         return lsaIt->second;
     } else {
@@ -329,7 +325,7 @@ OSPF::RouterLSA* OSPF::Area::findRouterLSA(OSPF::LinkStateID linkStateID)
 
 const OSPF::RouterLSA* OSPF::Area::findRouterLSA(OSPF::LinkStateID linkStateID) const
 {
-    std::map<OSPF::LinkStateID, OSPF::RouterLSA*>::const_iterator lsaIt = routerLSAsByID.find(linkStateID);
+    OpenHashMap<OSPF::LinkStateID, OSPF::RouterLSA*, OSPF::LinkStateIDHash>::const_iterator lsaIt = routerLSAsByID.find(linkStateID);
     if (lsaIt != routerLSAsByID.end()) {
         return lsaIt->second;
     } else {
@@ -339,7 +335,7 @@ const OSPF::RouterLSA* OSPF::Area::findRouterLSA(OSPF::LinkStateID linkStateID)
 
 OSPF::NetworkLSA* OSPF::Area::findNetworkLSA(OSPF::LinkStateID linkStateID)
 {
-    std::map<OSPF::LinkStateID, OSPF::NetworkLSA*>::iterator lsaIt = networkLSAsByID.find(linkStateID);
+    OpenHashMap<OSPF::LinkStateID, OSPF::NetworkLSA*, OSPF::LinkStateIDHash>::iterator lsaIt = networkLSAsByID.find(linkStateID);
     if (lsaIt != networkLSAsByID.end()) {
         return lsaIt->second;
     } else {
@@ -349,7 +345,7 @@ OSPF::NetworkLSA* OSPF::Area::findNetworkLSA(OSPF::LinkStateID linkStateID)
 
 const OSPF::NetworkLSA* OSPF::Area::findNetworkLSA(OSPF::LinkStateID linkStateID) const
 {
-    std::map<OSPF::LinkStateID, OSPF::NetworkLSA*>::const_iterator lsaIt = networkLSAsByID.find(linkStateID);
+    OpenHashMap<OSPF::LinkStateID, OSPF::NetworkLSA*, OSPF::LinkStateIDHash>::const_iterator lsaIt = networkLSAsByID.find(linkStateID);
     if (lsaIt != networkLSAsByID.end()) {
         return lsaIt->second;
     } else {
@@ -359,7 +355,7 @@ const OSPF::NetworkLSA* OSPF::Area::findNetworkLSA(OSPF::LinkStateID linkStateID
 
 OSPF::SummaryLSA* OSPF::Area::findSummaryLSA(OSPF::LSAKeyType lsaKey)
 {
-    std::map<OSPF::LSAKeyType, OSPF::SummaryLSA*, OSPF::LSAKeyType_Less>::iterator lsaIt = summaryLSAsByID.find(lsaKey);
+    OpenHashMap<OSPF::LSAKeyType, OSPF::SummaryLSA*, OSPF::LSAKeyTypeHash>::iterator lsaIt = summaryLSAsByID.find(lsaKey);
     if (lsaIt != summaryLSAsByID.end()) {
         return lsaIt->second;
     } else {
@@ -369,7 +365,7 @@ OSPF::SummaryLSA* OSPF::Area::findSummaryLSA(OSPF::LSAKeyType lsaKey)
 
 const OSPF::SummaryLSA* OSPF::Area::findSummaryLSA(OSPF::LSAKeyType lsaKey) const
 {
-    std::map<OSPF::LSAKeyType, OSPF::SummaryLSA*, OSPF::LSAKeyType_Less>::const_iterator lsaIt = summaryLSAsByID.find(lsaKey);
+    OpenHashMap<OSPF::LSAKeyType, OSPF::SummaryLSA*, OSPF::LSAKeyTypeHash>::const_iterator lsaIt = summaryLSAsByID.find(lsaKey);
     if (lsaIt != summaryLSAsByID.end()) {
         return lsaIt->second;
     } else {
@@ -453,14 +449,7 @@ void OSPF::Area::ageDatabase()
         }
     }
 
-    std::vector<RouterLSA*>::iterator routerIt = routerLSAs.begin();
-    while (routerIt != routerLSAs.end()) {
-        if ((*routerIt) == NULL) {
-            routerIt = routerLSAs.erase(routerIt);
-        } else {
-            routerIt++;
-        }
-    }
+    routerLSAs.erase(std::remove(routerLSAs.begin(), routerLSAs.end(), (OSPF::RouterLSA*)NULL), routerLSAs.end());
 
     lsaCount = networkLSAs.size();
     for (i = 0; i < lsaCount; i++) {
@@ -551,14 +540,7 @@ void OSPF::Area::ageDatabase()
         }
     }
 
-    std::vector<NetworkLSA*>::iterator networkIt = networkLSAs.begin();
-    while (networkIt != networkLSAs.end()) {
-        if ((*networkIt) == NULL) {
-            networkIt = networkLSAs.erase(networkIt);
-        } else {
-            networkIt++;
-        }
-    }
+    networkLSAs.erase(std::remove(networkLSAs.begin(), networkLSAs.end(), (OSPF::NetworkLSA*)NULL), networkLSAs.end());
 
     lsaCount = summaryLSAs.size();
     for (i = 0; i < lsaCount; i++) {
@@ -644,14 +626,7 @@ void OSPF::Area::ageDatabase()
         }
     }
 
-    std::vector<SummaryLSA*>::iterator summaryIt = summaryLSAs.begin();
-    while (summaryIt != summaryLSAs.end()) {
-        if ((*summaryIt) == NULL) {
-            summaryIt = summaryLSAs.erase(summaryIt);
-        } else {
-            summaryIt++;
-        }
-    }
+    summaryLSAs.erase(std::remove(summaryLSAs.begin(), summaryLSAs.end(), (OSPF::SummaryLSA*)NULL), summaryLSAs.end());
 
     long interfaceCount = associatedInterfaces.size();
     for (long m = 0; m < interfaceCount; m++) {
@@ -659,7 +634,7 @@ void OSPF::Area::ageDatabase()
     }
 
     if (shouldRebuildRoutingTable) {
-        parentRouter->rebuildRoutingTable();
+        parentRouter->scheduleRoutingTableRebuild();
     }
 }
 
@@ -1124,13 +1099,13 @@ OSPF::SummaryLSA* OSPF::Area::originateSummaryLSA(const OSPF::RoutingTableEntry*
                 lsaKey.linkStateID = entry->getDestination();
                 lsaKey.advertisingRouter = parentRouter->getRouterID();
 
-                std::map<OSPF::LSAKeyType, OSPF::SummaryLSA*, OSPF::LSAKeyType_Less>::iterator lsaIt = summaryLSAsByID.find(lsaKey);
-                if (lsaIt == summaryLSAsByID.end()) {
+                OSPF::SummaryLSA* ownSummaryLSA = findSummaryLSA(lsaKey);
+                if (ownSummaryLSA == NULL) {
                     delete (lsaToReoriginate);
                     lsaToReoriginate = NULL;
                     return NULL;
                 } else {
-                    OSPF::SummaryLSA* summaryLSA = new OSPF::SummaryLSA(*(lsaIt->second));
+                    OSPF::SummaryLSA* summaryLSA = new OSPF::SummaryLSA(*ownSummaryLSA);
                     OSPFLSAHeader& lsaHeader = summaryLSA->getHeader();
 
                     lsaHeader.setLsAge(0);
@@ -1181,13 +1156,13 @@ OSPF::SummaryLSA* OSPF::Area::originateSummaryLSA(const OSPF::RoutingTableEntry*
                     lsaKey.linkStateID = entry->getDestination();
                     lsaKey.advertisingRouter = parentRouter->getRouterID();
 
-                    std::map<OSPF::LSAKeyType, OSPF::SummaryLSA*, OSPF::LSAKeyType_Less>::iterator lsaIt = summaryLSAsByID.find(lsaKey);
-                    if (lsaIt == summaryLSAsByID.end()) {
+                    OSPF::SummaryLSA* ownSummaryLSA = findSummaryLSA(lsaKey);
+                    if (ownSummaryLSA == NULL) {
                         delete (lsaToReoriginate);
                         lsaToReoriginate = NULL;
                         return NULL;
                     } else {
-                        OSPF::SummaryLSA* summaryLSA = new OSPF::SummaryLSA(*(lsaIt->second));
+                        OSPF::SummaryLSA* summaryLSA = new OSPF::SummaryLSA(*ownSummaryLSA);
                         OSPFLSAHeader& lsaHeader = summaryLSA->getHeader();
 
                         lsaHeader.setLsAge(0);
@@ -1252,14 +1227,14 @@ OSPF::SummaryLSA* OSPF::Area::originateSummaryLSA(const OSPF::RoutingTableEntry*
                         lsaKey.linkStateID = entry->getDestination();
                         lsaKey.advertisingRouter = parentRouter->getRouterID();
 
-                        std::map<OSPF::LSAKeyType, OSPF::SummaryLSA*, OSPF::LSAKeyType_Less>::iterator lsaIt = summaryLSAsByID.find(lsaKey);
-                        if (lsaIt == summaryLSAsByID.end()) {
+                        OSPF::SummaryLSA* ownSummaryLSA = findSummaryLSA(lsaKey);
+                        if (ownSummaryLSA == NULL) {
                             delete (lsaToReoriginate);
                             lsaToReoriginate = NULL;
                             return NULL;
                         }
 
-                        OSPF::SummaryLSA* summaryLSA = new OSPF::SummaryLSA(*(lsaIt->second));
+                        OSPF::SummaryLSA* summaryLSA = new OSPF::SummaryLSA(*ownSummaryLSA);
                         OSPFLSAHeader& lsaHeader = summaryLSA->getHeader();
 
                         lsaHeader.setLsAge(0);
@@ -1346,13 +1321,58 @@ OSPF::SummaryLSA* OSPF::Area::originateSummaryLSA(const OSPF::SummaryLSA* summar
     return NULL;
 }
 
-void OSPF::Area::calculateShortestPathTree(std::vector<OSPF::RoutingTableEntry*>& newRoutingTable)
+void OSPF::Area::SPFCandidateList::add(OSPFLSA* vertex, unsigned long distance)
+{
+    Entry entry;
+    entry.distance = distance;
+    entry.isRouter = (vertex->getHeader().getLsType() == ROUTERLSA_TYPE);
+    entry.order = nextOrder++;
+    entry.vertex = vertex;
+    candidates[vertex] = std::make_pair(entry.order, distance);
+    heap.push_back(entry);
+    std::push_heap(heap.begin(), heap.end());
+}
+
+void OSPF::Area::SPFCandidateList::decreaseDistance(OSPFLSA* vertex, unsigned long distance)
+{
+    // push a new entry with the original order; the old one is skipped by removeClosest()
+    std::pair<unsigned long, unsigned long>& candidate = candidates[vertex];
+    Entry entry;
+    entry.distance = distance;
+    entry.isRouter = (vertex->getHeader().getLsType() == ROUTERLSA_TYPE);
+    entry.order = candidate.first;
+    entry.vertex = vertex;
+    candidate.second = distance;
+    heap.push_back(entry);
+    std::push_heap(heap.begin(), heap.end());
+}
+
+OSPFLSA* OSPF::Area::SPFCandidateList::removeClosest()
+{
+    while (!heap.empty()) {
+        Entry entry = heap.front();
+        std::pop_heap(heap.begin(), heap.end());
+        heap.pop_back();
+
+        std::map<OSPFLSA*, std::pair<unsigned long, unsigned long> >::iterator it = candidates.find(entry.vertex);
+        if ((it != candidates.end()) && (it->second.second == entry.distance)) {
+            candidates.erase(it);
+            return entry.vertex;
+        }
+    }
+    throw cRuntimeError("Model error: the SPF candidate list is empty");
+}
+
+bool OSPF::Area::calculateShortestPathTree(std::vector<OSPF::RoutingTableEntry*>& newRoutingTable)
 {
     OSPF::RouterID routerID = parentRouter->getRouterID();
     bool finished = false;
     std::vector<OSPFLSA*> treeVertices;
+    std::set<OSPFLSA*> treeVertexSet;
     OSPFLSA* justAddedVertex;
-    std::vector<OSPFLSA*> candidateVertices;
+    SPFCandidateList candidateVertices;
+    std::set<LinkStateID> changedRouters;
+    std::set<LinkStateID> changedNetworks;
     unsigned long            i, j, k;
     unsigned long lsaCount;
 
@@ -1368,9 +1388,12 @@ void OSPF::Area::calculateShortestPathTree(std::vector<OSPF::RoutingTableEntry*>
         delete newLSA;
     }
     if (spfTreeRoot == NULL) {
-        return;
+        return false;
     }
 
+    findChangedSPFVertices(changedRouters, changedNetworks);
+    unsigned long resumeStep = parentRouter->getIncrementalSPF() ? findFirstAffectedSPFStep(changedRouters, changedNetworks) : 0;
+
     lsaCount = routerLSAs.size();
     for (i = 0; i < lsaCount; i++) {
         routerLSAs[i]->clearNextHops();
@@ -1381,352 +1404,49 @@ void OSPF::Area::calculateShortestPathTree(std::vector<OSPF::RoutingTableEntry*>
     }
     spfTreeRoot->setDistance(0);
     treeVertices.push_back(spfTreeRoot);
+    treeVertexSet.insert(spfTreeRoot);
     justAddedVertex = spfTreeRoot;          // (1)
 
-    do {
-        LSAType vertexType = static_cast<LSAType> (justAddedVertex->getHeader().getLsType());
-
-        if ((vertexType == ROUTERLSA_TYPE)) {
-            OSPF::RouterLSA* routerVertex = check_and_cast<OSPF::RouterLSA*> (justAddedVertex);
-            if (routerVertex->getV_VirtualLinkEndpoint()) {    // (2)
-                transitCapability = true;
-            }
-
-            unsigned int linkCount = routerVertex->getLinksArraySize();
-            for (i = 0; i < linkCount; i++) {
-                Link& link = routerVertex->getLinks(i);
-                LinkType linkType = static_cast<LinkType> (link.getType());
-                OSPFLSA* joiningVertex;
-                LSAType joiningVertexType;
-
-                if (linkType == STUB_LINK) {     // (2) (a)
-                    continue;
-                }
-
-                if (linkType == TRANSIT_LINK) {
-                    joiningVertex = findNetworkLSA(link.getLinkID());
-                    joiningVertexType = NETWORKLSA_TYPE;
-                } else {
-                    joiningVertex = findRouterLSA(link.getLinkID());
-                    joiningVertexType = ROUTERLSA_TYPE;
-                }
-
-                if ((joiningVertex == NULL) ||
-                    (joiningVertex->getHeader().getLsAge() == MAX_AGE) ||
-                    (!hasLink(joiningVertex, justAddedVertex)))  // (from, to)     (2) (b)
-                {
-                    continue;
-                }
-
-                unsigned int treeSize = treeVertices.size();
-                bool alreadyOnTree = false;
-
-                for (j = 0; j < treeSize; j++) {
-                    if (treeVertices[j] == joiningVertex) {
-                        alreadyOnTree = true;
-                        break;
-                    }
-                }
-                if (alreadyOnTree) {    // (2) (c)
-                    continue;
-                }
-
-                unsigned long linkStateCost = routerVertex->getDistance() + link.getLinkCost();
-                unsigned int candidateCount = candidateVertices.size();
-                OSPFLSA* candidate = NULL;
-
-                for (j = 0; j < candidateCount; j++) {
-                    if (candidateVertices[j] == joiningVertex) {
-                        candidate = candidateVertices[j];
-                    }
-                }
-                if (candidate != NULL) {    // (2) (d)
-                    OSPF::RoutingInfo* routingInfo = check_and_cast<OSPF::RoutingInfo*> (candidate);
-                    unsigned long candidateDistance = routingInfo->getDistance();
-
-                    if (linkStateCost > candidateDistance) {
-                        continue;
-                    }
-                    if (linkStateCost < candidateDistance) {
-                        routingInfo->setDistance(linkStateCost);
-                        routingInfo->clearNextHops();
-                    }
-                    std::vector<OSPF::NextHop>* newNextHops = calculateNextHops(joiningVertex, justAddedVertex); // (destination, parent)
-                    unsigned int nextHopCount = newNextHops->size();
-                    for (k = 0; k < nextHopCount; k++) {
-                        routingInfo->addNextHop((*newNextHops)[k]);
-                    }
-                    delete newNextHops;
-                } else {
-                    if (joiningVertexType == ROUTERLSA_TYPE) {
-                        OSPF::RouterLSA* joiningRouterVertex = check_and_cast<OSPF::RouterLSA*> (joiningVertex);
-                        joiningRouterVertex->setDistance(linkStateCost);
-                        std::vector<OSPF::NextHop>* newNextHops = calculateNextHops(joiningVertex, justAddedVertex); // (destination, parent)
-                        unsigned int nextHopCount = newNextHops->size();
-                        for (k = 0; k < nextHopCount; k++) {
-                            joiningRouterVertex->addNextHop((*newNextHops)[k]);
-                        }
-                        delete newNextHops;
-                        OSPF::RoutingInfo* vertexRoutingInfo = check_and_cast<OSPF::RoutingInfo*> (joiningRouterVertex);
-                        vertexRoutingInfo->setParent(justAddedVertex);
-
-                        candidateVertices.push_back(joiningRouterVertex);
-                    } else {
-                        OSPF::NetworkLSA* joiningNetworkVertex = check_and_cast<OSPF::NetworkLSA*> (joiningVertex);
-                        joiningNetworkVertex->setDistance(linkStateCost);
-                        std::vector<OSPF::NextHop>* newNextHops = calculateNextHops(joiningVertex, justAddedVertex); // (destination, parent)
-                        unsigned int nextHopCount = newNextHops->size();
-                        for (k = 0; k < nextHopCount; k++) {
-                            joiningNetworkVertex->addNextHop((*newNextHops)[k]);
-                        }
-                        delete newNextHops;
-                        OSPF::RoutingInfo* vertexRoutingInfo = check_and_cast<OSPF::RoutingInfo*> (joiningNetworkVertex);
-                        vertexRoutingInfo->setParent(justAddedVertex);
-
-                        candidateVertices.push_back(joiningNetworkVertex);
-                    }
-                }
+    if (resumeStep > 0) {
+        // The steps before resumeStep do not examine any changed LSA, so they would add the same vertices
+        // to the tree with the same distances and next hops as in the last calculation. Restore those vertices,
+        // then replay the steps to rebuild the candidate list and the routing entries they produced.
+        EV << "Resuming shortest path tree calculation of area " << areaID.str(false) << " at step " << resumeStep
+           << " of " << spfTree.size() << ".\n";
+
+        for (i = 1; i <= resumeStep; i++) {
+            OSPFLSA* vertex;
+            if (spfTree[i].type == ROUTERLSA_TYPE) {
+                OSPF::RouterLSA* routerVertex = findRouterLSA(spfTree[i].linkStateID);
+                *static_cast<OSPF::RoutingInfo*> (routerVertex) = spfTree[i].routingInfo;
+                vertex = routerVertex;
+            } else {
+                OSPF::NetworkLSA* networkVertex = findNetworkLSA(spfTree[i].linkStateID);
+                *static_cast<OSPF::RoutingInfo*> (networkVertex) = spfTree[i].routingInfo;
+                vertex = networkVertex;
             }
+            treeVertices.push_back(vertex);
+            treeVertexSet.insert(vertex);
         }
-
-        if ((vertexType == NETWORKLSA_TYPE)) {
-            OSPF::NetworkLSA* networkVertex = check_and_cast<OSPF::NetworkLSA*> (justAddedVertex);
-            unsigned int routerCount = networkVertex->getAttachedRoutersArraySize();
-
-            for (i = 0; i < routerCount; i++) {     // (2)
-                OSPF::RouterLSA* joiningVertex = findRouterLSA(networkVertex->getAttachedRouters(i));
-                if ((joiningVertex == NULL) ||
-                    (joiningVertex->getHeader().getLsAge() == MAX_AGE) ||
-                    (!hasLink(joiningVertex, justAddedVertex)))  // (from, to)     (2) (b)
-                {
-                    continue;
-                }
-
-                unsigned int treeSize = treeVertices.size();
-                bool alreadyOnTree = false;
-
-                for (j = 0; j < treeSize; j++) {
-                    if (treeVertices[j] == joiningVertex) {
-                        alreadyOnTree = true;
-                        break;
-                    }
-                }
-                if (alreadyOnTree) {    // (2) (c)
-                    continue;
-                }
-
-                unsigned long linkStateCost = networkVertex->getDistance();   // link cost from network to router is always 0
-                unsigned int candidateCount = candidateVertices.size();
-                OSPFLSA* candidate = NULL;
-
-                for (j = 0; j < candidateCount; j++) {
-                    if (candidateVertices[j] == joiningVertex) {
-                        candidate = candidateVertices[j];
-                    }
-                }
-                if (candidate != NULL) {    // (2) (d)
-                    OSPF::RoutingInfo* routingInfo = check_and_cast<OSPF::RoutingInfo*> (candidate);
-                    unsigned long candidateDistance = routingInfo->getDistance();
-
-                    if (linkStateCost > candidateDistance) {
-                        continue;
-                    }
-                    if (linkStateCost < candidateDistance) {
-                        routingInfo->setDistance(linkStateCost);
-                        routingInfo->clearNextHops();
-                    }
-                    std::vector<OSPF::NextHop>* newNextHops = calculateNextHops(joiningVertex, justAddedVertex); // (destination, parent)
-                    unsigned int nextHopCount = newNextHops->size();
-                    for (k = 0; k < nextHopCount; k++) {
-                        routingInfo->addNextHop((*newNextHops)[k]);
-                    }
-                    delete newNextHops;
-                } else {
-                    joiningVertex->setDistance(linkStateCost);
-                    std::vector<OSPF::NextHop>* newNextHops = calculateNextHops(joiningVertex, justAddedVertex); // (destination, parent)
-                    unsigned int nextHopCount = newNextHops->size();
-                    for (k = 0; k < nextHopCount; k++) {
-                        joiningVertex->addNextHop((*newNextHops)[k]);
-                    }
-                    delete newNextHops;
-                    OSPF::RoutingInfo* vertexRoutingInfo = check_and_cast<OSPF::RoutingInfo*> (joiningVertex);
-                    vertexRoutingInfo->setParent(justAddedVertex);
-
-                    candidateVertices.push_back(joiningVertex);
-                }
-            }
+        for (i = 0; i < resumeStep; i++) {
+            addCandidateVertices(treeVertices[i], treeVertexSet, candidateVertices);
+            addVertexRoutingEntries(treeVertices[i + 1], treeVertices[i], newRoutingTable);
         }
+        justAddedVertex = treeVertices[resumeStep];
+    }
+
+    do {
+        addCandidateVertices(justAddedVertex, treeVertexSet, candidateVertices);
 
         if (candidateVertices.empty()) {  // (3)
             finished = true;
         } else {
-            unsigned int candidateCount = candidateVertices.size();
-            unsigned long minDistance = LS_INFINITY;
-            OSPFLSA* closestVertex = candidateVertices[0];
-
-            for (i = 0; i < candidateCount; i++) {
-                OSPF::RoutingInfo* routingInfo = check_and_cast<OSPF::RoutingInfo*> (candidateVertices[i]);
-                unsigned long currentDistance = routingInfo->getDistance();
-
-                if (currentDistance < minDistance) {
-                    closestVertex = candidateVertices[i];
-                    minDistance = currentDistance;
-                } else {
-                    if (currentDistance == minDistance) {
-                        if ((closestVertex->getHeader().getLsType() == ROUTERLSA_TYPE) &&
-                            (candidateVertices[i]->getHeader().getLsType() == NETWORKLSA_TYPE))
-                        {
-                            closestVertex = candidateVertices[i];
-                        }
-                    }
-                }
-            }
+            OSPFLSA* closestVertex = candidateVertices.removeClosest();
 
             treeVertices.push_back(closestVertex);
+            treeVertexSet.insert(closestVertex);
 
-            for (std::vector<OSPFLSA*>::iterator it = candidateVertices.begin(); it != candidateVertices.end(); it++) {
-                if ((*it) == closestVertex) {
-                    candidateVertices.erase(it);
-                    break;
-                }
-            }
-
-            if (closestVertex->getHeader().getLsType() == ROUTERLSA_TYPE) {
-                OSPF::RouterLSA* routerLSA = check_and_cast<OSPF::RouterLSA*> (closestVertex);
-                if (routerLSA->getB_AreaBorderRouter() || routerLSA->getE_ASBoundaryRouter()) {
-                    OSPF::RoutingTableEntry* entry = new OSPF::RoutingTableEntry;
-                    OSPF::RouterID destinationID = routerLSA->getHeader().getLinkStateID();
-                    unsigned int nextHopCount = routerLSA->getNextHopCount();
-                    OSPF::RoutingTableEntry::RoutingDestinationType destinationType = OSPF::RoutingTableEntry::NETWORK_DESTINATION;
-
-                    entry->setDestination(destinationID);
-                    entry->setLinkStateOrigin(routerLSA);
-                    entry->setArea(areaID);
-                    entry->setPathType(OSPF::RoutingTableEntry::INTRAAREA);
-                    entry->setCost(routerLSA->getDistance());
-                    if (routerLSA->getB_AreaBorderRouter()) {
-                        destinationType |= OSPF::RoutingTableEntry::AREA_BORDER_ROUTER_DESTINATION;
-                    }
-                    if (routerLSA->getE_ASBoundaryRouter()) {
-                        destinationType |= OSPF::RoutingTableEntry::AS_BOUNDARY_ROUTER_DESTINATION;
-                    }
-                    entry->setDestinationType(destinationType);
-                    entry->setOptionalCapabilities(routerLSA->getHeader().getLsOptions());
-                    for (i = 0; i < nextHopCount; i++) {
-                        entry->addNextHop(routerLSA->getNextHop(i));
-                    }
-
-                    newRoutingTable.push_back(entry);
-
-                    OSPF::Area* backbone;
-                    if (areaID != OSPF::BACKBONE_AREAID) {
-                        backbone = parentRouter->getAreaByID(OSPF::BACKBONE_AREAID);
-                    } else {
-                        backbone = this;
-                    }
-                    if (backbone != NULL) {
-                        OSPF::Interface* virtualIntf = backbone->findVirtualLink(destinationID);
-                        if ((virtualIntf != NULL) && (virtualIntf->getTransitAreaID() == areaID)) {
-                            OSPF::IPv4AddressRange range;
-                            range.address = getInterface(routerLSA->getNextHop(0).ifIndex)->getAddressRange().address;
-                            range.mask = IPv4Address::ALLONES_ADDRESS;
-                            virtualIntf->setAddressRange(range);
-                            virtualIntf->setIfIndex(routerLSA->getNextHop(0).ifIndex);
-                            virtualIntf->setOutputCost(routerLSA->getDistance());
-                            OSPF::Neighbor* virtualNeighbor = virtualIntf->getNeighbor(0);
-                            if (virtualNeighbor != NULL) {
-                                unsigned int linkCount = routerLSA->getLinksArraySize();
-                                OSPF::RouterLSA* toRouterLSA = dynamic_cast<OSPF::RouterLSA*> (justAddedVertex);
-                                if (toRouterLSA != NULL) {
-                                    for (i = 0; i < linkCount; i++) {
-                                        Link& link = routerLSA->getLinks(i);
-
-                                        if ((link.getType() == POINTTOPOINT_LINK) &&
-                                            (link.getLinkID() == toRouterLSA->getHeader().getLinkStateID()) &&
-                                            (virtualIntf->getState() < OSPF::Interface::WAITING_STATE))
-                                        {
-                                            virtualNeighbor->setAddress(IPv4Address(link.getLinkData()));
-                                            virtualIntf->processEvent(OSPF::Interface::INTERFACE_UP);
-                                            break;
-                                        }
-                                    }
-                                } else {
-                                    OSPF::NetworkLSA* toNetworkLSA = dynamic_cast<OSPF::NetworkLSA*> (justAddedVertex);
-                                    if (toNetworkLSA != NULL) {
-                                        for (i = 0; i < linkCount; i++) {
-                                            Link& link = routerLSA->getLinks(i);
-
-                                            if ((link.getType() == TRANSIT_LINK) &&
-                                                (link.getLinkID() == toNetworkLSA->getHeader().getLinkStateID()) &&
-                                                (virtualIntf->getState() < OSPF::Interface::WAITING_STATE))
-                                            {
-                                                virtualNeighbor->setAddress(IPv4Address(link.getLinkData()));
-                                                virtualIntf->processEvent(OSPF::Interface::INTERFACE_UP);
-                                                break;
-                                            }
-                                        }
-                                    }
-                                }
-                            }
-                        }
-                    }
-                }
-            }
-
-            if (closestVertex->getHeader().getLsType() == NETWORKLSA_TYPE) {
-                OSPF::NetworkLSA* networkLSA = check_and_cast<OSPF::NetworkLSA*> (closestVertex);
-                IPv4Address destinationID = (networkLSA->getHeader().getLinkStateID() & networkLSA->getNetworkMask());
-                unsigned int nextHopCount = networkLSA->getNextHopCount();
-                bool overWrite = false;
-                OSPF::RoutingTableEntry* entry = NULL;
-                unsigned long routeCount = newRoutingTable.size();
-                IPv4Address longestMatch(0u);
-
-                for (i = 0; i < routeCount; i++) {
-                    if (newRoutingTable[i]->getDestinationType() == OSPF::RoutingTableEntry::NETWORK_DESTINATION) {
-                        OSPF::RoutingTableEntry* routingEntry = newRoutingTable[i];
-                        IPv4Address entryAddress = routingEntry->getDestination();
-                        IPv4Address entryMask = routingEntry->getNetmask();
-
-                        if ((entryAddress & entryMask) == (destinationID & entryMask)) {
-                            if ((destinationID & entryMask) > longestMatch) {
-                                longestMatch = (destinationID & entryMask);
-                                entry = routingEntry;
-                            }
-                        }
-                    }
-                }
-                if (entry != NULL) {
-                    const OSPFLSA* entryOrigin = entry->getLinkStateOrigin();
-                    if ((entry->getCost() != networkLSA->getDistance()) ||
-                        (entryOrigin->getHeader().getLinkStateID() >= networkLSA->getHeader().getLinkStateID()))
-                    {
-                        overWrite = true;
-                    }
-                }
-
-                if ((entry == NULL) || (overWrite)) {
-                    if (entry == NULL) {
-                        entry = new OSPF::RoutingTableEntry;
-                    }
-
-                    entry->setDestination(IPv4Address(destinationID));
-                    entry->setNetmask(networkLSA->getNetworkMask());
-                    entry->setLinkStateOrigin(networkLSA);
-                    entry->setArea(areaID);
-                    entry->setPathType(OSPF::RoutingTableEntry::INTRAAREA);
-                    entry->setCost(networkLSA->getDistance());
-                    entry->setDestinationType(OSPF::RoutingTableEntry::NETWORK_DESTINATION);
-                    entry->setOptionalCapabilities(networkLSA->getHeader().getLsOptions());
-                    for (i = 0; i < nextHopCount; i++) {
-                        entry->addNextHop(networkLSA->getNextHop(i));
-                    }
-
-                    if (!overWrite) {
-                        newRoutingTable.push_back(entry);
-                    }
-                }
-            }
+            addVertexRoutingEntries(closestVertex, justAddedVertex, newRoutingTable);
 
             justAddedVertex = closestVertex;
         }
@@ -1793,12 +1513,7 @@ void OSPF::Area::calculateShortestPathTree(std::vector<OSPF::RoutingTableEntry*>
                         throw cRuntimeError("Can not cast class '%s' to OSPF::RouterLSA or OSPF::NetworkLSA", lsOrigin->getClassName());
                     }
                 }
-                std::vector<OSPF::NextHop>* newNextHops = calculateNextHops(link, routerVertex); // (destination, parent)
-                unsigned int nextHopCount = newNextHops->size();
-                for (k = 0; k < nextHopCount; k++) {
-                    entry->addNextHop((*newNextHops)[k]);
-                }
-                delete newNextHops;
+                calculateNextHops(link, routerVertex, entry); // (destination, parent)
             } else {
                 //FIXME remove
                 //if(parentRouter->getRouterID() == 0xC0A80302) {
@@ -1814,32 +1529,394 @@ void OSPF::Area::calculateShortestPathTree(std::vector<OSPF::RoutingTableEntry*>
                 entry->setCost(distance);
                 entry->setDestinationType(OSPF::RoutingTableEntry::NETWORK_DESTINATION);
                 entry->setOptionalCapabilities(routerVertex->getHeader().getLsOptions());
-                std::vector<OSPF::NextHop>* newNextHops = calculateNextHops(link, routerVertex); // (destination, parent)
-                unsigned int nextHopCount = newNextHops->size();
-                for (k = 0; k < nextHopCount; k++) {
-                    entry->addNextHop((*newNextHops)[k]);
+                calculateNextHops(link, routerVertex, entry); // (destination, parent)
+
+                newRoutingTable.push_back(entry);
+            }
+        }
+    }
+
+    // save the tree for the next calculation
+    spfTree.clear();
+    spfTree.reserve(treeVertices.size());
+    for (i = 0; i < treeVertices.size(); i++) {
+        SPFTreeVertex vertex;
+        vertex.type = static_cast<LSAType> (treeVertices[i]->getHeader().getLsType());
+        vertex.linkStateID = treeVertices[i]->getHeader().getLinkStateID();
+        vertex.routingInfo = *check_and_cast<OSPF::RoutingInfo*> (treeVertices[i]);
+        spfTree.push_back(vertex);
+    }
+
+    return resumeStep > 0;
+}
+
+void OSPF::Area::findChangedSPFVertices(std::set<OSPF::LinkStateID>& changedRouters, std::set<OSPF::LinkStateID>& changedNetworks)
+{
+    // compare the Router and Network LSAs with the ones seen by the last calculation, and take a copy of the changed ones
+    unsigned long lsaCount = routerLSAs.size();
+    for (unsigned long i = 0; i < lsaCount; i++) {
+        OSPF::RouterLSA* lsa = routerLSAs[i];
+        SPFRouterLSAMap::iterator it = spfRouterLSAs.find(lsa->getHeader().getLinkStateID());
+        if ((it == spfRouterLSAs.end()) ||
+            (it->second.first != lsa) ||
+            (it->second.second.getHeader().getAdvertisingRouter() != lsa->getHeader().getAdvertisingRouter()) ||
+            lsa->differsFrom(&it->second.second))
+        {
+            changedRouters.insert(lsa->getHeader().getLinkStateID());
+            spfRouterLSAs[lsa->getHeader().getLinkStateID()] = std::make_pair(lsa, OSPFRouterLSA(*lsa));
+        }
+    }
+    if (spfRouterLSAs.size() > lsaCount) {
+        SPFRouterLSAMap::iterator it = spfRouterLSAs.begin();
+        while (it != spfRouterLSAs.end()) {
+            if (findRouterLSA(it->first) == NULL) {
+                changedRouters.insert(it->first);
+                spfRouterLSAs.erase(it++);
+            } else {
+                it++;
+            }
+        }
+    }
+
+    lsaCount = networkLSAs.size();
+    for (unsigned long i = 0; i < lsaCount; i++) {
+        OSPF::NetworkLSA* lsa = networkLSAs[i];
+        SPFNetworkLSAMap::iterator it = spfNetworkLSAs.find(lsa->getHeader().getLinkStateID());
+        if ((it == spfNetworkLSAs.end()) ||
+            (it->second.first != lsa) ||
+            (it->second.second.getHeader().getAdvertisingRouter() != lsa->getHeader().getAdvertisingRouter()) ||
+            lsa->differsFrom(&it->second.second))
+        {
+            changedNetworks.insert(lsa->getHeader().getLinkStateID());
+            spfNetworkLSAs[lsa->getHeader().getLinkStateID()] = std::make_pair(lsa, OSPFNetworkLSA(*lsa));
+        }
+    }
+    if (spfNetworkLSAs.size() > lsaCount) {
+        SPFNetworkLSAMap::iterator it = spfNetworkLSAs.begin();
+        while (it != spfNetworkLSAs.end()) {
+            if (findNetworkLSA(it->first) == NULL) {
+                changedNetworks.insert(it->first);
+                spfNetworkLSAs.erase(it++);
+            } else {
+                it++;
+            }
+        }
+    }
+}
+
+unsigned long OSPF::Area::findFirstAffectedSPFStep(const std::set<OSPF::LinkStateID>& changedRouters, const std::set<OSPF::LinkStateID>& changedNetworks)
+{
+    // Next hops through virtual links and transit areas depend on the other areas' calculations as well,
+    // so these are always calculated from scratch.
+    if (spfTree.empty() || transitCapability) {
+        return 0;
+    }
+    unsigned long interfaceCount = associatedInterfaces.size();
+    for (unsigned long i = 0; i < interfaceCount; i++) {
+        if (associatedInterfaces[i]->getType() == OSPF::Interface::VIRTUAL) {
+            return 0;
+        }
+    }
+    if ((spfTree[0].type != ROUTERLSA_TYPE) || (findRouterLSA(spfTree[0].linkStateID) != spfTreeRoot)) {
+        return 0;
+    }
+
+    // Step i adds the neighbors of the i-th tree vertex to the candidate list, examining the LSA of
+    // the vertex and of its neighbors. The first step examining a changed LSA is the first one that
+    // may differ from the last calculation.
+    unsigned long treeSize = spfTree.size();
+    for (unsigned long i = 0; i < treeSize; i++) {
+        const SPFTreeVertex& vertex = spfTree[i];
+        if (vertex.type == ROUTERLSA_TYPE) {
+            if (changedRouters.find(vertex.linkStateID) != changedRouters.end()) {
+                return 0;   // the root changed (any other vertex was examined by an earlier step already)
+            }
+            OSPF::RouterLSA* routerVertex = findRouterLSA(vertex.linkStateID);
+            unsigned int linkCount = routerVertex->getLinksArraySize();
+            for (unsigned int j = 0; j < linkCount; j++) {
+                Link& link = routerVertex->getLinks(j);
+                LinkType linkType = static_cast<LinkType> (link.getType());
+                if (((linkType == TRANSIT_LINK) && (changedNetworks.find(link.getLinkID()) != changedNetworks.end())) ||
+                    (((linkType == POINTTOPOINT_LINK) || (linkType == VIRTUAL_LINK)) && (changedRouters.find(link.getLinkID()) != changedRouters.end())))
+                {
+                    return i;
+                }
+            }
+        } else {
+            if (changedNetworks.find(vertex.linkStateID) != changedNetworks.end()) {
+                return 0;   // examined by an earlier step already, should not happen
+            }
+            OSPF::NetworkLSA* networkVertex = findNetworkLSA(vertex.linkStateID);
+            unsigned int routerCount = networkVertex->getAttachedRoutersArraySize();
+            for (unsigned int j = 0; j < routerCount; j++) {
+                if (changedRouters.find(networkVertex->getAttachedRouters(j)) != changedRouters.end()) {
+                    return i;
+                }
+            }
+        }
+    }
+    return treeSize - 1;
+}
+
+void OSPF::Area::addCandidateVertices(OSPFLSA* justAddedVertex, const std::set<OSPFLSA*>& treeVertices, SPFCandidateList& candidateVertices)
+{
+    LSAType vertexType = static_cast<LSAType> (justAddedVertex->getHeader().getLsType());
+    unsigned long i;
+
+    if ((vertexType == ROUTERLSA_TYPE)) {
+        OSPF::RouterLSA* routerVertex = check_and_cast<OSPF::RouterLSA*> (justAddedVertex);
+        if (routerVertex->getV_VirtualLinkEndpoint()) {    // (2)
+            transitCapability = true;
+        }
+
+        unsigned int linkCount = routerVertex->getLinksArraySize();
+        for (i = 0; i < linkCount; i++) {
+            Link& link = routerVertex->getLinks(i);
+            LinkType linkType = static_cast<LinkType> (link.getType());
+            OSPFLSA* joiningVertex;
+
+            if (linkType == STUB_LINK) {     // (2) (a)
+                continue;
+            }
+
+            if (linkType == TRANSIT_LINK) {
+                joiningVertex = findNetworkLSA(link.getLinkID());
+            } else {
+                joiningVertex = findRouterLSA(link.getLinkID());
+            }
+
+            if ((joiningVertex == NULL) ||
+                (joiningVertex->getHeader().getLsAge() == MAX_AGE) ||
+                (!hasLink(joiningVertex, justAddedVertex)))  // (from, to)     (2) (b)
+            {
+                continue;
+            }
+
+            if (treeVertices.find(joiningVertex) != treeVertices.end()) {    // (2) (c)
+                continue;
+            }
+
+            unsigned long linkStateCost = routerVertex->getDistance() + link.getLinkCost();
+            OSPF::RoutingInfo* routingInfo = check_and_cast<OSPF::RoutingInfo*> (joiningVertex);
+
+            if (candidateVertices.contains(joiningVertex)) {    // (2) (d)
+                unsigned long candidateDistance = routingInfo->getDistance();
+
+                if (linkStateCost > candidateDistance) {
+                    continue;
+                }
+                if (linkStateCost < candidateDistance) {
+                    routingInfo->setDistance(linkStateCost);
+                    routingInfo->clearNextHops();
+                    candidateVertices.decreaseDistance(joiningVertex, linkStateCost);
+                }
+                calculateNextHops(joiningVertex, justAddedVertex, routingInfo); // (destination, parent)
+            } else {
+                routingInfo->setDistance(linkStateCost);
+                calculateNextHops(joiningVertex, justAddedVertex, routingInfo); // (destination, parent)
+                routingInfo->setParent(justAddedVertex);
+
+                candidateVertices.add(joiningVertex, linkStateCost);
+            }
+        }
+    }
+
+    if ((vertexType == NETWORKLSA_TYPE)) {
+        OSPF::NetworkLSA* networkVertex = check_and_cast<OSPF::NetworkLSA*> (justAddedVertex);
+        unsigned int routerCount = networkVertex->getAttachedRoutersArraySize();
+
+        for (i = 0; i < routerCount; i++) {     // (2)
+            OSPF::RouterLSA* joiningVertex = findRouterLSA(networkVertex->getAttachedRouters(i));
+            if ((joiningVertex == NULL) ||
+                (joiningVertex->getHeader().getLsAge() == MAX_AGE) ||
+                (!hasLink(joiningVertex, justAddedVertex)))  // (from, to)     (2) (b)
+            {
+                continue;
+            }
+
+            if (treeVertices.find(joiningVertex) != treeVertices.end()) {    // (2) (c)
+                continue;
+            }
+
+            unsigned long linkStateCost = networkVertex->getDistance();   // link cost from network to router is always 0
+
+            if (candidateVertices.contains(joiningVertex)) {    // (2) (d)
+                unsigned long candidateDistance = joiningVertex->getDistance();
+
+                if (linkStateCost > candidateDistance) {
+                    continue;
+                }
+                if (linkStateCost < candidateDistance) {
+                    joiningVertex->setDistance(linkStateCost);
+                    joiningVertex->clearNextHops();
+                    candidateVertices.decreaseDistance(joiningVertex, linkStateCost);
+                }
+                calculateNextHops(joiningVertex, justAddedVertex, joiningVertex); // (destination, parent)
+            } else {
+                joiningVertex->setDistance(linkStateCost);
+                calculateNextHops(joiningVertex, justAddedVertex, joiningVertex); // (destination, parent)
+                joiningVertex->setParent(justAddedVertex);
+
+                candidateVertices.add(joiningVertex, linkStateCost);
+            }
+        }
+    }
+}
+
+void OSPF::Area::addVertexRoutingEntries(OSPFLSA* closestVertex, OSPFLSA* justAddedVertex, std::vector<OSPF::RoutingTableEntry*>& newRoutingTable)
+{
+    unsigned long i;
+
+    if (closestVertex->getHeader().getLsType() == ROUTERLSA_TYPE) {
+        OSPF::RouterLSA* routerLSA = check_and_cast<OSPF::RouterLSA*> (closestVertex);
+        if (routerLSA->getB_AreaBorderRouter() || routerLSA->getE_ASBoundaryRouter()) {
+            OSPF::RoutingTableEntry* entry = new OSPF::RoutingTableEntry;
+            OSPF::RouterID destinationID = routerLSA->getHeader().getLinkStateID();
+            unsigned int nextHopCount = routerLSA->getNextHopCount();
+            OSPF::RoutingTableEntry::RoutingDestinationType destinationType = OSPF::RoutingTableEntry::NETWORK_DESTINATION;
+
+            entry->setDestination(destinationID);
+            entry->setLinkStateOrigin(routerLSA);
+            entry->setArea(areaID);
+            entry->setPathType(OSPF::RoutingTableEntry::INTRAAREA);
+            entry->setCost(routerLSA->getDistance());
+            if (routerLSA->getB_AreaBorderRouter()) {
+                destinationType |= OSPF::RoutingTableEntry::AREA_BORDER_ROUTER_DESTINATION;
+            }
+            if (routerLSA->getE_ASBoundaryRouter()) {
+                destinationType |= OSPF::RoutingTableEntry::AS_BOUNDARY_ROUTER_DESTINATION;
+            }
+            entry->setDestinationType(destinationType);
+            entry->setOptionalCapabilities(routerLSA->getHeader().getLsOptions());
+            for (i = 0; i < nextHopCount; i++) {
+                entry->addNextHop(routerLSA->getNextHop(i));
+            }
+
+            newRoutingTable.push_back(entry);
+
+            OSPF::Area* backbone;
+            if (areaID != OSPF::BACKBONE_AREAID) {
+                backbone = parentRouter->getAreaByID(OSPF::BACKBONE_AREAID);
+            } else {
+                backbone = this;
+            }
+            if (backbone != NULL) {
+                OSPF::Interface* virtualIntf = backbone->findVirtualLink(destinationID);
+                if ((virtualIntf != NULL) && (virtualIntf->getTransitAreaID() == areaID)) {
+                    OSPF::IPv4AddressRange range;
+                    range.address = getInterface(routerLSA->getNextHop(0).ifIndex)->getAddressRange().address;
+                    range.mask = IPv4Address::ALLONES_ADDRESS;
+                    virtualIntf->setAddressRange(range);
+                    virtualIntf->setIfIndex(routerLSA->getNextHop(0).ifIndex);
+                    virtualIntf->setOutputCost(routerLSA->getDistance());
+                    OSPF::Neighbor* virtualNeighbor = virtualIntf->getNeighbor(0);
+                    if (virtualNeighbor != NULL) {
+                        unsigned int linkCount = routerLSA->getLinksArraySize();
+                        OSPF::RouterLSA* toRouterLSA = dynamic_cast<OSPF::RouterLSA*> (justAddedVertex);
+                        if (toRouterLSA != NULL) {
+                            for (i = 0; i < linkCount; i++) {
+                                Link& link = routerLSA->getLinks(i);
+
+                                if ((link.getType() == POINTTOPOINT_LINK) &&
+                                    (link.getLinkID() == toRouterLSA->getHeader().getLinkStateID()) &&
+                                    (virtualIntf->getState() < OSPF::Interface::WAITING_STATE))
+                                {
+                                    virtualNeighbor->setAddress(IPv4Address(link.getLinkData()));
+                                    virtualIntf->processEvent(OSPF::Interface::INTERFACE_UP);
+                                    break;
+                                }
+                            }
+                        } else {
+                            OSPF::NetworkLSA* toNetworkLSA = dynamic_cast<OSPF::NetworkLSA*> (justAddedVertex);
+                            if (toNetworkLSA != NULL) {
+                                for (i = 0; i < linkCount; i++) {
+                                    Link& link = routerLSA->getLinks(i);
+
+                                    if ((link.getType() == TRANSIT_LINK) &&
+                                        (link.getLinkID() == toNetworkLSA->getHeader().getLinkStateID()) &&
+                                        (virtualIntf->getState() < OSPF::Interface::WAITING_STATE))
+                                    {
+                                        virtualNeighbor->setAddress(IPv4Address(link.getLinkData()));
+                                        virtualIntf->processEvent(OSPF::Interface::INTERFACE_UP);
+                                        break;
+                                    }
+                                }
+                            }
+                        }
+                    }
                 }
-                delete newNextHops;
+            }
+        }
+    }
 
+    if (closestVertex->getHeader().getLsType() == NETWORKLSA_TYPE) {
+        OSPF::NetworkLSA* networkLSA = check_and_cast<OSPF::NetworkLSA*> (closestVertex);
+        IPv4Address destinationID = (networkLSA->getHeader().getLinkStateID() & networkLSA->getNetworkMask());
+        unsigned int nextHopCount = networkLSA->getNextHopCount();
+        bool overWrite = false;
+        OSPF::RoutingTableEntry* entry = NULL;
+        unsigned long routeCount = newRoutingTable.size();
+        IPv4Address longestMatch(0u);
+
+        for (i = 0; i < routeCount; i++) {
+            if (newRoutingTable[i]->getDestinationType() == OSPF::RoutingTableEntry::NETWORK_DESTINATION) {
+                OSPF::RoutingTableEntry* routingEntry = newRoutingTable[i];
+                IPv4Address entryAddress = routingEntry->getDestination();
+                IPv4Address entryMask = routingEntry->getNetmask();
+
+                if ((entryAddress & entryMask) == (destinationID & entryMask)) {
+                    if ((destinationID & entryMask) > longestMatch) {
+                        longestMatch = (destinationID & entryMask);
+                        entry = routingEntry;
+                    }
+                }
+            }
+        }
+        if (entry != NULL) {
+            const OSPFLSA* entryOrigin = entry->getLinkStateOrigin();
+            if ((entry->getCost() != networkLSA->getDistance()) ||
+                (entryOrigin->getHeader().getLinkStateID() >= networkLSA->getHeader().getLinkStateID()))
+            {
+                overWrite = true;
+            }
+        }
+
+        if ((entry == NULL) || (overWrite)) {
+            if (entry == NULL) {
+                entry = new OSPF::RoutingTableEntry;
+            }
+
+            entry->setDestination(IPv4Address(destinationID));
+            entry->setNetmask(networkLSA->getNetworkMask());
+            entry->setLinkStateOrigin(networkLSA);
+            entry->setArea(areaID);
+            entry->setPathType(OSPF::RoutingTableEntry::INTRAAREA);
+            entry->setCost(networkLSA->getDistance());
+            entry->setDestinationType(OSPF::RoutingTableEntry::NETWORK_DESTINATION);
+            entry->setOptionalCapabilities(networkLSA->getHeader().getLsOptions());
+            for (i = 0; i < nextHopCount; i++) {
+                entry->addNextHop(networkLSA->getNextHop(i));
+            }
+
+            if (!overWrite) {
                 newRoutingTable.push_back(entry);
             }
         }
     }
 }
 
-std::vector<OSPF::NextHop>* OSPF::Area::calculateNextHops(OSPFLSA* destination, OSPFLSA* parent) const
+void OSPF::Area::calculateNextHops(OSPFLSA* destination, OSPFLSA* parent, OSPF::RoutingInfo* routingInfo) const
 {
-    std::vector<OSPF::NextHop>* hops = new std::vector<OSPF::NextHop>;
-    unsigned long               i, j;
+    unsigned long i, j;
 
     OSPF::RouterLSA* routerLSA = dynamic_cast<OSPF::RouterLSA*> (parent);
     if (routerLSA != NULL) {
         if (routerLSA != spfTreeRoot) {
             unsigned int nextHopCount = routerLSA->getNextHopCount();
             for (i = 0; i < nextHopCount; i++) {
-                hops->push_back(routerLSA->getNextHop(i));
+                routingInfo->addNextHop(routerLSA->getNextHop(i));
             }
-            return hops;
+            return;
         } else {
             OSPF::RouterLSA* destinationRouterLSA = dynamic_cast<OSPF::RouterLSA*> (destination);
             if (destinationRouterLSA != NULL) {
@@ -1857,7 +1934,7 @@ std::vector<OSPF::NextHop>* OSPF::Area::calculateNextHops(OSPFLSA* destination,
                                 nextHop.ifIndex = associatedInterfaces[i]->getIfIndex();
                                 nextHop.hopAddress = ptpNeighbor->getAddress();
                                 nextHop.advertisingRouter = destinationRouterLSA->getHeader().getAdvertisingRouter();
-                                hops->push_back(nextHop);
+                                routingInfo->addNextHop(nextHop);
                                 break;
                             }
                         }
@@ -1874,7 +1951,7 @@ std::vector<OSPF::NextHop>* OSPF::Area::calculateNextHops(OSPFLSA* destination,
                                     nextHop.ifIndex = associatedInterfaces[i]->getIfIndex();
                                     nextHop.hopAddress = IPv4Address(link.getLinkData());
                                     nextHop.advertisingRouter = destinationRouterLSA->getHeader().getAdvertisingRouter();
-                                    hops->push_back(nextHop);
+                                    routingInfo->addNextHop(nextHop);
                                 }
                             }
                             break;
@@ -1899,7 +1976,7 @@ std::vector<OSPF::NextHop>* OSPF::Area::calculateNextHops(OSPFLSA* destination,
                             //nextHop.hopAddress = (range.address & range.mask); //TODO revise it!
                             nextHop.hopAddress = IPv4Address::UNSPECIFIED_ADDRESS; //TODO revise it!
                             nextHop.advertisingRouter = destinationNetworkLSA->getHeader().getAdvertisingRouter();
-                            hops->push_back(nextHop);
+                            routingInfo->addNextHop(nextHop);
                         }
                     }
                 }
@@ -1911,9 +1988,9 @@ std::vector<OSPF::NextHop>* OSPF::Area::calculateNextHops(OSPFLSA* destination,
             if (networkLSA->getParent() != spfTreeRoot) {
                 unsigned int nextHopCount = networkLSA->getNextHopCount();
                 for (i = 0; i < nextHopCount; i++) {
-                    hops->push_back(networkLSA->getNextHop(i));
+                    routingInfo->addNextHop(networkLSA->getNextHop(i));
                 }
-                return hops;
+                return;
             } else {
                 IPv4Address parentLinkStateID = parent->getHeader().getLinkStateID();
 
@@ -1942,7 +2019,7 @@ std::vector<OSPF::NextHop>* OSPF::Area::calculateNextHops(OSPFLSA* destination,
                                         nextHop.ifIndex = associatedInterfaces[j]->getIfIndex();
                                         nextHop.hopAddress = nextHopNeighbor->getAddress();
                                         nextHop.advertisingRouter = destinationRouterLSA->getHeader().getAdvertisingRouter();
-                                        hops->push_back(nextHop);
+                                        routingInfo->addNextHop(nextHop);
                                     }
                                 }
                             }
@@ -1952,22 +2029,20 @@ std::vector<OSPF::NextHop>* OSPF::Area::calculateNextHops(OSPFLSA* destination,
             }
         }
     }
-
-    return hops;
 }
 
-std::vector<OSPF::NextHop>* OSPF::Area::calculateNextHops(Link& destination, OSPFLSA* parent) const
+void OSPF::Area::calculateNextHops(Link& destination, OSPFLSA* parent, OSPF::RoutingTableEntry* entry) const
 {
-    std::vector<OSPF::NextHop>* hops = new std::vector<OSPF::NextHop>;
+    unsigned int oldNextHopCount = entry->getNextHopCount();
     unsigned long i;
 
     OSPF::RouterLSA* routerLSA = check_and_cast<OSPF::RouterLSA*> (parent);
     if (routerLSA != spfTreeRoot) {
         unsigned int nextHopCount = routerLSA->getNextHopCount();
         for (i = 0; i < nextHopCount; i++) {
-            hops->push_back(routerLSA->getNextHop(i));
+            entry->addNextHop(routerLSA->getNextHop(i));
         }
-        return hops;
+        return;
     } else {
         unsigned long interfaceNum = associatedInterfaces.size();
         for (i = 0; i < interfaceNum; i++) {
@@ -1991,7 +2066,7 @@ std::vector<OSPF::NextHop>* OSPF::Area::calculateNextHops(Link& destination, OSP
                         nextHop.ifIndex = interface->getIfIndex();
                         nextHop.hopAddress = neighborAddress;
                         nextHop.advertisingRouter = parentRouter->getRouterID();
-                        hops->push_back(nextHop);
+                        entry->addNextHop(nextHop);
                         break;
                     }
                 }
@@ -2006,7 +2081,7 @@ std::vector<OSPF::NextHop>* OSPF::Area::calculateNextHops(Link& destination, OSP
                     // TODO: this has been commented because the linkID is not a real IP address in this case and we don't know the next hop address here, verify
                     // nextHop.hopAddress = destination.getLinkID();
                     nextHop.advertisingRouter = parentRouter->getRouterID();
-                    hops->push_back(nextHop);
+                    entry->addNextHop(nextHop);
                     break;
                 }
             }
@@ -2021,7 +2096,7 @@ std::vector<OSPF::NextHop>* OSPF::Area::calculateNextHops(Link& destination, OSP
                         nextHop.ifIndex = interface->getIfIndex();
                         nextHop.hopAddress = interface->getAddressRange().address;
                         nextHop.advertisingRouter = parentRouter->getRouterID();
-                        hops->push_back(nextHop);
+                        entry->addNextHop(nextHop);
                         break;
                     }
                 }
@@ -2032,7 +2107,7 @@ std::vector<OSPF::NextHop>* OSPF::Area::calculateNextHops(Link& destination, OSP
                         nextHop.ifIndex = interface->getIfIndex();
                         nextHop.hopAddress = neighbor->getAddress();
                         nextHop.advertisingRouter = parentRouter->getRouterID();
-                        hops->push_back(nextHop);
+                        entry->addNextHop(nextHop);
                         break;
                     }
                 }
@@ -2040,7 +2115,7 @@ std::vector<OSPF::NextHop>* OSPF::Area::calculateNextHops(Link& destination, OSP
             // next hops for virtual links are generated later, after examining transit areas' SummaryLSAs
         }
 
-        if (hops->size() == 0) {
+        if (entry->getNextHopCount() == oldNextHopCount) {
             unsigned long hostRouteCount = hostRoutes.size();
             for (i = 0; i < hostRouteCount; i++) {
                 if ((destination.getLinkID() == hostRoutes[i].address) &&
@@ -2050,14 +2125,12 @@ std::vector<OSPF::NextHop>* OSPF::Area::calculateNextHops(Link& destination, OSP
                     nextHop.ifIndex = hostRoutes[i].ifIndex;
                     nextHop.hopAddress = hostRoutes[i].address;
                     nextHop.advertisingRouter = parentRouter->getRouterID();
-                    hops->push_back(nextHop);
+                    entry->addNextHop(nextHop);
                     break;
                 }
             }
         }
     }
-
-    return hops;
 }
 
 bool OSPF::Area::hasLink(OSPFLSA* fromLSA, OSPFLSA* toLSA) const
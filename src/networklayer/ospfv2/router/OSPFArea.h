@@ -20,6 +20,7 @@
 
 #include <vector>
 #include <map>
+#include <set>
 
 #include "LSA.h"
 #include "OSPFcommon.h"
@@ -33,21 +34,73 @@ class Router;
 
 class Area : public cObject {
 private:
+    /**
+     * A vertex of the last shortest path tree, with its distance and next hops.
+     */
+    struct SPFTreeVertex {
+        LSAType     type;
+        LinkStateID linkStateID;
+        RoutingInfo routingInfo;
+    };
+    typedef std::map<LinkStateID, std::pair<RouterLSA*, OSPFRouterLSA> >    SPFRouterLSAMap;
+    typedef std::map<LinkStateID, std::pair<NetworkLSA*, OSPFNetworkLSA> >  SPFNetworkLSAMap;
+
+    /**
+     * The candidate list of the shortest path tree calculation, a binary heap.
+     * The closest candidate is the one with the smallest distance; Network LSAs
+     * come before Router LSAs at equal distance, then the candidate added to the
+     * list first is chosen, like with a linear search of the list.
+     */
+    class SPFCandidateList {
+    private:
+        struct Entry {
+            unsigned long   distance;
+            bool            isRouter;
+            unsigned long   order;
+            OSPFLSA*        vertex;
+
+            // heap order: the entry ordered last is the closest candidate
+            bool operator<(const Entry& other) const {
+                if (distance != other.distance)
+                    return distance > other.distance;
+                if (isRouter != other.isRouter)
+                    return isRouter;
+                return order > other.order;
+            }
+        };
+
+        std::vector<Entry>                                      heap;       // may contain outdated entries of candidates whose distance decreased
+        std::map<OSPFLSA*, std::pair<unsigned long, unsigned long> > candidates; // vertex -> (order, distance)
+        unsigned long                                           nextOrder;
+
+    public:
+        SPFCandidateList() : nextOrder(0) {}
+
+        bool        empty() const  { return candidates.empty(); }
+        bool        contains(OSPFLSA* vertex) const  { return candidates.find(vertex) != candidates.end(); }
+        void        add(OSPFLSA* vertex, unsigned long distance);
+        void        decreaseDistance(OSPFLSA* vertex, unsigned long distance);
+        OSPFLSA*    removeClosest();
+    };
+
     AreaID                                                  areaID;
     std::map<IPv4AddressRange, bool>                        advertiseAddressRanges;
     std::vector<IPv4AddressRange>                           areaAddressRanges;
     std::vector<Interface*>                                 associatedInterfaces;
     std::vector<HostRouteParameters>                        hostRoutes;
-    std::map<LinkStateID, RouterLSA*>                       routerLSAsByID;
+    OpenHashMap<LinkStateID, RouterLSA*, LinkStateIDHash>   routerLSAsByID;
     std::vector<RouterLSA*>                                 routerLSAs;
-    std::map<LinkStateID, NetworkLSA*>                      networkLSAsByID;
+    OpenHashMap<LinkStateID, NetworkLSA*, LinkStateIDHash>  networkLSAsByID;
     std::vector<NetworkLSA*>                                networkLSAs;
-    std::map<LSAKeyType, SummaryLSA*, LSAKeyType_Less>      summaryLSAsByID;
+    OpenHashMap<LSAKeyType, SummaryLSA*, LSAKeyTypeHash>    summaryLSAsByID;
     std::vector<SummaryLSA*>                                summaryLSAs;
     bool                                                    transitCapability;
     bool                                                    externalRoutingCapability;
     Metric                                                  stubDefaultCost;
     RouterLSA*                                              spfTreeRoot;
+    std::vector<SPFTreeVertex>                              spfTree;            // in the order the vertices were added to the tree
+    SPFRouterLSAMap                                         spfRouterLSAs;      // the router LSAs as seen by the last shortest path tree calculation
+    SPFNetworkLSAMap                                        spfNetworkLSAs;     // the network LSAs as seen by the last shortest path tree calculation
 
     Router*                                                 parentRouter;
 public:
@@ -113,7 +166,16 @@ public:
     SummaryLSA*       originateSummaryLSA(const RoutingTableEntry* entry,
                                           const std::map<LSAKeyType, bool, LSAKeyType_Less>& originatedLSAs,
                                           SummaryLSA*& lsaToReoriginate);
-    void              calculateShortestPathTree(std::vector<RoutingTableEntry*>& newRoutingTable);
+    /**
+     * Calculates the shortest path tree of the area and adds the intra-area
+     * routes to newRoutingTable. If some Router and Network LSAs changed since
+     * the last calculation, the calculation is resumed from the first step
+     * that would examine a changed LSA, because all steps before it would be
+     * repeated exactly, unless the parent router disables it. Returns true if
+     * the calculation was resumed.
+     * @sa RFC2328 Section 16.1.
+     */
+    bool              calculateShortestPathTree(std::vector<RoutingTableEntry*>& newRoutingTable);
     void              calculateInterAreaRoutes(std::vector<RoutingTableEntry*>& newRoutingTable);
     void              recheckSummaryLSAs(std::vector<RoutingTableEntry*>& newRoutingTable);
 
@@ -123,8 +185,12 @@ public:
 private:
     SummaryLSA*           originateSummaryLSA(const OSPF::SummaryLSA* summaryLSA);
     bool                  hasLink(OSPFLSA* fromLSA, OSPFLSA* toLSA) const;
-    std::vector<NextHop>* calculateNextHops(OSPFLSA* destination, OSPFLSA* parent) const;
-    std::vector<NextHop>* calculateNextHops(Link& destination, OSPFLSA* parent) const;
+    void                  findChangedSPFVertices(std::set<LinkStateID>& changedRouters, std::set<LinkStateID>& changedNetworks);
+    unsigned long         findFirstAffectedSPFStep(const std::set<LinkStateID>& changedRouters, const std::set<LinkStateID>& changedNetworks);
+    void                  addCandidateVertices(OSPFLSA* justAddedVertex, const std::set<OSPFLSA*>& treeVertices, SPFCandidateList& candidateVertices);
+    void                  addVertexRoutingEntries(OSPFLSA* closestVertex, OSPFLSA* justAddedVertex, std::vector<RoutingTableEntry*>& newRoutingTable);
+    void                  calculateNextHops(OSPFLSA* destination, OSPFLSA* parent, RoutingInfo* routingInfo) const;
+    void                  calculateNextHops(Link& destination, OSPFLSA* parent, RoutingTableEntry* entry) const;
 
     LinkStateID           getUniqueLinkStateID(IPv4AddressRange destination,
                                                Metric destinationCost,
@@ -16,6 +16,9 @@
 //
 
 
+#include <algorithm>
+#include <platdep/timeutil.h>
+
 #include "OSPFRouter.h"
 
 #include "RoutingTableAccess.h"
@@ -23,7 +26,18 @@
 
 OSPF::Router::Router(OSPF::RouterID id, cSimpleModule* containingModule) :
     routerID(id),
-    rfc1583Compatibility(false)
+    rfc1583Compatibility(false),
+    spfInitialDelay(0),
+    spfHoldTime(0),
+    spfMaxHoldTime(0),
+    spfCurrentHoldTime(0),
+    lastSPFTime(-1),
+    spfRequestCount(0),
+    spfCount(0),
+    incrementalSPF(true),
+    incrementalSPFCount(0),
+    spfCalculationTime(0),
+    changedRouteCount(0)
 {
     messageHandler = new OSPF::MessageHandler(this, containingModule);
     ageTimer = new cMessage();
@@ -31,6 +45,10 @@ OSPF::Router::Router(OSPF::RouterID id, cSimpleModule* containingModule) :
     ageTimer->setContextPointer(this);
     ageTimer->setName("OSPF::Router::DatabaseAgeTimer");
     messageHandler->startTimer(ageTimer, 1.0);
+    spfTimer = new cMessage();
+    spfTimer->setKind(SPF_TIMER);
+    spfTimer->setContextPointer(this);
+    spfTimer->setName("OSPF::Router::SPFTimer");
 }
 
 
@@ -50,6 +68,8 @@ OSPF::Router::~Router()
     }
     messageHandler->clearTimer(ageTimer);
     delete ageTimer;
+    messageHandler->clearTimer(spfTimer);
+    delete spfTimer;
     delete messageHandler;
 }
 
@@ -60,6 +80,20 @@ void OSPF::Router::addWatches()
     WATCH_PTRVECTOR(areas);
     WATCH_PTRVECTOR(asExternalLSAs);
     WATCH_PTRVECTOR(routingTable);
+    WATCH(spfRequestCount);
+    WATCH(spfCount);
+    WATCH(incrementalSPFCount);
+    WATCH(spfCalculationTime);
+    WATCH(changedRouteCount);
+}
+
+
+void OSPF::Router::setSPFDelays(simtime_t initialDelay, simtime_t holdTime, simtime_t maxHoldTime)
+{
+    spfInitialDelay = initialDelay;
+    spfHoldTime = holdTime;
+    spfMaxHoldTime = maxHoldTime;
+    spfCurrentHoldTime = holdTime;
 }
 
 
@@ -199,33 +233,33 @@ bool OSPF::Router::installASExternalLSA(OSPFASExternalLSA* lsa)
     lsaKey.linkStateID = lsa->getHeader().getLinkStateID();
     lsaKey.advertisingRouter = routerID;
 
-    std::map<OSPF::LSAKeyType, OSPF::ASExternalLSA*, OSPF::LSAKeyType_Less>::iterator lsaIt = asExternalLSAsByID.find(lsaKey);
-    if ((lsaIt != asExternalLSAsByID.end()) &&
+    OSPF::ASExternalLSA* ownLSA = findASExternalLSA(lsaKey);
+    if ((ownLSA != NULL) &&
         reachable &&
-        (lsaIt->second->getContents().getE_ExternalMetricType() == lsa->getContents().getE_ExternalMetricType()) &&
-        (lsaIt->second->getContents().getRouteCost() == lsa->getContents().getRouteCost()) &&
+        (ownLSA->getContents().getE_ExternalMetricType() == lsa->getContents().getE_ExternalMetricType()) &&
+        (ownLSA->getContents().getRouteCost() == lsa->getContents().getRouteCost()) &&
         (lsa->getContents().getForwardingAddress().getInt() != 0) && // forwarding address != 0.0.0.0
-        (lsaIt->second->getContents().getForwardingAddress() == lsa->getContents().getForwardingAddress()))
+        (ownLSA->getContents().getForwardingAddress() == lsa->getContents().getForwardingAddress()))
     {
         if (routerID > advertisingRouter) {
             return false;
         } else {
-            lsaIt->second->getHeader().setLsAge(MAX_AGE);
-            floodLSA(lsaIt->second, OSPF::BACKBONE_AREAID);
-            lsaIt->second->incrementInstallTime();
+            ownLSA->getHeader().setLsAge(MAX_AGE);
+            floodLSA(ownLSA, OSPF::BACKBONE_AREAID);
+            ownLSA->incrementInstallTime();
             ownLSAFloodedOut = true;
         }
     }
 
     lsaKey.advertisingRouter = advertisingRouter;
 
-    lsaIt = asExternalLSAsByID.find(lsaKey);
-    if (lsaIt != asExternalLSAsByID.end()) {
+    OSPF::ASExternalLSA* externalLSA = findASExternalLSA(lsaKey);
+    if (externalLSA != NULL) {
         unsigned long areaCount = areas.size();
         for (unsigned long i = 0; i < areaCount; i++) {
             areas[i]->removeFromAllRetransmissionLists(lsaKey);
         }
-        return ((lsaIt->second->update(lsa)) | ownLSAFloodedOut);
+        return ((externalLSA->update(lsa)) | ownLSAFloodedOut);
     } else {
         OSPF::ASExternalLSA* lsaCopy = new OSPF::ASExternalLSA(*lsa);
         asExternalLSAsByID[lsaKey] = lsaCopy;
@@ -278,7 +312,7 @@ OSPFLSA* OSPF::Router::findLSA(LSAType lsaType, OSPF::LSAKeyType lsaKey, OSPF::A
 
 OSPF::ASExternalLSA* OSPF::Router::findASExternalLSA(OSPF::LSAKeyType lsaKey)
 {
-    std::map<OSPF::LSAKeyType, OSPF::ASExternalLSA*, OSPF::LSAKeyType_Less>::iterator lsaIt = asExternalLSAsByID.find(lsaKey);
+    OpenHashMap<OSPF::LSAKeyType, OSPF::ASExternalLSA*, OSPF::LSAKeyTypeHash>::iterator lsaIt = asExternalLSAsByID.find(lsaKey);
     if (lsaIt != asExternalLSAsByID.end()) {
         return lsaIt->second;
     } else {
@@ -289,7 +323,7 @@ OSPF::ASExternalLSA* OSPF::Router::findASExternalLSA(OSPF::LSAKeyType lsaKey)
 
 const OSPF::ASExternalLSA* OSPF::Router::findASExternalLSA(OSPF::LSAKeyType lsaKey) const
 {
-    std::map<OSPF::LSAKeyType, OSPF::ASExternalLSA*, OSPF::LSAKeyType_Less>::const_iterator lsaIt = asExternalLSAsByID.find(lsaKey);
+    OpenHashMap<OSPF::LSAKeyType, OSPF::ASExternalLSA*, OSPF::LSAKeyTypeHash>::const_iterator lsaIt = asExternalLSAsByID.find(lsaKey);
     if (lsaIt != asExternalLSAsByID.end()) {
         return lsaIt->second;
     } else {
@@ -380,14 +414,7 @@ void OSPF::Router::ageDatabase()
         }
     }
 
-    std::vector<ASExternalLSA*>::iterator it = asExternalLSAs.begin();
-    while (it != asExternalLSAs.end()) {
-        if ((*it) == NULL) {
-            it = asExternalLSAs.erase(it);
-        } else {
-            it++;
-        }
-    }
+    asExternalLSAs.erase(std::remove(asExternalLSAs.begin(), asExternalLSAs.end(), (OSPF::ASExternalLSA*)NULL), asExternalLSAs.end());
 
     long areaCount = areas.size();
     for (long j = 0; j < areaCount; j++) {
@@ -396,7 +423,7 @@ void OSPF::Router::ageDatabase()
     messageHandler->startTimer(ageTimer, 1.0);
 
     if (shouldRebuildRoutingTable) {
-        rebuildRoutingTable();
+        scheduleRoutingTableRebuild();
     }
 }
 
@@ -703,8 +730,38 @@ OSPF::RoutingTableEntry* OSPF::Router::lookup(IPv4Address destination, std::vect
 }
 
 
+void OSPF::Router::scheduleRoutingTableRebuild()
+{
+    spfRequestCount++;
+    if (spfTimer->isScheduled()) {
+        EV << "Routing table rebuild is already scheduled.\n";
+        return;
+    }
+
+    simtime_t now = simTime();
+    simtime_t delay = spfInitialDelay;
+    if ((lastSPFTime < SIMTIME_ZERO) || (now - lastSPFTime > spfMaxHoldTime)) {
+        spfCurrentHoldTime = spfHoldTime;   // quiet period, start over
+    } else {
+        if (lastSPFTime + spfCurrentHoldTime - now > delay) {
+            delay = lastSPFTime + spfCurrentHoldTime - now;
+        }
+        spfCurrentHoldTime = std::min(spfCurrentHoldTime + spfCurrentHoldTime, spfMaxHoldTime);
+    }
+
+    if (delay == SIMTIME_ZERO) {
+        rebuildRoutingTable();
+    } else {
+        EV << "Routing table rebuild scheduled in " << delay << "s.\n";
+        messageHandler->startTimer(spfTimer, delay);
+    }
+}
+
+
 void OSPF::Router::rebuildRoutingTable()
 {
+    timeval startTime;
+    gettimeofday(&startTime, NULL);
     unsigned long areaCount = areas.size();
     bool hasTransitAreas = false;
     std::vector<OSPF::RoutingTableEntry*> newTable;
@@ -712,8 +769,14 @@ void OSPF::Router::rebuildRoutingTable()
 
     EV << "Rebuilding routing table:\n";
 
+    messageHandler->clearTimer(spfTimer);
+    lastSPFTime = simTime();
+    spfCount++;
+
     for (i = 0; i < areaCount; i++) {
-        areas[i]->calculateShortestPathTree(newTable);
+        if (areas[i]->calculateShortestPathTree(newTable)) {
+            incrementalSPFCount++;
+        }
         if (areas[i]->getTransitCapability()) {
             hasTransitAreas = true;
         }
@@ -745,6 +808,9 @@ void OSPF::Router::rebuildRoutingTable()
     routingTable.clear();
     routingTable.assign(newTable.begin(), newTable.end());
 
+    unsigned long changedRoutes = countChangedRoutes(oldTable);
+    changedRouteCount += changedRoutes;
+
     RoutingTableAccess routingTableAccess;
     std::vector<IPv4Route*> eraseEntries;
     IRoutingTable* simRoutingTable = routingTableAccess.get();
@@ -778,7 +844,13 @@ void OSPF::Router::rebuildRoutingTable()
         delete (oldTable[i]);
     }
 
-    EV << "Routing table was rebuilt.\n"
+    timeval endTime;
+    gettimeofday(&endTime, NULL);
+    double calculationTime = (endTime.tv_sec - startTime.tv_sec) + (endTime.tv_usec - startTime.tv_usec) / 1e6;
+    spfCalculationTime += calculationTime;
+
+    EV << "Routing table was rebuilt in " << calculationTime << "s, "
+       << changedRoutes << " entries changed.\n"
        << "Results:\n";
 
     routeCount = routingTable.size();
@@ -789,6 +861,49 @@ void OSPF::Router::rebuildRoutingTable()
 }
 
 
+unsigned long OSPF::Router::countChangedRoutes(const std::vector<OSPF::RoutingTableEntry*>& oldRoutingTable) const
+{
+    typedef std::multimap<IPv4AddressRange, const RoutingTableEntry*> RoutingTableEntryMap;
+    RoutingTableEntryMap oldTableMap;
+    std::vector<const RoutingTableEntry*> unmatchedEntries;
+    unsigned long changedRoutes = 0;
+    unsigned long i;
+
+    for (i = 0; i < oldRoutingTable.size(); i++) {
+        IPv4AddressRange destination(oldRoutingTable[i]->getDestination() & oldRoutingTable[i]->getNetmask(), oldRoutingTable[i]->getNetmask());
+        oldTableMap.insert(std::make_pair(destination, oldRoutingTable[i]));
+    }
+
+    // first pair up the unchanged entries...
+    for (i = 0; i < routingTable.size(); i++) {
+        IPv4AddressRange destination(routingTable[i]->getDestination() & routingTable[i]->getNetmask(), routingTable[i]->getNetmask());
+        std::pair<RoutingTableEntryMap::iterator, RoutingTableEntryMap::iterator> range = oldTableMap.equal_range(destination);
+        RoutingTableEntryMap::iterator it = range.first;
+        while ((it != range.second) && (*(it->second) != *(routingTable[i]))) {
+            it++;
+        }
+        if (it != range.second) {
+            oldTableMap.erase(it);
+        } else {
+            unmatchedEntries.push_back(routingTable[i]);
+        }
+    }
+
+    // ...then count an entry to a destination that had an entry before as changed, otherwise as added
+    for (i = 0; i < unmatchedEntries.size(); i++) {
+        IPv4AddressRange destination(unmatchedEntries[i]->getDestination() & unmatchedEntries[i]->getNetmask(), unmatchedEntries[i]->getNetmask());
+        RoutingTableEntryMap::iterator it = oldTableMap.find(destination);
+        if (it != oldTableMap.end()) {
+            oldTableMap.erase(it);
+        }
+        changedRoutes++;
+    }
+
+    // the rest were removed
+    return changedRoutes + oldTableMap.size();
+}
+
+
 bool OSPF::Router::hasRouteToASBoundaryRouter(const std::vector<OSPF::RoutingTableEntry*>& inRoutingTable, OSPF::RouterID asbrRouterID) const
 {
     long routeCount = inRoutingTable.size();
@@ -1373,7 +1488,7 @@ void OSPF::Router::updateExternalRoute(IPv4Address networkAddress, const OSPFASE
     delete asExternalLSA;
 
     if (rebuild) {
-        rebuildRoutingTable();
+        scheduleRoutingTableRebuild();
     }
 }
 
@@ -1415,11 +1530,11 @@ void OSPF::Router::removeExternalRoute(IPv4Address networkAddress)
     lsaKey.linkStateID = networkAddress;
     lsaKey.advertisingRouter = routerID;
 
-    std::map<OSPF::LSAKeyType, OSPF::ASExternalLSA*, OSPF::LSAKeyType_Less>::iterator lsaIt = asExternalLSAsByID.find(lsaKey);
-    if (lsaIt != asExternalLSAsByID.end()) {
-        lsaIt->second->getHeader().setLsAge(MAX_AGE);
-        lsaIt->second->setPurgeable();
-        floodLSA(lsaIt->second, OSPF::BACKBONE_AREAID);
+    OSPF::ASExternalLSA* externalLSA = findASExternalLSA(lsaKey);
+    if (externalLSA != NULL) {
+        externalLSA->getHeader().setLsAge(MAX_AGE);
+        externalLSA->setPurgeable();
+        floodLSA(externalLSA, OSPF::BACKBONE_AREAID);
     }
 
     std::map<IPv4Address, OSPFASExternalLSAContents>::iterator externalIt = externalRoutes.find(networkAddress);
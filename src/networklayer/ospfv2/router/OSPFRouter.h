@@ -43,13 +43,25 @@ private:
     RouterID                                                           routerID;                ///< The router ID assigned by the IP layer.
     std::map<AreaID, Area*>                                            areasByID;               ///< A map of the contained areas with the AreaID as key.
     std::vector<Area*>                                                 areas;                   ///< A list of the contained areas.
-    std::map<LSAKeyType, ASExternalLSA*, LSAKeyType_Less>              asExternalLSAsByID;      ///< A map of the ASExternalLSAs advertised by this router.
+    OpenHashMap<LSAKeyType, ASExternalLSA*, LSAKeyTypeHash>            asExternalLSAsByID;      ///< A hash index of the ASExternalLSAs advertised by this router.
     std::vector<ASExternalLSA*>                                        asExternalLSAs;          ///< A list of the ASExternalLSAs advertised by this router.
     std::map<IPv4Address, OSPFASExternalLSAContents>                   externalRoutes;          ///< A map of the external route advertised by this router.
     cMessage*                                                          ageTimer;                ///< Database age timer - fires every second.
     std::vector<RoutingTableEntry*>                                    routingTable;            ///< The OSPF routing table - contains more information than the one in the IP layer.
     MessageHandler*                                                    messageHandler;          ///< The message dispatcher class.
     bool                                                               rfc1583Compatibility;    ///< Decides whether to handle the preferred routing table entry to an AS boundary router as defined in RFC1583 or not.
+    cMessage*                                                          spfTimer;                ///< Delays the next routing table calculation while the SPF calculations are throttled.
+    simtime_t                                                          spfInitialDelay;         ///< The delay of the first routing table calculation after a quiet period.
+    simtime_t                                                          spfHoldTime;             ///< The initial minimum time between two routing table calculations.
+    simtime_t                                                          spfMaxHoldTime;          ///< The upper limit of the exponentially increasing hold time.
+    simtime_t                                                          spfCurrentHoldTime;      ///< The current minimum time between two routing table calculations.
+    simtime_t                                                          lastSPFTime;             ///< The time of the last routing table calculation, or -1 if there was none.
+    unsigned long                                                      spfRequestCount;         ///< The number of times a routing table calculation was requested.
+    unsigned long                                                      spfCount;                ///< The number of routing table calculations.
+    bool                                                               incrementalSPF;          ///< Decides whether the shortest path tree calculations may reuse part of the previous tree.
+    unsigned long                                                      incrementalSPFCount;     ///< The number of area shortest path tree calculations that reused part of the previous tree.
+    double                                                             spfCalculationTime;      ///< The total wall-clock time spent in routing table calculations, in seconds.
+    unsigned long                                                      changedRouteCount;       ///< The total number of routing table entries added, changed or removed by the calculations.
 
 public:
     /**
@@ -60,7 +72,7 @@ public:
 
     /**
      * Destructor.
-     * Clears all LSA lists and kills the Database Age timer.
+     * Clears all LSA lists and kills the Database Age and SPF timers.
      */
     virtual ~Router();
 
@@ -70,6 +82,26 @@ public:
     bool                     getRFC1583Compatibility() const  { return rfc1583Compatibility; }
     unsigned long            getAreaCount() const  { return areas.size(); }
 
+    /**
+     * Sets the SPF throttling parameters: a routing table calculation is
+     * started initialDelay after the first request following a quiet period,
+     * and then at most once per hold time, which doubles after each
+     * calculation in a row, up to maxHoldTime. With zero delays the routing
+     * table is calculated immediately on each request.
+     */
+    void                     setSPFDelays(simtime_t initialDelay, simtime_t holdTime, simtime_t maxHoldTime);
+    simtime_t                getSPFInitialDelay() const  { return spfInitialDelay; }
+    simtime_t                getSPFHoldTime() const  { return spfHoldTime; }
+    simtime_t                getSPFMaxHoldTime() const  { return spfMaxHoldTime; }
+    void                     setIncrementalSPF(bool incremental)  { incrementalSPF = incremental; }
+    bool                     getIncrementalSPF() const  { return incrementalSPF; }
+
+    unsigned long            getSPFRequestCount() const  { return spfRequestCount; }
+    unsigned long            getSPFCount() const  { return spfCount; }
+    unsigned long            getIncrementalSPFCount() const  { return incrementalSPFCount; }
+    double                   getSPFCalculationTime() const  { return spfCalculationTime; }
+    unsigned long            getChangedRouteCount() const  { return changedRouteCount; }
+
     MessageHandler*          getMessageHandler()  { return messageHandler; }
 
     unsigned long            getASExternalLSACount() const  { return asExternalLSAs.size(); }
@@ -203,8 +235,20 @@ public:
     RoutingTableEntry*   lookup(IPv4Address destination, std::vector<RoutingTableEntry*>* table = NULL) const;
 
     /**
-     * Rebuilds the routing table from scratch(based on the LSA database).
+     * Requests a routing table calculation after a change in the LSA database.
+     * The calculation is either done immediately, or delayed by the SPF timer
+     * according to the SPF throttling parameters; further requests until then
+     * are merged into the scheduled calculation.
+     * @sa setSPFDelays
+     */
+    void                 scheduleRoutingTableRebuild();
+
+    /**
+     * Rebuilds the routing table (based on the LSA database). The shortest path
+     * trees of the areas are recalculated incrementally where possible, unless
+     * it is disabled by setIncrementalSPF().
      * @sa RFC2328 Section 16.
+     * @sa OSPF::Area::calculateShortestPathTree
      */
     void                 rebuildRoutingTable();
 
@@ -333,6 +377,13 @@ private:
      */
     void                 notifyAboutRoutingTableChanges(std::vector<RoutingTableEntry*>& oldRoutingTable);
 
+    /**
+     * Returns the number of routing table entries that were added, changed or
+     * removed in routingTable compared to the input oldRoutingTable.
+     * @param oldRoutingTable [in] The previous version of the routing table.
+     */
+    unsigned long        countChangedRoutes(const std::vector<RoutingTableEntry*>& oldRoutingTable) const;
+
     /**
      * Returns true if there is a route to the AS Boundary Router identified by
      * asbrRouterID in the input inRoutingTable, false otherwise.
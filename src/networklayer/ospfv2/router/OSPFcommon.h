@@ -25,6 +25,7 @@
 
 #include "IPv4Address.h"
 #include "IPvXAddressResolver.h"
+#include "OpenHashMap.h"
 
 
 // global constants
@@ -125,6 +126,10 @@ typedef IPv4Address LinkStateID;
 struct LSAKeyType {
     LinkStateID linkStateID;
     RouterID    advertisingRouter;
+
+    bool operator==(const LSAKeyType& other) const {
+        return (linkStateID == other.linkStateID) && (advertisingRouter == other.advertisingRouter);
+    }
 };
 
 class LSAKeyType_Less : public std::binary_function <LSAKeyType, LSAKeyType, bool>
@@ -133,6 +138,16 @@ public:
     bool operator() (LSAKeyType leftKey, LSAKeyType rightKey) const;
 };
 
+struct LinkStateIDHash {
+    size_t operator()(const LinkStateID& linkStateID) const { return hashUInt32(linkStateID.getInt()); }
+};
+
+struct LSAKeyTypeHash {
+    size_t operator()(const LSAKeyType& lsaKey) const {
+        return hashCombine(hashUInt32(lsaKey.linkStateID.getInt()), hashUInt32(lsaKey.advertisingRouter.getInt()));
+    }
+};
+
 struct DesignatedRouterID {
     RouterID    routerID;
     IPv4Address ipInterfaceAddress;
@@ -0,0 +1,96 @@
+//
+// Copyright (C) 2026 OpenSim Ltd.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program.  If not, see http://www.gnu.org/licenses/.
+//
+
+#ifndef AODVEXPIRINGHASHSET_H_
+#define AODVEXPIRINGHASHSET_H_
+
+#include <deque>
+
+#include "INETDefs.h"
+#include "OpenHashMap.h"
+
+/*
+ * A set of keys, where each key expires at a given time. It is used for the
+ * RREQ duplicate cache and the blacklist of AODVRouting.
+ *
+ * The keys and their expiry times are stored in an OpenHashMap, so lookups
+ * are O(1) on average. Expired keys are removed lazily by the lookups, from
+ * the front of an expiry queue. Because of the queue, the expiry times must
+ * be inserted in nondecreasing order, e.g. as the current time plus a
+ * constant lifetime.
+ *
+ * Hash is a functor that computes the hash value of a key.
+ */
+template<typename K, typename Hash>
+class AODVExpiringHashSet
+{
+  private:
+    typedef OpenHashMap<K, simtime_t, Hash> ExpiryTimeMap;
+    typedef std::pair<K, simtime_t> QueueEntry;
+
+    ExpiryTimeMap expiryTimes;
+    std::deque<QueueEntry> expiryQueue;    // in insertion order, thus in expiry time order
+
+  public:
+    /*
+     * Returns the number of keys, including the expired ones not yet removed.
+     */
+    size_t size() const { return expiryTimes.size(); }
+
+    /*
+     * Removes the keys that expired before now.
+     */
+    void removeExpired(simtime_t now)
+    {
+        while (!expiryQueue.empty() && expiryQueue.front().second < now) {
+            const QueueEntry& entry = expiryQueue.front();
+            typename ExpiryTimeMap::iterator it = expiryTimes.find(entry.first);
+            // the key may have been inserted again later with a later expiry time
+            if (it != expiryTimes.end() && it->second == entry.second)
+                expiryTimes.erase(it);
+            expiryQueue.pop_front();
+        }
+    }
+
+    /*
+     * Returns true if the set contains the key, and it does not expire before now.
+     */
+    bool contains(const K& key, simtime_t now)
+    {
+        removeExpired(now);
+        return expiryTimes.find(key) != expiryTimes.end();
+    }
+
+    /*
+     * Inserts the key, or updates its expiry time. The expiry time must not
+     * be less than the one of any previous insertion.
+     */
+    void insert(const K& key, simtime_t expiryTime)
+    {
+        ASSERT(expiryQueue.empty() || expiryQueue.back().second <= expiryTime);
+        expiryTimes[key] = expiryTime;
+        expiryQueue.push_back(QueueEntry(key, expiryTime));
+    }
+
+    void clear()
+    {
+        expiryTimes.clear();
+        expiryQueue.clear();
+    }
+};
+
+#endif // ifndef AODVEXPIRINGHASHSET_H_
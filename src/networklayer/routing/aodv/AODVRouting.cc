@@ -35,6 +35,10 @@ void AODVRouting::initialize(int stage)
         rebootTime = SIMTIME_ZERO;
         rreqId = sequenceNum = 0;
         rreqCount = rerrCount = 0;
+        rateLimitPeriodEnd = SIMTIME_ZERO;
+        lastDiscoveryTimeoutId = 0;
+        numRREQSent = numRREQForwarded = numRREQDuplicate = numRREQBlacklisted = 0;
+        numRREQNotForwarded = numRREQRateLimited = numRouteDiscoveriesFailed = 0;
         host = getContainingNode(this);
         routingTable = RoutingTableAccess().get();
         interfaceTable = InterfaceTableAccess().get();
@@ -65,6 +69,14 @@ void AODVRouting::initialize(int stage)
         netTraversalTime = par("netTraversalTime");
         nextHopWait = par("nextHopWait");
         pathDiscoveryTime = par("pathDiscoveryTime");
+
+        WATCH(numRREQSent);
+        WATCH(numRREQForwarded);
+        WATCH(numRREQDuplicate);
+        WATCH(numRREQBlacklisted);
+        WATCH(numRREQNotForwarded);
+        WATCH(numRREQRateLimited);
+        WATCH(numRouteDiscoveriesFailed);
     }
     else if (stage == 4) {
         NodeStatus *nodeStatus = dynamic_cast<NodeStatus *>(host->getSubmodule("status"));
@@ -88,15 +100,22 @@ void AODVRouting::initialize(int stage)
         }
 
         expungeTimer = new cMessage("ExpungeTimer");
-        counterTimer = new cMessage("CounterTimer");
         rrepAckTimer = new cMessage("RREPACKTimer");
-        blacklistTimer = new cMessage("BlackListTimer");
-
-        if (isOperational)
-            scheduleAt(simTime() + 1, counterTimer);
+        discoveryTimer = new cMessage("DiscoveryTimer");
     }
 }
 
+void AODVRouting::finish()
+{
+    recordScalar("RREQs sent", numRREQSent);
+    recordScalar("RREQs forwarded", numRREQForwarded);
+    recordScalar("RREQs suppressed as duplicate", numRREQDuplicate);
+    recordScalar("RREQs suppressed by blacklist", numRREQBlacklisted);
+    recordScalar("RREQs not forwarded", numRREQNotForwarded);
+    recordScalar("RREQs rate limited", numRREQRateLimited);
+    recordScalar("route discoveries failed", numRouteDiscoveriesFailed);
+}
+
 void AODVRouting::handleMessage(cMessage *msg)
 {
     if (!isOperational) {
@@ -108,20 +127,14 @@ void AODVRouting::handleMessage(cMessage *msg)
     }
 
     if (msg->isSelfMessage()) {
-        if (dynamic_cast<WaitForRREP *>(msg))
-            handleWaitForRREP((WaitForRREP *)msg);
+        if (msg == discoveryTimer)
+            handleDiscoveryTimer();
         else if (msg == helloMsgTimer)
             sendHelloMessagesIfNeeded();
         else if (msg == expungeTimer)
             expungeRoutes();
-        else if (msg == counterTimer) {
-            rreqCount = rerrCount = 0;
-            scheduleAt(simTime() + 1, counterTimer);
-        }
         else if (msg == rrepAckTimer)
             handleRREPACKTimer();
-        else if (msg == blacklistTimer)
-            handleBlackListTimer();
         else
             throw cRuntimeError("Unknown self message");
     }
@@ -222,24 +235,24 @@ AODVRouting::AODVRouting()
     networkProtocol = NULL;
     helloMsgTimer = NULL;
     expungeTimer = NULL;
-    blacklistTimer = NULL;
     rrepAckTimer = NULL;
+    discoveryTimer = NULL;
     jitterPar = NULL;
     nb = NULL;
 }
 
 bool AODVRouting::hasOngoingRouteDiscovery(const IPv4Address& target)
 {
-    return waitForRREPTimers.find(target) != waitForRREPTimers.end();
+    return routeDiscoveries.find(target) != routeDiscoveries.end();
 }
 
 void AODVRouting::startRouteDiscovery(const IPv4Address& target, unsigned timeToLive)
 {
     EV_INFO << "Starting route discovery with originator " << getSelfIPAddress() << " and destination " << target << endl;
     ASSERT(!hasOngoingRouteDiscovery(target));
-    AODVRREQ *rreq = createRREQ(target);
-    addressToRreqRetries[target] = 0;
-    sendRREQ(rreq, IPv4Address::ALLONES_ADDRESS, timeToLive);
+    RouteDiscovery& discovery = routeDiscoveries[target];
+    discovery.initialTTL = timeToLive;
+    sendRREQ(target, discovery);
 }
 
 IPv4Address AODVRouting::getSelfIPAddress() const
@@ -254,7 +267,7 @@ void AODVRouting::delayDatagram(IPv4Datagram *datagram)
     targetAddressToDelayedPackets.insert(std::pair<IPv4Address, IPv4Datagram *>(target, datagram));
 }
 
-void AODVRouting::sendRREQ(AODVRREQ *rreq, const IPv4Address& destAddr, unsigned int timeToLive)
+void AODVRouting::sendRREQ(const IPv4Address& target, RouteDiscovery& discovery)
 {
     // In an expanding ring search, the originating node initially uses a TTL =
     // TTL_START in the RREQ packet IP header and sets the timeout for
@@ -267,63 +280,108 @@ void AODVRouting::sendRREQ(AODVRREQ *rreq, const IPv4Address& destAddr, unsigned
     // until the TTL set in the RREQ reaches TTL_THRESHOLD, beyond which a
     // TTL = NET_DIAMETER is used for each attempt.
 
+    updateRateLimitPeriod();
     if (rreqCount >= rreqRatelimit) {
-        EV_WARN << "A node should not originate more than RREQ_RATELIMIT RREQ messages per second. Canceling sending RREQ" << endl;
-        delete rreq;
+        // The RREQ is not dropped, because the discovery would never complete:
+        // it is sent when the next second begins.
+        EV_WARN << "A node should not originate more than RREQ_RATELIMIT RREQ messages per second. Postponing the RREQ to " << rateLimitPeriodEnd << endl;
+        numRREQRateLimited++;
+        discovery.isRateLimited = true;
+        scheduleDiscoveryTimeout(target, discovery, rateLimitPeriodEnd);
         return;
     }
 
-    std::map<IPv4Address, WaitForRREP *>::iterator rrepTimer = waitForRREPTimers.find(rreq->getDestAddr());
-    WaitForRREP *rrepTimerMsg = NULL;
-    if (rrepTimer != waitForRREPTimers.end()) {
-        rrepTimerMsg = rrepTimer->second;
-        unsigned int lastTTL = rrepTimerMsg->getLastTTL();
-        rrepTimerMsg->setDestAddr(rreq->getDestAddr());
-
-        // The Hop Count stored in an invalid routing table entry indicates the
-        // last known hop count to that destination in the routing table.  When
-        // a new route to the same destination is required at a later time
-        // (e.g., upon route loss), the TTL in the RREQ IP header is initially
-        // set to the Hop Count plus TTL_INCREMENT.  Thereafter, following each
-        // timeout the TTL is incremented by TTL_INCREMENT until TTL =
-        // TTL_THRESHOLD is reached.  Beyond this TTL = NET_DIAMETER is used.
-        // Once TTL = NET_DIAMETER, the timeout for waiting for the RREP is set
-        // to NET_TRAVERSAL_TIME, as specified in section 6.3.
-
-        if (timeToLive != 0) {
-            rrepTimerMsg->setLastTTL(timeToLive);
-            rrepTimerMsg->setFromInvalidEntry(true);
-            cancelEvent(rrepTimerMsg);
-        }
-        else if (lastTTL + ttlIncrement < ttlThreshold) {
-            ASSERT(!rrepTimerMsg->isScheduled());
-            timeToLive = lastTTL + ttlIncrement;
-            rrepTimerMsg->setLastTTL(lastTTL + ttlIncrement);
-        }
-        else {
-            ASSERT(!rrepTimerMsg->isScheduled());
-            timeToLive = netDiameter;
-            rrepTimerMsg->setLastTTL(netDiameter);
-        }
+    // The Hop Count stored in an invalid routing table entry indicates the
+    // last known hop count to that destination in the routing table.  When
+    // a new route to the same destination is required at a later time
+    // (e.g., upon route loss), the TTL in the RREQ IP header is initially
+    // set to the Hop Count plus TTL_INCREMENT.  Thereafter, following each
+    // timeout the TTL is incremented by TTL_INCREMENT until TTL =
+    // TTL_THRESHOLD is reached.  Beyond this TTL = NET_DIAMETER is used.
+    // Once TTL = NET_DIAMETER, the timeout for waiting for the RREP is set
+    // to NET_TRAVERSAL_TIME, as specified in section 6.3.
+
+    unsigned int timeToLive;
+    if (discovery.lastTTL == 0)
+        timeToLive = discovery.initialTTL != 0 ? std::min(discovery.initialTTL, netDiameter) : ttlStart;
+    else if (discovery.lastTTL + ttlIncrement < ttlThreshold)
+        timeToLive = discovery.lastTTL + ttlIncrement;
+    else
+        timeToLive = netDiameter;
+    discovery.lastTTL = timeToLive;
+
+    simtime_t timeout;
+    if (timeToLive == netDiameter) {
+        // To reduce congestion in a network, repeated attempts by a source
+        // node at route discovery for a single destination MUST utilize a
+        // binary exponential backoff.  The first time a source node
+        // broadcasts a RREQ, it waits NET_TRAVERSAL_TIME milliseconds for the
+        // reception of a RREP.  If a RREP is not received within that time,
+        // the source node sends a new RREQ.  When calculating the time to
+        // wait for the RREP after sending the second RREQ, the source node
+        // MUST use a binary exponential backoff.
+        timeout = netTraversalTime * (1 << discovery.retries);
     }
     else {
-        rrepTimerMsg = new WaitForRREP();
-        waitForRREPTimers[rreq->getDestAddr()] = rrepTimerMsg;
-        ASSERT(hasOngoingRouteDiscovery(rreq->getDestAddr()));
-
-        timeToLive = ttlStart;
-        rrepTimerMsg->setLastTTL(ttlStart);
-        rrepTimerMsg->setFromInvalidEntry(false);
-        rrepTimerMsg->setDestAddr(rreq->getDestAddr());
+        // Each time, the timeout for receiving a RREP is RING_TRAVERSAL_TIME.
+        timeout = 2.0 * nodeTraversalTime * (timeToLive + timeoutBuffer);
     }
+    scheduleDiscoveryTimeout(target, discovery, simTime() + timeout);
 
-    // Each time, the timeout for receiving a RREP is RING_TRAVERSAL_TIME.
-    simtime_t ringTraversalTime = 2.0 * nodeTraversalTime * (timeToLive + timeoutBuffer);
-    scheduleAt(simTime() + ringTraversalTime, rrepTimerMsg);
-
-    EV_INFO << "Sending a Route Request with target " << rreq->getDestAddr() << " and TTL= " << timeToLive << endl;
-    sendAODVPacket(rreq, destAddr, timeToLive, jitterPar->doubleValue());
+    AODVRREQ *rreq = createRREQ(target);
+    EV_INFO << "Sending a Route Request with target " << target << " and TTL= " << timeToLive << endl;
+    sendAODVPacket(rreq, IPv4Address::ALLONES_ADDRESS, timeToLive, jitterPar->doubleValue());
     rreqCount++;
+    numRREQSent++;
+}
+
+void AODVRouting::updateRateLimitPeriod()
+{
+    // rreqCount and rerrCount count the messages of the current second; the
+    // second begins with the first message after the previous one ended
+    if (simTime() >= rateLimitPeriodEnd) {
+        rreqCount = rerrCount = 0;
+        rateLimitPeriodEnd = simTime() + 1;
+    }
+}
+
+void AODVRouting::scheduleDiscoveryTimeout(const IPv4Address& target, RouteDiscovery& discovery, simtime_t time)
+{
+    // the previous entry of the discovery, if any, is skipped when it gets to the top
+    discovery.timeoutId = ++lastDiscoveryTimeoutId;
+    discoveryTimeouts.push(DiscoveryTimeout(time, discovery.timeoutId, target));
+
+    if (!discoveryTimer->isScheduled())
+        scheduleAt(time, discoveryTimer);
+    else if (discoveryTimer->getArrivalTime() > time) {
+        cancelEvent(discoveryTimer);
+        scheduleAt(time, discoveryTimer);
+    }
+}
+
+void AODVRouting::handleDiscoveryTimer()
+{
+    while (!discoveryTimeouts.empty() && discoveryTimeouts.top().time <= simTime()) {
+        DiscoveryTimeout timeout = discoveryTimeouts.top();
+        discoveryTimeouts.pop();
+        std::map<IPv4Address, RouteDiscovery>::iterator it = routeDiscoveries.find(timeout.target);
+        if (it != routeDiscoveries.end() && it->second.timeoutId == timeout.id)
+            handleDiscoveryTimeout(timeout.target, it->second);
+    }
+
+    // skip the entries of finished discoveries
+    while (!discoveryTimeouts.empty()) {
+        const DiscoveryTimeout& timeout = discoveryTimeouts.top();
+        std::map<IPv4Address, RouteDiscovery>::iterator it = routeDiscoveries.find(timeout.target);
+        if (it != routeDiscoveries.end() && it->second.timeoutId == timeout.id)
+            break;
+        discoveryTimeouts.pop();
+    }
+    // the handlers may have scheduled the timer for a later entry
+    if (discoveryTimer->isScheduled())
+        cancelEvent(discoveryTimer);
+    if (!discoveryTimeouts.empty())
+        scheduleAt(discoveryTimeouts.top().time, discoveryTimer);
 }
 
 void AODVRouting::sendRREP(AODVRREP *rrep, const IPv4Address& destAddr, unsigned int timeToLive)
@@ -411,7 +469,7 @@ AODVRREQ *AODVRouting::createRREQ(const IPv4Address& destAddr)
     // it will not reprocess and re-forward the packet.
 
     RREQIdentifier rreqIdentifier(getSelfIPAddress(), rreqId);
-    rreqsArrivalTime[rreqIdentifier] = simTime();
+    rreqCache.insert(rreqIdentifier, simTime() + pathDiscoveryTime);
 
     return rreqPacket;
 }
@@ -746,9 +804,9 @@ void AODVRouting::handleRREQ(AODVRREQ *rreq, const IPv4Address& sourceAddr, unsi
 
     // A node ignores all RREQs received from any node in its blacklist set.
 
-    std::map<IPv4Address, simtime_t>::iterator blackListIt = blacklist.find(sourceAddr);
-    if (blackListIt != blacklist.end()) {
+    if (blacklist.contains(sourceAddr, simTime())) {
         EV_INFO << "The sender node " << sourceAddr << " is in our blacklist. Ignoring the Route Request" << endl;
+        numRREQBlacklisted++;
         delete rreq;
         return;
     }
@@ -770,15 +828,15 @@ void AODVRouting::handleRREQ(AODVRREQ *rreq, const IPv4Address& sourceAddr, unsi
     // If such a RREQ has been received, the node silently discards the newly received RREQ.
 
     RREQIdentifier rreqIdentifier(rreq->getOriginatorAddr(), rreq->getRreqId());
-    std::map<RREQIdentifier, simtime_t, RREQIdentifierCompare>::iterator checkRREQArrivalTime = rreqsArrivalTime.find(rreqIdentifier);
-    if (checkRREQArrivalTime != rreqsArrivalTime.end() && simTime() - checkRREQArrivalTime->second <= pathDiscoveryTime) {
+    if (rreqCache.contains(rreqIdentifier, simTime())) {
         EV_WARN << "The same packet has arrived within PATH_DISCOVERY_TIME= " << pathDiscoveryTime << ". Discarding it" << endl;
+        numRREQDuplicate++;
         delete rreq;
         return;
     }
 
-    // update or create
-    rreqsArrivalTime[rreqIdentifier] = simTime();
+    // create, or renew the expired one
+    rreqCache.insert(rreqIdentifier, simTime() + pathDiscoveryTime);
 
     // First, it first increments the hop count value in the RREQ by one, to
     // account for the new hop through the intermediate node.
@@ -938,9 +996,12 @@ void AODVRouting::handleRREQ(AODVRREQ *rreq, const IPv4Address& sourceAddr, unsi
 
         AODVRREQ *outgoingRREQ = rreq->dup();
         forwardRREQ(outgoingRREQ, timeToLive);
+        numRREQForwarded++;
     }
-    else
+    else {
         EV_WARN << "Can't forward the RREQ because of its small (<= 1) TTL: " << timeToLive << " or the AODV reboot has not completed yet" << endl;
+        numRREQNotForwarded++;
+    }
 
     delete rreq;
 }
@@ -1081,6 +1142,7 @@ void AODVRouting::handleLinkBreakSendRERR(const IPv4Address& unreachableAddr)
     // TTL == 1) with the unreachable destinations, and their corresponding
     // destination sequence numbers, included in the packet.
 
+    updateRateLimitPeriod();
     if (rerrCount >= rerrRatelimit) {
         EV_WARN << "A node should not generate more than RERR_RATELIMIT RERR messages per second. Canceling sending RERR" << endl;
         return;
@@ -1160,6 +1222,7 @@ void AODVRouting::handleRERR(AODVRERR *rerr, const IPv4Address& sourceAddr)
         }
     }
 
+    updateRateLimitPeriod();
     if (rerrCount >= rerrRatelimit) {
         EV_WARN << "A node should not generate more than RERR_RATELIMIT RERR messages per second. Canceling sending RERR" << endl;
         delete rerr;
@@ -1185,8 +1248,6 @@ bool AODVRouting::handleOperationStage(LifecycleOperation *operation, int stage,
 
             if (useHelloMessages)
                 scheduleAt(simTime() + helloInterval - periodicJitter->doubleValue(), helloMsgTimer);
-
-            scheduleAt(simTime() + 1, counterTimer);
         }
     }
     else if (dynamic_cast<NodeShutdownOperation *>(operation)) {
@@ -1210,9 +1271,9 @@ bool AODVRouting::handleOperationStage(LifecycleOperation *operation, int stage,
 void AODVRouting::clearState()
 {
     rerrCount = rreqCount = rreqId = sequenceNum = 0;
-    addressToRreqRetries.clear();
-    for (std::map<IPv4Address, WaitForRREP *>::iterator it = waitForRREPTimers.begin(); it != waitForRREPTimers.end(); ++it)
-        cancelAndDelete(it->second);
+    rateLimitPeriodEnd = SIMTIME_ZERO;
+    routeDiscoveries.clear();
+    discoveryTimeouts = std::priority_queue<DiscoveryTimeout, std::vector<DiscoveryTimeout>, DiscoveryTimeoutCompare>();
 
     // FIXME: Drop the queued datagrams.
     //for (std::multimap<IPv4Address, IPv4Datagram *>::iterator it = targetAddressToDelayedPackets.begin(); it != targetAddressToDelayedPackets.end(); it++)
@@ -1220,37 +1281,43 @@ void AODVRouting::clearState()
 
     targetAddressToDelayedPackets.clear();
 
-    waitForRREPTimers.clear();
-    rreqsArrivalTime.clear();
+    rreqCache.clear();
+    blacklist.clear();
 
     if (useHelloMessages)
         cancelEvent(helloMsgTimer);
 
     cancelEvent(expungeTimer);
-    cancelEvent(counterTimer);
-    cancelEvent(blacklistTimer);
     cancelEvent(rrepAckTimer);
+    cancelEvent(discoveryTimer);
 }
 
-void AODVRouting::handleWaitForRREP(WaitForRREP *rrepTimer)
+void AODVRouting::handleDiscoveryTimeout(const IPv4Address& target, RouteDiscovery& discovery)
 {
-    EV_INFO << "We didn't get any Route Reply within RREP timeout" << endl;
-    IPv4Address destAddr = rrepTimer->getDestAddr();
-
-    ASSERT(addressToRreqRetries.find(destAddr) != addressToRreqRetries.end());
-    if (addressToRreqRetries[destAddr] == rreqRetries) {
-        EV_WARN << "Re-discovery attempts for node " << destAddr << " reached RREQ_RETRIES= " << rreqRetries << " limit. Stop sending RREQ." << endl;
+    if (discovery.isRateLimited) {
+        discovery.isRateLimited = false;
+        sendRREQ(target, discovery);
         return;
     }
 
-    AODVRREQ *rreq = createRREQ(destAddr);
+    EV_INFO << "We didn't get any Route Reply within RREP timeout" << endl;
 
     // the node MAY try again to discover a route by broadcasting another
     // RREQ, up to a maximum of RREQ_RETRIES times at the maximum TTL value.
-    if (rrepTimer->getLastTTL() == netDiameter) // netDiameter is the maximum TTL value
-        addressToRreqRetries[destAddr]++;
+    if (discovery.lastTTL == netDiameter) {    // netDiameter is the maximum TTL value
+        if (discovery.retries == rreqRetries) {
+            // If a route is not received within the waiting time, the data
+            // packets destined for the corresponding destination SHOULD be
+            // dropped from the buffer.
+            EV_WARN << "Re-discovery attempts for node " << target << " reached RREQ_RETRIES= " << rreqRetries << " limit. Stop sending RREQ." << endl;
+            numRouteDiscoveriesFailed++;
+            cancelRouteDiscovery(target);
+            return;
+        }
+        discovery.retries++;
+    }
 
-    sendRREQ(rreq, IPv4Address::ALLONES_ADDRESS, 0);
+    sendRREQ(target, discovery);
 }
 
 void AODVRouting::forwardRREP(AODVRREP *rrep, const IPv4Address& destAddr, unsigned int timeToLive)
@@ -1288,11 +1355,9 @@ void AODVRouting::completeRouteDiscovery(const IPv4Address& target)
     // clear the multimap
     targetAddressToDelayedPackets.erase(lt, ut);
 
-    // we have a route for the destination, thus we must cancel the WaitForRREPTimer events
-    std::map<IPv4Address, WaitForRREP *>::iterator waitRREPIter = waitForRREPTimers.find(target);
-    ASSERT(waitRREPIter != waitForRREPTimers.end());
-    cancelAndDelete(waitRREPIter->second);
-    waitForRREPTimers.erase(waitRREPIter);
+    // we have a route for the destination, thus the discovery timeout is
+    // no longer needed (its entry is skipped in discoveryTimeouts)
+    routeDiscoveries.erase(target);
 }
 
 void AODVRouting::sendGRREP(AODVRREP *grrep, const IPv4Address& destAddr, unsigned int timeToLive)
@@ -1538,6 +1603,7 @@ INetfilter::IHook::Result AODVRouting::datagramForwardHook(IPv4Datagram *datagra
 
 void AODVRouting::sendRERRWhenNoRouteToForward(const IPv4Address& unreachableAddr)
 {
+    updateRateLimitPeriod();
     if (rerrCount >= rerrRatelimit) {
         EV_WARN << "A node should not generate more than RERR_RATELIMIT RERR messages per second. Canceling sending RERR" << endl;
         return;
@@ -1571,6 +1637,7 @@ void AODVRouting::cancelRouteDiscovery(const IPv4Address& destAddr)
         networkProtocol->dropQueuedDatagram(const_cast<const IPv4Datagram *>(it->second));
 
     targetAddressToDelayedPackets.erase(lt, ut);
+    routeDiscoveries.erase(destAddr);
 }
 
 bool AODVRouting::updateValidRouteLifeTime(const IPv4Address& destAddr, simtime_t lifetime)
@@ -1626,30 +1693,8 @@ void AODVRouting::handleRREPACKTimer()
 
     EV_INFO << "RREP-ACK didn't arrived within timeout. Adding " << failedNextHop << " to the blacklist" << endl;
 
-    blacklist[failedNextHop] = simTime() + blacklistTimeout;    // lifetime
-
-    if (!blacklistTimer->isScheduled())
-        scheduleAt(simTime() + blacklistTimeout, blacklistTimer);
-}
-
-void AODVRouting::handleBlackListTimer()
-{
-    simtime_t nextTime = SimTime::getMaxTime();
-
-    for (std::map<IPv4Address, simtime_t>::iterator it = blacklist.begin(); it != blacklist.end(); ) {
-        std::map<IPv4Address, simtime_t>::iterator current = it++;
-
-        // Nodes are removed from the blacklist set after a BLACKLIST_TIMEOUT period
-        if (it->second <= simTime()) {
-            EV_DETAIL << "Blacklist lifetime has expired for " << current->first << " removing it from the blacklisted addresses" << endl;
-            blacklist.erase(current);
-        }
-        else if (nextTime > current->second)
-            nextTime = current->second;
-    }
-
-    if (nextTime != SimTime::getMaxTime())
-        scheduleAt(nextTime, blacklistTimer);
+    // Nodes are removed from the blacklist set after a BLACKLIST_TIMEOUT period
+    blacklist.insert(failedNextHop, simTime() + blacklistTimeout);
 }
 
 AODVRouting::~AODVRouting()
@@ -1657,9 +1702,8 @@ AODVRouting::~AODVRouting()
     clearState();
     delete helloMsgTimer;
     delete expungeTimer;
-    delete counterTimer;
     delete rrepAckTimer;
-    delete blacklistTimer;
+    delete discoveryTimer;
 
     nb = NotificationBoardAccess().getIfExists(this);
     if (nb)
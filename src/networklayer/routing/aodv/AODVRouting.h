@@ -31,7 +31,9 @@
 #include "AODVRouteData.h"
 #include "UDPPacket.h"
 #include "AODVControlPackets_m.h"
+#include "AODVExpiringHashSet.h"
 #include <map>
+#include <queue>
 
 /*
  * This class implements AODV routing protocol and Netfilter hooks
@@ -43,13 +45,14 @@ class INET_API AODVRouting : public cSimpleModule, public ILifecycle, public INe
   protected:
     /*
      * It implements a unique identifier for an arbitrary RREQ message
-     * in the network. See: rreqsArrivalTime.
+     * in the network. See: rreqCache.
      */
     class RREQIdentifier
     {
       public:
         IPv4Address originatorAddr;
         unsigned int rreqID;
+        RREQIdentifier() : rreqID(0) {};
         RREQIdentifier(const IPv4Address& originatorAddr, unsigned int rreqID) : originatorAddr(originatorAddr), rreqID(rreqID) {};
         bool operator==(const RREQIdentifier& other) const
         {
@@ -57,12 +60,56 @@ class INET_API AODVRouting : public cSimpleModule, public ILifecycle, public INe
         }
     };
 
-    class RREQIdentifierCompare
+    class RREQIdentifierHash
     {
       public:
-        bool operator()(const RREQIdentifier& lhs, const RREQIdentifier& rhs) const
+        size_t operator()(const RREQIdentifier& rreqIdentifier) const
         {
-            return lhs.rreqID < rhs.rreqID;
+            return hashCombine(hashUInt32(rreqIdentifier.originatorAddr.getInt()), hashUInt32(rreqIdentifier.rreqID));
+        }
+    };
+
+    class IPv4AddressHash
+    {
+      public:
+        size_t operator()(const IPv4Address& address) const { return hashUInt32(address.getInt()); }
+    };
+
+    /*
+     * State of an ongoing route discovery (expanding ring search, RFC 3561 6.4).
+     * See: routeDiscoveries.
+     */
+    class RouteDiscovery
+    {
+      public:
+        unsigned int initialTTL;    // TTL of the first RREQ if it is not TTL_START (hop count of the invalid route + TTL_INCREMENT), or 0
+        unsigned int lastTTL;    // TTL of the last RREQ, or 0 if none has been sent yet
+        unsigned int retries;    // number of RREQs resent with TTL = NET_DIAMETER
+        bool isRateLimited;    // the next RREQ is postponed because of RREQ_RATELIMIT
+        unsigned long timeoutId;    // identifies the pending entry of discoveryTimeouts
+        RouteDiscovery() : initialTTL(0), lastTTL(0), retries(0), isRateLimited(false), timeoutId(0) {};
+    };
+
+    /*
+     * An entry of the discovery timeout queue: when the RREP timeout of a
+     * route discovery expires, or its postponed RREQ is to be sent.
+     */
+    class DiscoveryTimeout
+    {
+      public:
+        simtime_t time;
+        unsigned long id;    // increasing, to keep the order of equal times
+        IPv4Address target;
+        DiscoveryTimeout(simtime_t time, unsigned long id, const IPv4Address& target) : time(time), id(id), target(target) {};
+    };
+
+    class DiscoveryTimeoutCompare
+    {
+      public:
+        // the earliest timeout is at the top of the priority queue
+        bool operator()(const DiscoveryTimeout& lhs, const DiscoveryTimeout& rhs) const
+        {
+            return lhs.time > rhs.time || (lhs.time == rhs.time && lhs.id > rhs.id);
         }
     };
 
@@ -109,21 +156,31 @@ class INET_API AODVRouting : public cSimpleModule, public ILifecycle, public INe
     // state
     unsigned int rreqId;    // when sending a new RREQ packet, rreqID incremented by one from the last id used by this node
     unsigned int sequenceNum;    // it helps to prevent loops in the routes (RFC 3561 6.1 p11.)
-    std::map<IPv4Address, WaitForRREP *> waitForRREPTimers;    // timeout for Route Replies
-    std::map<RREQIdentifier, simtime_t, RREQIdentifierCompare> rreqsArrivalTime;    // maps RREQ id to its arriving time
+    std::map<IPv4Address, RouteDiscovery> routeDiscoveries;    // ongoing route discoveries by target address
+    std::priority_queue<DiscoveryTimeout, std::vector<DiscoveryTimeout>, DiscoveryTimeoutCompare> discoveryTimeouts;    // entries of finished discoveries are skipped lazily
+    unsigned long lastDiscoveryTimeoutId;
+    AODVExpiringHashSet<RREQIdentifier, RREQIdentifierHash> rreqCache;    // RREQs received (or sent) within PATH_DISCOVERY_TIME
     IPv4Address failedNextHop;    // next hop to the destination who failed to send us RREP-ACK
-    std::map<IPv4Address, simtime_t> blacklist;    // we don't accept RREQs from blacklisted nodes
-    unsigned int rerrCount;    // num of originated RERR in the last second
-    unsigned int rreqCount;    // num of originated RREQ in the last second
+    AODVExpiringHashSet<IPv4Address, IPv4AddressHash> blacklist;    // we don't accept RREQs from blacklisted nodes
+    unsigned int rerrCount;    // num of originated RERR in the current second
+    unsigned int rreqCount;    // num of originated RREQ in the current second
+    simtime_t rateLimitPeriodEnd;    // end of the current second of rerrCount and rreqCount
     simtime_t lastBroadcastTime;    // the last time when any control packet was broadcasted
-    std::map<IPv4Address, unsigned int> addressToRreqRetries; // number of re-discovery attempts per address
 
     // self messages
     cMessage *helloMsgTimer;    // timer to send hello messages (only if the feature is enabled)
     cMessage *expungeTimer;    // timer to clean the routing table out
-    cMessage *counterTimer;    // timer to set rrerCount = rreqCount = 0 in each second
     cMessage *rrepAckTimer;    // timer to wait for RREP-ACKs (RREP-ACK timeout)
-    cMessage *blacklistTimer;    // timer to clean the blacklist out
+    cMessage *discoveryTimer;    // timer of the earliest entry of discoveryTimeouts
+
+    // statistics
+    unsigned long numRREQSent;    // originated RREQs
+    unsigned long numRREQForwarded;
+    unsigned long numRREQDuplicate;    // received RREQs suppressed as duplicates
+    unsigned long numRREQBlacklisted;    // received RREQs suppressed because of the blacklist
+    unsigned long numRREQNotForwarded;    // received RREQs suppressed because of their TTL (or a recent reboot)
+    unsigned long numRREQRateLimited;    // RREQs postponed because of RREQ_RATELIMIT
+    unsigned long numRouteDiscoveriesFailed;    // route discoveries given up after RREQ_RETRIES
 
     // lifecycle
     simtime_t rebootTime;    // the last time when the node rebooted
@@ -136,6 +193,7 @@ class INET_API AODVRouting : public cSimpleModule, public ILifecycle, public INe
     void handleMessage(cMessage *msg);
     void initialize(int stage);
     virtual int numInitStages() const { return 5; }
+    virtual void finish();
 
     /* Route Discovery */
     void startRouteDiscovery(const IPv4Address& target, unsigned int timeToLive = 0);
@@ -166,7 +224,7 @@ class INET_API AODVRouting : public cSimpleModule, public ILifecycle, public INe
     void handleRREPACK(AODVRREPACK *rrepACK, const IPv4Address& neighborAddr);
 
     /* Control Packet sender methods */
-    void sendRREQ(AODVRREQ *rreq, const IPv4Address& destAddr, unsigned int timeToLive);
+    void sendRREQ(const IPv4Address& target, RouteDiscovery& discovery);
     void sendRREPACK(AODVRREPACK *rrepACK, const IPv4Address& destAddr);
     void sendRREP(AODVRREP *rrep, const IPv4Address& destAddr, unsigned int timeToLive);
     void sendGRREP(AODVRREP *grrep, const IPv4Address& destAddr, unsigned int timeToLive);
@@ -177,9 +235,11 @@ class INET_API AODVRouting : public cSimpleModule, public ILifecycle, public INe
 
     /* Self message handlers */
     void handleRREPACKTimer();
-    void handleBlackListTimer();
     void sendHelloMessagesIfNeeded();
-    void handleWaitForRREP(WaitForRREP *rrepTimer);
+    void handleDiscoveryTimer();
+    void handleDiscoveryTimeout(const IPv4Address& target, RouteDiscovery& discovery);
+    void scheduleDiscoveryTimeout(const IPv4Address& target, RouteDiscovery& discovery, simtime_t time);
+    void updateRateLimitPeriod();
 
     /* General functions to handle route errors */
     void sendRERRWhenNoRouteToForward(const IPv4Address& unreachableAddr);
@@ -16,6 +16,8 @@
 // Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 //
 
+#include <algorithm>
+
 #include "GPSR.h"
 #include "InterfaceTableAccess.h"
 #include "IPProtocolId_m.h"
@@ -49,6 +51,9 @@ GPSR::GPSR()
     networkProtocol = NULL;
     beaconTimer = NULL;
     purgeNeighborsTimer = NULL;
+    neighborCacheValid = false;
+    planarNeighborsValid = false;
+    neighborCacheVersion = 0;
 }
 
 GPSR::~GPSR()
@@ -387,67 +392,87 @@ void GPSR::purgeNeighbors()
     neighborPositionTable.removeOldPositions(simTime() - neighborValidityInterval);
 }
 
-std::vector<IPvXAddress> GPSR::getPlanarNeighbors()
+void GPSR::updateNeighborCache()
 {
-    std::vector<IPvXAddress> planarNeighbors;
-    std::vector<IPvXAddress> neighborAddresses = neighborPositionTable.getAddresses();
     Coord selfPosition = mobility->getCurrentPosition();
+    if (neighborCacheValid && neighborCacheVersion == neighborPositionTable.getVersion() &&
+        neighborCacheSelfPosition.x == selfPosition.x && neighborCacheSelfPosition.y == selfPosition.y && neighborCacheSelfPosition.z == selfPosition.z)
+        return;
+    neighbors.clear();
+    std::vector<IPvXAddress> neighborAddresses = neighborPositionTable.getAddresses();
     for (std::vector<IPvXAddress>::iterator it = neighborAddresses.begin(); it != neighborAddresses.end(); it++) {
-        const IPvXAddress & neighborAddress = *it;
-        Coord neighborPosition = neighborPositionTable.getPosition(neighborAddress);
+        Coord neighborPosition = neighborPositionTable.getPosition(*it);
+        neighbors.push_back(NeighborEntry(*it, neighborPosition, getVectorAngle(neighborPosition - selfPosition)));
+    }
+    neighborCacheValid = true;
+    neighborCacheVersion = neighborPositionTable.getVersion();
+    neighborCacheSelfPosition = selfPosition;
+    planarNeighborsValid = false;
+}
+
+const std::vector<GPSR::NeighborEntry> & GPSR::getNeighbors()
+{
+    updateNeighborCache();
+    return neighbors;
+}
+
+const std::vector<GPSR::NeighborEntry> & GPSR::getPlanarNeighbors()
+{
+    updateNeighborCache();
+    if (planarNeighborsValid)
+        return planarNeighbors;
+    planarNeighbors.clear();
+    const Coord & selfPosition = neighborCacheSelfPosition;
+    for (unsigned int i = 0; i < neighbors.size(); i++) {
+        const Coord & neighborPosition = neighbors[i].position;
+        bool isEliminated = false;
         if (planarizationMode == GPSR_RNG_PLANARIZATION) {
             double neighborDistance = (neighborPosition - selfPosition).length();
-            for (std::vector<IPvXAddress>::iterator jt = neighborAddresses.begin(); jt != neighborAddresses.end(); jt++) {
-                const IPvXAddress & witnessAddress = *jt;
-                Coord witnessPosition = neighborPositionTable.getPosition(witnessAddress);
-                double witnessDistance = (witnessPosition - selfPosition).length();;
-                double neighborWitnessDistance = (witnessPosition - neighborPosition).length();
-                if (*it == *jt)
+            for (unsigned int j = 0; j < neighbors.size() && !isEliminated; j++) {
+                if (i == j)
                     continue;
-                else if (neighborDistance > std::max(witnessDistance, neighborWitnessDistance))
-                    goto eliminate;
+                const Coord & witnessPosition = neighbors[j].position;
+                double witnessDistance = (witnessPosition - selfPosition).length();
+                double neighborWitnessDistance = (witnessPosition - neighborPosition).length();
+                isEliminated = neighborDistance > std::max(witnessDistance, neighborWitnessDistance);
             }
         }
         else if (planarizationMode == GPSR_GG_PLANARIZATION) {
             Coord middlePosition = (selfPosition + neighborPosition) / 2;
             double neighborDistance = (neighborPosition - middlePosition).length();
-            for (std::vector<IPvXAddress>::iterator jt = neighborAddresses.begin(); jt != neighborAddresses.end(); jt++) {
-                const IPvXAddress & witnessAddress = *jt;
-                Coord witnessPosition = neighborPositionTable.getPosition(witnessAddress);
-                double witnessDistance = (witnessPosition - middlePosition).length();;
-                if (*it == *jt)
+            for (unsigned int j = 0; j < neighbors.size() && !isEliminated; j++) {
+                if (i == j)
                     continue;
-                else if (witnessDistance < neighborDistance)
-                    goto eliminate;
+                double witnessDistance = (neighbors[j].position - middlePosition).length();
+                isEliminated = witnessDistance < neighborDistance;
             }
         }
         else
             throw cRuntimeError("Unknown planarization mode");
-        planarNeighbors.push_back(*it);
-        eliminate: ;
+        if (!isEliminated)
+            planarNeighbors.push_back(neighbors[i]);
     }
+    // neighbors with the same angle remain in address order
+    std::stable_sort(planarNeighbors.begin(), planarNeighbors.end());
+    planarNeighborsValid = true;
     return planarNeighbors;
 }
 
 IPvXAddress GPSR::getNextPlanarNeighborCounterClockwise(const IPvXAddress& startNeighborAddress, double startNeighborAngle)
 {
     GPSR_EV << "Finding next planar neighbor (counter clockwise): startAddress = " << startNeighborAddress << ", startAngle = " << startNeighborAngle << endl;
-    IPvXAddress bestNeighborAddress = startNeighborAddress;
-    double bestNeighborAngleDifference = 2 * PI;
-    std::vector<IPvXAddress> neighborAddresses = getPlanarNeighbors();
-    for (std::vector<IPvXAddress>::iterator it = neighborAddresses.begin(); it != neighborAddresses.end(); it++) {
-        const IPvXAddress & neighborAddress = *it;
-        double neighborAngle = getNeighborAngle(neighborAddress);
-        double neighborAngleDifference = neighborAngle - startNeighborAngle;
-        if (neighborAngleDifference < 0)
-            neighborAngleDifference += 2 * PI;
-        GPSR_EV << "Trying next planar neighbor (counter clockwise): address = " << neighborAddress << ", angle = " << neighborAngle << endl;
-        if (neighborAngleDifference != 0 && neighborAngleDifference < bestNeighborAngleDifference) {
-            bestNeighborAngleDifference = neighborAngleDifference;
-            bestNeighborAddress = neighborAddress;
-        }
+    const std::vector<NeighborEntry> & neighborEntries = getPlanarNeighbors();
+    if (neighborEntries.empty() || isNaN(startNeighborAngle))
+        return startNeighborAddress;
+    // the neighbor with the smallest angle greater than the start angle, or wrapping around, the one with the smallest angle
+    std::vector<NeighborEntry>::const_iterator it = std::upper_bound(neighborEntries.begin(), neighborEntries.end(), NeighborEntry(IPvXAddress(), Coord(), startNeighborAngle));
+    if (it == neighborEntries.end()) {
+        it = neighborEntries.begin();
+        if (it->angle == startNeighborAngle)
+            return startNeighborAddress;
     }
-    return bestNeighborAddress;
+    GPSR_EV << "Found next planar neighbor (counter clockwise): address = " << it->address << ", angle = " << it->angle << endl;
+    return it->address;
 }
 
 //
@@ -474,14 +499,12 @@ IPvXAddress GPSR::findGreedyRoutingNextHop(IPv4Datagram * datagram, const IPvXAd
     Coord destinationPosition = packet->getDestinationPosition();
     double bestDistance = (destinationPosition - selfPosition).length();
     IPvXAddress bestNeighbor;
-    std::vector<IPvXAddress> neighborAddresses = neighborPositionTable.getAddresses();
-    for (std::vector<IPvXAddress>::iterator it = neighborAddresses.begin(); it != neighborAddresses.end(); it++) {
-        const IPvXAddress & neighborAddress = *it;
-        Coord neighborPosition = neighborPositionTable.getPosition(neighborAddress);
-        double neighborDistance = (destinationPosition - neighborPosition).length();
+    const std::vector<NeighborEntry> & neighborEntries = getNeighbors();
+    for (std::vector<NeighborEntry>::const_iterator it = neighborEntries.begin(); it != neighborEntries.end(); it++) {
+        double neighborDistance = (destinationPosition - it->position).length();
         if (neighborDistance < bestDistance) {
             bestDistance = neighborDistance;
-            bestNeighbor = neighborAddress.get4();
+            bestNeighbor = it->address.get4();
         }
     }
     if (bestNeighbor.isUnspecified()) {
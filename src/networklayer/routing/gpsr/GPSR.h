@@ -44,7 +44,15 @@
 // KLUDGE: we should rather add these fields as header extensions
 class INET_API GPSR : public cSimpleModule, public ILifecycle, public INotifiable, public INetfilter::IHook
 {
-    private:
+    protected:
+        struct NeighborEntry {
+            IPvXAddress address;
+            Coord position;
+            double angle; // as seen from our position
+            NeighborEntry(const IPvXAddress & address, const Coord & position, double angle) : address(address), position(position), angle(angle) { }
+            bool operator<(const NeighborEntry & other) const { return angle < other.angle; }
+        };
+
         // GPSR parameters
         GPSRPlanarizationMode planarizationMode;
         const char * interfaces;
@@ -67,6 +75,14 @@ class INET_API GPSR : public cSimpleModule, public ILifecycle, public INotifiabl
         cMessage * purgeNeighborsTimer;
         PositionTable neighborPositionTable;
 
+        // neighbor cache: rebuilt when the neighbor position table or our position changes
+        bool neighborCacheValid;
+        bool planarNeighborsValid;
+        unsigned int neighborCacheVersion; // of the neighbor position table
+        Coord neighborCacheSelfPosition;
+        std::vector<NeighborEntry> neighbors; // all neighbors in address order
+        std::vector<NeighborEntry> planarNeighbors; // planarized neighbor set sorted by angle
+
     public:
         GPSR();
         virtual ~GPSR();
@@ -77,7 +93,6 @@ class INET_API GPSR : public cSimpleModule, public ILifecycle, public INotifiabl
         void initialize(int stage);
         void handleMessage(cMessage * message);
 
-    private:
         // handling messages
         void processSelfMessage(cMessage * message);
         void processMessage(cMessage * message);
@@ -125,7 +140,9 @@ class INET_API GPSR : public cSimpleModule, public ILifecycle, public INotifiabl
         // neighbor
         simtime_t getNextNeighborExpiration();
         void purgeNeighbors();
-        std::vector<IPvXAddress> getPlanarNeighbors();
+        void updateNeighborCache();
+        const std::vector<NeighborEntry> & getNeighbors();
+        const std::vector<NeighborEntry> & getPlanarNeighbors();
         IPvXAddress getNextPlanarNeighborCounterClockwise(const IPvXAddress & startNeighborAddress, double startNeighborAngle);
 
         // next hop
@@ -42,23 +42,40 @@ Coord PositionTable::getPosition(const IPvXAddress & address) const {
 
 void PositionTable::setPosition(const IPvXAddress & address, const Coord & coord) {
     ASSERT(!address.isUnspecified());
-    addressToPositionMap[address] = AddressToPositionMapValue(simTime(), coord);
+    AddressToPositionMap::iterator it = addressToPositionMap.find(address);
+    if (it == addressToPositionMap.end())
+        addressToPositionMap[address] = AddressToPositionMapValue(simTime(), coord);
+    else {
+        const Coord & oldCoord = it->second.second;
+        if (oldCoord.x == coord.x && oldCoord.y == coord.y && oldCoord.z == coord.z) {
+            // refreshing the timestamp only does not change the version
+            it->second.first = simTime();
+            return;
+        }
+        it->second = AddressToPositionMapValue(simTime(), coord);
+    }
+    version++;
 }
 
 void PositionTable::removePosition(const IPvXAddress & address) {
     AddressToPositionMap::iterator it = addressToPositionMap.find(address);
     addressToPositionMap.erase(it);
+    version++;
 }
 
 void PositionTable::removeOldPositions(simtime_t timestamp) {
     for (AddressToPositionMap::iterator it = addressToPositionMap.begin(); it != addressToPositionMap.end();)
-        if (it->second.first <= timestamp)
+        if (it->second.first <= timestamp) {
             addressToPositionMap.erase(it++);
+            version++;
+        }
         else
             it++;
 }
 
 void PositionTable::clear() {
+    if (!addressToPositionMap.empty())
+        version++;
     addressToPositionMap.clear();
 }
 
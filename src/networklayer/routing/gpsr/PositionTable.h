@@ -33,9 +33,10 @@ class INET_API PositionTable {
         typedef std::pair<simtime_t, Coord> AddressToPositionMapValue;
         typedef std::map<IPvXAddress, AddressToPositionMapValue> AddressToPositionMap;
         AddressToPositionMap addressToPositionMap;
+        unsigned int version;
 
     public:
-        PositionTable() { }
+        PositionTable() : version(0) { }
 
         std::vector<IPvXAddress> getAddresses() const;
 
@@ -49,6 +50,13 @@ class INET_API PositionTable {
         void clear();
 
         simtime_t getOldestPosition() const;
+
+        /**
+         * Returns a number that changes whenever an address is added or removed,
+         * or a position changes, so that users can tell if their cached data is
+         * up to date.
+         */
+        unsigned int getVersion() const { return version; }
 };
 
 #endif
@@ -135,6 +135,7 @@ RIPRouting::RIPRouting()
     triggeredUpdateTimer = NULL;
     startupTimer = NULL;
     shutdownTimer = NULL;
+    numUnindexedRoutes = 0;
     isOperational = false;
 }
 
@@ -261,6 +262,7 @@ RIPRoute* RIPRouting::importRoute(IPv4Route *route, RIPRoute::RouteType type, in
     }
 
     ripRoutes.push_back(ripRoute);
+    indexRoute(ripRoute);
     emit(numRoutesSignal, ripRoutes.size());
     return ripRoute;
 }
@@ -386,8 +388,10 @@ void RIPRouting::receiveChangeNotification(int signalID, const cObject *obj)
                                route->getNetmask() != IPv4Address::makeNetmask(ripRoute->getPrefixLength()) ||
                                route->getGateway() != ripRoute->getNextHop().get4() ||
                                route->getInterface() != ripRoute->getInterface();
+                unindexRoute(ripRoute);
                 ripRoute->setDestination(route->getDestination());
                 ripRoute->setPrefixLength(route->getNetmask().getNetmaskLength());
+                indexRoute(ripRoute);
                 ripRoute->setNextHop(route->getGateway());
                 ripRoute->setInterface(route->getInterface());
                 if (changed)
@@ -417,11 +421,15 @@ bool RIPRouting::handleOperationStage(LifecycleOperation *operation, int stage,
     else if (dynamic_cast<NodeShutdownOperation *>(operation)) {
         if (stage == NodeShutdownOperation::STAGE_ROUTING_PROTOCOLS) {
             // invalidate routes
+            rt->beginRouteChanges();
             for (RouteVector::iterator it = ripRoutes.begin(); it != ripRoutes.end(); ++it)
                 invalidateRoute(*it);
+            rt->commitRouteChanges();
             // send updates to neighbors
+            RouteVector routes;
+            collectRoutes(routes, false);
             for (InterfaceVector::iterator it = ripInterfaces.begin(); it != ripInterfaces.end(); ++it)
-                sendRoutes(IPv4Address::ALL_RIP_ROUTERS_MCAST, ripUdpPort, *it, false);
+                sendRoutes(IPv4Address::ALL_RIP_ROUTERS_MCAST, ripUdpPort, *it, routes);
 
             stopRIPRouting();
 
@@ -499,7 +507,11 @@ void RIPRouting::stopRIPRouting()
     cancelEvent(triggeredUpdateTimer);
 
     // clear data
+    for (RouteVector::iterator it = ripRoutes.begin(); it != ripRoutes.end(); ++it)
+        delete *it;
     ripRoutes.clear();
+    ripRouteIndex.clear();
+    numUnindexedRoutes = 0;
     ripInterfaces.clear();
 }
 
@@ -557,6 +569,9 @@ void RIPRouting::handleMessage(cMessage *msg)
 /**
  * This method called when a triggered or regular update timer expired.
  * It either sends the changed/all routes to neighbors.
+ *
+ * The routes are collected once, and sent on each interface with
+ * the split horizon processing of that interface.
  */
 void RIPRouting::processUpdate(bool triggered)
 {
@@ -565,13 +580,23 @@ void RIPRouting::processUpdate(bool triggered)
     else
         RIP_EV << "sending regular updates on all interfaces\n";
 
+    expireRoutes();
+
+    RouteVector routes;
+    collectRoutes(routes, triggered);
     for (InterfaceVector::iterator it = ripInterfaces.begin(); it != ripInterfaces.end(); ++it)
         if (it->mode != NO_RIP)
-            sendRoutes(IPv4Address::ALL_RIP_ROUTERS_MCAST, ripUdpPort, *it, triggered);
+            sendRoutes(IPv4Address::ALL_RIP_ROUTERS_MCAST, ripUdpPort, *it, routes);
 
     // clear changed flags
     for (RouteVector::iterator it = ripRoutes.begin(); it != ripRoutes.end(); ++it)
         (*it)->setChanged(false);
+
+    // all changes have been sent, so a pending triggered update is not needed
+    // (RFC 2453 3.10.1); after a triggered update, the next one is damped
+    cancelEvent(triggeredUpdateTimer);
+    if (triggered)
+        triggeredUpdateDampingEnd = simTime() + par("triggeredUpdateDelay").doubleValue();
 }
 
 /**
@@ -650,13 +675,36 @@ void RIPRouting::processRequest(RIPPacket *packet)
 
 /**
  * Send all or changed part of the routing table to address/port on the specified interface.
- * This method is called by regular updates (every 30s), triggered updates (when some route changed),
- * and when RIP requests are processed.
+ * This method is called when RIP requests are processed.
  */
 void RIPRouting::sendRoutes(const IPvXAddress &address, int port, const RIPInterfaceEntry &ripInterface, bool changedOnly)
 {
     RIP_DEBUG << "Sending " << (changedOnly ? "changed" : "all") << " routes on " << ripInterface.ie->getFullName() << std::endl;
 
+    expireRoutes();
+
+    RouteVector routes;
+    collectRoutes(routes, changedOnly);
+    sendRoutes(address, port, ripInterface, routes);
+}
+
+/**
+ * Collects all or the changed routes for sending them in an update.
+ */
+void RIPRouting::collectRoutes(RouteVector &routes, bool changedOnly)
+{
+    routes.reserve(ripRoutes.size());
+    for (RouteVector::iterator it = ripRoutes.begin(); it != ripRoutes.end(); ++it)
+        if (!changedOnly || (*it)->isChanged())
+            routes.push_back(*it);
+}
+
+/**
+ * Sends the routes to address/port on the specified interface, applying
+ * the split horizon processing of the interface.
+ */
+void RIPRouting::sendRoutes(const IPvXAddress &address, int port, const RIPInterfaceEntry &ripInterface, const RouteVector &routes)
+{
     int maxEntries = mode == RIPv2 ? 25 : (ripInterface.ie->getMTU() - 40/*IPv6_HEADER_BYTES*/ - UDP_HEADER_BYTES - RIP_HEADER_SIZE) / RIP_RTE_SIZE;
 
     RIPPacket *packet = new RIPPacket("RIP response");
@@ -664,14 +712,9 @@ void RIPRouting::sendRoutes(const IPvXAddress &address, int port, const RIPInter
     packet->setEntryArraySize(maxEntries);
     int k = 0; // index into RIP entries
 
-    for (RouteVector::iterator it = ripRoutes.begin(); it != ripRoutes.end(); ++it)
+    for (RouteVector::const_iterator it = routes.begin(); it != routes.end(); ++it)
     {
-        RIPRoute *ripRoute = checkRouteIsExpired(*it);
-        if (!ripRoute)
-            continue;
-
-        if (changedOnly && !ripRoute->isChanged())
-            continue;
+        RIPRoute *ripRoute = *it;
 
         // Split Horizon check:
         //   Omit routes learned from one neighbor in updates sent to that neighbor.
@@ -779,6 +822,7 @@ void RIPRouting::processResponse(RIPPacket *packet)
 
     RIP_EV << "response received from " << srcAddr << "\n";
     int numEntries = packet->getEntryArraySize();
+    rt->beginRouteChanges();
     for (int i = 0; i < numEntries; ++i) {
         RIPEntry &entry = packet->getEntry(i);
         int metric = std::min((int)entry.metric + incomingIe->metric, RIP_INFINITE_METRIC);
@@ -804,6 +848,7 @@ void RIPRouting::processResponse(RIPPacket *packet)
                 addRoute(entry.address, entry.prefixLength, incomingIe->ie, nextHop, metric, entry.routeTag, srcAddr);
         }
     }
+    rt->commitRouteChanges();
 
     delete packet;
 }
@@ -915,6 +960,7 @@ void RIPRouting::addRoute(const IPvXAddress &dest, int prefixLength, const Inter
     ripRoute->setLastUpdateTime(simTime());
     ripRoute->setChanged(true);
     ripRoutes.push_back(ripRoute);
+    indexRoute(ripRoute);
     emit(numRoutesSignal, ripRoutes.size());
     triggerUpdate();
 }
@@ -984,15 +1030,19 @@ void RIPRouting::updateRoute(RIPRoute *ripRoute, const InterfaceEntry *ie, const
 }
 
 /**
- * Sets the update timer to trigger an update in the [1s,5s] interval.
- * If the update is already scheduled, it does nothing.
+ * Schedules a triggered update. If the update is already scheduled, it does
+ * nothing, so the changes until the update are coalesced into it.
+ *
+ * RFC 2453 3.10.1: after a triggered update is sent, the next one is delayed
+ * by a random 1-5s interval (triggeredUpdateDelay), so if the interval has not
+ * elapsed yet, the update is scheduled to its end, otherwise it is sent after
+ * the current event.
  */
 void RIPRouting::triggerUpdate()
 {
     if (!triggeredUpdateTimer->isScheduled())
     {
-        double delay = par("triggeredUpdateDelay");
-        simtime_t updateTime = simTime() + delay;
+        simtime_t updateTime = std::max(simTime(), triggeredUpdateDampingEnd);
         // Triggered updates may be suppressed if a regular
         // update is due by the time the triggered update would be sent.
         if (!updateTimer->isScheduled() || updateTimer->getArrivalTime() > updateTime)
@@ -1001,26 +1051,41 @@ void RIPRouting::triggerUpdate()
 }
 
 /**
- * Should be called regularly to handle expiry and purge of routes.
- * If the route is valid, then returns it, otherwise returns NULL.
+ * Should be called before sending routes to handle expiry and purge of routes.
+ * Learned routes not updated for routeExpiryTime are invalidated, so they are
+ * advertised with infinite metric, and they are purged after routePurgeTime.
+ * The purged routes are removed from ripRoutes in one pass.
  */
-RIPRoute *RIPRouting::checkRouteIsExpired(RIPRoute *route)
+void RIPRouting::expireRoutes()
 {
-    if (route->getType() == RIPRoute::RIP_ROUTE_RTE)
+    simtime_t now = simTime();
+    RouteVector purgedRoutes;
+
+    rt->beginRouteChanges();
+    RouteVector::iterator dest = ripRoutes.begin();
+    for (RouteVector::iterator it = ripRoutes.begin(); it != ripRoutes.end(); ++it)
     {
-        simtime_t now = simTime();
-        if (now >= route->getLastUpdateTime() + routeExpiryTime + routePurgeTime)
-        {
-            purgeRoute(route);
-            return NULL;
-        }
-        if (now >= route->getLastUpdateTime() + routeExpiryTime)
+        RIPRoute *ripRoute = *it;
+        if (ripRoute->getType() == RIPRoute::RIP_ROUTE_RTE)
         {
-            invalidateRoute(route);
-            return NULL;
+            if (now >= ripRoute->getLastUpdateTime() + routeExpiryTime + routePurgeTime)
+            {
+                purgedRoutes.push_back(ripRoute);
+                continue;
+            }
+            if (now >= ripRoute->getLastUpdateTime() + routeExpiryTime && ripRoute->getMetric() != RIP_INFINITE_METRIC)
+                invalidateRoute(ripRoute);
         }
+        *dest++ = ripRoute;
     }
-    return route;
+    ripRoutes.erase(dest, ripRoutes.end());
+
+    for (RouteVector::iterator it = purgedRoutes.begin(); it != purgedRoutes.end(); ++it)
+        purgeRoute(*it);
+    rt->commitRouteChanges();
+
+    if (!purgedRoutes.empty())
+        emit(numRoutesSignal, ripRoutes.size());
 }
 
 /*
@@ -1048,7 +1113,8 @@ void RIPRouting::invalidateRoute(RIPRoute *ripRoute)
 }
 
 /**
- * Removes the route from the routing table.
+ * Removes the route from the routing table, and deletes it.
+ * The caller must have removed it from ripRoutes.
  */
 void RIPRouting::purgeRoute(RIPRoute *ripRoute)
 {
@@ -1061,12 +1127,8 @@ void RIPRouting::purgeRoute(RIPRoute *ripRoute)
         deleteRoute(route);
     }
 
-    RouteVector::iterator end = std::remove(ripRoutes.begin(), ripRoutes.end(), ripRoute);
-    if (end != ripRoutes.end())
-        ripRoutes.erase(end, ripRoutes.end());
+    unindexRoute(ripRoute);
     delete ripRoute;
-
-    emit(numRoutesSignal, ripRoutes.size());
 }
 
 /**
@@ -1107,10 +1169,8 @@ RIPInterfaceEntry *RIPRouting::findInterfaceById(int interfaceId)
 
 RIPRoute *RIPRouting::findRoute(const IPvXAddress &destination, int prefixLength)
 {
-    for (RouteVector::iterator it = ripRoutes.begin(); it != ripRoutes.end(); ++it)
-        if ((*it)->getDestination() == destination && (*it)->getPrefixLength() == prefixLength)
-            return *it;
-    return NULL;
+    RouteIndex::iterator it = ripRouteIndex.find(RouteKey(destination, prefixLength));
+    return it != ripRouteIndex.end() ? it->second : NULL;
 }
 
 RIPRoute *RIPRouting::findRoute(const IPvXAddress &destination, int prefixLength, RIPRoute::RouteType type)
@@ -1137,6 +1197,45 @@ RIPRoute *RIPRouting::findRoute(const InterfaceEntry *ie, RIPRoute::RouteType ty
     return NULL;
 }
 
+/**
+ * Adds the route to ripRouteIndex, unless an other route is indexed with
+ * the same destination and prefix length.
+ */
+void RIPRouting::indexRoute(RIPRoute *ripRoute)
+{
+    std::pair<RouteIndex::iterator, bool> result = ripRouteIndex.insert(std::make_pair(RouteKey(ripRoute->getDestination(), ripRoute->getPrefixLength()), ripRoute));
+    if (!result.second)
+        numUnindexedRoutes++;
+}
+
+/**
+ * Removes the route from ripRouteIndex. If it was indexed, then an other
+ * route with the same key is indexed in its place.
+ */
+void RIPRouting::unindexRoute(RIPRoute *ripRoute)
+{
+    RouteKey key(ripRoute->getDestination(), ripRoute->getPrefixLength());
+    RouteIndex::iterator it = ripRouteIndex.find(key);
+    if (it == ripRouteIndex.end() || it->second != ripRoute)
+    {
+        numUnindexedRoutes--;
+        return;
+    }
+    ripRouteIndex.erase(it);
+    if (numUnindexedRoutes > 0)
+    {
+        for (RouteVector::iterator it = ripRoutes.begin(); it != ripRoutes.end(); ++it)
+        {
+            if (*it != ripRoute && (*it)->getDestination() == ripRoute->getDestination() && (*it)->getPrefixLength() == key.prefixLength)
+            {
+                ripRouteIndex[key] = *it;
+                numUnindexedRoutes--;
+                break;
+            }
+        }
+    }
+}
+
 void RIPRouting::addInterface(const InterfaceEntry *ie, cXMLElement *config)
 {
     RIPInterfaceEntry ripInterface(ie);
@@ -1160,7 +1259,10 @@ void RIPRouting::deleteInterface(const InterfaceEntry *ie)
     {
         if ((*it)->getInterface() == ie)
         {
+            RIPRoute *ripRoute = *it;
             it = ripRoutes.erase(it);
+            unindexRoute(ripRoute);
+            delete ripRoute;
             emitNumRoutesSignal = true;
         }
         else
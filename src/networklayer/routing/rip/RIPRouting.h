@@ -24,6 +24,7 @@
 #include "IInterfaceTable.h"
 #include "ILifecycle.h"
 #include "UDPSocket.h"
+#include "OpenHashMap.h"
 
 #define RIP_INFINITE_METRIC 16
 
@@ -129,12 +130,32 @@ struct RIPInterfaceEntry
  *
  * 2. There is no merging of subnet routes. RFC 2453 3.7 suggests that subnetted network routes should
  *    not be advertised outside the subnetted network.
+ *
+ * The routes are indexed by destination and prefix length, so the entries of
+ * received responses are looked up in constant time. Triggered updates are
+ * damped as described in RFC 2453 3.10.1: after a triggered update, further
+ * changes are collected for a random 1-5s interval (triggeredUpdateDelay),
+ * and sent in a single triggered update. The routes of an update are collected
+ * once, and only the split horizon processing is done per interface.
  */
 class INET_API RIPRouting : public cSimpleModule, public INotifiable, public ILifecycle
 {
     enum Mode { RIPv2, RIPng };
     typedef std::vector<RIPInterfaceEntry> InterfaceVector;
     typedef std::vector<RIPRoute*> RouteVector;
+    struct RouteKey
+    {
+        uint32 dest;
+        int prefixLength;
+        RouteKey() : dest(0), prefixLength(0) {}
+        RouteKey(const IPvXAddress& dest, int prefixLength) : dest(dest.get4().getInt()), prefixLength(prefixLength) {}
+        bool operator==(const RouteKey& other) const { return dest == other.dest && prefixLength == other.prefixLength; }
+    };
+    struct RouteKeyHash
+    {
+        size_t operator()(const RouteKey& key) const { return hashCombine(hashUInt32(key.dest), key.prefixLength); }
+    };
+    typedef OpenHashMap<RouteKey, RIPRoute*, RouteKeyHash> RouteIndex;
     // environment
     cModule *host;                  // the host module that owns this module
     IInterfaceTable *ift;           // interface table of the host
@@ -142,9 +163,12 @@ class INET_API RIPRouting : public cSimpleModule, public INotifiable, public ILi
     // state
     InterfaceVector ripInterfaces;  // interfaces on which RIP is used
     RouteVector ripRoutes;          // all advertised routes (imported or learned)
+    RouteIndex ripRouteIndex;       // index of ripRoutes by destination and prefix length; holds the first of the routes with the same key
+    int numUnindexedRoutes;         // number of routes not in ripRouteIndex, because an other route has the same key
     UDPSocket socket;               // bound to the RIP port (see udpPort parameter)
     cMessage *updateTimer;          // for sending unsolicited Response messages in every ~30 seconds.
     cMessage *triggeredUpdateTimer; // scheduled when there are pending changes
+    simtime_t triggeredUpdateDampingEnd; // no triggered update is sent before this time
     cMessage *startupTimer;         // timer for delayed startup
     cMessage *shutdownTimer;        // scheduled at shutdown
     // parameters
@@ -171,6 +195,8 @@ class INET_API RIPRouting : public cSimpleModule, public INotifiable, public ILi
     RIPRoute *findRoute(const IPvXAddress &destination, int prefixLength, RIPRoute::RouteType type);
     RIPRoute *findRoute(const IPv4Route *route);
     RIPRoute *findRoute(const InterfaceEntry *ie, RIPRoute::RouteType type);
+    void indexRoute(RIPRoute *ripRoute);
+    void unindexRoute(RIPRoute *ripRoute);
     void addInterface(const InterfaceEntry *ie, cXMLElement *config);
     void deleteInterface(const InterfaceEntry *ie);
     void invalidateRoutes(const InterfaceEntry *ie);
@@ -199,6 +225,8 @@ class INET_API RIPRouting : public cSimpleModule, public INotifiable, public ILi
     virtual void processRequest(RIPPacket *packet);
     virtual void processUpdate(bool triggered);
     virtual void sendRoutes(const IPvXAddress &address, int port, const RIPInterfaceEntry &ripInterface, bool changedOnly);
+    virtual void collectRoutes(RouteVector &routes, bool changedOnly);
+    virtual void sendRoutes(const IPvXAddress &address, int port, const RIPInterfaceEntry &ripInterface, const RouteVector &routes);
 
     virtual void processResponse(RIPPacket *packet);
     virtual bool isValidResponse(RIPPacket *packet);
@@ -206,7 +234,7 @@ class INET_API RIPRouting : public cSimpleModule, public INotifiable, public ILi
     virtual void updateRoute(RIPRoute *route, const InterfaceEntry *ie, const IPvXAddress &nextHop, int metric, uint16 routeTag, const IPvXAddress &from);
 
     virtual void triggerUpdate();
-    virtual RIPRoute *checkRouteIsExpired(RIPRoute *route);
+    virtual void expireRoutes();
     virtual void invalidateRoute(RIPRoute *route);
     virtual void purgeRoute(RIPRoute *route);
 
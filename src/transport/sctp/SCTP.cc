@@ -39,6 +39,21 @@ bool SCTP::logverbose;
 
 int32 SCTP::nextAssocId = 0;
 
+static size_t hashAddress(const IPvXAddress& addr)
+{
+    const uint32 *w = addr.words();
+    size_t h = hashUInt32(w[0]);
+    if (addr.isIPv6())
+        h = hashCombine(hashCombine(hashCombine(h, hashUInt32(w[1])), hashUInt32(w[2])), hashUInt32(w[3]));
+    return h;
+}
+
+size_t SCTP::SockPairHash::operator()(const SockPair& key) const
+{
+    size_t h = hashCombine(hashUInt32(key.localPort), hashUInt32(key.remotePort));
+    return hashCombine(hashCombine(h, hashAddress(key.localAddr)), hashAddress(key.remoteAddr));
+}
+
 
 void SCTP::printInfoAssocMap()
 {
@@ -166,7 +181,6 @@ void SCTP::handleMessage(cMessage *msg)
     else if (msg->arrivedOn("from_ip") || msg->arrivedOn("from_ipv6"))
     {
         sctpEV3<<"Message from IP\n";
-        printInfoAssocMap();
         if (!dynamic_cast<SCTPMessage *>(msg))
         {
             sctpEV3<<"no sctp message, delete it\n";
@@ -499,7 +513,6 @@ SCTPAssociation *SCTP::findAssocForMessage(IPvXAddress srcAddr, IPvXAddress dest
     key.remotePort = srcPort;
     SockPair save = key;
     sctpEV3<<"findAssocForMessage: srcAddr="<<destAddr<<" destAddr="<<srcAddr<<" srcPort="<<destPort<<"  destPort="<<srcPort<<"\n";
-    printInfoAssocMap();
 
     // try with fully qualified SockPair
     SctpAssocMap::iterator i;
@@ -574,23 +587,45 @@ void SCTP::updateSockPair(SCTPAssociation *assoc, IPvXAddress localAddr, IPvXAdd
     key.localPort = assoc->localPort = localPort;
     key.remotePort = assoc->remotePort = remotePort;
 
-    for (SctpAssocMap::iterator i=sctpAssocMap.begin(); i!=sctpAssocMap.end(); i++)
-    {
-        if (i->second == assoc)
-        {
-            sctpAssocMap.erase(i);
-            break;
-        }
-    }
+    // remove the assoc's first entry (there is only one before the
+    // association is established, e.g. a listening socket's)
+    SctpAssocKeyMap::iterator k = sctpAssocKeyMap.find(assoc);
+    if (k!=sctpAssocKeyMap.end() && !k->second.empty())
+        eraseAssocKey(sctpAssocMap.find(*k->second.begin()));
 
     sctpEV3<<"updateSockPair assoc="<<assoc<<"    localAddr="<<key.localAddr<<"            remoteAddr="<<key.remoteAddr<<"     localPort="<<key.localPort<<"  remotePort="<<remotePort<<"\n";
 
-    sctpAssocMap[key] = assoc;
+    insertAssocKey(key, assoc);
     sizeAssocMap = sctpAssocMap.size();
     sctpEV3<<"assoc inserted in sctpAssocMap\n";
     printInfoAssocMap();
 }
 
+void SCTP::insertAssocKey(const SockPair& key, SCTPAssociation *assoc)
+{
+    SctpAssocMap::iterator i = sctpAssocMap.find(key);
+    if (i!=sctpAssocMap.end())
+    {
+        if (i->second==assoc)
+            return;
+        eraseAssocKey(i);
+    }
+    sctpAssocMap[key] = assoc;
+    sctpAssocKeyMap[assoc].insert(key);
+}
+
+void SCTP::eraseAssocKey(SctpAssocMap::iterator i)
+{
+    SctpAssocKeyMap::iterator k = sctpAssocKeyMap.find(i->second);
+    if (k!=sctpAssocKeyMap.end())
+    {
+        k->second.erase(i->first);
+        if (k->second.empty())
+            sctpAssocKeyMap.erase(k);
+    }
+    sctpAssocMap.erase(i);
+}
+
 void SCTP::addLocalAddress(SCTPAssociation *assoc, IPvXAddress address)
 {
 
@@ -607,14 +642,14 @@ void SCTP::addLocalAddress(SCTPAssociation *assoc, IPvXAddress address)
             ASSERT(i->second==assoc);
             if (key.localAddr.isUnspecified())
             {
-                sctpAssocMap.erase(i);
+                eraseAssocKey(i);
                 sizeAssocMap--;
             }
         }
         else
             sctpEV3<<"no actual sockPair found\n";
         key.localAddr = address;
-        sctpAssocMap[key] = assoc;
+        insertAssocKey(key, assoc);
         sizeAssocMap = sctpAssocMap.size();
         sctpEV3<<"addLocalAddress " << address << " number of connections now="<<sizeAssocMap<<"\n";
 
@@ -640,7 +675,7 @@ void SCTP::addLocalAddressToAllRemoteAddresses(SCTPAssociation *assoc, IPvXAddre
             ASSERT(j->second==assoc);
             if (key.localAddr.isUnspecified())
                     {
-                    sctpAssocMap.erase(j);
+                    eraseAssocKey(j);
                     sizeAssocMap--;
                 }
 
@@ -648,7 +683,7 @@ void SCTP::addLocalAddressToAllRemoteAddresses(SCTPAssociation *assoc, IPvXAddre
             else
                 sctpEV3<<"no actual sockPair found\n";
             key.localAddr = address;
-            sctpAssocMap[key] = assoc;
+            insertAssocKey(key, assoc);
 
             sizeAssocMap++;
             sctpEV3<<"number of connections="<<sctpAssocMap.size()<<"\n";
@@ -673,7 +708,7 @@ void SCTP::removeLocalAddressFromAllRemoteAddresses(SCTPAssociation *assoc, IPvX
             if (j!=sctpAssocMap.end())
             {
                 ASSERT(j->second==assoc);
-                sctpAssocMap.erase(j);
+                eraseAssocKey(j);
                 sizeAssocMap--;
             }
             else
@@ -699,7 +734,7 @@ void SCTP::removeRemoteAddressFromAllAssociations(SCTPAssociation *assoc, IPvXAd
             if (j!=sctpAssocMap.end())
             {
                 ASSERT(j->second==assoc);
-                sctpAssocMap.erase(j);
+                eraseAssocKey(j);
                 sizeAssocMap--;
             }
             else
@@ -728,7 +763,7 @@ bool SCTP::addRemoteAddress(SCTPAssociation *assoc, IPvXAddress localAddress, IP
     }
     else
     {
-        sctpAssocMap[key] = assoc;
+        insertAssocKey(key, assoc);
         sizeAssocMap++;
     }
 
@@ -742,9 +777,10 @@ void SCTP::addForkedAssociation(SCTPAssociation *assoc, SCTPAssociation *newAsso
 
     EV<<"addForkedConnection assocId="<<assoc->assocId<<"    newId="<<newAssoc->assocId<<"\n";
 
-    for (SctpAssocMap::iterator j=sctpAssocMap.begin(); j!=sctpAssocMap.end(); ++j)
-        if (assoc->assocId==j->second->assocId)
-            keyAssoc = j->first;
+    // the last key in map order, as the former full scan of sctpAssocMap found
+    SctpAssocKeyMap::iterator k = sctpAssocKeyMap.find(assoc);
+    if (k!=sctpAssocKeyMap.end() && !k->second.empty())
+        keyAssoc = *k->second.rbegin();
     // update assoc's socket pair, and register newAssoc (which'll keep LISTENing)
     updateSockPair(assoc, localAddr, remoteAddr, localPort, remotePort);
     updateSockPair(newAssoc, keyAssoc.localAddr, keyAssoc.remoteAddr, keyAssoc.localPort, keyAssoc.remotePort);
@@ -769,8 +805,6 @@ void SCTP::addForkedAssociation(SCTPAssociation *assoc, SCTPAssociation *newAsso
 
 void SCTP::removeAssociation(SCTPAssociation *assoc)
 {
-    bool            ok = false;
-    bool            find = false;
     const int32 id = assoc->assocId;
 
     sctpEV3 << "Deleting SCTP connection " << assoc << " id= "<< id << endl;
@@ -783,45 +817,27 @@ void SCTP::removeAssociation(SCTPAssociation *assoc)
             assocStatMapIterator->second.lifeTime = assocStatMapIterator->second.stop - assocStatMapIterator->second.start;
             assocStatMapIterator->second.throughput = assocStatMapIterator->second.ackedBytes*8 / assocStatMapIterator->second.lifeTime.dbl();
         }
-        while (!ok) {
-            if (sizeAssocMap == 0) {
-                ok = true;
+        SctpAssocKeyMap::iterator k = sctpAssocKeyMap.find(assoc);
+        if (k != sctpAssocKeyMap.end()) {
+            if (assoc->T1_InitTimer) {
+                assoc->stopTimer(assoc->T1_InitTimer);
             }
-            else {
-                for (SctpAssocMap::iterator sctpAssocMapIterator = sctpAssocMap.begin();
-                      sctpAssocMapIterator != sctpAssocMap.end(); sctpAssocMapIterator++) {
-                    if (sctpAssocMapIterator->second != NULL) {
-                        SCTPAssociation* myAssoc = sctpAssocMapIterator->second;
-                        if (myAssoc->assocId == assoc->assocId) {
-                            if (myAssoc->T1_InitTimer) {
-                                myAssoc->stopTimer(myAssoc->T1_InitTimer);
-                            }
-                            if (myAssoc->T2_ShutdownTimer) {
-                                myAssoc->stopTimer(myAssoc->T2_ShutdownTimer);
-                            }
-                            if (myAssoc->T5_ShutdownGuardTimer) {
-                                myAssoc->stopTimer(myAssoc->T5_ShutdownGuardTimer);
-                            }
-                            if (myAssoc->SackTimer) {
-                                myAssoc->stopTimer(myAssoc->SackTimer);
-                            }
-                            if (myAssoc->StartAddIP) {
-                                myAssoc->stopTimer(myAssoc->StartAddIP);
-                            }
-                            sctpAssocMap.erase(sctpAssocMapIterator);
-                            sizeAssocMap--;
-                            find = true;
-                            break;
-                        }
-                    }
-                }
+            if (assoc->T2_ShutdownTimer) {
+                assoc->stopTimer(assoc->T2_ShutdownTimer);
             }
-
-            if (!find) {
-                ok = true;
+            if (assoc->T5_ShutdownGuardTimer) {
+                assoc->stopTimer(assoc->T5_ShutdownGuardTimer);
+            }
+            if (assoc->SackTimer) {
+                assoc->stopTimer(assoc->SackTimer);
             }
-            else {
-                find = false;
+            if (assoc->StartAddIP) {
+                assoc->stopTimer(assoc->StartAddIP);
+            }
+            const std::set<SockPair> keys = k->second;
+            for (std::set<SockPair>::const_iterator key = keys.begin(); key != keys.end(); ++key) {
+                eraseAssocKey(sctpAssocMap.find(*key));
+                sizeAssocMap--;
             }
         }
     }
@@ -899,10 +915,15 @@ SCTPAssociation* SCTP::getAssoc(int32 assocId)
 
 void SCTP::finish()
 {
-    SctpAssocMap::iterator assocMapIterator = sctpAssocMap.begin();
-    while (assocMapIterator != sctpAssocMap.end()) {
-        removeAssociation(assocMapIterator->second);
-        assocMapIterator = sctpAssocMap.begin();
+    // remove the associations in the order of their socket pairs; removing
+    // one also removes the other socket pairs it is entered under
+    std::set<SockPair> keys;
+    for (SctpAssocMap::iterator i = sctpAssocMap.begin(); i != sctpAssocMap.end(); ++i)
+        keys.insert(i->first);
+    for (std::set<SockPair>::iterator key = keys.begin(); key != keys.end(); ++key) {
+        SctpAssocMap::iterator i = sctpAssocMap.find(*key);
+        if (i != sctpAssocMap.end())
+            removeAssociation(i->second);
     }
     EV << getFullPath() << ": finishing SCTP with "
         << sctpAssocMap.size() << " connections open." << endl;
@@ -24,10 +24,12 @@
 #endif
 
 #include <map>
+#include <set>
 
 #include "INETDefs.h"
 
 #include "IPvXAddress.h"
+#include "OpenHashMap.h"
 #include "UDPSocket.h"
 
 #define SCTP_UDP_PORT  9899
@@ -119,6 +121,14 @@ class INET_API SCTP : public cSimpleModule
                 else
                     return localPort<b.localPort;
             }
+            inline bool operator==(const SockPair& b) const
+            {
+                return remoteAddr==b.remoteAddr && localAddr==b.localAddr && remotePort==b.remotePort && localPort==b.localPort;
+            }
+        };
+        struct SockPairHash
+        {
+            size_t operator()(const SockPair& key) const;
         };
         struct VTagPair
         {
@@ -172,12 +182,17 @@ class INET_API SCTP : public cSimpleModule
 
 
         typedef std::map<AppAssocKey,SCTPAssociation*> SctpAppAssocMap;
-        typedef std::map<SockPair,SCTPAssociation*> SctpAssocMap;
+        typedef OpenHashMap<SockPair,SCTPAssociation*,SockPairHash> SctpAssocMap;
 
         SctpAppAssocMap sctpAppAssocMap;
         SctpAssocMap sctpAssocMap;
         std::list<SCTPAssociation*>assocList;
 
+        // Keys under which each association is entered in sctpAssocMap (one
+        // per address pair), so its entries can be found without a full scan
+        typedef std::map<SCTPAssociation*, std::set<SockPair> > SctpAssocKeyMap;
+        SctpAssocKeyMap sctpAssocKeyMap;
+
         UDPSocket udpSocket;
 
     protected:
@@ -192,6 +207,10 @@ class INET_API SCTP : public cSimpleModule
         void sendShutdownCompleteFromMain(SCTPMessage* sctpmsg, IPvXAddress srcAddr, IPvXAddress destAddr);
         void updateDisplayString();
 
+        /** Enters/removes a sctpAssocMap entry, keeping sctpAssocKeyMap in sync */
+        void insertAssocKey(const SockPair& key, SCTPAssociation *assoc);
+        void eraseAssocKey(SctpAssocMap::iterator i);
+
     public:
         static bool testing;         // switches between sctpEV and testingEV
         static bool logverbose;  // if !testing, turns on more verbose logging
@@ -504,11 +504,21 @@ class INET_API SCTPDataVariables : public cObject
     public:
         static const IPvXAddress zeroAddress;
 
+        // ====== Pooled Allocation ===========================================
+        // One object is created per DATA chunk sent or received, so released
+        // objects are kept on a free list and reused.
+        static void* operator new(size_t size);
+        static void operator delete(void* ptr, size_t size);
+        static uint32 getFreeListLength() { return freeListLength; }
+
         // ====== Private Control Information =================================
     private:
         SCTPPathVariables* initialDestination;
         SCTPPathVariables* lastDestination;
         SCTPPathVariables* nextDestination;
+
+        static void*       freeList;
+        static uint32      freeListLength;
 };
 
 
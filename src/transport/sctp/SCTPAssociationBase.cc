@@ -304,6 +304,37 @@ SCTPDataVariables::~SCTPDataVariables()
 {
 }
 
+#define SCTP_DATAVARIABLES_POOL_SIZE    8192
+
+void*  SCTPDataVariables::freeList = NULL;
+uint32 SCTPDataVariables::freeListLength = 0;
+
+void* SCTPDataVariables::operator new(size_t size)
+{
+    // Subclasses have a different size and are not pooled
+    if ((size != sizeof(SCTPDataVariables)) || (freeList == NULL)) {
+        return ::operator new(size);
+    }
+    void* ptr = freeList;
+    freeList = *(void**)ptr;
+    freeListLength--;
+    return ptr;
+}
+
+void SCTPDataVariables::operator delete(void* ptr, size_t size)
+{
+    if (ptr == NULL) {
+        return;
+    }
+    if ((size != sizeof(SCTPDataVariables)) || (freeListLength >= SCTP_DATAVARIABLES_POOL_SIZE)) {
+        ::operator delete(ptr);
+        return;
+    }
+    *(void**)ptr = freeList;
+    freeList = ptr;
+    freeListLength++;
+}
+
 SCTPStateVariables::SCTPStateVariables()
 {
     active = false;
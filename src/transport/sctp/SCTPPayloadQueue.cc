@@ -0,0 +1,133 @@
+//
+// Copyright (C) 2026 OpenSim Ltd
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, see <http://www.gnu.org/licenses/>.
+//
+
+
+#include "SCTPPayloadQueue.h"
+
+#define SCTP_PAYLOADQUEUE_INITIAL_SIZE    16
+
+
+void SCTPPayloadQueue::grow(uint32 minSize)
+{
+    size_t newSize = slots.empty() ? SCTP_PAYLOADQUEUE_INITIAL_SIZE : slots.size();
+    while (newSize < minSize)
+        newSize *= 2;
+    if (newSize == slots.size())
+        return;
+
+    std::vector<SCTPDataVariables *> newSlots(newSize, (SCTPDataVariables *)NULL);
+    for (uint32 i = 0; i < span; i++) {
+        const uint32 tsn = firstTsn + i;
+        SCTPDataVariables *chunk = slot(tsn);
+        if (chunk != NULL)
+            newSlots[tsn & (newSize - 1)] = chunk;
+    }
+    slots.swap(newSlots);
+}
+
+SCTPPayloadQueue::iterator SCTPPayloadQueue::next(uint32 tsn) const
+{
+    if (count == 0)
+        return end();
+
+    // an iterator whose element has been erased may now lie before the window
+    const int32 distance = (int32)(tsn - firstTsn);
+    for (uint32 i = (distance < 0) ? 0 : (uint32)distance + 1; i < span; i++) {
+        SCTPDataVariables *chunk = slot(firstTsn + i);
+        if (chunk != NULL)
+            return iterator(this, firstTsn + i, chunk);
+    }
+    return end();
+}
+
+SCTPPayloadQueue::iterator SCTPPayloadQueue::find(uint32 tsn) const
+{
+    if (inWindow(tsn)) {
+        SCTPDataVariables *chunk = slot(tsn);
+        if (chunk != NULL)
+            return iterator(this, tsn, chunk);
+    }
+    return end();
+}
+
+void SCTPPayloadQueue::insert(uint32 tsn, SCTPDataVariables *chunk)
+{
+    ASSERT(chunk != NULL);
+
+    if (count == 0) {
+        if (slots.empty())
+            grow(1);
+        firstTsn = tsn;
+        span = 1;
+    }
+    else {
+        const int32 distance = (int32)(tsn - firstTsn);
+        if (distance < 0) {
+            const uint32 newSpan = span + (uint32)(-distance);
+            if (newSpan > slots.size())
+                grow(newSpan);
+            firstTsn = tsn;
+            span = newSpan;
+        }
+        else if ((uint32)distance >= span) {
+            const uint32 newSpan = (uint32)distance + 1;
+            if (newSpan > slots.size())
+                grow(newSpan);
+            span = newSpan;
+        }
+    }
+
+    SCTPDataVariables *& s = slot(tsn);
+    if (s == NULL)
+        count++;
+    s = chunk;
+}
+
+size_t SCTPPayloadQueue::erase(uint32 tsn)
+{
+    if (!inWindow(tsn))
+        return 0;
+    SCTPDataVariables *& s = slot(tsn);
+    if (s == NULL)
+        return 0;
+    s = NULL;
+
+    if (--count == 0) {
+        span = 0;
+    }
+    else if (tsn == firstTsn) {
+        while (slot(firstTsn) == NULL) {
+            firstTsn++;
+            span--;
+        }
+    }
+    else if (tsn == firstTsn + span - 1) {
+        while (slot(firstTsn + span - 1) == NULL)
+            span--;
+    }
+    return 1;
+}
+
+void SCTPPayloadQueue::clear()
+{
+    for (uint32 i = 0; i < span; i++)
+        slot(firstTsn + i) = NULL;
+    firstTsn = 0;
+    span = 0;
+    count = 0;
+}
+
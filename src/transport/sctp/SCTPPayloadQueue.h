@@ -0,0 +1,109 @@
+//
+// Copyright (C) 2026 OpenSim Ltd
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, see <http://www.gnu.org/licenses/>.
+//
+
+#ifndef __SCTPPAYLOADQUEUE_H
+#define __SCTPPAYLOADQUEUE_H
+
+#include <vector>
+
+#include "INETDefs.h"
+
+
+class SCTPDataVariables;
+
+
+/**
+ * TSN-indexed container of chunks, used as SCTPQueue::PayloadQueue.
+ *
+ * The TSNs held by a queue always lie within a window (the send and
+ * retransmission queues between the cumulative ack point and the highest
+ * TSN sent, the receive queues within the receiver window), so chunks are
+ * stored in a power-of-2 ring buffer indexed by TSN. find(), insert() and
+ * erase() are O(1); the buffer grows when a TSN falls outside the window.
+ *
+ * The interface is the subset of std::map<uint32, SCTPDataVariables*> used
+ * by the SCTP code, except that iteration follows serial number arithmetic
+ * (RFC 1982), so TSN wrap-around is handled correctly. Iterators refer to a
+ * TSN rather than to a slot: an iterator stays valid (and can be advanced)
+ * after its own element or any other element has been erased.
+ */
+class INET_API SCTPPayloadQueue
+{
+  public:
+    typedef uint32 key_type;
+    typedef SCTPDataVariables *mapped_type;
+    typedef std::pair<uint32, SCTPDataVariables *> value_type;
+
+    class iterator
+    {
+        friend class SCTPPayloadQueue;
+      protected:
+        const SCTPPayloadQueue *queue;
+        value_type value;   // chunk is NULL for end()
+
+        iterator(const SCTPPayloadQueue *queue, uint32 tsn, SCTPDataVariables *chunk) : queue(queue), value(tsn, chunk) {}
+
+      public:
+        iterator() : queue(NULL), value(0, (SCTPDataVariables *)NULL) {}
+        const value_type& operator*() const { return value; }
+        const value_type *operator->() const { return &value; }
+        iterator& operator++() { *this = queue->next(value.first); return *this; }
+        iterator operator++(int) { iterator tmp = *this; ++(*this); return tmp; }
+        bool operator==(const iterator& other) const {
+            return value.second == other.value.second && (value.second == NULL || value.first == other.value.first);
+        }
+        bool operator!=(const iterator& other) const { return !(*this == other); }
+    };
+    typedef iterator const_iterator;
+
+  protected:
+    std::vector<SCTPDataVariables *> slots;   // size is 0 or a power of 2
+    uint32 firstTsn;    // lowest TSN stored (valid if count > 0)
+    uint32 span;        // highest TSN - firstTsn + 1, or 0 if empty
+    uint32 count;       // number of chunks stored
+
+  protected:
+    SCTPDataVariables *& slot(uint32 tsn) { return slots[tsn & (slots.size() - 1)]; }
+    SCTPDataVariables *slot(uint32 tsn) const { return slots[tsn & (slots.size() - 1)]; }
+    bool inWindow(uint32 tsn) const { return count > 0 && (uint32)(tsn - firstTsn) < span; }
+    void grow(uint32 minSize);
+    iterator next(uint32 tsn) const;
+
+  public:
+    SCTPPayloadQueue() : firstTsn(0), span(0), count(0) {}
+
+    bool empty() const { return count == 0; }
+    size_t size() const { return count; }
+
+    iterator begin() const { return count > 0 ? iterator(this, firstTsn, slot(firstTsn)) : end(); }
+    iterator end() const { return iterator(this, 0, NULL); }
+
+    iterator find(uint32 tsn) const;
+
+    /**
+     * Stores the chunk under the given TSN, replacing any chunk already
+     * stored there. The chunk must not be NULL.
+     */
+    void insert(uint32 tsn, SCTPDataVariables *chunk);
+
+    void erase(const iterator& it) { if (it.value.second != NULL) erase(it.value.first); }
+    size_t erase(uint32 tsn);
+    void clear();
+};
+
+#endif
+
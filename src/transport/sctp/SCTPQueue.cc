@@ -46,7 +46,7 @@ bool SCTPQueue::checkAndInsertChunk(const uint32 key, SCTPDataVariables* chunk)
     if (found != payloadQueue.end()) {
         return false;
     }
-    payloadQueue[key] = chunk;
+    payloadQueue.insert(key, chunk);
     return true;
 }
 
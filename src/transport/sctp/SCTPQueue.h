@@ -23,6 +23,7 @@
 
 #include "IPvXAddress.h"
 #include "SCTP.h"
+#include "SCTPPayloadQueue.h"
 
 
 class SCTPDataVariables;
@@ -94,7 +95,7 @@ class INET_API SCTPQueue : public cObject
                                             uint32&            rtxEarliestOutstandingTSN) const;
 
   public:
-     typedef std::map<uint32, SCTPDataVariables*> PayloadQueue;
+     typedef SCTPPayloadQueue PayloadQueue;    // TSN-indexed ring buffer
      PayloadQueue payloadQueue;
 
   protected:
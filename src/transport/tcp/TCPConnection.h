@@ -199,6 +199,8 @@ class INET_API TCPStateVariables : public cObject
     bool delayed_acks_enabled;  // set if delayed ACK algorithm (RFC 1122) is enabled
     bool limited_transmit_enabled; // set if Limited Transmit algorithm (RFC 3042) is enabled
     bool increased_IW_enabled;  // set if Increased Initial Window (RFC 3390) is enabled
+    bool pacing_enabled;        // set if data segments are paced at the rate given by TCPBaseAlg::getPacingRate()
+    uint32 super_segment_size;  // max number of full-sized segments sent as one TCPSegment message (1: off)
 
     uint32 full_sized_segment_counter; // this counter is needed for delayed ACK
     bool ack_now;               // send ACK immediately, needed if delayed_acks_enabled is set
@@ -505,8 +507,12 @@ class INET_API TCPConnection
     /**
      * Utility: sends one segment of 'bytes' bytes from snd_nxt, and advances snd_nxt.
      * sendData(), sendProbe() and retransmitData() internally all rely on this one.
+     *
+     * With segmentCount > 1, up to segmentCount full-sized segments are sent
+     * as a single super-segment message (see TCPSegment's segmentCount field);
+     * it is only split into individual segments where the link layer needs them.
      */
-    virtual void sendSegment(uint32 bytes);
+    virtual void sendSegment(uint32 bytes, uint32 segmentCount = 1);
 
     /** Utility: adds control info to segment and sends it to IP */
     virtual void sendToIP(TCPSegment *tcpseg);
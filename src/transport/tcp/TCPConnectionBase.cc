@@ -64,6 +64,8 @@ TCPStateVariables::TCPStateVariables()
     delayed_acks_enabled = false; // will be set from configureStateVariables()
     limited_transmit_enabled = false; // will be set from configureStateVariables()
     increased_IW_enabled = false; // will be set from configureStateVariables()
+    pacing_enabled = false;     // will be set from configureStateVariables()
+    super_segment_size = 1;     // will be set from configureStateVariables()
     full_sized_segment_counter = 0;
     ack_now = false;
 
@@ -149,6 +151,8 @@ std::string TCPStateVariables::detailedInfo() const
     out << "nagle_enabled=" << nagle_enabled << "\n";
     out << "limited_transmit_enabled=" << limited_transmit_enabled << "\n";
     out << "increased_IW_enabled=" << increased_IW_enabled << "\n";
+    out << "pacing_enabled=" << pacing_enabled << "\n";
+    out << "super_segment_size=" << super_segment_size << "\n";
     out << "delayed_acks_enabled=" << delayed_acks_enabled << "\n";
     out << "ws_support=" << ws_support << "\n";
     out << "ws_enabled=" << ws_enabled << "\n";
@@ -152,6 +152,9 @@ void TCPConnection::printSegmentBrief(TCPSegment *tcpseg)
     {
         tcpEV << "[" << tcpseg->getSequenceNo() << ".." << (tcpseg->getSequenceNo() + tcpseg->getPayloadLength()) << ") ";
         tcpEV << "(l=" << tcpseg->getPayloadLength() << ") ";
+
+        if (tcpseg->getSegmentCount() > 1)
+            tcpEV << "(" << tcpseg->getSegmentCount() << " segments) ";
     }
 
     if (tcpseg->getAckBit())  tcpEV << "ack " << tcpseg->getAckNo() << " ";
@@ -224,7 +227,7 @@ void TCPConnection::sendToIP(TCPSegment *tcpseg)
     tcpseg->setDestPort(remotePort);
     ASSERT(tcpseg->getHeaderLength() >= TCP_HEADER_OCTETS);     // TCP_HEADER_OCTETS = 20 (without options)
     ASSERT(tcpseg->getHeaderLength() <= TCP_MAX_HEADER_OCTETS); // TCP_MAX_HEADER_OCTETS = 60
-    tcpseg->setByteLength(tcpseg->getHeaderLength() + tcpseg->getPayloadLength());
+    tcpseg->setByteLength(tcpseg->getSegmentCount() * tcpseg->getHeaderLength() + tcpseg->getPayloadLength());
     state->sentBytes = tcpseg->getPayloadLength(); // resetting sentBytes to 0 if sending a segment without data (e.g. ACK)
 
     tcpEV << "Sending: ";
@@ -381,21 +384,29 @@ void TCPConnection::configureStateVariables()
     state->nagle_enabled = tcpMain->par("nagleEnabled"); // Nagle's algorithm (RFC 896) enabled/disabled
     state->limited_transmit_enabled = tcpMain->par("limitedTransmitEnabled"); // Limited Transmit algorithm (RFC 3042) enabled/disabled
     state->increased_IW_enabled = tcpMain->par("increasedIWEnabled"); // Increased Initial Window (RFC 3390) enabled/disabled
+    state->pacing_enabled = tcpMain->par("pacingEnabled"); // sender pacing enabled/disabled
+    int superSegmentSize = tcpMain->par("superSegmentSize"); // max number of segments in one TCPSegment message
+
+    if (superSegmentSize < 1)
+        throw cRuntimeError("Invalid superSegmentSize parameter: %d", superSegmentSize);
+
+    if (superSegmentSize > 1 && transferMode != TCP_TRANSFER_BYTECOUNT)
+    {
+        EV << "superSegmentSize is only supported in the bytecount data transfer mode, sending single segments\n";
+        superSegmentSize = 1;
+    }
+
+    state->super_segment_size = superSegmentSize;
     state->snd_mss = tcpMain->par("mss").longValue(); // Maximum Segment Size (RFC 793)
     state->ts_support = tcpMain->par("timestampSupport"); // if set, this means that current host supports TS (RFC 1323)
     state->sack_support = tcpMain->par("sackSupport"); // if set, this means that current host supports SACK (RFC 2018, 2883, 3517)
 
     if (state->sack_support)
     {
-        std::string algorithmName1 = "TCPReno";
-        std::string algorithmName2 = tcpMain->par("tcpAlgorithmClass");
-
-        if (algorithmName1 != algorithmName2) // TODO add additional checks for new SACK supporting algorithms here once they are implemented
-        {
-            EV << "If you want to use TCP SACK please set tcpAlgorithmClass to TCPReno\n";
+        std::string algorithmName = tcpMain->par("tcpAlgorithmClass");
 
-            ASSERT(false);
-        }
+        if (algorithmName != "TCPReno" && algorithmName != "TCPCubic")
+            throw cRuntimeError("TCP SACK is only supported by TCPReno and TCPCubic, not by tcpAlgorithmClass %s", algorithmName.c_str());
     }
 }
 
@@ -589,7 +600,7 @@ void TCPConnection::sendFin()
     tcpAlgorithm->ackSent();
 }
 
-void TCPConnection::sendSegment(uint32 bytes)
+void TCPConnection::sendSegment(uint32 bytes, uint32 segmentCount)
 {
     if (state->sack_enabled && state->afterRto)
     {
@@ -620,8 +631,21 @@ void TCPConnection::sendSegment(uint32 bytes)
 
     ASSERT(options_len < state->snd_mss);
 
-    if (bytes + options_len > state->snd_mss)
-        bytes = state->snd_mss - options_len;
+    // a super-segment carries only full-sized segments (every one of them
+    // gets the same header options when split)
+    uint32 maxSegmentPayload = state->snd_mss - options_len;
+
+    if (segmentCount > 1)
+    {
+        segmentCount = std::min(segmentCount, (uint32)(bytes / maxSegmentPayload));
+        if (segmentCount > 1)
+            bytes = segmentCount * maxSegmentPayload;
+        else
+            segmentCount = 1;
+    }
+
+    if (segmentCount == 1 && bytes + options_len > state->snd_mss)
+        bytes = maxSegmentPayload;
 
     state->sentBytes = bytes;
 
@@ -635,6 +659,7 @@ void TCPConnection::sendSegment(uint32 bytes)
     tcpseg->setAckNo(state->rcv_nxt);
     tcpseg->setAckBit(true);
     tcpseg->setWindow(updateRcvWnd());
+    tcpseg->setSegmentCount(segmentCount);
 
     // TBD when to set PSH bit?
     // TBD set URG bit if needed
@@ -754,7 +779,14 @@ bool TCPConnection::sendData(bool fullSegmentsOnly, uint32 congestionWindow)
     {
         while (bytesToSend >= effectiveMaxBytesSend)
         {
-            sendSegment(state->snd_mss);
+            // coalesce consecutive full-sized segments into a super-segment if
+            // enabled (not after RTO, where SACK may skip parts of the sequence space)
+            uint32 segmentCount = 1;
+
+            if (state->super_segment_size > 1 && !state->afterRto)
+                segmentCount = std::min(state->super_segment_size, (uint32)(bytesToSend / effectiveMaxBytesSend));
+
+            sendSegment(segmentCount * state->snd_mss, segmentCount);
             bytesToSend -= state->sentBytes;
         }
     }
@@ -44,6 +44,7 @@
 #define MAX_REXMIT_TIMEOUT    240   // 2 * MSL (RFC 1122)
 #define MIN_PERSIST_TIMEOUT     5   //  5s
 #define MAX_PERSIST_TIMEOUT    60   // 60s
+#define MAX_SEND_QUANTUM    65536   // 64KB: max amount of data released at once when pacing
 
 TCPBaseAlgStateVariables::TCPBaseAlgStateVariables()
 {
@@ -70,6 +71,8 @@ TCPBaseAlgStateVariables::TCPBaseAlgStateVariables()
     // whose initial value is the initial send sequence number."
     recover = iss;
     firstPartialACK = false;
+
+    pacing_next_send_time = 0;
 }
 
 std::string TCPBaseAlgStateVariables::info() const
@@ -95,7 +98,7 @@ std::string TCPBaseAlgStateVariables::detailedInfo() const
 TCPBaseAlg::TCPBaseAlg() : TCPAlgorithm(),
         state((TCPBaseAlgStateVariables *&)TCPAlgorithm::state)
 {
-    rexmitTimer = persistTimer = delayedAckTimer = keepAliveTimer = NULL;
+    rexmitTimer = persistTimer = delayedAckTimer = keepAliveTimer = paceTimer = NULL;
     cwndVector = ssthreshVector = rttVector = srttVector = rttvarVector = rtoVector = numRtosVector = NULL;
 }
 
@@ -108,6 +111,7 @@ TCPBaseAlg::~TCPBaseAlg()
     if (persistTimer)    delete cancelEvent(persistTimer);
     if (delayedAckTimer) delete cancelEvent(delayedAckTimer);
     if (keepAliveTimer)  delete cancelEvent(keepAliveTimer);
+    if (paceTimer)       delete cancelEvent(paceTimer);
 
     // delete statistics objects
     delete cwndVector;
@@ -127,11 +131,13 @@ void TCPBaseAlg::initialize()
     persistTimer = new cMessage("PERSIST");
     delayedAckTimer = new cMessage("DELAYEDACK");
     keepAliveTimer = new cMessage("KEEPALIVE");
+    paceTimer = new cMessage("PACE");
 
     rexmitTimer->setContextPointer(conn);
     persistTimer->setContextPointer(conn);
     delayedAckTimer->setContextPointer(conn);
     keepAliveTimer->setContextPointer(conn);
+    paceTimer->setContextPointer(conn);
 
     if (conn->getTcpMain()->recordStatistics)
     {
@@ -208,6 +214,7 @@ void TCPBaseAlg::connectionClosed()
     cancelEvent(persistTimer);
     cancelEvent(delayedAckTimer);
     cancelEvent(keepAliveTimer);
+    cancelEvent(paceTimer);
 }
 
 void TCPBaseAlg::processTimer(cMessage *timer, TCPEventCode& event)
@@ -220,6 +227,8 @@ void TCPBaseAlg::processTimer(cMessage *timer, TCPEventCode& event)
         processDelayedAckTimer(event);
     else if (timer == keepAliveTimer)
         processKeepAliveTimer(event);
+    else if (timer == paceTimer)
+        processPaceTimer(event);
     else
         throw cRuntimeError(timer, "unrecognized timer");
 }
@@ -355,6 +364,12 @@ void TCPBaseAlg::processKeepAliveTimer(TCPEventCode& event)
     // packets."
 }
 
+void TCPBaseAlg::processPaceTimer(TCPEventCode& event)
+{
+    // next send quantum may be released
+    sendData(false);
+}
+
 void TCPBaseAlg::startRexmitTimer()
 {
     // start counting retransmissions for this seq number.
@@ -457,17 +472,12 @@ bool TCPBaseAlg::sendData(bool sendCommandInvoked)
     if (!conn->isSendQueueEmpty())  // do we have any data to send?
     {
         if ((simTime() - state->time_last_data_sent) > state->rexmit_timeout)
-        {
-            // RFC 5681, page 11: "For the purposes of this standard, we define RW = min(IW,cwnd)."
-            if (state->increased_IW_enabled)
-                state->snd_cwnd = std::min(std::min(4 * state->snd_mss, std::max(2 * state->snd_mss, (uint32)4380)), state->snd_cwnd);
-            else
-                state->snd_cwnd = state->snd_mss;
-
-            tcpEV << "Restarting idle connection, CWND is set to " << state->snd_cwnd << "\n";
-        }
+            restartIdleConnection();
     }
 
+    if (state->pacing_enabled)
+        return sendDataPaced(fullSegmentsOnly);
+
     //
     // Send window is effectively the minimum of the congestion window (cwnd)
     // and the advertised window (snd_wnd).
@@ -475,6 +485,62 @@ bool TCPBaseAlg::sendData(bool sendCommandInvoked)
     return conn->sendData(fullSegmentsOnly, state->snd_cwnd);
 }
 
+void TCPBaseAlg::restartIdleConnection()
+{
+    // RFC 5681, page 11: "For the purposes of this standard, we define RW = min(IW,cwnd)."
+    if (state->increased_IW_enabled)
+        state->snd_cwnd = std::min(std::min(4 * state->snd_mss, std::max(2 * state->snd_mss, (uint32)4380)), state->snd_cwnd);
+    else
+        state->snd_cwnd = state->snd_mss;
+
+    tcpEV << "Restarting idle connection, CWND is set to " << state->snd_cwnd << "\n";
+}
+
+double TCPBaseAlg::getPacingRate()
+{
+    if (state->srtt == 0)
+        return 0;   // no RTT estimate yet
+
+    return TCP_PACING_CA_GAIN * state->snd_cwnd / SIMTIME_DBL(state->srtt);
+}
+
+bool TCPBaseAlg::sendDataPaced(bool fullSegmentsOnly)
+{
+    double pacingRate = getPacingRate();
+
+    if (pacingRate <= 0)
+        return conn->sendData(fullSegmentsOnly, state->snd_cwnd);
+
+    simtime_t now = simTime();
+
+    if (now < state->pacing_next_send_time)
+    {
+        if (!paceTimer->isScheduled())
+            conn->scheduleTimeout(paceTimer, state->pacing_next_send_time - now);
+
+        return false;
+    }
+
+    // release at most one send quantum: ~1ms worth of data at the pacing rate
+    uint32 sndNxt = state->afterRto ? state->snd_nxt : state->snd_max;
+    uint32 quantum = std::max(state->snd_mss, std::min((uint32)(pacingRate / 1000), (uint32)MAX_SEND_QUANTUM));
+    uint32 window = std::min(state->snd_cwnd, (sndNxt - state->snd_una) + quantum);
+
+    bool sent = conn->sendData(fullSegmentsOnly, window);
+
+    if (sent && seqGreater(state->snd_nxt, sndNxt))
+    {
+        uint32 bytesSent = state->snd_nxt - sndNxt;
+        state->pacing_next_send_time = now + bytesSent / pacingRate;
+
+        // more to send and the window is not full: next release is driven by the PACE timer
+        if (!conn->isSendQueueEmpty() && (state->snd_nxt - state->snd_una) < state->snd_cwnd && !paceTimer->isScheduled())
+            conn->scheduleTimeout(paceTimer, state->pacing_next_send_time - now);
+    }
+
+    return sent;
+}
+
 void TCPBaseAlg::sendCommandInvoked()
 {
     // try sending
@@ -23,6 +23,10 @@
 
 #include "TCPAlgorithm.h"
 
+// pacing rate = gain * cwnd / srtt, with the gains used by Linux
+#define TCP_PACING_SS_GAIN   2.0   // in slow start
+#define TCP_PACING_CA_GAIN   1.2   // in congestion avoidance
+
 
 /**
  * State variables for TCPBaseAlg.
@@ -73,6 +77,11 @@ class INET_API TCPBaseAlgStateVariables : public TCPStateVariables
     uint32 recover;            ///< recover (RFC 3782)
     bool firstPartialACK;      ///< first partial acknowledgement (RFC 3782)
     //@}
+
+    /// pacing (if pacing_enabled)
+    //@{
+    simtime_t pacing_next_send_time; ///< earliest time the next send quantum may be released
+    //@}
 };
 
 
@@ -87,6 +96,9 @@ class INET_API TCPBaseAlgStateVariables : public TCPStateVariables
  *   - Nagle's algorithm (RFC 896) to prevent silly window syndrome
  *   - Increased Initial Window (RFC 3390)
  *   - PERSIST timer
+ *   - sender pacing (optional): each sendData() call releases at most one
+ *     send quantum (~1ms of data), and the PACE timer schedules the next
+ *     one according to getPacingRate()
  *
  * To be done:
  *   - KEEP-ALIVE timer
@@ -109,6 +121,7 @@ class INET_API TCPBaseAlg : public TCPAlgorithm
     cMessage *persistTimer;
     cMessage *delayedAckTimer;
     cMessage *keepAliveTimer;
+    cMessage *paceTimer;
 
     cOutVector *cwndVector;  // will record changes to snd_cwnd
     cOutVector *ssthreshVector; // will record changes to ssthresh
@@ -119,12 +132,13 @@ class INET_API TCPBaseAlg : public TCPAlgorithm
     cOutVector *numRtosVector; // will record total number of RTOs
 
   protected:
-    /** @name Process REXMIT, PERSIST, DELAYED-ACK and KEEP-ALIVE timers */
+    /** @name Process REXMIT, PERSIST, DELAYED-ACK, KEEP-ALIVE and PACE timers */
     //@{
     virtual void processRexmitTimer(TCPEventCode& event);
     virtual void processPersistTimer(TCPEventCode& event);
     virtual void processDelayedAckTimer(TCPEventCode& event);
     virtual void processKeepAliveTimer(TCPEventCode& event);
+    virtual void processPaceTimer(TCPEventCode& event);
     //@}
 
     /**
@@ -150,6 +164,26 @@ class INET_API TCPBaseAlg : public TCPAlgorithm
      */
     virtual bool sendData(bool sendCommandInvoked);
 
+    /**
+     * Called from sendData() when data is about to be sent after the connection
+     * has been idle for more than one RTO; reduces cwnd to the restart window
+     * (RFC 2581, RFC 5681).
+     */
+    virtual void restartIdleConnection();
+
+    /**
+     * Returns the pacing rate in bytes/s, used if pacing_enabled is set;
+     * 0 means that segments are not paced (e.g. no RTT estimate yet).
+     * This default implementation returns TCP_PACING_CA_GAIN * cwnd / srtt.
+     */
+    virtual double getPacingRate();
+
+    /**
+     * Sends at most one send quantum within the congestion window if the
+     * pacing rate allows, and schedules the PACE timer for the next one.
+     */
+    virtual bool sendDataPaced(bool fullSegmentsOnly);
+
     /** Utility function */
     cMessage *cancelEvent(cMessage *msg) {return conn->getTcpMain()->cancelEvent(msg);}
 
@@ -174,7 +208,7 @@ class INET_API TCPBaseAlg : public TCPAlgorithm
     virtual void connectionClosed();
 
     /**
-     * Process REXMIT, PERSIST, DELAYED-ACK and KEEP-ALIVE timers.
+     * Process REXMIT, PERSIST, DELAYED-ACK, KEEP-ALIVE and PACE timers.
      */
     virtual void processTimer(cMessage *timer, TCPEventCode& event);
 
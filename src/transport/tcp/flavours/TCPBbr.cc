@@ -0,0 +1,491 @@
+//
+// Copyright (C) 2026 OpenSim Ltd
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program; if not, see <http://www.gnu.org/licenses/>.
+//
+
+#include <algorithm>   // min,max
+
+#include "TCPBbr.h"
+#include "TCP.h"
+
+
+Register_Class(TCPBbr);
+
+#define BBR_HIGH_GAIN               2.885  // 2/ln(2): doubles the sending rate every round in STARTUP
+#define BBR_CWND_GAIN               2.0
+#define BBR_RTPROP_FILTER_LEN       10.0   // 10s
+#define BBR_PROBE_RTT_DURATION      0.2    // 200ms
+#define BBR_MIN_PIPE_CWND_SEGMENTS  4
+#define BBR_FULL_BW_THRESH          1.25   // STARTUP ends when bw grew less than 25%...
+#define BBR_FULL_BW_COUNT           3      // ...during 3 rounds
+#define BBR_GAIN_CYCLE_LEN          8
+
+static const double pacingGainCycle[BBR_GAIN_CYCLE_LEN] = { 1.25, 0.75, 1, 1, 1, 1, 1, 1 };
+
+static const char *modeNames[] = { "STARTUP", "DRAIN", "PROBE_BW", "PROBE_RTT" };
+
+
+TCPBbrStateVariables::TCPBbrStateVariables()
+{
+    bbr_mode = STARTUP;
+    bbr_btlBw = 0;
+    for (int i = 0; i < BBR_BTLBW_FILTER_LEN; i++)
+    {
+        bbr_bwSamples[i] = 0;
+        bbr_bwSampleRound[i] = 0;
+    }
+    bbr_rtProp = 0;
+    bbr_rtPropStamp = 0;
+    bbr_rtPropExpired = false;
+    bbr_roundCount = 0;
+    bbr_nextRoundDelivered = 0;
+    bbr_roundStart = false;
+    bbr_fullBw = 0;
+    bbr_fullBwCount = 0;
+    bbr_filledPipe = false;
+    bbr_pacingGain = BBR_HIGH_GAIN;
+    bbr_cwndGain = BBR_HIGH_GAIN;
+    bbr_cycleIndex = 0;
+    bbr_cycleStamp = 0;
+    bbr_probeRttDoneStamp = 0;
+    bbr_probeRttRoundDone = false;
+    bbr_idleRestart = false;
+    bbr_priorCwnd = 0;
+    bbr_inRecovery = false;
+    bbr_recoveryPoint = 0;
+    bbr_pacingRate = 0;
+}
+
+std::string TCPBbrStateVariables::info() const
+{
+    std::stringstream out;
+    out << TCPBaseAlgStateVariables::info();
+    out << " mode=" << modeNames[bbr_mode];
+    out << " btlBw=" << bbr_btlBw;
+    out << " rtProp=" << bbr_rtProp;
+    return out.str();
+}
+
+std::string TCPBbrStateVariables::detailedInfo() const
+{
+    std::stringstream out;
+    out << TCPBaseAlgStateVariables::detailedInfo();
+    out << "mode=" << modeNames[bbr_mode] << "\n";
+    out << "btlBw=" << bbr_btlBw << "\n";
+    out << "rtProp=" << bbr_rtProp << "\n";
+    out << "pacingGain=" << bbr_pacingGain << "\n";
+    out << "cwndGain=" << bbr_cwndGain << "\n";
+    out << "pacingRate=" << bbr_pacingRate << "\n";
+    out << "filledPipe=" << bbr_filledPipe << "\n";
+    out << "roundCount=" << bbr_roundCount << "\n";
+    return out.str();
+}
+
+TCPBbr::TCPBbr() : TCPBaseAlg(),
+        state((TCPBbrStateVariables *&)TCPAlgorithm::state)
+{
+    btlBwVector = rtPropVector = pacingRateVector = NULL;
+}
+
+TCPBbr::~TCPBbr()
+{
+    delete btlBwVector;
+    delete rtPropVector;
+    delete pacingRateVector;
+}
+
+void TCPBbr::initialize()
+{
+    TCPBaseAlg::initialize();
+
+    state->pacing_enabled = true;
+
+    if (conn->getTcpMain()->recordStatistics)
+    {
+        btlBwVector = new cOutVector("estimated bottleneck bandwidth");
+        rtPropVector = new cOutVector("RTprop");
+        pacingRateVector = new cOutVector("pacing rate");
+    }
+}
+
+void TCPBbr::established(bool active)
+{
+    TCPBaseAlg::established(active);
+
+    enterStartup();
+
+    // initial pacing rate: high_gain * InitialCwnd / (SRTT or 1ms)
+    simtime_t rtt = state->srtt > 0 ? state->srtt : simtime_t(0.001);
+    state->bbr_pacingRate = BBR_HIGH_GAIN * state->snd_cwnd / SIMTIME_DBL(rtt);
+}
+
+uint32 TCPBbr::getBDP(double gain)
+{
+    if (state->bbr_rtProp == 0 || state->bbr_btlBw == 0)
+        return state->snd_cwnd;     // no valid estimate yet
+
+    return (uint32)(gain * state->bbr_btlBw * SIMTIME_DBL(state->bbr_rtProp));
+}
+
+void TCPBbr::enterStartup()
+{
+    state->bbr_mode = TCPBbrStateVariables::STARTUP;
+    state->bbr_pacingGain = BBR_HIGH_GAIN;
+    state->bbr_cwndGain = BBR_HIGH_GAIN;
+}
+
+void TCPBbr::enterProbeBW()
+{
+    state->bbr_mode = TCPBbrStateVariables::PROBE_BW;
+    state->bbr_cwndGain = BBR_CWND_GAIN;
+
+    // start at a random phase, but never in the draining (0.75) phase
+    state->bbr_cycleIndex = 2 + conn->getTcpMain()->intrand(BBR_GAIN_CYCLE_LEN - 2);
+    state->bbr_cycleStamp = simTime();
+    state->bbr_pacingGain = pacingGainCycle[state->bbr_cycleIndex];
+
+    tcpEV << "BBR entering PROBE_BW, cycle index " << state->bbr_cycleIndex << "\n";
+}
+
+void TCPBbr::enterProbeRTT()
+{
+    state->bbr_priorCwnd = state->bbr_inRecovery ? std::max(state->bbr_priorCwnd, state->snd_cwnd) : state->snd_cwnd;
+    state->bbr_mode = TCPBbrStateVariables::PROBE_RTT;
+    state->bbr_pacingGain = 1;
+    state->bbr_cwndGain = 1;
+    state->bbr_probeRttDoneStamp = 0;
+
+    tcpEV << "BBR entering PROBE_RTT\n";
+}
+
+void TCPBbr::exitProbeRTT()
+{
+    state->snd_cwnd = std::max(state->snd_cwnd, state->bbr_priorCwnd);
+
+    if (state->bbr_filledPipe)
+        enterProbeBW();
+    else
+        enterStartup();
+}
+
+void TCPBbr::updateBtlBw(const TCPDeliveryRateSampler::RateSample& rs)
+{
+    state->bbr_roundStart = false;
+
+    if (rs.delivered > 0 && rs.priorDelivered >= state->bbr_nextRoundDelivered)
+    {
+        state->bbr_nextRoundDelivered = state->rateSampler.getDelivered();
+        state->bbr_roundCount++;
+        state->bbr_roundStart = true;
+    }
+
+    if (rs.deliveryRate < 0 || (rs.isAppLimited && rs.deliveryRate < state->bbr_btlBw))
+        return;
+
+    // windowed max filter: one slot per round, slots older than the window are ignored
+    int slot = state->bbr_roundCount % BBR_BTLBW_FILTER_LEN;
+
+    if (state->bbr_bwSampleRound[slot] != state->bbr_roundCount)
+    {
+        state->bbr_bwSampleRound[slot] = state->bbr_roundCount;
+        state->bbr_bwSamples[slot] = 0;
+    }
+
+    if (rs.deliveryRate > state->bbr_bwSamples[slot])
+        state->bbr_bwSamples[slot] = rs.deliveryRate;
+
+    double btlBw = 0;
+
+    for (int i = 0; i < BBR_BTLBW_FILTER_LEN; i++)
+        if (state->bbr_bwSampleRound[i] + BBR_BTLBW_FILTER_LEN > state->bbr_roundCount && state->bbr_bwSamples[i] > btlBw)
+            btlBw = state->bbr_bwSamples[i];
+
+    if (btlBw != state->bbr_btlBw)
+    {
+        state->bbr_btlBw = btlBw;
+
+        if (btlBwVector)
+            btlBwVector->record(btlBw * 8);  // in bps
+    }
+}
+
+void TCPBbr::updateRTprop(const TCPDeliveryRateSampler::RateSample& rs)
+{
+    simtime_t now = simTime();
+    state->bbr_rtPropExpired = state->bbr_rtProp > 0 && now > state->bbr_rtPropStamp + BBR_RTPROP_FILTER_LEN;
+
+    if (rs.rtt >= 0 && (state->bbr_rtProp == 0 || rs.rtt <= state->bbr_rtProp || state->bbr_rtPropExpired))
+    {
+        state->bbr_rtProp = rs.rtt;
+        state->bbr_rtPropStamp = now;
+
+        if (rtPropVector)
+            rtPropVector->record(state->bbr_rtProp);
+    }
+}
+
+void TCPBbr::checkCyclePhase(const TCPDeliveryRateSampler::RateSample& rs)
+{
+    if (state->bbr_mode != TCPBbrStateVariables::PROBE_BW)
+        return;
+
+    simtime_t now = simTime();
+    bool isFullLength = (now - state->bbr_cycleStamp) > state->bbr_rtProp;
+    bool next;
+
+    if (state->bbr_pacingGain == 1)
+        next = isFullLength;
+    else if (state->bbr_pacingGain > 1)
+        next = isFullLength && getInflight() >= getBDP(state->bbr_pacingGain);
+    else
+        next = isFullLength || getInflight() <= getBDP(1);
+
+    if (next)
+    {
+        state->bbr_cycleIndex = (state->bbr_cycleIndex + 1) % BBR_GAIN_CYCLE_LEN;
+        state->bbr_cycleStamp = now;
+        state->bbr_pacingGain = pacingGainCycle[state->bbr_cycleIndex];
+    }
+}
+
+void TCPBbr::checkFullPipe(const TCPDeliveryRateSampler::RateSample& rs)
+{
+    if (state->bbr_filledPipe || !state->bbr_roundStart || rs.isAppLimited)
+        return;
+
+    if (state->bbr_btlBw >= state->bbr_fullBw * BBR_FULL_BW_THRESH)
+    {
+        state->bbr_fullBw = state->bbr_btlBw;
+        state->bbr_fullBwCount = 0;
+        return;
+    }
+
+    if (++state->bbr_fullBwCount >= BBR_FULL_BW_COUNT)
+    {
+        state->bbr_filledPipe = true;
+        tcpEV << "BBR: pipe filled, btlBw=" << state->bbr_btlBw * 8 << "bps\n";
+    }
+}
+
+void TCPBbr::checkDrain()
+{
+    if (state->bbr_mode == TCPBbrStateVariables::STARTUP && state->bbr_filledPipe)
+    {
+        state->bbr_mode = TCPBbrStateVariables::DRAIN;
+        state->bbr_pacingGain = 1.0 / BBR_HIGH_GAIN;
+        state->bbr_cwndGain = BBR_HIGH_GAIN;
+        tcpEV << "BBR entering DRAIN\n";
+    }
+
+    if (state->bbr_mode == TCPBbrStateVariables::DRAIN && getInflight() <= getBDP(1))
+        enterProbeBW();
+}
+
+void TCPBbr::checkProbeRTT()
+{
+    uint32 minPipeCwnd = BBR_MIN_PIPE_CWND_SEGMENTS * state->snd_mss;
+
+    if (state->bbr_mode != TCPBbrStateVariables::PROBE_RTT && state->bbr_rtPropExpired && !state->bbr_idleRestart)
+        enterProbeRTT();
+
+    if (state->bbr_mode == TCPBbrStateVariables::PROBE_RTT)
+    {
+        simtime_t now = simTime();
+        state->rateSampler.onAppLimited(getInflight());
+
+        if (state->bbr_probeRttDoneStamp == 0 && getInflight() <= minPipeCwnd)
+        {
+            state->bbr_probeRttDoneStamp = now + BBR_PROBE_RTT_DURATION;
+            state->bbr_probeRttRoundDone = false;
+            state->bbr_nextRoundDelivered = state->rateSampler.getDelivered();
+        }
+        else if (state->bbr_probeRttDoneStamp != 0)
+        {
+            if (state->bbr_roundStart)
+                state->bbr_probeRttRoundDone = true;
+
+            if (state->bbr_probeRttRoundDone && now > state->bbr_probeRttDoneStamp)
+            {
+                state->bbr_rtPropStamp = now;
+                exitProbeRTT();
+            }
+        }
+    }
+
+    state->bbr_idleRestart = false;
+}
+
+void TCPBbr::updateModelAndState(const TCPDeliveryRateSampler::RateSample& rs, uint32 bytesAcked)
+{
+    updateBtlBw(rs);
+    checkCyclePhase(rs);
+    checkFullPipe(rs);
+    checkDrain();
+    updateRTprop(rs);
+    checkProbeRTT();
+}
+
+void TCPBbr::setPacingRate(double gain)
+{
+    if (state->bbr_btlBw == 0)
+        return;
+
+    double rate = gain * state->bbr_btlBw;
+
+    if (state->bbr_filledPipe || rate > state->bbr_pacingRate)
+    {
+        state->bbr_pacingRate = rate;
+
+        if (pacingRateVector)
+            pacingRateVector->record(rate * 8);  // in bps
+    }
+}
+
+void TCPBbr::setCwnd(uint32 bytesAcked)
+{
+    uint32 minPipeCwnd = BBR_MIN_PIPE_CWND_SEGMENTS * state->snd_mss;
+    uint32 targetCwnd = getBDP(state->bbr_cwndGain) + 3 * state->snd_mss;  // room for 3 send quanta
+
+    if (state->bbr_inRecovery)
+        state->snd_cwnd = std::max(getInflight() + bytesAcked, minPipeCwnd);  // packet conservation
+    else if (state->bbr_filledPipe)
+        state->snd_cwnd = std::min(state->snd_cwnd + bytesAcked, targetCwnd);
+    else if (state->snd_cwnd < targetCwnd || state->rateSampler.getDelivered() < 10 * state->snd_mss)
+        state->snd_cwnd += bytesAcked;
+
+    state->snd_cwnd = std::max(state->snd_cwnd, minPipeCwnd);
+
+    if (state->bbr_mode == TCPBbrStateVariables::PROBE_RTT)
+        state->snd_cwnd = std::min(state->snd_cwnd, minPipeCwnd);
+
+    if (cwndVector)
+        cwndVector->record(state->snd_cwnd);
+}
+
+void TCPBbr::receivedDataAck(uint32 firstSeqAcked)
+{
+    TCPBaseAlg::receivedDataAck(firstSeqAcked);
+
+    uint32 bytesAcked = state->snd_una - firstSeqAcked;
+    TCPDeliveryRateSampler::RateSample rs;
+    state->rateSampler.onAck(state->snd_una, bytesAcked, rs);
+
+    if (state->bbr_inRecovery && seqGE(state->snd_una, state->bbr_recoveryPoint))
+    {
+        tcpEV << "BBR: leaving loss recovery, restoring cwnd\n";
+        state->bbr_inRecovery = false;
+        state->snd_cwnd = std::max(state->snd_cwnd, state->bbr_priorCwnd);
+    }
+
+    updateModelAndState(rs, bytesAcked);
+    setPacingRate(state->bbr_pacingGain);
+    setCwnd(bytesAcked);
+
+    tcpEV << "BBR " << modeNames[state->bbr_mode] << ": btlBw=" << state->bbr_btlBw * 8 << "bps, rtProp="
+          << state->bbr_rtProp << ", pacingRate=" << state->bbr_pacingRate * 8 << "bps, cwnd=" << state->snd_cwnd << "\n";
+
+    sendData(false);
+}
+
+void TCPBbr::receivedDuplicateAck()
+{
+    TCPBaseAlg::receivedDuplicateAck();
+
+    if (state->dupacks == DUPTHRESH) // DUPTHRESH = 3
+    {
+        if (!state->bbr_inRecovery)
+        {
+            tcpEV << "BBR on dupAcks == DUPTHRESH(=3): perform Fast Retransmit, packet conservation\n";
+            state->bbr_priorCwnd = state->snd_cwnd;
+            state->bbr_inRecovery = true;
+            state->bbr_recoveryPoint = state->snd_max;
+            state->snd_cwnd = std::max(getInflight(), BBR_MIN_PIPE_CWND_SEGMENTS * state->snd_mss);
+
+            if (cwndVector)
+                cwndVector->record(state->snd_cwnd);
+        }
+
+        conn->retransmitOneSegment(false);
+        sendData(false);
+    }
+    else if (state->dupacks > DUPTHRESH) // DUPTHRESH = 3
+    {
+        // each further duplicate ACK means a segment has left the network
+        state->snd_cwnd += state->snd_mss;
+
+        if (cwndVector)
+            cwndVector->record(state->snd_cwnd);
+
+        sendData(false);
+    }
+}
+
+void TCPBbr::processRexmitTimer(TCPEventCode& event)
+{
+    TCPBaseAlg::processRexmitTimer(event);
+
+    if (event == TCP_E_ABORT)
+        return;
+
+    // the model is kept, only the window is collapsed until the lost data are recovered
+    if (!state->bbr_inRecovery)
+        state->bbr_priorCwnd = state->snd_cwnd;
+
+    state->bbr_inRecovery = true;
+    state->bbr_recoveryPoint = state->snd_max;
+    state->snd_cwnd = state->snd_mss;
+
+    if (cwndVector)
+        cwndVector->record(state->snd_cwnd);
+
+    tcpEV << "BBR RTO: resetting cwnd to " << state->snd_cwnd << "\n";
+
+    state->afterRto = true;
+    conn->retransmitOneSegment(true);
+}
+
+bool TCPBbr::sendData(bool sendCommandInvoked)
+{
+    if (getInflight() == 0 && !conn->isSendQueueEmpty())
+    {
+        // restarting from idle: pace at the estimated bandwidth right away
+        state->bbr_idleRestart = true;
+
+        if (state->bbr_mode == TCPBbrStateVariables::PROBE_BW)
+            setPacingRate(1);
+    }
+
+    // pacing and the congestion window are handled by TCPBaseAlg
+    bool sent = TCPBaseAlg::sendData(sendCommandInvoked);
+
+    if (conn->isSendQueueEmpty() && getInflight() < state->snd_cwnd)
+        state->rateSampler.onAppLimited(getInflight());
+
+    return sent;
+}
+
+void TCPBbr::dataSent(uint32 fromseq)
+{
+    TCPBaseAlg::dataSent(fromseq);
+
+    state->rateSampler.onSent(fromseq, state->snd_nxt, state->snd_una);
+}
+
+void TCPBbr::segmentRetransmitted(uint32 fromseq, uint32 toseq)
+{
+    TCPBaseAlg::segmentRetransmitted(fromseq, toseq);
+
+    state->rateSampler.onSent(fromseq, toseq, state->snd_una);
+}
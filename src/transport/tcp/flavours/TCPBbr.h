@@ -0,0 +1,180 @@
+//
+// Copyright (C) 2026 OpenSim Ltd
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program; if not, see <http://www.gnu.org/licenses/>.
+//
+
+#ifndef __INET_TCPBBR_H
+#define __INET_TCPBBR_H
+
+#include "INETDefs.h"
+
+#include "TCPBaseAlg.h"
+#include "TCPDeliveryRateSampler.h"
+
+#define BBR_BTLBW_FILTER_LEN   10   // length of the bottleneck bandwidth max filter, in round trips
+
+
+/**
+ * State variables for TCPBbr.
+ */
+class INET_API TCPBbrStateVariables : public TCPBaseAlgStateVariables
+{
+  public:
+    enum Mode { STARTUP, DRAIN, PROBE_BW, PROBE_RTT };
+
+    TCPBbrStateVariables();
+    virtual std::string info() const;
+    virtual std::string detailedInfo() const;
+
+    Mode bbr_mode;
+
+    /// bottleneck bandwidth estimation: max of the per-round maxima of the last rounds
+    //@{
+    double bbr_btlBw;                               ///< bytes/s
+    double bbr_bwSamples[BBR_BTLBW_FILTER_LEN];     ///< max delivery rate in the given round
+    uint64 bbr_bwSampleRound[BBR_BTLBW_FILTER_LEN]; ///< round of the slot
+    //@}
+
+    /// round-trip propagation time estimation
+    //@{
+    simtime_t bbr_rtProp;      ///< min RTT in the filter window (0: no sample yet)
+    simtime_t bbr_rtPropStamp; ///< time of the last bbr_rtProp update
+    bool bbr_rtPropExpired;
+    //@}
+
+    /// round counting
+    //@{
+    uint64 bbr_roundCount;
+    uint64 bbr_nextRoundDelivered;
+    bool bbr_roundStart;
+    //@}
+
+    /// full pipe detection in STARTUP
+    //@{
+    double bbr_fullBw;
+    int bbr_fullBwCount;
+    bool bbr_filledPipe;
+    //@}
+
+    /// gains and gain cycling in PROBE_BW
+    //@{
+    double bbr_pacingGain;
+    double bbr_cwndGain;
+    int bbr_cycleIndex;
+    simtime_t bbr_cycleStamp;
+    //@}
+
+    /// PROBE_RTT
+    //@{
+    simtime_t bbr_probeRttDoneStamp; ///< 0: cwnd not reduced to the minimum yet
+    bool bbr_probeRttRoundDone;
+    bool bbr_idleRestart;
+    //@}
+
+    /// loss recovery (packet conservation)
+    //@{
+    uint32 bbr_priorCwnd;
+    bool bbr_inRecovery;
+    uint32 bbr_recoveryPoint;
+    //@}
+
+    /// pacing
+    //@{
+    double bbr_pacingRate;     ///< bytes/s, 0 until the first estimate
+    //@}
+
+    TCPDeliveryRateSampler rateSampler;
+};
+
+
+/**
+ * Implements BBR (v1) congestion control, as described in
+ * draft-cardwell-iccrg-bbr-congestion-control-00.
+ *
+ * BBR builds an explicit model of the path (bottleneck bandwidth from
+ * delivery rate samples, see TCPDeliveryRateSampler, and round-trip
+ * propagation time from RTT samples), and derives the pacing rate and
+ * the congestion window from it. Transmissions are always paced, using
+ * TCPBaseAlg's pacing with the model-based rate (regardless of the
+ * pacingEnabled parameter).
+ *
+ * Losses do not reduce the model; fast retransmit is performed on three
+ * duplicate ACKs, with packet conservation during recovery.
+ */
+class INET_API TCPBbr : public TCPBaseAlg
+{
+  protected:
+    TCPBbrStateVariables *&state; // alias to TCPAlgorithm's 'state'
+
+    cOutVector *btlBwVector;     // will record the bottleneck bandwidth estimate
+    cOutVector *rtPropVector;    // will record the RTprop estimate
+    cOutVector *pacingRateVector;
+
+    /** Create and return a TCPBbrStateVariables object. */
+    virtual TCPStateVariables *createStateVariables() {
+        return new TCPBbrStateVariables();
+    }
+
+    /** @name Model and state machine */
+    //@{
+    virtual uint32 getBDP(double gain);
+    virtual uint32 getInflight() { return state->snd_max - state->snd_una; }
+    virtual void updateModelAndState(const TCPDeliveryRateSampler::RateSample& rs, uint32 bytesAcked);
+    virtual void updateBtlBw(const TCPDeliveryRateSampler::RateSample& rs);
+    virtual void updateRTprop(const TCPDeliveryRateSampler::RateSample& rs);
+    virtual void checkCyclePhase(const TCPDeliveryRateSampler::RateSample& rs);
+    virtual void checkFullPipe(const TCPDeliveryRateSampler::RateSample& rs);
+    virtual void checkDrain();
+    virtual void checkProbeRTT();
+    virtual void enterStartup();
+    virtual void enterProbeBW();
+    virtual void enterProbeRTT();
+    virtual void exitProbeRTT();
+    virtual void setPacingRate(double gain);
+    virtual void setCwnd(uint32 bytesAcked);
+    //@}
+
+    /** Redefine what should happen on retransmission */
+    virtual void processRexmitTimer(TCPEventCode& event);
+
+    /** Send data, observing the pacing rate and the congestion window */
+    virtual bool sendData(bool sendCommandInvoked);
+
+    /** BBR does not reduce cwnd after idle periods */
+    virtual void restartIdleConnection() {}
+
+    /** Returns the model-based pacing rate */
+    virtual double getPacingRate() { return state->bbr_pacingRate; }
+
+  public:
+    /** Ctor */
+    TCPBbr();
+
+    virtual ~TCPBbr();
+
+    virtual void initialize();
+
+    virtual void established(bool active);
+
+    virtual void receivedDataAck(uint32 firstSeqAcked);
+
+    virtual void receivedDuplicateAck();
+
+    virtual void dataSent(uint32 fromseq);
+
+    virtual void segmentRetransmitted(uint32 fromseq, uint32 toseq);
+};
+
+#endif
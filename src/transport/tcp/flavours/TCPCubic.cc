@@ -0,0 +1,221 @@
+//
+// Copyright (C) 2026 OpenSim Ltd
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program; if not, see <http://www.gnu.org/licenses/>.
+//
+
+#include <algorithm>   // min,max
+#include <math.h>
+
+#include "TCPCubic.h"
+#include "TCP.h"
+
+
+Register_Class(TCPCubic);
+
+// RFC 8312 constants
+#define CUBIC_BETA            0.7  // multiplicative decrease factor
+#define CUBIC_C               0.4  // scaling constant, in segments/s^3
+#define CUBIC_MAX_GROWTH      1.5  // target is capped at 1.5*cwnd per RTT (RFC 8312bis)
+
+
+TCPCubicStateVariables::TCPCubicStateVariables()
+{
+    cubic_wmax = 0;
+    cubic_wlastmax = 0;
+    cubic_epochStart = 0;
+    cubic_K = 0;
+    cubic_originPoint = 0;
+    cubic_westimate = 0;
+    cubic_cwndFraction = 0;
+    cubic_minRtt = 0;
+}
+
+std::string TCPCubicStateVariables::info() const
+{
+    std::stringstream out;
+    out << TCPTahoeRenoFamilyStateVariables::info();
+    out << " W_max=" << cubic_wmax;
+    return out.str();
+}
+
+std::string TCPCubicStateVariables::detailedInfo() const
+{
+    std::stringstream out;
+    out << TCPTahoeRenoFamilyStateVariables::detailedInfo();
+    out << "W_max=" << cubic_wmax << "\n";
+    out << "W_lastmax=" << cubic_wlastmax << "\n";
+    out << "epochStart=" << cubic_epochStart << "\n";
+    out << "K=" << cubic_K << "\n";
+    out << "W_est=" << cubic_westimate << "\n";
+    out << "minRtt=" << cubic_minRtt << "\n";
+    return out.str();
+}
+
+TCPCubic::TCPCubic() : TCPReno(),
+        state((TCPCubicStateVariables *&)TCPAlgorithm::state)
+{
+}
+
+void TCPCubic::recalculateSlowStartThreshold()
+{
+    // RFC 8312, section 4.6 (fast convergence) and 4.5 (multiplicative decrease):
+    // "W_max = cwnd * (1 + beta_cubic) / 2" if the flow released bandwidth,
+    // otherwise W_max = cwnd; then "ssthresh = cwnd * beta_cubic".
+    double cwnd = state->snd_cwnd;
+
+    if (cwnd < state->cubic_wlastmax)
+    {
+        state->cubic_wlastmax = cwnd;
+        state->cubic_wmax = cwnd * (1.0 + CUBIC_BETA) / 2.0;
+    }
+    else
+    {
+        state->cubic_wlastmax = cwnd;
+        state->cubic_wmax = cwnd;
+    }
+
+    state->ssthresh = std::max((uint32)(cwnd * CUBIC_BETA), 2 * state->snd_mss);
+    state->cubic_epochStart = 0;   // start a new epoch at the next congestion avoidance ACK
+
+    if (ssthreshVector)
+        ssthreshVector->record(state->ssthresh);
+
+    tcpEV << "CUBIC window reduction: W_max=" << state->cubic_wmax << ", ssthresh=" << state->ssthresh << "\n";
+}
+
+void TCPCubic::rttMeasurementComplete(simtime_t tSent, simtime_t tAcked)
+{
+    TCPReno::rttMeasurementComplete(tSent, tAcked);
+
+    simtime_t rtt = tAcked - tSent;
+
+    if (rtt > 0 && (state->cubic_minRtt == 0 || rtt < state->cubic_minRtt))
+        state->cubic_minRtt = rtt;
+}
+
+void TCPCubic::cubicUpdate(uint32 bytesAcked)
+{
+    const double mss = state->snd_mss;
+    double cwnd = state->snd_cwnd;
+    simtime_t now = simTime();
+
+    if (state->cubic_epochStart == 0)
+    {
+        // RFC 8312, section 4.1: beginning of a congestion avoidance epoch
+        state->cubic_epochStart = now;
+
+        if (cwnd < state->cubic_wmax)
+        {
+            state->cubic_K = pow((state->cubic_wmax - cwnd) / mss / CUBIC_C, 1.0 / 3.0);
+            state->cubic_originPoint = state->cubic_wmax;
+        }
+        else
+        {
+            state->cubic_K = 0;
+            state->cubic_originPoint = cwnd;
+        }
+
+        state->cubic_westimate = cwnd;
+        state->cubic_cwndFraction = 0;
+    }
+
+    // W_cubic(t+RTT): the window to be reached one RTT later
+    simtime_t rtt = state->cubic_minRtt > 0 ? state->cubic_minRtt : state->srtt;
+    double t = SIMTIME_DBL(now - state->cubic_epochStart + rtt) - state->cubic_K;
+    double target = state->cubic_originPoint + CUBIC_C * t * t * t * mss;
+
+    if (target < cwnd)
+        target = cwnd;
+    else if (target > CUBIC_MAX_GROWTH * cwnd)
+        target = CUBIC_MAX_GROWTH * cwnd;
+
+    // RFC 8312, section 4.3/4.4: concave and convex regions,
+    // cwnd grows by (target - cwnd)/cwnd segments per acked segment
+    double incr;
+
+    if (target > cwnd)
+        incr = (target - cwnd) * bytesAcked / cwnd;
+    else
+        incr = 0.01 * mss * bytesAcked / cwnd;
+
+    // RFC 8312, section 4.2: TCP-friendly region
+    state->cubic_westimate += 3.0 * (1.0 - CUBIC_BETA) / (1.0 + CUBIC_BETA) * mss * bytesAcked / cwnd;
+
+    if (state->cubic_westimate > cwnd + incr)
+        incr = state->cubic_westimate - cwnd;
+
+    incr += state->cubic_cwndFraction;
+    uint32 wholeBytes = (uint32)incr;
+    state->cubic_cwndFraction = incr - wholeBytes;
+    state->snd_cwnd += wholeBytes;
+
+    if (cwndVector)
+        cwndVector->record(state->snd_cwnd);
+
+    tcpEV << "cwnd > ssthresh: CUBIC Congestion Avoidance: target=" << (uint32)target
+          << ", W_est=" << (uint32)state->cubic_westimate << ", increasing cwnd to " << state->snd_cwnd << "\n";
+}
+
+void TCPCubic::receivedDataAck(uint32 firstSeqAcked)
+{
+    TCPTahoeRenoFamily::receivedDataAck(firstSeqAcked);
+
+    if (state->dupacks >= DUPTHRESH) // DUPTHRESH = 3
+    {
+        //
+        // Perform Fast Recovery: set cwnd to ssthresh (deflating the window).
+        //
+        tcpEV << "Fast Recovery: setting cwnd to ssthresh=" << state->ssthresh << "\n";
+        state->snd_cwnd = state->ssthresh;
+
+        if (cwndVector)
+            cwndVector->record(state->snd_cwnd);
+    }
+    else if (state->snd_cwnd < state->ssthresh)
+    {
+        tcpEV << "cwnd <= ssthresh: Slow Start: increasing cwnd by one SMSS bytes to ";
+
+        // perform Slow Start (RFC 2581), as in TCPReno
+        state->snd_cwnd += state->snd_mss;
+
+        if (cwndVector)
+            cwndVector->record(state->snd_cwnd);
+
+        tcpEV << "cwnd=" << state->snd_cwnd << "\n";
+    }
+    else
+    {
+        cubicUpdate(state->snd_una - firstSeqAcked);
+    }
+
+    if (state->sack_enabled && state->lossRecovery)
+    {
+        // RFC 3517 loss recovery, see TCPReno::receivedDataAck()
+        if (seqGE(state->snd_una, state->recoveryPoint))
+        {
+            tcpEV << "Loss Recovery terminated.\n";
+            state->lossRecovery = false;
+        }
+        else
+        {
+            conn->setPipe();
+
+            if (((int)state->snd_cwnd - (int)state->pipe) >= (int)state->snd_mss) // Note: Typecast needed to avoid prohibited transmissions
+                conn->sendDataDuringLossRecoveryPhase(state->snd_cwnd);
+        }
+    }
+
+    sendData(false);
+}
@@ -0,0 +1,87 @@
+//
+// Copyright (C) 2026 OpenSim Ltd
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program; if not, see <http://www.gnu.org/licenses/>.
+//
+
+#ifndef __INET_TCPCUBIC_H
+#define __INET_TCPCUBIC_H
+
+#include "INETDefs.h"
+
+#include "TCPReno.h"
+
+
+/**
+ * State variables for TCPCubic.
+ */
+class INET_API TCPCubicStateVariables : public TCPTahoeRenoFamilyStateVariables
+{
+  public:
+    TCPCubicStateVariables();
+    virtual std::string info() const;
+    virtual std::string detailedInfo() const;
+
+    double cubic_wmax;          ///< window size just before the last reduction (bytes)
+    double cubic_wlastmax;      ///< previous value of cubic_wmax, for fast convergence (bytes)
+    simtime_t cubic_epochStart; ///< beginning of the current congestion avoidance epoch (0: no epoch)
+    double cubic_K;             ///< time to reach cubic_originPoint in the current epoch (s)
+    double cubic_originPoint;   ///< plateau of the cubic function in the current epoch (bytes)
+    double cubic_westimate;     ///< window estimate of a Reno flow (TCP-friendly region, bytes)
+    double cubic_cwndFraction;  ///< sub-byte remainder of cwnd increments
+    simtime_t cubic_minRtt;     ///< minimum RTT observed (0: no sample yet)
+};
+
+
+/**
+ * Implements CUBIC congestion control (RFC 8312) on top of TCP Reno's
+ * fast retransmit/fast recovery and SACK-based loss recovery.
+ *
+ * In congestion avoidance the window follows
+ *
+ *   W(t) = C*(t-K)^3 + W_max,   K = cbrt(W_max*(1-beta)/C)
+ *
+ * where t is the time elapsed since the last window reduction, with the
+ * TCP-friendly region and fast convergence enabled. On loss, ssthresh is
+ * set to beta*cwnd (beta = 0.7). Hystart is not implemented; slow start
+ * is the standard one.
+ */
+class INET_API TCPCubic : public TCPReno
+{
+  protected:
+    TCPCubicStateVariables *&state; // alias to TCPAlgorithm's 'state'
+
+    /** Create and return a TCPCubicStateVariables object. */
+    virtual TCPStateVariables *createStateVariables() {
+        return new TCPCubicStateVariables();
+    }
+
+    /** Performs the multiplicative decrease, and remembers W_max */
+    virtual void recalculateSlowStartThreshold();
+
+    /** Tracks the minimum RTT in addition to the usual RTO calculation */
+    virtual void rttMeasurementComplete(simtime_t tSent, simtime_t tAcked);
+
+    /** Congestion avoidance: cubic window growth for bytesAcked newly acked bytes */
+    virtual void cubicUpdate(uint32 bytesAcked);
+
+  public:
+    /** Ctor */
+    TCPCubic();
+
+    /** Redefine what should happen when data got acked, to add congestion window management */
+    virtual void receivedDataAck(uint32 firstSeqAcked);
+};
+
+#endif
@@ -0,0 +1,147 @@
+//
+// Copyright (C) 2026 OpenSim Ltd
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program; if not, see <http://www.gnu.org/licenses/>.
+//
+
+#include "TCPDeliveryRateSampler.h"
+
+
+TCPDeliveryRateSampler::TCPDeliveryRateSampler()
+{
+    delivered = 0;
+    deliveredTime = 0;
+    firstSentTime = 0;
+    appLimitedUntil = 0;
+}
+
+void TCPDeliveryRateSampler::snapshot(SentRecord& rec, simtime_t now)
+{
+    rec.delivered = delivered;
+    rec.deliveredTime = deliveredTime;
+    rec.firstSentTime = firstSentTime;
+    rec.sentTime = now;
+    rec.isAppLimited = appLimitedUntil != 0;
+}
+
+void TCPDeliveryRateSampler::onSent(uint32 beg, uint32 end, uint32 sndUna)
+{
+    if (!seqLess(beg, end))
+        return;
+
+    simtime_t now = simTime();
+
+    // nothing in flight: this transmission starts a new flight
+    if (records.empty() && beg == sndUna)
+        firstSentTime = deliveredTime = now;
+
+    // retransmitted part: re-stamp the overlapping records (splitting them at the borders)
+    for (SentRecords::iterator it = records.begin(); it != records.end() && seqLess(it->beg, end); ++it)
+    {
+        if (seqLE(it->end, beg))
+            continue;
+
+        if (seqLess(it->beg, beg))
+        {
+            SentRecord head = *it;
+            head.end = beg;
+            records.insert(it, head);
+            it->beg = beg;
+        }
+
+        if (seqLess(end, it->end))
+        {
+            SentRecord tail = *it;
+            tail.beg = end;
+            it->end = end;
+            SentRecords::iterator next = it;
+            records.insert(++next, tail);
+        }
+
+        snapshot(*it, now);
+        it->retransmitted = true;
+    }
+
+    // new data
+    uint32 newBeg = records.empty() ? beg : seqMax(beg, records.back().end);
+
+    if (seqLess(newBeg, end))
+    {
+        SentRecord rec;
+        rec.beg = newBeg;
+        rec.end = end;
+        rec.retransmitted = false;
+        snapshot(rec, now);
+        records.push_back(rec);
+    }
+}
+
+void TCPDeliveryRateSampler::onAppLimited(uint32 bytesInFlight)
+{
+    appLimitedUntil = delivered + (bytesInFlight ? bytesInFlight : 1);
+}
+
+void TCPDeliveryRateSampler::onAck(uint32 sndUna, uint32 bytesAcked, RateSample& sample)
+{
+    sample.deliveryRate = -1;
+    sample.rtt = -1;
+    sample.priorDelivered = 0;
+    sample.delivered = 0;
+    sample.isAppLimited = false;
+
+    simtime_t now = simTime();
+    delivered += bytesAcked;
+    deliveredTime = now;
+
+    if (appLimitedUntil != 0 && delivered > appLimitedUntil)
+        appLimitedUntil = 0;
+
+    // find the newest acked record, i.e. the one containing sndUna-1, and drop acked records
+    const SentRecord *newest = NULL;
+    SentRecord last;
+
+    while (!records.empty() && seqLess(records.front().beg, sndUna))
+    {
+        SentRecord& front = records.front();
+        last = front;
+        newest = &last;
+
+        if (seqLE(front.end, sndUna))
+            records.pop_front();
+        else
+        {
+            front.beg = sndUna;
+            break;
+        }
+    }
+
+    if (!newest)
+        return;
+
+    firstSentTime = newest->sentTime;
+
+    simtime_t sendElapsed = newest->sentTime - newest->firstSentTime;
+    simtime_t ackElapsed = deliveredTime - newest->deliveredTime;
+    simtime_t interval = std::max(sendElapsed, ackElapsed);
+
+    sample.priorDelivered = newest->delivered;
+    sample.delivered = delivered - newest->delivered;
+    sample.isAppLimited = newest->isAppLimited;
+
+    if (!newest->retransmitted)
+        sample.rtt = now - newest->sentTime;
+
+    if (interval > 0)
+        sample.deliveryRate = sample.delivered / SIMTIME_DBL(interval);
+}
@@ -0,0 +1,102 @@
+//
+// Copyright (C) 2026 OpenSim Ltd
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program; if not, see <http://www.gnu.org/licenses/>.
+//
+
+#ifndef __INET_TCPDELIVERYRATESAMPLER_H
+#define __INET_TCPDELIVERYRATESAMPLER_H
+
+#include <list>
+
+#include "INETDefs.h"
+
+#include "TCPSegment.h"
+
+
+/**
+ * Delivery rate estimation for model-based congestion control (BBR),
+ * following draft-cheng-iccrg-delivery-rate-estimation.
+ *
+ * The sampler snapshots the connection's delivery state whenever data are
+ * (re)transmitted, and computes a rate sample when the data get cumulatively
+ * acknowledged. Data sent in one burst share one record, because they were
+ * sent at the same time with the same delivery state. SACKed data are not
+ * counted as delivered before they are cumulatively acked. The records are
+ * kept across a retransmission timeout: the retransmissions re-stamp them,
+ * and data acked after a retransmission give no RTT sample.
+ */
+class INET_API TCPDeliveryRateSampler
+{
+  public:
+    /** Result of onAck() */
+    struct RateSample
+    {
+        double deliveryRate;      ///< bytes/s, or -1 if no valid sample
+        simtime_t rtt;            ///< RTT of the newest acked data, or -1 if it was retransmitted
+        uint64 priorDelivered;    ///< 'delivered' when the newest acked data were sent
+        uint64 delivered;         ///< bytes delivered during the sample interval
+        bool isAppLimited;        ///< the sample was taken while the application was idle
+    };
+
+  protected:
+    struct SentRecord
+    {
+        uint32 beg, end;          // [beg, end)
+        uint64 delivered;         // delivered bytes when sent
+        simtime_t deliveredTime;  // time of the last delivery when sent
+        simtime_t firstSentTime;  // send time of the first packet of the flight when sent
+        simtime_t sentTime;
+        bool isAppLimited;
+        bool retransmitted;
+    };
+    typedef std::list<SentRecord> SentRecords;
+
+    SentRecords records;          // ordered by sequence number, contiguous
+    uint64 delivered;             // total bytes delivered (cumulatively acked)
+    simtime_t deliveredTime;      // time 'delivered' was last updated
+    simtime_t firstSentTime;      // send time of the newest acked data
+    uint64 appLimitedUntil;       // non-zero while app-limited: 'delivered' value ending that period
+
+    void snapshot(SentRecord& rec, simtime_t now);
+
+  public:
+    TCPDeliveryRateSampler();
+
+    /** Total number of bytes delivered so far */
+    uint64 getDelivered() const { return delivered; }
+
+    /** True while the sender is in an application-limited phase */
+    bool isAppLimited() const { return appLimitedUntil != 0; }
+
+    /**
+     * To be called when [beg,end) has been sent or retransmitted;
+     * sndUna is the oldest unacknowledged sequence number.
+     */
+    void onSent(uint32 beg, uint32 end, uint32 sndUna);
+
+    /**
+     * To be called when the sender runs out of data to send while it
+     * still has window; bytesInFlight is the amount of outstanding data.
+     */
+    void onAppLimited(uint32 bytesInFlight);
+
+    /**
+     * To be called when an ACK advanced snd_una to sndUna, acknowledging
+     * bytesAcked new bytes. Fills in 'sample'.
+     */
+    void onAck(uint32 sndUna, uint32 bytesAcked, RateSample& sample);
+};
+
+#endif
@@ -47,3 +47,12 @@ TCPTahoeRenoFamily::TCPTahoeRenoFamily() : TCPBaseAlg(),
         state((TCPTahoeRenoFamilyStateVariables *&)TCPAlgorithm::state)
 {
 }
+
+double TCPTahoeRenoFamily::getPacingRate()
+{
+    if (state->srtt == 0)
+        return 0;   // no RTT estimate yet
+
+    double gain = state->snd_cwnd < state->ssthresh ? TCP_PACING_SS_GAIN : TCP_PACING_CA_GAIN;
+    return gain * state->snd_cwnd / SIMTIME_DBL(state->srtt);
+}
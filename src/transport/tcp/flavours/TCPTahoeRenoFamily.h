@@ -46,6 +46,9 @@ class INET_API TCPTahoeRenoFamily : public TCPBaseAlg
   protected:
     TCPTahoeRenoFamilyStateVariables *&state; // alias to TCPAlgorithm's 'state'
 
+    /** Paces faster (TCP_PACING_SS_GAIN) in slow start */
+    virtual double getPacingRate();
+
   public:
     /** Ctor */
     TCPTahoeRenoFamily();
@@ -166,6 +166,8 @@ void TCPSegment::parsimUnpack(cCommBuffer *b)
 {
     TCPSegment_Base::parsimUnpack(b);
     doUnpacking(b, payloadList);
+    for (PayloadList::iterator i = payloadList.begin(); i != payloadList.end(); ++i)
+        take(i->msg);
 }
 
 void TCPSegment::setPayloadArraySize(unsigned int size)
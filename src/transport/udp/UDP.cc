@@ -95,6 +95,7 @@ UDP::SockDesc::SockDesc(int sockId_, int appGateIndex_) {
     reuseAddr = false;
     localPort = -1;
     remotePort = -1;
+    seqNum = 0;
     isBroadcast = false;
     multicastOutputInterfaceId = -1;
     multicastLoop = DEFAULT_MULTICAST_LOOP;
@@ -102,6 +103,34 @@ UDP::SockDesc::SockDesc(int sockId_, int appGateIndex_) {
     typeOfService = 0;
 }
 
+bool UDP::SockPair::operator==(const SockPair& other) const
+{
+    return localPort == other.localPort && remotePort == other.remotePort &&
+            remoteAddr == other.remoteAddr && localAddr == other.localAddr;
+}
+
+static size_t hashAddress(const IPvXAddress& addr)
+{
+    const uint32 *w = addr.words();
+    size_t h = hashUInt32(w[0]);
+    if (addr.isIPv6())
+        h = hashCombine(hashCombine(hashCombine(h, hashUInt32(w[1])), hashUInt32(w[2])), hashUInt32(w[3]));
+    return h;
+}
+
+size_t UDP::SockPairHash::operator()(const SockPair& pair) const
+{
+    size_t h = hashCombine(hashUInt32(pair.localPort), hashUInt32(pair.remotePort));
+    return hashCombine(hashCombine(h, hashAddress(pair.localAddr)), hashAddress(pair.remoteAddr));
+}
+
+// key of a connected socket in connectedSocketsMap; unspecified local addresses
+// (IPv4 or IPv6) are all stored as IPvXAddress()
+static UDP::SockPair getSockPair(UDP::SockDesc *sd)
+{
+    return UDP::SockPair(sd->localAddr.isUnspecified() ? IPvXAddress() : sd->localAddr, sd->localPort, sd->remoteAddr, sd->remotePort);
+}
+
 //--------
 UDP::UDP()
 {
@@ -124,6 +153,7 @@ void UDP::initialize(int stage)
         WATCH_PTRMAP(socketsByIdMap);
         WATCH_MAP(socketsByPortMap);
 
+        lastSeqNum = 0;
         lastEphemeralPort = EPHEMERAL_PORTRANGE_START;
         icmp = NULL;
         icmpv6 = NULL;
@@ -357,7 +387,8 @@ void UDP::processUDPPacket(UDPPacket *udpPacket)
     else
     {
         // multicast packet: find all matching sockets, and send up a copy to each
-        std::vector<SockDesc*> sds = findSocketsForMcastBcastPacket(destAddr, destPort, srcAddr, srcPort, isMulticast, isBroadcast);
+        std::vector<SockDesc*>& sds = mcastBcastSockets;
+        findSocketsForMcastBcastPacket(destAddr, destPort, srcAddr, srcPort, isMulticast, isBroadcast, sds);
         if (sds.empty())
         {
             EV << "No socket registered on port " << destPort << "\n";
@@ -501,14 +532,22 @@ void UDP::bind(int sockId, int gateIndex, const IPvXAddress& localAddr, int loca
         if (sd->isBound)
             error("bind: socket is already bound (sockId=%d)", sockId);
 
+        // the socket keeps its place in the lookup tables unless its key changes
+        bool isPortChanged = localPort != -1 && sd->localPort != localPort;
+        bool isKeyChanged = isPortChanged || (isConnected(sd) && sd->localAddr != localAddr);
         sd->isBound = true;
+        if (isKeyChanged)
+            removeFromLookupTables(sd);
         sd->localAddr = localAddr;
-        if (localPort != -1 && sd->localPort != localPort)
+        if (isPortChanged)
         {
             socketsByPortMap[sd->localPort].remove(sd);
             sd->localPort = localPort;
+            sd->seqNum = ++lastSeqNum;
             socketsByPortMap[sd->localPort].push_back(sd);
         }
+        if (isKeyChanged)
+            addToLookupTables(sd);
     }
     else
     {
@@ -525,9 +564,11 @@ void UDP::connect(int sockId, int gateIndex, const IPvXAddress& remoteAddr, int
         error("connect: invalid remote port number %d", remotePort);
 
     SockDesc *sd = getOrCreateSocket(sockId, gateIndex);
+    removeFromLookupTables(sd);
     sd->remoteAddr = remoteAddr;
     sd->remotePort = remotePort;
     sd->onlyLocalPortIsSet = false;
+    addToLookupTables(sd);
 
     EV << "Socket connected: " << *sd << "\n";
 }
@@ -546,7 +587,9 @@ UDP::SockDesc *UDP::createSocket(int sockId, int gateIndex, const IPvXAddress& l
 
     // add to socketsByPortMap
     SockDescList& list = socketsByPortMap[sd->localPort]; // create if doesn't exist
+    sd->seqNum = ++lastSeqNum;
     list.push_back(sd);
+    addToLookupTables(sd);
 
     EV << "Socket created: " << *sd << "\n";
     return sd;
@@ -570,6 +613,7 @@ void UDP::close(int sockId)
             {list.erase(it); break;}
     if (list.empty())
         socketsByPortMap.erase(sd->localPort);
+    removeFromLookupTables(sd);
     delete sd;
 }
 
@@ -582,11 +626,46 @@ void UDP::clearAllSockets()
         it->second.clear();
     }
     socketsByPortMap.clear();
+    connectedSocketsMap.clear();
+    unconnectedSocketsByPortMap.clear();
     for (SocketsByIdMap::iterator it = socketsByIdMap.begin(); it != socketsByIdMap.end(); ++it)
         delete it->second;
     socketsByIdMap.clear();
 }
 
+bool UDP::isConnected(SockDesc *sd)
+{
+    return !sd->onlyLocalPortIsSet && sd->remotePort != -1 && !sd->remoteAddr.isUnspecified();
+}
+
+void UDP::addToLookupTables(SockDesc *sd)
+{
+    if (isConnected(sd))
+        connectedSocketsMap[getSockPair(sd)].push_back(sd);
+    else
+        unconnectedSocketsByPortMap[sd->localPort].push_back(sd);
+}
+
+void UDP::removeFromLookupTables(SockDesc *sd)
+{
+    if (isConnected(sd))
+    {
+        ConnectedSocketsMap::iterator it = connectedSocketsMap.find(getSockPair(sd));
+        ASSERT(it != connectedSocketsMap.end());
+        it->second.remove(sd);
+        if (it->second.empty())
+            connectedSocketsMap.erase(it);
+    }
+    else
+    {
+        SocketsByPortMap::iterator it = unconnectedSocketsByPortMap.find(sd->localPort);
+        ASSERT(it != unconnectedSocketsByPortMap.end());
+        it->second.remove(sd);
+        if (it->second.empty())
+            unconnectedSocketsByPortMap.erase(it);
+    }
+}
+
 ushort UDP::getEphemeralPort()
 {
     // start at the last allocated port number + 1, and search for an unused one
@@ -625,37 +704,65 @@ UDP::SockDesc *UDP::findFirstSocketByLocalAddress(const IPvXAddress& localAddr,
 
 UDP::SockDesc *UDP::findSocketForUnicastPacket(const IPvXAddress& localAddr, ushort localPort, const IPvXAddress& remoteAddr, ushort remotePort)
 {
-    SocketsByPortMap::iterator it = socketsByPortMap.find(localPort);
-    if (it == socketsByPortMap.end())
-        return NULL;
-
-    // select the socket bound to ANY_ADDR only if there is no socket bound to localAddr
-    SockDescList& list = it->second;
+    // Select the last bound socket among those bound to localAddr, or if there
+    // is none, the first bound socket among those bound to ANY_ADDR, whether
+    // connected or not. Connected and unconnected sockets are kept in separate
+    // tables, so their binding order is compared by seqNum.
+    SockDesc *socketBoundToLocalAddress = NULL;
     SockDesc *socketBoundToAnyAddress = NULL;
-    for (SockDescList::reverse_iterator it = list.rbegin(); it != list.rend(); ++it)
+    SocketsByPortMap::iterator it = unconnectedSocketsByPortMap.find(localPort);
+    if (it != unconnectedSocketsByPortMap.end())
     {
-        SockDesc *sd = *it;
-        if (sd->onlyLocalPortIsSet || (
-                (sd->remotePort == -1 || sd->remotePort == remotePort) &&
-                (sd->localAddr.isUnspecified() || sd->localAddr == localAddr) &&
-                (sd->remoteAddr.isUnspecified() || sd->remoteAddr == remoteAddr) ))
+        SockDescList& list = it->second;
+        for (SockDescList::reverse_iterator it = list.rbegin(); it != list.rend(); ++it)
         {
-            if (sd->localAddr.isUnspecified())
-                socketBoundToAnyAddress = sd;
-            else
-                return sd;
+            SockDesc *sd = *it;
+            if (sd->onlyLocalPortIsSet || (
+                    (sd->remotePort == -1 || sd->remotePort == remotePort) &&
+                    (sd->localAddr.isUnspecified() || sd->localAddr == localAddr) &&
+                    (sd->remoteAddr.isUnspecified() || sd->remoteAddr == remoteAddr) ))
+            {
+                if (sd->localAddr.isUnspecified())
+                    socketBoundToAnyAddress = sd;
+                else
+                {
+                    socketBoundToLocalAddress = sd;
+                    break;
+                }
+            }
         }
     }
+
+    if (connectedSocketsMap.empty())
+        return socketBoundToLocalAddress ? socketBoundToLocalAddress : socketBoundToAnyAddress;
+
+    ConnectedSocketsMap::iterator cit = connectedSocketsMap.find(SockPair(localAddr, localPort, remoteAddr, remotePort));
+    if (cit != connectedSocketsMap.end())
+    {
+        for (SockDescList::iterator it = cit->second.begin(); it != cit->second.end(); ++it)
+            if (!socketBoundToLocalAddress || (*it)->seqNum > socketBoundToLocalAddress->seqNum)
+                socketBoundToLocalAddress = *it;
+    }
+    if (socketBoundToLocalAddress)
+        return socketBoundToLocalAddress;
+
+    cit = connectedSocketsMap.find(SockPair(IPvXAddress(), localPort, remoteAddr, remotePort));
+    if (cit != connectedSocketsMap.end())
+    {
+        for (SockDescList::iterator it = cit->second.begin(); it != cit->second.end(); ++it)
+            if (!socketBoundToAnyAddress || (*it)->seqNum < socketBoundToAnyAddress->seqNum)
+                socketBoundToAnyAddress = *it;
+    }
     return socketBoundToAnyAddress;
 }
 
-std::vector<UDP::SockDesc*> UDP::findSocketsForMcastBcastPacket(const IPvXAddress& localAddr, ushort localPort, const IPvXAddress& remoteAddr, ushort remotePort, bool isMulticast, bool isBroadcast)
+void UDP::findSocketsForMcastBcastPacket(const IPvXAddress& localAddr, ushort localPort, const IPvXAddress& remoteAddr, ushort remotePort, bool isMulticast, bool isBroadcast, std::vector<SockDesc*>& result)
 {
     ASSERT(isMulticast || isBroadcast);
-    std::vector<SockDesc*> result;
+    result.clear();
     SocketsByPortMap::iterator it = socketsByPortMap.find(localPort);
     if (it == socketsByPortMap.end())
-        return result;
+        return;
 
     SockDescList& list = it->second;
     for (SockDescList::iterator it = list.begin(); it != list.end(); ++it)
@@ -680,7 +787,6 @@ std::vector<UDP::SockDesc*> UDP::findSocketsForMcastBcastPacket(const IPvXAddres
             }
         }
     }
-    return result;
 }
 
 void UDP::sendUp(cPacket *payload, SockDesc *sd, const IPvXAddress& srcAddr, ushort srcPort, const IPvXAddress& destAddr, ushort destPort, int interfaceId, int ttl, unsigned char tos)
@@ -22,8 +22,10 @@
 
 #include <map>
 #include <list>
+#include <vector>
 
 #include "ILifecycle.h"
+#include "OpenHashMap.h"
 #include "UDPControlInfo.h"
 
 class IPv4ControlInfo;
@@ -57,6 +59,7 @@ class INET_API UDP : public cSimpleModule, public ILifecycle
         IPvXAddress remoteAddr;
         int localPort;
         int remotePort;
+        unsigned long seqNum; // order of the sockets in socketsByPortMap, see findSocketForUnicastPacket()
         bool isBroadcast;
         int multicastOutputInterfaceId;
         bool multicastLoop;
@@ -65,16 +68,45 @@ class INET_API UDP : public cSimpleModule, public ILifecycle
         std::map<IPvXAddress,int> multicastAddrs; // key: multicast address; value: output interface Id or -1
     };
 
+    // local and remote address/port of a connected socket; key of the unicast lookup table
+    struct SockPair
+    {
+        IPvXAddress localAddr;
+        IPvXAddress remoteAddr;
+        int localPort;
+        int remotePort;
+
+        SockPair() : localPort(-1), remotePort(-1) {}
+        SockPair(const IPvXAddress& localAddr, int localPort, const IPvXAddress& remoteAddr, int remotePort) :
+            localAddr(localAddr), remoteAddr(remoteAddr), localPort(localPort), remotePort(remotePort) {}
+        bool operator==(const SockPair& other) const;
+    };
+
+    struct SockPairHash
+    {
+        size_t operator()(const SockPair& pair) const;
+    };
+
     typedef std::list<SockDesc *> SockDescList;   // might contain duplicated local addresses if their reuseAddr flag is set
     typedef std::map<int,SockDesc *> SocketsByIdMap;
     typedef std::map<int,SockDescList> SocketsByPortMap;
+    typedef OpenHashMap<SockPair,SockDescList,SockPairHash> ConnectedSocketsMap;
 
   protected:
     // sockets
     SocketsByIdMap socketsByIdMap;
-    SocketsByPortMap socketsByPortMap;
+    SocketsByPortMap socketsByPortMap;  // all sockets
+
+    // unicast lookup: connected sockets by local/remote address and port (local
+    // address may be unspecified), and all other sockets by local port
+    ConnectedSocketsMap connectedSocketsMap;
+    SocketsByPortMap unconnectedSocketsByPortMap;
+
+    // reused for every multicast/broadcast packet to avoid allocations
+    std::vector<SockDesc *> mcastBcastSockets;
 
     // other state vars
+    unsigned long lastSeqNum;
     ushort lastEphemeralPort;
     ICMP *icmp;
     ICMPv6 *icmpv6;
@@ -105,6 +137,9 @@ class INET_API UDP : public cSimpleModule, public ILifecycle
     virtual void connect(int sockId, int gateIndex, const IPvXAddress& remoteAddr, int remotePort);
     virtual void close(int sockId);
     virtual void clearAllSockets();
+    virtual bool isConnected(SockDesc *sd);
+    virtual void addToLookupTables(SockDesc *sd);
+    virtual void removeFromLookupTables(SockDesc *sd);
     virtual void setTimeToLive(SockDesc *sd, int ttl);
     virtual void setTypeOfService(SockDesc *sd, int typeOfService);
     virtual void setBroadcast(SockDesc *sd, bool broadcast);
@@ -119,7 +154,7 @@ class INET_API UDP : public cSimpleModule, public ILifecycle
     virtual ushort getEphemeralPort();
 
     virtual SockDesc *findSocketForUnicastPacket(const IPvXAddress& localAddr, ushort localPort, const IPvXAddress& remoteAddr, ushort remotePort);
-    virtual std::vector<SockDesc*> findSocketsForMcastBcastPacket(const IPvXAddress& localAddr, ushort localPort, const IPvXAddress& remoteAddr, ushort remotePort, bool isMulticast, bool isBroadcast);
+    virtual void findSocketsForMcastBcastPacket(const IPvXAddress& localAddr, ushort localPort, const IPvXAddress& remoteAddr, ushort remotePort, bool isMulticast, bool isBroadcast, std::vector<SockDesc*>& result);
     virtual SockDesc *findFirstSocketByLocalAddress(const IPvXAddress& localAddr, ushort localPort);
     virtual void sendUp(cPacket *payload, SockDesc *sd, const IPvXAddress& srcAddr, ushort srcPort, const IPvXAddress& destAddr, ushort destPort, int interfaceId, int ttl, unsigned char tos);
     virtual void sendDown(cPacket *appData, const IPvXAddress& srcAddr, ushort srcPort, const IPvXAddress& destAddr, ushort destPort, int interfaceId, bool multicastLoop, int ttl, unsigned char tos);
@@ -16,13 +16,29 @@
 // along with this program; if not, see <http://www.gnu.org/licenses/>.
 //
 
+#include <string.h>
+
 #include "TCPIPchecksum.h"
 
 //#if !defined(_WIN32) && !defined(__WIN32__) && !defined(WIN32) && !defined(__CYGWIN__) && !defined(_WIN64)
 //#include <netinet/in.h>  // htonl, ntohl, ...
 //#endif
 
-uint16_t TCPIPchecksum::_checksum(const void *addr, unsigned int count)
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#  define TCPIPCHECKSUM_X86_DISPATCH
+#  include <immintrin.h>
+#  define TARGET_SSE2 __attribute__((target("sse2")))
+#  define TARGET_AVX2 __attribute__((target("avx2")))
+#elif defined(_MSC_VER) && defined(_M_X64)
+#  include <emmintrin.h>  // SSE2 is part of the x86-64 baseline
+#  define TCPIPCHECKSUM_MSVC_SSE2
+#  define TARGET_SSE2
+#endif
+
+
+TCPIPchecksum::SumFunction TCPIPchecksum::sumFunction = &TCPIPchecksum::resolveAndSum;
+
+uint16_t TCPIPchecksum::_checksumScalar(const void *addr, unsigned int count)
 {
     uint32_t sum = 0;
 
@@ -42,3 +58,224 @@ uint16_t TCPIPchecksum::_checksum(const void *addr, unsigned int count)
 
     return (uint16_t)sum;
 }
+
+// adds a 64-bit word to a one's complement accumulator (end-around carry)
+static inline uint64_t addWithCarry(uint64_t sum, uint64_t word)
+{
+    sum += word;
+    return sum + (sum < word);
+}
+
+// sums the remaining bytes (fewer than the block size of the caller), then
+// folds the 64-bit accumulator down to 16 bits; the odd trailing byte is
+// treated exactly like in _checksumScalar()
+static uint16_t sumTailAndFold(uint64_t sum, const uint8_t *p, unsigned int count)
+{
+    while (count >= 8)
+    {
+        uint64_t w;
+        memcpy(&w, p, 8);
+        sum = addWithCarry(sum, w);
+        p += 8;
+        count -= 8;
+    }
+
+    uint64_t tail = 0;
+    while (count > 1)
+    {
+        uint16_t w;
+        memcpy(&w, p, 2);
+        tail += w;
+        p += 2;
+        count -= 2;
+    }
+    if (count)
+        tail += *p;
+    sum = addWithCarry(sum, tail);
+
+    sum = (sum & 0xFFFFFFFF) + (sum >> 32);
+    sum = (sum & 0xFFFFFFFF) + (sum >> 32);
+    sum = (sum & 0xFFFF) + (sum >> 16);
+    sum = (sum & 0xFFFF) + (sum >> 16);
+    sum = (sum & 0xFFFF) + (sum >> 16);
+    return (uint16_t)sum;
+}
+
+uint16_t TCPIPchecksum::_checksumWide64(const void *addr, unsigned int count)
+{
+    const uint8_t *p = (const uint8_t *)addr;
+    uint64_t sum0 = 0, sum1 = 0;
+
+    // two independent accumulators to break the carry dependency chain
+    while (count >= 32)
+    {
+        uint64_t w[4];
+        memcpy(w, p, 32);
+        sum0 = addWithCarry(sum0, w[0]);
+        sum1 = addWithCarry(sum1, w[1]);
+        sum0 = addWithCarry(sum0, w[2]);
+        sum1 = addWithCarry(sum1, w[3]);
+        p += 32;
+        count -= 32;
+    }
+
+    return sumTailAndFold(addWithCarry(sum0, sum1), p, count);
+}
+
+#if defined(TCPIPCHECKSUM_X86_DISPATCH) || defined(TCPIPCHECKSUM_MSVC_SSE2)
+
+// 32-bit halves of each 128-bit block are zero-extended into 64-bit lanes,
+// so the lane sums cannot overflow for any realistic buffer size
+TARGET_SSE2 uint16_t TCPIPchecksum::_checksumSSE2(const void *addr, unsigned int count)
+{
+    const uint8_t *p = (const uint8_t *)addr;
+    const __m128i zero = _mm_setzero_si128();
+    __m128i acc0 = _mm_setzero_si128();
+    __m128i acc1 = _mm_setzero_si128();
+
+    while (count >= 32)
+    {
+        __m128i v0 = _mm_loadu_si128((const __m128i *)p);
+        __m128i v1 = _mm_loadu_si128((const __m128i *)(p + 16));
+        acc0 = _mm_add_epi64(acc0, _mm_unpacklo_epi32(v0, zero));
+        acc1 = _mm_add_epi64(acc1, _mm_unpackhi_epi32(v0, zero));
+        acc0 = _mm_add_epi64(acc0, _mm_unpacklo_epi32(v1, zero));
+        acc1 = _mm_add_epi64(acc1, _mm_unpackhi_epi32(v1, zero));
+        p += 32;
+        count -= 32;
+    }
+
+    uint64_t lanes[4];
+    _mm_storeu_si128((__m128i *)lanes, acc0);
+    _mm_storeu_si128((__m128i *)(lanes + 2), acc1);
+    uint64_t sum = addWithCarry(addWithCarry(lanes[0], lanes[1]), addWithCarry(lanes[2], lanes[3]));
+    return sumTailAndFold(sum, p, count);
+}
+
+#else
+
+uint16_t TCPIPchecksum::_checksumSSE2(const void *addr, unsigned int count)
+{
+    throw cRuntimeError("TCPIPchecksum: SSE2 implementation not available in this build");
+}
+
+#endif
+
+#ifdef TCPIPCHECKSUM_X86_DISPATCH
+
+TARGET_AVX2 uint16_t TCPIPchecksum::_checksumAVX2(const void *addr, unsigned int count)
+{
+    const uint8_t *p = (const uint8_t *)addr;
+    const __m256i zero = _mm256_setzero_si256();
+    __m256i acc0 = _mm256_setzero_si256();
+    __m256i acc1 = _mm256_setzero_si256();
+
+    while (count >= 64)
+    {
+        __m256i v0 = _mm256_loadu_si256((const __m256i *)p);
+        __m256i v1 = _mm256_loadu_si256((const __m256i *)(p + 32));
+        acc0 = _mm256_add_epi64(acc0, _mm256_unpacklo_epi32(v0, zero));
+        acc1 = _mm256_add_epi64(acc1, _mm256_unpackhi_epi32(v0, zero));
+        acc0 = _mm256_add_epi64(acc0, _mm256_unpacklo_epi32(v1, zero));
+        acc1 = _mm256_add_epi64(acc1, _mm256_unpackhi_epi32(v1, zero));
+        p += 64;
+        count -= 64;
+    }
+
+    uint64_t lanes[8];
+    _mm256_storeu_si256((__m256i *)lanes, acc0);
+    _mm256_storeu_si256((__m256i *)(lanes + 4), acc1);
+    uint64_t sum = 0;
+    for (int i = 0; i < 8; i++)
+        sum = addWithCarry(sum, lanes[i]);
+    return sumTailAndFold(sum, p, count);
+}
+
+#else
+
+uint16_t TCPIPchecksum::_checksumAVX2(const void *addr, unsigned int count)
+{
+    throw cRuntimeError("TCPIPchecksum: AVX2 implementation not available in this build");
+}
+
+#endif
+
+bool TCPIPchecksum::isAvailable(Implementation impl)
+{
+    switch (impl)
+    {
+        case IMPL_AUTO:
+        case IMPL_SCALAR:
+        case IMPL_WIDE64:
+            return true;
+#if defined(TCPIPCHECKSUM_X86_DISPATCH)
+        case IMPL_SSE2:
+            return __builtin_cpu_supports("sse2");
+        case IMPL_AVX2:
+            return __builtin_cpu_supports("avx2");
+#elif defined(TCPIPCHECKSUM_MSVC_SSE2)
+        case IMPL_SSE2:
+            return true;
+#endif
+        default:
+            return false;
+    }
+}
+
+TCPIPchecksum::SumFunction TCPIPchecksum::getSumFunction(Implementation impl)
+{
+    switch (impl)
+    {
+        case IMPL_SCALAR: return &TCPIPchecksum::_checksumScalar;
+        case IMPL_WIDE64: return &TCPIPchecksum::_checksumWide64;
+        case IMPL_SSE2: return &TCPIPchecksum::_checksumSSE2;
+        case IMPL_AVX2: return &TCPIPchecksum::_checksumAVX2;
+        case IMPL_AUTO:
+            if (isAvailable(IMPL_AVX2))
+                return &TCPIPchecksum::_checksumAVX2;
+            if (isAvailable(IMPL_SSE2))
+                return &TCPIPchecksum::_checksumSSE2;
+            return &TCPIPchecksum::_checksumWide64;
+        default:
+            throw cRuntimeError("TCPIPchecksum: unknown implementation %d", (int)impl);
+    }
+}
+
+uint16_t TCPIPchecksum::resolveAndSum(const void *addr, unsigned int count)
+{
+    sumFunction = getSumFunction(IMPL_AUTO);
+    return sumFunction(addr, count);
+}
+
+void TCPIPchecksum::setImplementation(Implementation impl)
+{
+    if (!isAvailable(impl))
+        throw cRuntimeError("TCPIPchecksum: %s implementation is not available on this platform", getImplementationName(impl));
+    sumFunction = (impl == IMPL_AUTO) ? &TCPIPchecksum::resolveAndSum : getSumFunction(impl);
+}
+
+TCPIPchecksum::Implementation TCPIPchecksum::getImplementation()
+{
+    if (sumFunction == &TCPIPchecksum::resolveAndSum)
+        sumFunction = getSumFunction(IMPL_AUTO);
+    if (sumFunction == &TCPIPchecksum::_checksumScalar)
+        return IMPL_SCALAR;
+    if (sumFunction == &TCPIPchecksum::_checksumSSE2)
+        return IMPL_SSE2;
+    if (sumFunction == &TCPIPchecksum::_checksumAVX2)
+        return IMPL_AVX2;
+    return IMPL_WIDE64;
+}
+
+const char *TCPIPchecksum::getImplementationName(Implementation impl)
+{
+    switch (impl)
+    {
+        case IMPL_AUTO: return "auto";
+        case IMPL_SCALAR: return "scalar";
+        case IMPL_WIDE64: return "wide64";
+        case IMPL_SSE2: return "SSE2";
+        case IMPL_AVX2: return "AVX2";
+        default: return "unknown";
+    }
+}
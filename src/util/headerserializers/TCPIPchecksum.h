@@ -24,9 +24,31 @@
 
 /**
  * Calculates checksum.
+ *
+ * The one's complement sum is computed by one of several interchangeable
+ * implementations (byte-wise reference loop, 64-bit wide words, SSE2, AVX2).
+ * The fastest one supported by the CPU is selected at the first call;
+ * all of them produce bit-identical results.
  */
 class TCPIPchecksum
 {
+    public:
+        enum Implementation
+        {
+            IMPL_AUTO = 0,  // select the fastest available one
+            IMPL_SCALAR,    // reference 16-bit loop
+            IMPL_WIDE64,    // portable 64-bit word accumulation
+            IMPL_SSE2,
+            IMPL_AVX2
+        };
+
+    protected:
+        typedef uint16_t (*SumFunction)(const void *addr, unsigned int count);
+        static SumFunction sumFunction;
+
+        static uint16_t resolveAndSum(const void *addr, unsigned int count);
+        static SumFunction getSumFunction(Implementation impl);
+
     public:
         TCPIPchecksum() {}
 
@@ -42,7 +64,71 @@ class TCPIPchecksum
             return ~ _checksum(addr, count);
         }
 
-        static uint16_t _checksum(const void *addr, unsigned int count);
+        /*
+         * one's complement sum (without the final complement), using the
+         * implementation selected at runtime
+         */
+        static uint16_t _checksum(const void *addr, unsigned int count)
+        {
+            return sumFunction(addr, count);
+        }
+
+        /** @name Individual implementations; they are exposed for testing and benchmarking */
+        //@{
+        static uint16_t _checksumScalar(const void *addr, unsigned int count);
+        static uint16_t _checksumWide64(const void *addr, unsigned int count);
+        static uint16_t _checksumSSE2(const void *addr, unsigned int count);
+        static uint16_t _checksumAVX2(const void *addr, unsigned int count);
+        //@}
+
+        /**
+         * Returns true if the given implementation can run on this CPU/build.
+         */
+        static bool isAvailable(Implementation impl);
+
+        /**
+         * Forces the given implementation (IMPL_AUTO restores the automatic
+         * selection). Throws an error if the implementation is not available.
+         */
+        static void setImplementation(Implementation impl);
+
+        /**
+         * Returns the implementation currently in use.
+         */
+        static Implementation getImplementation();
+
+        static const char *getImplementationName(Implementation impl);
+
+        /** @name Incremental checksum update (RFC 1624, eqn. 3: HC' = ~(~HC + ~m + m'))
+         *
+         * The checksum and the words must be in the same byte order
+         * (e.g. all in network byte order, as stored in the header).
+         * Useful for TTL decrement, port or address rewrites without
+         * re-summing the whole packet.
+         */
+        //@{
+        static uint16_t updateChecksum(uint16_t oldChecksum, uint16_t oldWord, uint16_t newWord)
+        {
+            uint32_t sum = (uint16_t)~oldChecksum;
+            sum += (uint16_t)~oldWord;
+            sum += newWord;
+            sum = (sum & 0xFFFF) + (sum >> 16);
+            sum = (sum & 0xFFFF) + (sum >> 16);
+            return (uint16_t)~sum;
+        }
+
+        static uint16_t updateChecksum32(uint16_t oldChecksum, uint32_t oldValue, uint32_t newValue)
+        {
+            uint32_t sum = (uint16_t)~oldChecksum;
+            sum += (uint16_t)~(oldValue >> 16);
+            sum += (uint16_t)~(oldValue & 0xFFFF);
+            sum += newValue >> 16;
+            sum += newValue & 0xFFFF;
+            sum = (sum & 0xFFFF) + (sum >> 16);
+            sum = (sum & 0xFFFF) + (sum >> 16);
+            return (uint16_t)~sum;
+        }
+        //@}
 };
 
 #endif